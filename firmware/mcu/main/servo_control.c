@@ -2,6 +2,7 @@
 #include "driver/ledc.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
 #include <math.h>
 
 /* GPIO assignment */
@@ -30,6 +31,18 @@ static int s_step[2]    = {0, 0};      /* current step in sync move */
 static bool s_sync_mode = false;       /* true = use synchronized interpolation */
 static TaskHandle_t s_smooth_task = NULL;
 
+/* Command → first LEDC update latency (32-bit us: written atomically) */
+static volatile uint32_t s_cmd_us = 0;  /* 0 = no command waiting */
+static uint32_t s_lat_max_us = 0;
+static uint64_t s_lat_sum_us = 0;
+static uint32_t s_lat_n = 0;
+
+static void mark_command(void)
+{
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    s_cmd_us = now ? now : 1;
+}
+
 /* ------------------------------------------------------------------ */
 /* Internal: apply angle to hardware immediately */
 static void servo_apply_hardware(servo_axis_t axis, int angle)
@@ -37,6 +50,15 @@ static void servo_apply_hardware(servo_axis_t axis, int angle)
     ledc_channel_t ch = (axis == SERVO_X) ? LEDC_CH_X : LEDC_CH_Y;
     ledc_set_duty(LEDC_MODE, ch, angle_to_duty(angle));
     ledc_update_duty(LEDC_MODE, ch);
+
+    uint32_t cmd = s_cmd_us;
+    if (cmd) {
+        uint32_t lat = (uint32_t)esp_timer_get_time() - cmd;
+        s_cmd_us = 0;
+        s_lat_sum_us += lat;
+        s_lat_n++;
+        if (lat > s_lat_max_us) s_lat_max_us = lat;
+    }
 }
 
 /* ------------------------------------------------------------------ */
@@ -157,12 +179,20 @@ void servo_set_angle(servo_axis_t axis, float angle)
     s_sync_mode = false;
 
     /* Set target - background task will smooth to it */
+    if (s_current[axis] != rounded) mark_command();
     s_target[axis] = rounded;
 }
 
 /* ------------------------------------------------------------------ */
 
 void servo_set_angle_sync(int x, int y)
+{
+    servo_move_sync(x, y, 0);
+}
+
+/* ------------------------------------------------------------------ */
+
+void servo_move_sync(int x, int y, int duration_ms)
 {
     /* Clamp X axis */
     if (x < 0) x = 0;
@@ -195,12 +225,18 @@ void servo_set_angle_sync(int x, int y)
         return;
     }
 
+    /* Explicit duration (binary frames / "X:90:500") overrides the speed */
+    if (duration_ms > 0) {
+        max_steps = (duration_ms + STEP_MS - 1) / STEP_MS;
+    }
+
     s_steps[0] = max_steps;
     s_steps[1] = max_steps;
     s_step[0] = 0;
     s_step[1] = 0;
 
     /* Enable synchronized mode */
+    mark_command();
     s_sync_mode = true;
 }
 
@@ -248,3 +284,11 @@ int servo_get_target(servo_axis_t axis)
 {
     return s_target[axis];
 }
+
+/* ------------------------------------------------------------------ */
+
+void servo_get_latency(uint32_t *avg_us, uint32_t *max_us)
+{
+    if (avg_us) *avg_us = s_lat_n ? (uint32_t)(s_lat_sum_us / s_lat_n) : 0;
+    if (max_us) *max_us = s_lat_max_us;
+}
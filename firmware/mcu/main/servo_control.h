@@ -1,6 +1,7 @@
 #pragma once
 #include "servo_math.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef enum {
     SERVO_X = 0,  /* GPIO 12 — left/right */
@@ -29,6 +30,12 @@ void servo_set_angle(servo_axis_t axis, float angle);
  */
 void servo_set_angle_sync(int x, int y);
 
+/**
+ * Same as servo_set_angle_sync(), finishing in duration_ms.
+ * @param duration_ms  Move time (ms), 0 = default SMOOTH_SPEED pace
+ */
+void servo_move_sync(int x, int y, int duration_ms);
+
 /**
  * Set angle immediately without smoothing.
  * Use for initialization or emergency positioning.
@@ -56,3 +63,11 @@ int servo_get_target(servo_axis_t axis);
  * @return  true if any servo is moving
  */
 bool servo_is_moving(void);
+
+/**
+ * Command-to-PWM latency: from servo_set_angle() / servo_move_sync() to
+ * the first LEDC duty update it causes (bounded by the STEP_MS tick).
+ * @param avg_us  Receives the average (may be NULL)
+ * @param max_us  Receives the maximum (may be NULL)
+ */
+void servo_get_latency(uint32_t *avg_us, uint32_t *max_us);
@@ -5,6 +5,7 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "esp_timer.h"
 
 #define TAG         "UART"
@@ -14,6 +15,13 @@
 #define UART_BAUD   115200
 #define RX_BUF      512
 
+/* Event-driven receive: the task sleeps on the driver's event queue */
+#define RX_QUEUE_LEN     20
+#define RX_TOUT_SYMBOLS  2      /* idle-line gap that ends a burst (~0.2 ms) */
+#define LINE_PATTERN     '\n'   /* ASCII line end, AT_CMD pattern detect   */
+#define PATTERN_QUEUE    8
+#define STATS_PERIOD_MS  10000  /* rate report, only printed while active   */
+
 /* Sync command buffering */
 #define SYNC_TIMEOUT_MS  50   /* Max time to wait for paired command */
 
@@ -21,44 +29,199 @@ static bool s_has_x = false;
 static bool s_has_y = false;
 static int  s_pending_x = 0;
 static int  s_pending_y = 0;
+static int  s_duration = 0;           /* longest duration of the pair (ms) */
 static int64_t s_first_cmd_time = 0;
 
+static uart_rx_t s_rx;
+static QueueHandle_t s_uart_queue = NULL;
+
+static uart_handler_stats_t s_stats;
+static int64_t s_lat_sum_us = 0;
+static uint32_t s_lat_n = 0;
+
 /* ------------------------------------------------------------------ */
 
+/* 0.1° → whole degrees (servo_control works in degrees) */
+static int tenths_to_deg(int angle_x10)
+{
+    return (angle_x10 + 5) / 10;
+}
+
 /* Flush pending commands (either sync or individual) */
 static void flush_pending_commands(void)
 {
     if (s_has_x && s_has_y) {
         /* Both commands received - use synchronized mode */
         ESP_LOGI(TAG, "Sync move: X=%d, Y=%d", s_pending_x, s_pending_y);
-        servo_set_angle_sync(s_pending_x, s_pending_y);
+        servo_move_sync(s_pending_x, s_pending_y, s_duration);
     } else if (s_has_x) {
         /* Only X received */
         ESP_LOGI(TAG, "X → %d° (solo)", s_pending_x);
-        servo_set_angle(SERVO_X, s_pending_x);
+        if (s_duration > 0) {
+            servo_move_sync(s_pending_x, servo_get_target(SERVO_Y), s_duration);
+        } else {
+            servo_set_angle(SERVO_X, s_pending_x);
+        }
     } else if (s_has_y) {
         /* Only Y received */
         ESP_LOGI(TAG, "Y → %d° (solo)", s_pending_y);
-        servo_set_angle(SERVO_Y, s_pending_y);
+        if (s_duration > 0) {
+            servo_move_sync(servo_get_target(SERVO_X), s_pending_y, s_duration);
+        } else {
+            servo_set_angle(SERVO_Y, s_pending_y);
+        }
     }
 
     /* Reset buffer */
     s_has_x = false;
     s_has_y = false;
+    s_duration = 0;
+}
+
+/* Buffer one axis of a command */
+static void buffer_axis(char axis, int angle, int duration_ms)
+{
+    if (axis == 'X') {
+        s_pending_x = angle;
+        s_has_x = true;
+    } else {
+        s_pending_y = angle;
+        s_has_y = true;
+    }
+    if (duration_ms > s_duration) {
+        s_duration = duration_ms;
+    }
+}
+
+static void handle_cmd(const uart_cmd_t *cmd)
+{
+    if (cmd->binary) {
+        /* A frame already carries both axes of one update: apply at once */
+        flush_pending_commands();
+        for (int i = 0; i < cmd->count; i++) {
+            buffer_axis(cmd->axis[i].axis, tenths_to_deg(cmd->axis[i].angle_x10),
+                        cmd->axis[i].duration_ms);
+        }
+        flush_pending_commands();
+        return;
+    }
+
+    /* ASCII line: buffer command for sync */
+    if (!s_has_x && !s_has_y) {
+        s_first_cmd_time = esp_timer_get_time() / 1000;
+    }
+    buffer_axis(cmd->axis[0].axis, tenths_to_deg(cmd->axis[0].angle_x10),
+                cmd->axis[0].duration_ms);
+
+    /* If both received, flush immediately */
+    if (s_has_x && s_has_y) {
+        flush_pending_commands();
+    }
 }
 
 /* ------------------------------------------------------------------ */
 
+/* Read everything the driver has buffered and dispatch complete commands.
+ * t0_us: when the event was taken off the queue (start of rx latency). */
+static void drain_rx(int64_t t0_us)
+{
+    uint8_t raw[RX_BUF];
+    uart_cmd_t cmd;
+    size_t avail = 0;
+
+    uart_get_buffered_data_len(UART_NUM, &avail);
+    while (avail > 0) {
+        int n = uart_read_bytes(UART_NUM, raw, avail < sizeof(raw) ? avail : sizeof(raw), 0);
+        if (n <= 0) {
+            break;
+        }
+        avail -= n;
+
+        for (int i = 0; i < n; i++) {
+            if (uart_rx_feed(&s_rx, raw[i], &cmd)) {
+                handle_cmd(&cmd);
+
+                uint32_t lat = (uint32_t)(esp_timer_get_time() - t0_us);
+                s_lat_sum_us += lat;
+                s_lat_n++;
+                if (lat > s_stats.rx_latency_max_us) {
+                    s_stats.rx_latency_max_us = lat;
+                }
+            }
+        }
+    }
+}
+
+static void log_rates(int64_t now_ms)
+{
+    static int64_t  last_ms = 0;
+    static uint32_t last_wakeups = 0;
+
+    if (now_ms - last_ms < STATS_PERIOD_MS) {
+        return;
+    }
+
+    uart_handler_stats_t st;
+    uint32_t pwm_avg, pwm_max;
+    uart_handler_get_stats(&st);
+    servo_get_latency(&pwm_avg, &pwm_max);
+
+    uint32_t wakeups = st.wakeups - last_wakeups;
+    ESP_LOGI(TAG, "wakeups %lu.%lu/s, rx->cmd avg %luus max %luus, cmd->pwm avg %luus max %luus, ovf %lu",
+             (unsigned long)(wakeups * 1000 / (now_ms - last_ms)),
+             (unsigned long)(wakeups * 10000 / (now_ms - last_ms) % 10),
+             (unsigned long)st.rx_latency_avg_us, (unsigned long)st.rx_latency_max_us,
+             (unsigned long)pwm_avg, (unsigned long)pwm_max, (unsigned long)st.overflows);
+    last_ms = now_ms;
+    last_wakeups = st.wakeups;
+}
+
 static void uart_rx_task(void *arg)
 {
     (void)arg;
-    uint8_t raw[RX_BUF];
-    char    line[64];
-    int     line_len = 0;
+    uart_rx_stats_t last = {0};
+    uart_event_t ev;
+
+    uart_rx_init(&s_rx);
 
     while (1) {
-        int n = uart_read_bytes(UART_NUM, raw, sizeof(raw) - 1,
-                                pdMS_TO_TICKS(10));  /* Shorter timeout for sync */
+        /* Sleep until the driver posts an event; only a buffered ASCII
+         * half-pair needs a deadline (SYNC_TIMEOUT_MS) */
+        TickType_t wait = portMAX_DELAY;
+        if (s_has_x || s_has_y) {
+            int64_t left = s_first_cmd_time + SYNC_TIMEOUT_MS - esp_timer_get_time() / 1000;
+            wait = left > 0 ? pdMS_TO_TICKS(left) + 1 : 0;
+        }
+
+        bool got = xQueueReceive(s_uart_queue, &ev, wait) == pdTRUE;
+        int64_t t0 = esp_timer_get_time();
+        s_stats.wakeups++;
+
+        if (got) {
+            s_stats.events++;
+            switch (ev.type) {
+            case UART_PATTERN_DET:
+                uart_pattern_pop_pos(UART_NUM);   /* keep the position queue empty */
+                /* fall through */
+            case UART_DATA:
+                drain_rx(t0);
+                break;
+
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                /* Bytes were lost: drop everything and resync on the next delimiter */
+                s_stats.overflows++;
+                uart_flush_input(UART_NUM);
+                xQueueReset(s_uart_queue);
+                uart_rx_init(&s_rx);
+                last = s_rx.stats;
+                ESP_LOGW(TAG, "rx overflow, input flushed");
+                break;
+
+            default:
+                break;
+            }
+        }
 
         /* Check for sync timeout */
         if (s_has_x || s_has_y) {
@@ -68,42 +231,17 @@ static void uart_rx_task(void *arg)
             }
         }
 
-        for (int i = 0; i < n; i++) {
-            char c = (char)raw[i];
-
-            if (c == '\n' || c == '\r') {
-                /* Complete line received — parse and dispatch */
-                line[line_len] = '\0';
-                char axis;
-                int  angle;
-
-                if (parse_axis_cmd(line, &axis, &angle) == 0) {
-                    /* Buffer command for sync */
-                    if (!s_has_x && !s_has_y) {
-                        s_first_cmd_time = esp_timer_get_time() / 1000;
-                    }
-
-                    if (axis == 'X') {
-                        s_pending_x = angle;
-                        s_has_x = true;
-                    } else {
-                        s_pending_y = angle;
-                        s_has_y = true;
-                    }
-
-                    /* If both received, flush immediately */
-                    if (s_has_x && s_has_y) {
-                        flush_pending_commands();
-                    }
-                } else if (line_len > 0) {
-                    ESP_LOGW(TAG, "unknown cmd: '%s'", line);
-                }
-                line_len = 0;
-
-            } else if (c != '\r' && line_len < (int)sizeof(line) - 1) {
-                line[line_len++] = c;
-            }
+        /* Report link errors as they happen */
+        if (s_rx.stats.crc_errors != last.crc_errors || s_rx.stats.bad != last.bad ||
+            s_rx.stats.seq_gaps != last.seq_gaps) {
+            ESP_LOGW(TAG, "rx errors: crc=%lu bad=%lu seq_gaps=%lu (frames=%lu lines=%lu)",
+                     (unsigned long)s_rx.stats.crc_errors, (unsigned long)s_rx.stats.bad,
+                     (unsigned long)s_rx.stats.seq_gaps, (unsigned long)s_rx.stats.frames,
+                     (unsigned long)s_rx.stats.lines);
+            last = s_rx.stats;
         }
+
+        log_rates(t0 / 1000);
     }
 }
 
@@ -121,7 +259,24 @@ void uart_handler_init(void)
     uart_param_config(UART_NUM, &cfg);
     uart_set_pin(UART_NUM, UART_TX, UART_RX,
                  UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    uart_driver_install(UART_NUM, RX_BUF * 2, 0, 0, NULL, 0);
+    uart_driver_install(UART_NUM, RX_BUF * 2, 0, RX_QUEUE_LEN, &s_uart_queue, 0);
+
+    /* A binary frame or line arrives as one burst: post UART_DATA as soon
+     * as the line goes idle instead of after the default 10 symbols */
+    uart_set_rx_timeout(UART_NUM, RX_TOUT_SYMBOLS);
+
+    /* ASCII lines also end on '\n'. 0x00 is not used as the pattern: it
+     * opens as well as closes every binary frame, the idle timeout covers it */
+    uart_enable_pattern_det_baud_intr(UART_NUM, LINE_PATTERN, 1, 9, 0, 0);
+    uart_pattern_queue_reset(UART_NUM, PATTERN_QUEUE);
+}
+
+void uart_handler_get_stats(uart_handler_stats_t *out)
+{
+    if (!out) return;
+
+    *out = s_stats;
+    out->rx_latency_avg_us = s_lat_n ? (uint32_t)(s_lat_sum_us / s_lat_n) : 0;
 }
 
 void uart_handler_start_task(void)
@@ -1,7 +1,20 @@
 #pragma once
+#include <stdint.h>
+
+typedef struct {
+    uint32_t wakeups;            /* rx task wake-ups (events + sync deadlines) */
+    uint32_t events;             /* UART driver events received                */
+    uint32_t overflows;          /* FIFO / buffer overflows (input flushed)    */
+    uint32_t rx_latency_avg_us;  /* event dequeued → command handed to servo   */
+    uint32_t rx_latency_max_us;
+} uart_handler_stats_t;
 
 /** Configure UART2 (GPIO 16 RX / GPIO 17 TX, 115200 8N1). */
 void uart_handler_init(void);
 
-/** Start the UART receive task (FreeRTOS task, priority 10). */
+/** Start the UART receive task (FreeRTOS task, priority 10).
+ *  The task blocks on the driver event queue: no wake-ups while idle. */
 void uart_handler_start_task(void);
+
+/** Receive-path counters (also logged every 10 s while commands arrive). */
+void uart_handler_get_stats(uart_handler_stats_t *out);
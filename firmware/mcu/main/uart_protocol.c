@@ -1,19 +1,256 @@
 #include "uart_protocol.h"
 #include <stdio.h>
+#include <string.h>
 
 int parse_axis_cmd(const char *line, char *out_axis, int *out_angle)
 {
-    if (!line || !out_axis || !out_angle) return -1;
+    int duration;
+    return parse_axis_cmd_ex(line, out_axis, out_angle, &duration);
+}
+
+int parse_axis_cmd_ex(const char *line, char *out_axis, int *out_angle,
+                      int *out_duration)
+{
+    if (!line || !out_axis || !out_angle || !out_duration) return -1;
 
     char axis;
     int  angle;
+    int  duration = 0;
 
-    /* sscanf enforces the literal ':' separator */
-    if (sscanf(line, "%c:%d", &axis, &angle) != 2) return -1;
+    /* sscanf enforces the literal ':' separators; duration is optional */
+    int n = sscanf(line, "%c:%d:%d", &axis, &angle, &duration);
+    if (n < 2)                                     return -1;
     if (axis != 'X' && axis != 'Y')                return -1;
     if (angle < 0 || angle > 180)                  return -1;
+    if (n == 3 && (duration < 0 || duration > 0xFFFF)) return -1;
 
-    *out_axis  = axis;
-    *out_angle = angle;
+    *out_axis     = axis;
+    *out_angle    = angle;
+    *out_duration = (n == 3) ? duration : 0;
     return 0;
 }
+
+/* ── CRC / COBS ──────────────────────────────────────────────────── */
+
+/* CRC-16/CCITT-FALSE, one byte per lookup (poly 0x1021) */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+uint16_t uart_crc16(const uint8_t *data, int len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (int i = 0; i < len; i++) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+int cobs_decode(const uint8_t *in, int len, uint8_t *out, int size)
+{
+    if (!in || !out || len < 1) return -1;
+
+    int o = 0;
+    int i = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > len) return -1;   /* zero or overrun */
+
+        for (int k = 1; k < code; k++) {
+            if (in[i] == 0 || o >= size) return -1;
+            out[o++] = in[i++];
+        }
+        /* Implicit zero between blocks, not after the last or a full block */
+        if (code != 0xFF && i < len) {
+            if (o >= size) return -1;
+            out[o++] = 0;
+        }
+    }
+    return o;
+}
+
+/* ── binary frames ───────────────────────────────────────────────── */
+
+int uart_frame_decode(const uint8_t *body, int len, uart_cmd_t *out)
+{
+    uint8_t raw[UART_FRAME_RAW_MAX];
+
+    if (!body || !out) return -1;
+
+    int n = cobs_decode(body, len, raw, sizeof(raw));
+    if (n < 3 + 5 + 2) return -1;
+
+    uint16_t crc = (uint16_t)(raw[n - 2] | (raw[n - 1] << 8));
+    if (uart_crc16(raw, n - 2) != crc) return -2;
+
+    int count = raw[2];
+    if (raw[1] != UART_FRAME_TYPE_SERVO)                   return -1;
+    if (count < 1 || count > UART_FRAME_AXES_MAX)          return -1;
+    if (n != 3 + 5 * count + 2)                            return -1;
+
+    const uint8_t *p = &raw[3];
+    for (int i = 0; i < count; i++, p += 5) {
+        int angle = p[1] | (p[2] << 8);
+        if (p[0] > 1 || angle > 1800) return -1;
+
+        out->axis[i].axis        = (p[0] == 0) ? 'X' : 'Y';
+        out->axis[i].angle_x10   = angle;
+        out->axis[i].duration_ms = p[3] | (p[4] << 8);
+    }
+    out->count  = count;
+    out->seq    = raw[0];
+    out->binary = true;
+    return 0;
+}
+
+/* ── receive stream ──────────────────────────────────────────────── */
+
+void uart_rx_init(uart_rx_t *rx)
+{
+    if (rx) {
+        memset(rx, 0, sizeof(*rx));
+        rx->state = RX_IDLE;
+    }
+}
+
+/* Complete binary frame in rx->buf */
+static int rx_end_frame(uart_rx_t *rx, uart_cmd_t *out)
+{
+    int ret = rx->overflow ? -1 : uart_frame_decode(rx->buf, rx->len, out);
+
+    if (ret == -2) {
+        rx->stats.crc_errors++;
+        return 0;
+    }
+    if (ret != 0) {
+        rx->stats.bad++;
+        return 0;
+    }
+
+    if (rx->has_seq) {
+        rx->stats.seq_gaps += (uint8_t)(out->seq - rx->last_seq - 1);
+    }
+    rx->has_seq  = true;
+    rx->last_seq = out->seq;
+    rx->stats.frames++;
+    return 1;
+}
+
+/* Complete ASCII line in rx->buf */
+static int rx_end_line(uart_rx_t *rx, uart_cmd_t *out)
+{
+    char axis;
+    int  angle, duration;
+
+    rx->buf[rx->len] = '\0';
+    if (rx->overflow || parse_axis_cmd_ex((const char *)rx->buf, &axis, &angle, &duration) != 0) {
+        rx->stats.bad++;
+        return 0;
+    }
+
+    out->count              = 1;
+    out->axis[0].axis        = axis;
+    out->axis[0].angle_x10   = angle * 10;
+    out->axis[0].duration_ms = duration;
+    out->seq                = 0;
+    out->binary             = false;
+    rx->stats.lines++;
+    return 1;
+}
+
+static void rx_append(uart_rx_t *rx, uint8_t byte)
+{
+    if (rx->len < (int)sizeof(rx->buf) - 1) {
+        rx->buf[rx->len++] = byte;
+    } else {
+        rx->overflow = true;
+    }
+}
+
+static void rx_begin(uart_rx_t *rx, int state, uint8_t byte)
+{
+    rx->state    = state;
+    rx->len      = 0;
+    rx->overflow = false;
+    rx_append(rx, byte);
+}
+
+int uart_rx_feed(uart_rx_t *rx, uint8_t byte, uart_cmd_t *out)
+{
+    if (!rx || !out) return 0;
+
+    switch (rx->state) {
+    case RX_IDLE:
+        if (byte == 0x00) {
+            rx->state = RX_FRAME_START;
+        } else if (byte != '\r' && byte != '\n') {
+            rx_begin(rx, RX_ASCII, byte);
+        }
+        return 0;
+
+    case RX_FRAME_START:
+        /* After a delimiter: printable starts a line, anything else is
+         * the COBS code byte (always < 0x20 for frames this short) */
+        if (byte == 0x00) {
+            return 0;
+        }
+        rx_begin(rx, (byte >= 0x20) ? RX_ASCII : RX_BINARY, byte);
+        return 0;
+
+    case RX_ASCII:
+        if (byte == 0x00) {
+            rx->stats.bad++;                   /* cut off by a frame */
+            rx->state = RX_FRAME_START;
+            return 0;
+        }
+        if (byte == '\r' || byte == '\n') {
+            rx->state = RX_IDLE;
+            return rx_end_line(rx, out);
+        }
+        rx_append(rx, byte);
+        return 0;
+
+    case RX_BINARY:
+    default:
+        if (byte == 0x00) {
+            /* The trailing delimiter may double as the next leading one */
+            rx->state = RX_FRAME_START;
+            return rx_end_frame(rx, out);
+        }
+        rx_append(rx, byte);
+        return 0;
+    }
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <stdint.h>
+#include <stdbool.h>
 
 /**
  * Parse one UART axis command (trailing \r\n already stripped).
@@ -13,3 +15,87 @@
  * @return  0 on success, -1 on any parse or range error.
  */
 int parse_axis_cmd(const char *line, char *out_axis, int *out_angle);
+
+/**
+ * Same as parse_axis_cmd(), also accepting the S3's duration field.
+ *
+ * Expected format:  "X:90"  or  "X:90:500"
+ *
+ * @param out_duration Receives the duration in ms, 0 if absent.
+ * @return  0 on success, -1 on any parse or range error.
+ */
+int parse_axis_cmd_ex(const char *line, char *out_axis, int *out_angle,
+                      int *out_duration);
+
+/* ── binary frames ───────────────────────────────────────────────── */
+
+/*
+ * S3 → MCU binary servo frame (docs/COMMUNICATION_PROTOCOL.md §6):
+ *
+ *   0x00 | COBS( seq | type | n | n × axis entry | crc16 ) | 0x00
+ *
+ *   axis entry: axis u8 (0 = X, 1 = Y) | angle u16 (0.1°, 0-1800)
+ *               | duration u16 (ms, 0 = default speed)
+ *   crc16     : CRC-16/CCITT-FALSE over seq .. last entry
+ *
+ * Little endian. Shares the link with ASCII lines: a frame always starts
+ * after a 0x00, an ASCII line never contains one.
+ */
+#define UART_FRAME_TYPE_SERVO  0x01
+#define UART_FRAME_AXES_MAX    4
+#define UART_FRAME_RAW_MAX     (3 + 5 * UART_FRAME_AXES_MAX + 2)
+#define UART_FRAME_MAX         (UART_FRAME_RAW_MAX + 1 + 2)
+
+/** One decoded command: a binary frame or a single ASCII line. */
+typedef struct {
+    int  count;                        /* axis entries (1..AXES_MAX)   */
+    struct {
+        char axis;                     /* 'X' or 'Y'                   */
+        int  angle_x10;                /* 0.1°, 0-1800                 */
+        int  duration_ms;              /* 0 = default speed            */
+    } axis[UART_FRAME_AXES_MAX];
+    uint8_t seq;                       /* binary only                  */
+    bool    binary;
+} uart_cmd_t;
+
+/** CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF); "123456789" → 0x29B1 */
+uint16_t uart_crc16(const uint8_t *data, int len);
+
+/** COBS decode without delimiters; -1 if out is too small or the input
+ *  is not valid COBS. (The encoder lives on the S3, uart_frame.c.) */
+int cobs_decode(const uint8_t *in, int len, uint8_t *out, int size);
+
+/**
+ * Decode the COBS body of one frame (delimiters stripped).
+ * @return  0 on success, -1 on bad COBS / length / type / axis / range,
+ *          -2 on CRC mismatch.
+ */
+int uart_frame_decode(const uint8_t *body, int len, uart_cmd_t *out);
+
+/* ── receive stream ──────────────────────────────────────────────── */
+
+typedef struct {
+    uint32_t frames;       /* binary frames accepted                   */
+    uint32_t lines;        /* ASCII lines accepted                     */
+    uint32_t crc_errors;   /* binary frames with a bad CRC             */
+    uint32_t bad;          /* malformed frames or lines                */
+    uint32_t seq_gaps;     /* binary frames lost (sequence skips)      */
+} uart_rx_stats_t;
+
+typedef struct {
+    enum { RX_IDLE, RX_FRAME_START, RX_ASCII, RX_BINARY } state;
+    uint8_t  buf[64];
+    int      len;
+    bool     overflow;
+    bool     has_seq;
+    uint8_t  last_seq;
+    uart_rx_stats_t stats;
+} uart_rx_t;
+
+void uart_rx_init(uart_rx_t *rx);
+
+/**
+ * Feed one received byte (ASCII lines and binary frames may interleave).
+ * @return  1 when out holds a complete command, 0 otherwise.
+ */
+int uart_rx_feed(uart_rx_t *rx, uint8_t byte, uart_cmd_t *out);
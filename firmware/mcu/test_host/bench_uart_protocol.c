@@ -0,0 +1,89 @@
+/**
+ * Host benchmark — ASCII lines vs binary frames (uart_protocol.c)
+ *
+ * Run:
+ *   cd firmware/mcu/test_host
+ *   cmake -B build && cmake --build build
+ *   ./build/bench_uart_protocol
+ *
+ * Reports the host CPU cost of build + receive per two-axis update and
+ * the wire time of each format at 115200 8N1 (10 bits per byte).
+ */
+#include "uart_protocol.h"
+#include "uart_frame_fixture.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define ITERATIONS  200000
+#define BAUD        115200
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char *name, double ns, long bytes, long cmds)
+{
+    double per_update = (double)bytes / ITERATIONS;
+    printf("%-7s %7.1f ns/update  %5.1f B/update  %6.3f ms wire  %ld cmds\n",
+           name, ns / ITERATIONS, per_update, per_update * 10.0 * 1000.0 / BAUD, cmds);
+}
+
+/* ── ASCII: "X:<a>:<t>\r\n" + "Y:<a>:<t>\r\n" ────────────────────── */
+
+static void bench_ascii(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t cmd;
+    char       buf[48];
+    long       bytes = 0, cmds = 0;
+
+    uart_rx_init(&rx);
+    double t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        int x = i % 181, y = 90 + i % 61;
+        int n = snprintf(buf, sizeof(buf), "X:%d:%d\r\nY:%d:%d\r\n", x, 100, y, 100);
+        for (int k = 0; k < n; k++) cmds += uart_rx_feed(&rx, (uint8_t)buf[k], &cmd);
+        bytes += n;
+    }
+    report("ascii", now_ns() - t0, bytes, cmds);
+}
+
+/* ── binary: one COBS frame with both axes ───────────────────────── */
+
+static void bench_binary(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t cmd, out;
+    uint8_t    buf[UART_FRAME_MAX];
+    long       bytes = 0, cmds = 0;
+
+    memset(&cmd, 0, sizeof(cmd));
+    cmd.count = 2;
+    cmd.axis[0].axis = 'X';
+    cmd.axis[1].axis = 'Y';
+
+    uart_rx_init(&rx);
+    double t0 = now_ns();
+    for (int i = 0; i < ITERATIONS; i++) {
+        cmd.axis[0].angle_x10   = (i % 181) * 10;
+        cmd.axis[1].angle_x10   = (90 + i % 61) * 10;
+        cmd.axis[0].duration_ms = 100;
+        cmd.axis[1].duration_ms = 100;
+        int n = uart_frame_encode((uint8_t)i, &cmd, buf, sizeof(buf));
+        for (int k = 0; k < n; k++) cmds += uart_rx_feed(&rx, buf[k], &out);
+        bytes += n;
+    }
+    report("binary", now_ns() - t0, bytes, cmds);
+}
+
+int main(void)
+{
+    printf("%d two-axis updates, %d baud\n", ITERATIONS, BAUD);
+    bench_ascii();
+    bench_binary();
+    return 0;
+}
@@ -9,6 +9,33 @@
  */
 #include "unity.h"
 #include "uart_protocol.h"
+#include "uart_frame_fixture.h"
+#include <string.h>
+
+/* Same bytes as firmware/s3/test_host/test_uart_frame.c (S3 encoder) */
+static const uint8_t FRAME_X90_Y45[] = {
+    0x00, 0x04, 0x05, 0x01, 0x02, 0x0C, 0x84, 0x03, 0xF4, 0x01,
+    0x01, 0xC2, 0x01, 0x2C, 0x01, 0xD5, 0x1B, 0x00,
+};
+
+static int feed_all(uart_rx_t *rx, const uint8_t *data, int len, uart_cmd_t *out, int max)
+{
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        if (uart_rx_feed(rx, data[i], &out[n]) && n < max - 1) n++;
+    }
+    return n;
+}
+
+static uart_cmd_t two_axis_cmd(int x10, int y10, int dur)
+{
+    uart_cmd_t c;
+    memset(&c, 0, sizeof(c));
+    c.count = 2;
+    c.axis[0].axis = 'X'; c.axis[0].angle_x10 = x10; c.axis[0].duration_ms = dur;
+    c.axis[1].axis = 'Y'; c.axis[1].angle_x10 = y10; c.axis[1].duration_ms = dur;
+    return c;
+}
 
 void setUp(void)    {}
 void tearDown(void) {}
@@ -118,6 +145,201 @@ void test_null_out_angle(void)
     TEST_ASSERT_NOT_EQUAL(0, parse_axis_cmd("X:90", &axis, NULL));
 }
 
+/* ── duration field ──────────────────────────────────────────────── */
+
+void test_parse_ex_duration(void)
+{
+    char axis; int angle, dur;
+    TEST_ASSERT_EQUAL_INT(0, parse_axis_cmd_ex("X:90:500", &axis, &angle, &dur));
+    TEST_ASSERT_EQUAL_CHAR('X', axis);
+    TEST_ASSERT_EQUAL_INT(90, angle);
+    TEST_ASSERT_EQUAL_INT(500, dur);
+
+    TEST_ASSERT_EQUAL_INT(0, parse_axis_cmd_ex("Y:120", &axis, &angle, &dur));
+    TEST_ASSERT_EQUAL_INT(0, dur);
+
+    TEST_ASSERT_NOT_EQUAL(0, parse_axis_cmd_ex("X:90:-5", &axis, &angle, &dur));
+    TEST_ASSERT_NOT_EQUAL(0, parse_axis_cmd_ex("X:90:70000", &axis, &angle, &dur));
+}
+
+/* ── CRC / COBS ──────────────────────────────────────────────────── */
+
+void test_crc16_check_value(void)
+{
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, uart_crc16((const uint8_t *)"123456789", 9));
+}
+
+void test_cobs_round_trip(void)
+{
+    const uint8_t in[] = { 0x00, 0x11, 0x00, 0x00, 0x22, 0x33, 0x00 };
+    uint8_t enc[16], dec[16];
+
+    int n = cobs_encode(in, sizeof(in), enc, sizeof(enc));
+    TEST_ASSERT_EQUAL_INT(sizeof(in) + 1, n);
+    for (int i = 0; i < n; i++) TEST_ASSERT_NOT_EQUAL(0, enc[i]);
+
+    TEST_ASSERT_EQUAL_INT(sizeof(in), cobs_decode(enc, n, dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(in, dec, sizeof(in));
+}
+
+void test_cobs_decode_rejects_bad_input(void)
+{
+    const uint8_t overrun[] = { 0x05, 0x11, 0x22 };
+    const uint8_t inner0[]  = { 0x03, 0x11, 0x00 };
+    uint8_t dec[16];
+
+    TEST_ASSERT_EQUAL_INT(-1, cobs_decode(overrun, sizeof(overrun), dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_INT(-1, cobs_decode(inner0,  sizeof(inner0),  dec, sizeof(dec)));
+    TEST_ASSERT_EQUAL_INT(-1, cobs_decode(overrun, 0, dec, sizeof(dec)));
+}
+
+/* ── binary frames ───────────────────────────────────────────────── */
+
+void test_decode_s3_frame(void)
+{
+    uart_cmd_t c;
+    /* Body only: strip both delimiters */
+    TEST_ASSERT_EQUAL_INT(0, uart_frame_decode(&FRAME_X90_Y45[1], sizeof(FRAME_X90_Y45) - 2, &c));
+    TEST_ASSERT_TRUE(c.binary);
+    TEST_ASSERT_EQUAL_UINT8(5, c.seq);
+    TEST_ASSERT_EQUAL_INT(2, c.count);
+    TEST_ASSERT_EQUAL_CHAR('X', c.axis[0].axis);
+    TEST_ASSERT_EQUAL_INT(900, c.axis[0].angle_x10);
+    TEST_ASSERT_EQUAL_INT(500, c.axis[0].duration_ms);
+    TEST_ASSERT_EQUAL_CHAR('Y', c.axis[1].axis);
+    TEST_ASSERT_EQUAL_INT(450, c.axis[1].angle_x10);
+    TEST_ASSERT_EQUAL_INT(300, c.axis[1].duration_ms);
+}
+
+void test_encode_matches_s3(void)
+{
+    uart_cmd_t c = two_axis_cmd(900, 450, 0);
+    uint8_t out[UART_FRAME_MAX];
+
+    c.axis[0].duration_ms = 500;
+    c.axis[1].duration_ms = 300;
+    int n = uart_frame_encode(5, &c, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(sizeof(FRAME_X90_Y45), n);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(FRAME_X90_Y45, out, n);
+}
+
+void test_frame_round_trip_all_angles(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[2];
+    uint8_t    buf[UART_FRAME_MAX];
+
+    uart_rx_init(&rx);
+    for (int a = 0; a <= 1800; a++) {
+        uart_cmd_t c = two_axis_cmd(a, 1800 - a, a * 36);
+        int n = uart_frame_encode((uint8_t)a, &c, buf, sizeof(buf));
+        TEST_ASSERT_EQUAL_INT(1, feed_all(&rx, buf, n, got, 2));
+        TEST_ASSERT_EQUAL_INT(a, got[0].axis[0].angle_x10);
+        TEST_ASSERT_EQUAL_INT(1800 - a, got[0].axis[1].angle_x10);
+        TEST_ASSERT_EQUAL_INT(a * 36, got[0].axis[1].duration_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1801, rx.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.seq_gaps);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.crc_errors);
+}
+
+void test_corruption_is_detected_and_resyncs(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[4];
+    uint8_t    stream[2 * sizeof(FRAME_X90_Y45)];
+
+    /* Flip every bit of every body byte in turn; the next frame must survive */
+    for (int i = 1; i < (int)sizeof(FRAME_X90_Y45) - 1; i++) {
+        for (int b = 0; b < 8; b++) {
+            memcpy(stream, FRAME_X90_Y45, sizeof(FRAME_X90_Y45));
+            memcpy(stream + sizeof(FRAME_X90_Y45), FRAME_X90_Y45, sizeof(FRAME_X90_Y45));
+            stream[i] ^= (uint8_t)(1u << b);
+
+            uart_rx_init(&rx);
+            int n = feed_all(&rx, stream, sizeof(stream), got, 4);
+            TEST_ASSERT_EQUAL_INT(1, n);
+            TEST_ASSERT_EQUAL_INT(900, got[0].axis[0].angle_x10);
+            /* A flip to 0x00 splits the frame: one or two rejects */
+            TEST_ASSERT_TRUE(rx.stats.crc_errors + rx.stats.bad >= 1);
+        }
+    }
+}
+
+void test_truncated_frame_rejected(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[2];
+
+    uart_rx_init(&rx);
+    TEST_ASSERT_EQUAL_INT(0, feed_all(&rx, FRAME_X90_Y45, 9, got, 2));
+    TEST_ASSERT_EQUAL_INT(1, feed_all(&rx, FRAME_X90_Y45, sizeof(FRAME_X90_Y45), got, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.bad);
+}
+
+void test_seq_gap_counted(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[2];
+    uint8_t    buf[UART_FRAME_MAX];
+    uart_cmd_t c = two_axis_cmd(900, 1200, 0);
+
+    uart_rx_init(&rx);
+    const uint8_t seqs[] = { 254, 255, 2 };     /* wraps, loses 0 and 1 */
+    for (int i = 0; i < 3; i++) {
+        int n = uart_frame_encode(seqs[i], &c, buf, sizeof(buf));
+        feed_all(&rx, buf, n, got, 2);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, rx.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(2, rx.stats.seq_gaps);
+}
+
+/* ── ASCII compatibility on the same stream ──────────────────────── */
+
+void test_ascii_and_binary_interleaved(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[4];
+    uint8_t    stream[64];
+    int        len = 0;
+
+    memcpy(stream + len, "X:30\r\n", 6);                 len += 6;
+    memcpy(stream + len, FRAME_X90_Y45, sizeof(FRAME_X90_Y45)); len += sizeof(FRAME_X90_Y45);
+    memcpy(stream + len, "Y:120:250\r\n", 11);           len += 11;
+
+    uart_rx_init(&rx);
+    TEST_ASSERT_EQUAL_INT(3, feed_all(&rx, stream, len, got, 4));
+
+    TEST_ASSERT_FALSE(got[0].binary);
+    TEST_ASSERT_EQUAL_INT(1, got[0].count);
+    TEST_ASSERT_EQUAL_CHAR('X', got[0].axis[0].axis);
+    TEST_ASSERT_EQUAL_INT(300, got[0].axis[0].angle_x10);
+
+    TEST_ASSERT_TRUE(got[1].binary);
+    TEST_ASSERT_EQUAL_INT(2, got[1].count);
+
+    TEST_ASSERT_FALSE(got[2].binary);
+    TEST_ASSERT_EQUAL_CHAR('Y', got[2].axis[0].axis);
+    TEST_ASSERT_EQUAL_INT(1200, got[2].axis[0].angle_x10);
+    TEST_ASSERT_EQUAL_INT(250, got[2].axis[0].duration_ms);
+
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(2, rx.stats.lines);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.bad);
+}
+
+void test_ascii_bad_line_counted(void)
+{
+    uart_rx_t  rx;
+    uart_cmd_t got[2];
+    const char *s = "Z:90\r\nX:45\r\n";
+
+    uart_rx_init(&rx);
+    TEST_ASSERT_EQUAL_INT(1, feed_all(&rx, (const uint8_t *)s, strlen(s), got, 2));
+    TEST_ASSERT_EQUAL_INT(450, got[0].axis[0].angle_x10);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.bad);
+}
+
 /* ── entry point ─────────────────────────────────────────────────── */
 
 int main(void)
@@ -137,5 +359,17 @@ int main(void)
     RUN_TEST(test_null_line);
     RUN_TEST(test_null_out_axis);
     RUN_TEST(test_null_out_angle);
+    RUN_TEST(test_parse_ex_duration);
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_cobs_round_trip);
+    RUN_TEST(test_cobs_decode_rejects_bad_input);
+    RUN_TEST(test_decode_s3_frame);
+    RUN_TEST(test_encode_matches_s3);
+    RUN_TEST(test_frame_round_trip_all_angles);
+    RUN_TEST(test_corruption_is_detected_and_resyncs);
+    RUN_TEST(test_truncated_frame_rejected);
+    RUN_TEST(test_seq_gap_counted);
+    RUN_TEST(test_ascii_and_binary_interleaved);
+    RUN_TEST(test_ascii_bad_line_counted);
     return UNITY_END();
 }
@@ -0,0 +1,21 @@
+#include "uart_frame_fixture.h"
+#include "uart_frame.h"
+
+int uart_frame_encode(uint8_t seq, const uart_cmd_t *cmd, uint8_t *out, int size)
+{
+    uart_frame_axis_t axes[UART_FRAME_AXES_MAX];
+
+    if (!cmd || cmd->count < 1 || cmd->count > UART_FRAME_AXES_MAX) return -1;
+
+    for (int i = 0; i < cmd->count; i++) {
+        axes[i].axis        = (cmd->axis[i].axis == 'X') ? UART_FRAME_AXIS_X : UART_FRAME_AXIS_Y;
+        axes[i].angle_x10   = (uint16_t)cmd->axis[i].angle_x10;
+        axes[i].duration_ms = (uint16_t)cmd->axis[i].duration_ms;
+    }
+    return uart_frame_encode_servo(seq, axes, cmd->count, out, size);
+}
+
+int cobs_encode(const uint8_t *in, int len, uint8_t *out, int size)
+{
+    return uart_frame_cobs_encode(in, len, out, size);
+}
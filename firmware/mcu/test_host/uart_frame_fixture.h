@@ -0,0 +1,18 @@
+/**
+ * Test fixture — S3 → MCU frame encoder
+ *
+ * The MCU only decodes; its tests and bench build frames with the encoder
+ * the S3 actually runs (firmware/s3/main/uart_frame.c), adapted to
+ * uart_cmd_t.
+ */
+#pragma once
+#include "uart_protocol.h"
+
+/**
+ * Build one delimited servo frame from a decoded command.
+ * @return  Frame length including both 0x00 delimiters, -1 on bad args.
+ */
+int uart_frame_encode(uint8_t seq, const uart_cmd_t *cmd, uint8_t *out, int size);
+
+/** COBS encode without delimiters; -1 if out is too small. */
+int cobs_encode(const uint8_t *in, int len, uint8_t *out, int size);
@@ -340,6 +340,9 @@ esp_codec_dev_handle_t bsp_audio_codec_speaker_init(void);
 esp_codec_dev_handle_t bsp_audio_codec_microphone_init(void);
 esp_err_t bsp_i2s_read(void *audio_buffer, size_t len, size_t *bytes_read, uint32_t timeout_ms);
 esp_err_t bsp_i2s_write(void *audio_buffer, size_t len, size_t *bytes_written, uint32_t timeout_ms);
+/* Called from the I2S ISR each time a TX DMA buffer of `bytes` has been sent (keep it short, IRAM) */
+typedef void (*bsp_i2s_tx_sent_cb_t)(size_t bytes, void *user_ctx);
+esp_err_t bsp_i2s_set_tx_sent_callback(bsp_i2s_tx_sent_cb_t cb, void *user_ctx);
 esp_err_t bsp_codec_set_fs(uint32_t rate, uint32_t bits_cfg, i2s_slot_mode_t ch);
 esp_err_t bsp_codec_volume_set(int volume, int *volume_set);
 esp_err_t bsp_codec_mute_set(bool enable);
@@ -32,6 +32,8 @@ static  SemaphoreHandle_t codec_mutex = NULL;
 static i2s_chan_handle_t i2s_tx_chan = NULL;
 static i2s_chan_handle_t i2s_rx_chan = NULL;
 static const audio_codec_data_if_t *i2s_data_if = NULL;
+static bsp_i2s_tx_sent_cb_t i2s_tx_sent_cb = NULL;
+static void *i2s_tx_sent_ctx = NULL;
 
 void bsp_lvgl_rounder_cb(struct _lv_disp_drv_t *disp_drv, lv_area_t *area)
 {
@@ -944,6 +946,28 @@ esp_err_t bsp_spiffs_init_default(void)
     return bsp_spiffs_init(DRV_BASE_PATH_FLASH, DRV_FS_MAX_FILES);
 }
 
+static bool IRAM_ATTR bsp_i2s_on_sent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    bsp_i2s_tx_sent_cb_t cb = i2s_tx_sent_cb;
+    if (cb)
+    {
+        cb(event->size, i2s_tx_sent_ctx);
+    }
+    return false;
+}
+
+esp_err_t bsp_i2s_set_tx_sent_callback(bsp_i2s_tx_sent_cb_t cb, void *user_ctx)
+{
+    if (!i2s_tx_chan)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    i2s_tx_sent_cb = NULL;
+    i2s_tx_sent_ctx = user_ctx;
+    i2s_tx_sent_cb = cb;
+    return ESP_OK;
+}
+
 esp_err_t bsp_audio_init(const i2s_std_config_t *i2s_config)
 {
     esp_err_t ret = ESP_FAIL;
@@ -975,7 +999,13 @@ esp_err_t bsp_audio_init(const i2s_std_config_t *i2s_config)
 
     if (i2s_tx_chan != NULL)
     {
+        /* Sent events can only be registered before the channel is enabled;
+         * the forwarder stays idle until bsp_i2s_set_tx_sent_callback() */
+        i2s_event_callbacks_t tx_cbs = {
+            .on_sent = bsp_i2s_on_sent,
+        };
         ESP_GOTO_ON_ERROR(i2s_channel_init_std_mode(i2s_tx_chan, p_i2s_cfg), err, TAG, "I2S channel initialization failed");
+        ESP_GOTO_ON_ERROR(i2s_channel_register_event_callback(i2s_tx_chan, &tx_cbs, NULL), err, TAG, "I2S callback registration failed");
         ESP_GOTO_ON_ERROR(i2s_channel_enable(i2s_tx_chan), err, TAG, "I2S enabling failed");
     }
     if (i2s_rx_chan != NULL)
@@ -16,8 +16,12 @@
 #include "hal_audio.h"
 #include "hal_display.h"
 #include "boot_animation.h"
+#include "boot_graph.h"
+#include "json_arena.h"
 #include "emoji_png.h"
 #include "sensecap-watcher.h"
+#include <stdlib.h>
+#include <string.h>
 
 #define TAG "MAIN"
 
@@ -57,15 +61,6 @@ static void on_button_multi_click_restart(void)
 /* Hardware Self-Test                                                 */
 /* ------------------------------------------------------------------ */
 
-/* Emoji loading progress callback (called from app_main context) */
-static void on_emoji_type_loaded(emoji_anim_type_t type, int types_done, int types_total)
-{
-    /* Map emoji loading to 45% - 90% range */
-    int progress = 45 + (types_done * 45) / types_total;
-    boot_anim_set_progress(progress);
-    boot_anim_set_text(emoji_type_name(type));
-}
-
 #if ENABLE_HW_SELFTEST
 
 /* Note: Display test is done by hal_display_ui_init() which calls hal_display_minimal_init() */
@@ -134,9 +129,8 @@ static void run_hw_selftest(void)
              pass_count, fail_count);
     ESP_LOGI(TAG, "=====================================");
 
-    /* Display result on screen (do NOT jump to 100% - boot continues) */
+    /* Display result on screen (the boot graph owns the progress arc) */
     if (fail_count == 0) {
-        boot_anim_set_progress(15);
         boot_anim_set_text("HW OK");
     } else {
         char msg[32];
@@ -148,104 +142,229 @@ static void run_hw_selftest(void)
 #endif /* ENABLE_HW_SELFTEST */
 
 /* ------------------------------------------------------------------ */
-/* Main Application                                                   */
+/* Boot Stages                                                        */
 /* ------------------------------------------------------------------ */
 
-void app_main(void)
+/*
+ * Three independent chains run in parallel; the network is up within a few
+ * seconds instead of after the ~36s emoji load:
+ *
+ *   uart -> selftest -> voice_init --+
+ *                                    +--> voice_start
+ *   emoji ---------------------------+
+ *
+ *   wifi -> discovery -> ws -> online
+ *
+ * With a cached server, discovery returns at once and keeps verifying in
+ * the background while ws connects.
+ */
+enum {
+    BOOT_UART = 0,
+    BOOT_SELFTEST,
+    BOOT_VOICE_INIT,
+    BOOT_WIFI,
+    BOOT_DISCOVERY,
+    BOOT_WS,
+    BOOT_ONLINE,
+    BOOT_EMOJI,
+    BOOT_VOICE_START,
+    BOOT_STAGE_COUNT
+};
+
+static int stage_uart(void)
 {
-    ESP_LOGI(TAG, "MVP-W S3 v1.0 starting");
-
-    /* 1. Minimal display init for boot animation */
-    if (hal_display_minimal_init() != 0) {
-        ESP_LOGE(TAG, "Failed to initialize display");
-        return;
-    }
-
-    /* 2. Show boot animation */
-    boot_anim_init();
-    boot_anim_set_text("Initializing...");
-
-    /* 3. UART bridge to MCU */
-    boot_anim_set_progress(10);
-    boot_anim_set_text("UART...");
     uart_bridge_init();
+    return 0;
+}
 
+static int stage_selftest(void)
+{
 #if ENABLE_HW_SELFTEST
     run_hw_selftest();
     /* Continue regardless of result (non-fatal) */
 #endif
+    return 0;
+}
 
-    /* 4. Voice recorder: init only (do NOT start yet - wait until after emoji load) */
-    boot_anim_set_progress(20);
-    boot_anim_set_text("Voice...");
+/* After the self-test: test_audio() brings the I2S path up and down */
+static int stage_voice_init(void)
+{
+    /* Init only: the recorder starts once emoji loading is done */
     voice_recorder_init();
 
-    /* 5. Register button callbacks */
     bsp_set_btn_long_press_cb(on_button_long_press);
     bsp_set_btn_long_release_cb(on_button_long_release);
     bsp_set_btn_multi_click_cb(RESTART_CLICK_COUNT, on_button_multi_click_restart);
     ESP_LOGI(TAG, "Button callbacks registered via SDK");
+    return 0;
+}
 
-    /* 6. Initialize and connect to WiFi */
-    boot_anim_set_progress(25);
-    boot_anim_set_text("WiFi...");
+static int stage_wifi(void)
+{
     wifi_init();
     if (wifi_connect() != 0) {
-        boot_anim_show_error("WiFi Error");
-        return;
+        return -1;
     }
     ESP_LOGI(TAG, "WiFi connected");
-    boot_anim_set_progress(35);
+    return 0;
+}
+
+static void use_server(const server_info_t *info)
+{
+    char *ws_url = discovery_get_ws_url(info);
+    if (ws_url) {
+        ws_client_switch_server(ws_url);
+        free(ws_url);
+    }
+}
+
+static bool ws_connected(void)
+{
+    return ws_client_is_connected();
+}
 
-    /* 7. Service discovery */
-    boot_anim_set_text("Discovering...");
+/* Background discovery answered (the cached server has not connected yet) */
+static void on_server_discovered(const server_info_t *info)
+{
+    if (!info) {
+        ESP_LOGW(TAG, "Discovery found nothing, keeping cached server");
+        return;
+    }
+    discovery_save_cached(info);
+
+    char *ws_url = discovery_get_ws_url(info);
+    if (ws_url && !ws_client_is_connected() &&
+        strcmp(ws_url, ws_client_get_server_url()) != 0) {
+        ESP_LOGI(TAG, "Cached server stale, switching to %s", ws_url);
+        ws_client_switch_server(ws_url);
+    }
+    free(ws_url);
+}
+
+/*
+ * Cached server: return at once so the WS stage connects to it while the
+ * broadcast runs in the background; whichever succeeds first wins.
+ * No cache: discover (broadcast, then mDNS) before connecting.
+ */
+static int stage_discovery(void)
+{
     discovery_init();
     server_info_t server_info = {0};
+
+    if (discovery_load_cached(&server_info) == 0) {
+        use_server(&server_info);
+        discovery_start_async(on_server_discovered, ws_connected);
+        return 0;
+    }
+
     if (discovery_start(&server_info) != 0) {
-        boot_anim_show_error("Server Not Found");
-        return;
+        return -1;
     }
     ESP_LOGI(TAG, "Server discovered: %s:%u", server_info.ip, server_info.port);
-    boot_anim_set_progress(40);
+    discovery_save_cached(&server_info);
+    use_server(&server_info);
+    return 0;
+}
 
-    /* Set WebSocket URL */
-    char *ws_url = discovery_get_ws_url(&server_info);
-    if (ws_url) {
-        ws_client_set_server_url(ws_url);
-        free(ws_url);
+/* Messages that arrive before the main UI is up only miss their display
+ * update (display_update() is a no-op until hal_display_ui_init()) */
+static int stage_ws(void)
+{
+    if (ws_client_init() != 0) {
+        return -1;
     }
+    ws_handlers_dispatch_start();   /* Non-fatal: handlers run inline */
+    ws_router_t router = ws_handlers_get_router();
+    ws_router_init(&router);
+    ESP_LOGI(TAG, "WS router handlers registered");
+    return ws_client_start();
+}
 
-    /* 8. SPIFFS init + emoji loading (45% → 90%, the longest stage ~36s)
-     * Voice recorder NOT started yet - prevents AFE ring buffer overflow during load */
-    boot_anim_set_progress(45);
-    boot_anim_set_text("Loading...");
+/* Time-to-connected for the timeline; boot only waits here if every
+ * other stage is already done. Non-fatal: the client keeps retrying. */
+static int stage_online(void)
+{
+    if (ws_client_wait_connected(CONFIG_DISCOVERY_CONNECT_WAIT_MS) != 0) {
+        ESP_LOGW(TAG, "Not connected after %d ms (still retrying)", CONFIG_DISCOVERY_CONNECT_WAIT_MS);
+        return -1;
+    }
+    ESP_LOGI(TAG, "Connected to %s", ws_client_get_server_url());
+    return 0;
+}
+
+/* Emoji loading progress callback (called from the emoji stage task) */
+static void on_emoji_type_loaded(emoji_anim_type_t type, int types_done, int types_total)
+{
+    boot_graph_stage_progress(BOOT_EMOJI, types_done, types_total);
+    boot_anim_set_text(emoji_type_name(type));
+}
+
+/* SPIFFS init + emoji loading, the longest stage (~36s) */
+static int stage_emoji(void)
+{
     if (emoji_spiffs_init() == 0) {
         emoji_load_all_images_with_cb(on_emoji_type_loaded);
     } else {
         ESP_LOGW(TAG, "SPIFFS init failed (emoji disabled)");
-        boot_anim_set_progress(90);
     }
+    return 0;
+}
 
-    /* 9. Start voice recorder now (AFE ring buffer empty, no overflow risk) */
+/* Not before emoji loading is done: prevents AFE ring buffer overflow */
+static int stage_voice_start(void)
+{
     if (voice_recorder_start() != 0) {
         ESP_LOGE(TAG, "Failed to start voice recorder (non-fatal)");
     }
+    return 0;
+}
 
-    /* 10. Initialize WebSocket client */
-    boot_anim_set_progress(92);
-    boot_anim_set_text("Connecting...");
-    ws_client_init();
-    ws_router_t router = ws_handlers_get_router();
-    ws_router_init(&router);
-    ESP_LOGI(TAG, "WS router handlers registered");
-    ws_client_start();
+static const boot_stage_t boot_stages[BOOT_STAGE_COUNT] = {
+    [BOOT_UART]        = { "UART",      stage_uart,        0,                         5,  4096,  NULL },
+    [BOOT_SELFTEST]    = { "Self-test", stage_selftest,    BOOT_DEP(BOOT_UART),       5,  4096,  NULL },
+    [BOOT_VOICE_INIT]  = { "Voice",     stage_voice_init,  BOOT_DEP(BOOT_SELFTEST),   5,  12288, NULL },
+    [BOOT_WIFI]        = { "WiFi",      stage_wifi,        0,                         10, 4096,  "WiFi Error" },
+    [BOOT_DISCOVERY]   = { "Discovery", stage_discovery,   BOOT_DEP(BOOT_WIFI),       5,  6144,  "Server Not Found" },
+    [BOOT_WS]          = { "Connect",   stage_ws,          BOOT_DEP(BOOT_DISCOVERY),  5,  6144,  NULL },
+    [BOOT_ONLINE]      = { "Online",    stage_online,      BOOT_DEP(BOOT_WS),         5,  3072,  NULL },
+    [BOOT_EMOJI]       = { "Loading",   stage_emoji,       0,                         60, 16384, NULL },
+    [BOOT_VOICE_START] = { "Listen",    stage_voice_start, BOOT_DEP(BOOT_EMOJI) | BOOT_DEP(BOOT_VOICE_INIT),
+                                                                                      5,  4096,  NULL },
+};
+
+/* ------------------------------------------------------------------ */
+/* Main Application                                                   */
+/* ------------------------------------------------------------------ */
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "MVP-W S3 v1.0 starting");
+
+    /* cJSON allocations: heap unless a call site opens an arena */
+    json_arena_install();
+
+    /* 1. Minimal display init for boot animation */
+    if (hal_display_minimal_init() != 0) {
+        ESP_LOGE(TAG, "Failed to initialize display");
+        return;
+    }
+
+    /* 2. Show boot animation */
+    boot_anim_init();
+    boot_anim_set_text("Initializing...");
+
+    /* 3. Everything else: dependency graph (10% -> 95%), timeline logged.
+     * A fatal stage failure leaves the error screen up (reboot countdown). */
+    if (boot_graph_run(boot_stages, BOOT_STAGE_COUNT, 10, 95) != 0) {
+        return;
+    }
 
-    /* 10. Ready! */
+    /* 4. Ready! */
     boot_anim_set_progress(100);
     boot_anim_set_text("Ready!");
     vTaskDelay(pdMS_TO_TICKS(500));
 
-    /* 11. Finish boot animation, switch to main UI */
+    /* 5. Finish boot animation, switch to main UI */
     boot_anim_finish();
     hal_display_ui_init();
     display_update("Ready", "happy", 0, NULL);
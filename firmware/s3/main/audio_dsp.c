@@ -0,0 +1,243 @@
+/**
+ * @file audio_dsp.c
+ * @brief Integer audio frame statistics implementation
+ *
+ * Inner loop notes (Xtensa LX7, no 64-bit ALU, no double FPU):
+ * - Squares of two samples are summed in 32 bits (2 * 2^30 fits) before
+ *   one 64-bit add, halving the carry-propagating adds.
+ * - Peak tracks raw min/max (no per-sample abs or branch).
+ * - Zero count and zero crossings are branchless compare-and-adds
+ *   (a crossing is a sign-bit change, 0 counts as positive).
+ *
+ * audio_dsp_stats() runs this single-pass C kernel. With CONFIG_AUDIO_DSP_PIE
+ * (ESP32-S3, experimental) it runs the sum of squares and min/max on the
+ * PIE vector unit instead (audio_dsp_aes3.S): 8 lanes per EE.VMULAS.S16.ACCX
+ * into the 40-bit ACCX register, zeros and crossings in a second scalar
+ * pass. esp-dsp's dsps_dotprod_s16 is not used since it saturates its
+ * result to int16. Host builds define AUDIO_DSP_PIE_MODEL to run the same
+ * wrapper over a C model of the assembly chunk.
+ */
+
+#include "audio_dsp.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if CONFIG_AUDIO_DSP_PIE || defined(AUDIO_DSP_PIE_MODEL)
+#define AUDIO_DSP_PIE 1
+#endif
+
+/* ------------------------------------------------------------------ */
+/* Private: Helpers                                                   */
+/* ------------------------------------------------------------------ */
+
+static void finish_stats(audio_stats_t *out, int n, uint64_t sum_sq, int32_t min, int32_t max,
+                         int zeros, int crossings)
+{
+    out->sum_sq = sum_sq;
+    out->peak = (-min > max) ? -min : max;
+    out->zero_count = zeros;
+    out->zero_crossings = crossings;
+
+    /* Mean square <= 2^30, fits 32 bits */
+    out->rms = (n > 0) ? (int)audio_dsp_isqrt((uint32_t)(sum_sq / (uint32_t)n)) : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Frame statistics                                           */
+/* ------------------------------------------------------------------ */
+
+void audio_dsp_stats_c(const int16_t *samples, int n, audio_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    uint64_t sum_sq = 0;
+    int32_t max = 0;
+    int32_t min = 0;
+    int zeros = 0;
+    int crossings = 0;
+    int i = 0;
+
+    if (samples && n > 0) {
+        int32_t prev = samples[0];
+
+        /* 4 samples per iteration, two 32-bit pair sums */
+        for (; i + 4 <= n; i += 4) {
+            int32_t a = samples[i];
+            int32_t b = samples[i + 1];
+            int32_t c = samples[i + 2];
+            int32_t d = samples[i + 3];
+
+            uint32_t p0 = (uint32_t)(a * a) + (uint32_t)(b * b);
+            uint32_t p1 = (uint32_t)(c * c) + (uint32_t)(d * d);
+            sum_sq += (uint64_t)p0 + p1;
+
+            int32_t hi0 = a > b ? a : b;
+            int32_t hi1 = c > d ? c : d;
+            int32_t lo0 = a < b ? a : b;
+            int32_t lo1 = c < d ? c : d;
+            int32_t hi = hi0 > hi1 ? hi0 : hi1;
+            int32_t lo = lo0 < lo1 ? lo0 : lo1;
+            if (hi > max) max = hi;
+            if (lo < min) min = lo;
+
+            zeros += (a == 0) + (b == 0) + (c == 0) + (d == 0);
+            crossings += ((prev ^ a) < 0) + ((a ^ b) < 0) + ((b ^ c) < 0) + ((c ^ d) < 0);
+            prev = d;
+        }
+
+        /* Tail */
+        for (; i < n; i++) {
+            int32_t x = samples[i];
+            sum_sq += (uint32_t)(x * x);
+            if (x > max) max = x;
+            if (x < min) min = x;
+            zeros += (x == 0);
+            crossings += ((prev ^ x) < 0);
+            prev = x;
+        }
+    }
+
+    finish_stats(out, n, sum_sq, min, max, zeros, crossings);
+}
+
+#if AUDIO_DSP_PIE
+
+/* ------------------------------------------------------------------ */
+/* Private: PIE path                                                  */
+/* ------------------------------------------------------------------ */
+
+/* Per-lane state shared with audio_dsp_aes3.S (offsets fixed there) */
+typedef struct {
+    int16_t max[8];         /* 0:  lane max */
+    int16_t min[8];         /* 16: lane min */
+    uint32_t sum_lo;        /* 32: ACCX bits 0-31 */
+    uint32_t sum_hi;        /* 36: ACCX bits 32-39 */
+} __attribute__((aligned(16))) audio_dsp_lanes_t;
+
+/* At most 256 samples per chunk: 256 * 2^30 = 2^38 stays below the
+ * signed 40-bit ACCX */
+#define PIE_CHUNK   256
+
+#ifdef AUDIO_DSP_PIE_MODEL
+/* C model of audio_dsp_chunk_aes3: x 16-byte aligned, n % 8 == 0 */
+static void audio_dsp_chunk_aes3(const int16_t *x, int n, audio_dsp_lanes_t *lanes)
+{
+    int64_t accx = 0;
+
+    for (int i = 0; i < n; i++) {
+        int lane = i & 7;
+        accx += (int32_t)x[i] * x[i];
+        if (x[i] > lanes->max[lane]) lanes->max[lane] = x[i];
+        if (x[i] < lanes->min[lane]) lanes->min[lane] = x[i];
+    }
+    lanes->sum_lo = (uint32_t)accx;
+    lanes->sum_hi = (uint32_t)(accx >> 32) & 0xFF;
+}
+#else
+void audio_dsp_chunk_aes3(const int16_t *x, int n, audio_dsp_lanes_t *lanes);
+#endif
+
+static void stats_pie(const int16_t *samples, int n, audio_stats_t *out)
+{
+    audio_dsp_lanes_t lanes;
+    uint64_t sum_sq = 0;
+    int32_t max = 0;
+    int32_t min = 0;
+    int zeros = 0;
+    int crossings = 0;
+    int i = 0;
+
+    if (!samples || n <= 0) {
+        finish_stats(out, 0, 0, 0, 0, 0, 0);
+        return;
+    }
+
+    /* Scalar head up to the 16-byte boundary EE.VLD.128 needs */
+    for (; i < n && ((uintptr_t)&samples[i] & 15); i++) {
+        int32_t x = samples[i];
+        sum_sq += (uint32_t)(x * x);
+        if (x > max) max = x;
+        if (x < min) min = x;
+    }
+
+    /* Vector body: 8 lanes, ACCX read back once per chunk */
+    memset(&lanes, 0, sizeof(lanes));
+    while (n - i >= 8) {
+        int len = (n - i) & ~7;
+        if (len > PIE_CHUNK) {
+            len = PIE_CHUNK;
+        }
+        audio_dsp_chunk_aes3(&samples[i], len, &lanes);
+        sum_sq += ((uint64_t)(lanes.sum_hi & 0xFF) << 32) | lanes.sum_lo;
+        i += len;
+    }
+    for (int k = 0; k < 8; k++) {
+        if (lanes.max[k] > max) max = lanes.max[k];
+        if (lanes.min[k] < min) min = lanes.min[k];
+    }
+
+    /* Tail */
+    for (; i < n; i++) {
+        int32_t x = samples[i];
+        sum_sq += (uint32_t)(x * x);
+        if (x > max) max = x;
+        if (x < min) min = x;
+    }
+
+    /* Zeros and crossings compare neighbouring lanes: one scalar pass */
+    int32_t prev = samples[0];
+    for (i = 0; i < n; i++) {
+        int32_t x = samples[i];
+        zeros += (x == 0);
+        crossings += ((prev ^ x) < 0);
+        prev = x;
+    }
+
+    finish_stats(out, n, sum_sq, min, max, zeros, crossings);
+}
+
+#endif /* AUDIO_DSP_PIE */
+
+void audio_dsp_stats(const int16_t *samples, int n, audio_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+#if AUDIO_DSP_PIE
+    stats_pie(samples, n, out);
+#else
+    audio_dsp_stats_c(samples, n, out);
+#endif
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Integer square root                                        */
+/* ------------------------------------------------------------------ */
+
+uint32_t audio_dsp_isqrt(uint32_t v)
+{
+    /* Bit-by-bit method: 16 iterations, shifts and adds only */
+    uint32_t res = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return res;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file audio_dsp.h
+ * @brief Integer audio frame statistics (platform independent)
+ *
+ * Single pass over a PCM16 frame: sum of squares, peak, zero count and
+ * zero crossings, plus an integer square root for RMS. No floating point, so it stays
+ * cheap on cores shared with the AFE.
+ */
+
+#ifndef AUDIO_DSP_H
+#define AUDIO_DSP_H
+
+#include <stdint.h>
+
+/* Frame statistics */
+typedef struct {
+    uint64_t sum_sq;        /* Sum of x^2 */
+    int peak;               /* max |x| (0-32768) */
+    int zero_count;         /* Samples equal to 0 */
+    int zero_crossings;     /* Sign changes between adjacent samples */
+    int rms;                /* sqrt(sum_sq / n) */
+} audio_stats_t;
+
+/**
+ * Compute frame statistics in one pass
+ * @param samples PCM16 samples
+ * @param n Number of samples (n <= 0 gives all-zero stats)
+ * @param out Output statistics
+ */
+void audio_dsp_stats(const int16_t *samples, int n, audio_stats_t *out);
+
+/**
+ * Portable C kernel, same results as audio_dsp_stats()
+ *
+ * audio_dsp_stats() uses this kernel unless CONFIG_AUDIO_DSP_PIE selects
+ * the ESP32-S3 vector path; exposed so the two can be checked against
+ * each other.
+ */
+void audio_dsp_stats_c(const int16_t *samples, int n, audio_stats_t *out);
+
+/**
+ * Integer square root
+ * @return floor(sqrt(v))
+ */
+uint32_t audio_dsp_isqrt(uint32_t v);
+
+#endif /* AUDIO_DSP_H */
@@ -0,0 +1,257 @@
+/**
+ * @file audio_resampler.c
+ * @brief Streaming rational polyphase resampler implementation
+ *
+ * The prototype low-pass runs at L * in_rate and has L * TAPS taps; branch p
+ * holds taps p, p + L, p + 2L, ... so each output costs TAPS multiply-adds no
+ * matter the ratio. Branches are normalized to unity DC gain after
+ * quantization, so a constant input never picks up a phase-dependent ripple.
+ *
+ * Inner loop notes (Xtensa LX7):
+ * - Q15 x Q15 products accumulate in 32 bits. Interpolating branches are
+ *   near-ideal fractional delays whose sum of |coeff| can exceed 2.0, so init
+ *   drops to Q14 (or lower) when a worst-case input could overflow.
+ * - The delay line is stored twice so the FIR window is one contiguous run,
+ *   no modulo in the loop.
+ *
+ * esp-dsp's dsps_fird_s16 only decimates (no interpolating branches), so
+ * this stays portable C; the 4-way unrolled MAC maps onto the LX7 MULA path.
+ */
+
+#include "audio_resampler.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Transition band edges as a fraction of min(in, out) */
+#define PASS_EDGE       0.425f
+#define STOP_EDGE       0.575f
+
+/* ------------------------------------------------------------------ */
+/* Private: Filter design                                             */
+/* ------------------------------------------------------------------ */
+
+static uint32_t gcd_u32(uint32_t a, uint32_t b)
+{
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Zeroth-order modified Bessel function (series, converges fast for beta < 10) */
+static float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    float q = x * x / 4.0f;
+
+    for (int k = 1; k < 32; k++) {
+        term *= q / (float)(k * k);
+        sum += term;
+        if (term < sum * 1e-7f) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/* Kaiser beta for the attenuation the tap count can reach over this transition */
+static float kaiser_beta(int n_taps, float transition)
+{
+    float atten = 8.0f + 2.285f * 2.0f * (float)M_PI * transition * (float)(n_taps - 1);
+
+    if (atten > 50.0f) {
+        return 0.1102f * (atten - 8.7f);
+    }
+    if (atten > 21.0f) {
+        return 0.5842f * powf(atten - 21.0f, 0.4f) + 0.07886f * (atten - 21.0f);
+    }
+    return 0.0f;
+}
+
+static int design_filter(audio_resampler_t *rs)
+{
+    const int n_taps = rs->up * AUDIO_RESAMPLER_TAPS;
+    const float center = (float)(n_taps - 1) / 2.0f;
+    const float fs_up = (float)rs->in_rate * (float)rs->up;
+    const float f_min = (float)(rs->in_rate < rs->out_rate ? rs->in_rate : rs->out_rate);
+    /* Cycles per sample at the upsampled rate */
+    const float cutoff = 0.5f * (PASS_EDGE + STOP_EDGE) * f_min / fs_up;
+    const float beta = kaiser_beta(n_taps, (STOP_EDGE - PASS_EDGE) * f_min / fs_up);
+    const float i0_beta = bessel_i0(beta);
+    float proto[AUDIO_RESAMPLER_MAX_PHASES * AUDIO_RESAMPLER_TAPS];
+
+    for (int n = 0; n < n_taps; n++) {
+        float t = (float)n - center;
+        float x = 2.0f * cutoff * t;
+        float sinc = (t == 0.0f) ? 1.0f : sinf((float)M_PI * x) / ((float)M_PI * x);
+        float r = t / center;
+        float w = bessel_i0(beta * sqrtf(fmaxf(0.0f, 1.0f - r * r))) / i0_beta;
+        proto[n] = 2.0f * cutoff * sinc * w;
+    }
+
+    for (int p = 0; p < rs->up; p++) {
+        float sum = 0.0f;
+
+        for (int j = 0; j < AUDIO_RESAMPLER_TAPS; j++) {
+            sum += proto[p + j * rs->up];
+        }
+        if (sum <= 0.0f) {
+            return -1;
+        }
+        for (int j = 0; j < AUDIO_RESAMPLER_TAPS; j++) {
+            proto[p + j * rs->up] /= sum;
+        }
+    }
+
+    /* Widest Q format whose worst-case sum (32768 * sum|coeff|) fits int32 */
+    for (int shift = 15; shift >= 12; shift--) {
+        int32_t worst = 0;
+
+        for (int p = 0; p < rs->up; p++) {
+            int32_t abs_sum = 0;
+            for (int j = 0; j < AUDIO_RESAMPLER_TAPS; j++) {
+                int32_t q = (int32_t)lrintf(proto[p + j * rs->up] * (float)(1 << shift));
+                if (q > INT16_MAX) q = INT16_MAX;
+                if (q < INT16_MIN) q = INT16_MIN;
+                rs->coeffs[p][j] = (int16_t)q;
+                abs_sum += q < 0 ? -q : q;
+            }
+            if (abs_sum > worst) {
+                worst = abs_sum;
+            }
+        }
+        if (worst <= 65535) {
+            rs->shift = shift;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Kernel                                                    */
+/* ------------------------------------------------------------------ */
+
+/* window[j] = x[n - j] */
+static inline int16_t fir_q(const int16_t *coeffs, const int16_t *window, int shift)
+{
+    int32_t acc = 1 << (shift - 1);     /* Round to nearest */
+
+    for (int j = 0; j < AUDIO_RESAMPLER_TAPS; j += 4) {
+        acc += (int32_t)coeffs[j] * window[j];
+        acc += (int32_t)coeffs[j + 1] * window[j + 1];
+        acc += (int32_t)coeffs[j + 2] * window[j + 2];
+        acc += (int32_t)coeffs[j + 3] * window[j + 3];
+    }
+    acc >>= shift;
+    if (acc > INT16_MAX) acc = INT16_MAX;
+    if (acc < INT16_MIN) acc = INT16_MIN;
+    return (int16_t)acc;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Resampler                                                  */
+/* ------------------------------------------------------------------ */
+
+int audio_resampler_init(audio_resampler_t *rs, uint32_t in_rate, uint32_t out_rate)
+{
+    if (!rs || in_rate == 0 || out_rate == 0) {
+        return -1;
+    }
+
+    uint32_t g = gcd_u32(in_rate, out_rate);
+    uint32_t up = out_rate / g;
+    uint32_t down = in_rate / g;
+
+    if (up > AUDIO_RESAMPLER_MAX_PHASES || down > AUDIO_RESAMPLER_MAX_PHASES) {
+        return -1;
+    }
+
+    memset(rs, 0, sizeof(*rs));
+    rs->in_rate = in_rate;
+    rs->out_rate = out_rate;
+    rs->up = (int)up;
+    rs->down = (int)down;
+
+    if (in_rate != out_rate && design_filter(rs) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+void audio_resampler_reset(audio_resampler_t *rs)
+{
+    if (!rs) {
+        return;
+    }
+    rs->phase = 0;
+    rs->pos = 0;
+    memset(rs->delay, 0, sizeof(rs->delay));
+}
+
+int audio_resampler_output_len(const audio_resampler_t *rs, int n_in)
+{
+    if (!rs || n_in <= 0) {
+        return 0;
+    }
+
+    int span = n_in * rs->up - rs->phase;
+    return span > 0 ? (span + rs->down - 1) / rs->down : 0;
+}
+
+int audio_resampler_input_len(const audio_resampler_t *rs, int n_out)
+{
+    if (!rs || n_out <= 0) {
+        return 0;
+    }
+
+    /* Input index holding the last wanted output, plus one */
+    return (rs->phase + (n_out - 1) * rs->down) / rs->up + 1;
+}
+
+int audio_resampler_process(audio_resampler_t *rs, const int16_t *in, int n_in,
+                            int16_t *out, int max_out)
+{
+    if (!rs || !in || !out || n_in < 0) {
+        return -1;
+    }
+    if (max_out < audio_resampler_output_len(rs, n_in)) {
+        return -1;
+    }
+
+    /* Same rate: plain copy (in == out allowed) */
+    if (rs->in_rate == rs->out_rate) {
+        memmove(out, in, (size_t)n_in * sizeof(int16_t));
+        return n_in;
+    }
+
+    const int up = rs->up;
+    const int down = rs->down;
+    const int shift = rs->shift;
+    int phase = rs->phase;
+    int pos = rs->pos;
+    int n_out = 0;
+
+    for (int i = 0; i < n_in; i++) {
+        pos = (pos == 0 ? AUDIO_RESAMPLER_TAPS : pos) - 1;
+        rs->delay[pos] = in[i];
+        rs->delay[pos + AUDIO_RESAMPLER_TAPS] = in[i];
+
+        while (phase < up) {
+            out[n_out++] = fir_q(rs->coeffs[phase], &rs->delay[pos], shift);
+            phase += down;
+        }
+        phase -= up;
+    }
+
+    rs->phase = phase;
+    rs->pos = pos;
+    return n_out;
+}
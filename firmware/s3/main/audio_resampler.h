@@ -0,0 +1,71 @@
+/**
+ * @file audio_resampler.h
+ * @brief Streaming rational polyphase resampler, PCM16 mono (platform independent)
+ *
+ * Converts between rates with a small L/M ratio (16k <-> 24k <-> 48k) so the
+ * codec can run at one fixed I2S rate. Coefficients are a Kaiser-windowed sinc
+ * quantized to Q15 (or Q14) at init; the per-sample path is integer only.
+ *
+ * Passband is flat to 0.425 * min(in, out), stopband starts at
+ * 0.575 * min(in, out). History is kept across calls, so a stream can be fed
+ * in chunks of any size.
+ */
+
+#ifndef AUDIO_RESAMPLER_H
+#define AUDIO_RESAMPLER_H
+
+#include <stdint.h>
+
+#define AUDIO_RESAMPLER_TAPS        48  /* Taps per polyphase branch */
+#define AUDIO_RESAMPLER_MAX_PHASES  6   /* Max L and M after reduction */
+
+typedef struct {
+    uint32_t in_rate;
+    uint32_t out_rate;
+    int up;                     /* L (1 = no interpolation) */
+    int down;                   /* M */
+    int phase;                  /* Next output time, in 1/L input samples past the next input */
+    int pos;                    /* Delay line write index */
+    int shift;                  /* Coefficient Q format (15, lower if a branch could overflow) */
+    int16_t coeffs[AUDIO_RESAMPLER_MAX_PHASES][AUDIO_RESAMPLER_TAPS];   /* Q<shift>, per branch */
+    int16_t delay[2 * AUDIO_RESAMPLER_TAPS];    /* Mirrored so a window is always contiguous */
+} audio_resampler_t;
+
+/**
+ * Initialize a resampler (designs the filter, clears history)
+ * @param in_rate Input sample rate in Hz
+ * @param out_rate Output sample rate in Hz
+ * @return 0 on success, -1 if a rate is 0 or the reduced L or M exceeds
+ *         AUDIO_RESAMPLER_MAX_PHASES
+ */
+int audio_resampler_init(audio_resampler_t *rs, uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * Clear history (start of a new stream, same rates)
+ */
+void audio_resampler_reset(audio_resampler_t *rs);
+
+/**
+ * Exact number of output samples the next n_in input samples produce
+ */
+int audio_resampler_output_len(const audio_resampler_t *rs, int n_in);
+
+/**
+ * Minimum number of input samples needed for n_out more output samples.
+ * When down >= up (decimation or bypass) feeding exactly this many yields
+ * exactly n_out; when interpolating it may yield up to L/M - 1 extra.
+ */
+int audio_resampler_input_len(const audio_resampler_t *rs, int n_out);
+
+/**
+ * Resample a chunk
+ * @param in Input samples
+ * @param n_in Number of input samples
+ * @param out Output buffer
+ * @param max_out Capacity of out, must be >= audio_resampler_output_len(rs, n_in)
+ * @return Number of output samples written, or -1 on error
+ */
+int audio_resampler_process(audio_resampler_t *rs, const int16_t *in, int n_in,
+                            int16_t *out, int max_out);
+
+#endif /* AUDIO_RESAMPLER_H */
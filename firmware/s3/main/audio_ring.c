@@ -0,0 +1,125 @@
+/**
+ * @file audio_ring.c
+ * @brief Lock-free SPSC audio frame ring implementation
+ */
+
+#include "audio_ring.h"
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Public: Storage and init                                           */
+/* ------------------------------------------------------------------ */
+
+int audio_ring_storage_size(int frame_size, int frame_count)
+{
+    if (frame_size <= 0 || frame_count <= 0) {
+        return 0;
+    }
+    /* Length table first so it stays int aligned */
+    return frame_count * (int)sizeof(int) + frame_count * frame_size;
+}
+
+int audio_ring_init(audio_ring_t *ring, void *storage, int frame_size, int frame_count)
+{
+    if (!ring || !storage || frame_size <= 0 || frame_count <= 0) {
+        return -1;
+    }
+
+    ring->lens = (int *)storage;
+    ring->frames = (uint8_t *)storage + frame_count * sizeof(int);
+    ring->frame_size = frame_size;
+    ring->frame_count = frame_count;
+    ring->high_water = 0;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Producer                                                   */
+/* ------------------------------------------------------------------ */
+
+int audio_ring_push(audio_ring_t *ring, const uint8_t *data, int len)
+{
+    if (!ring || len < 0 || len > ring->frame_size || (len > 0 && !data)) {
+        return -1;
+    }
+
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    int used = (int)(head - tail);
+    if (used >= ring->frame_count) {
+        return -1;  /* Full */
+    }
+
+    int slot = (int)(head % (unsigned)ring->frame_count);
+    if (len > 0) {
+        memcpy(&ring->frames[slot * ring->frame_size], data, len);
+    }
+    ring->lens[slot] = len;
+
+    /* Publish slot contents before the new head */
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    if (used + 1 > ring->high_water) {
+        ring->high_water = used + 1;
+    }
+    return 0;
+}
+
+int audio_ring_free(const audio_ring_t *ring)
+{
+    if (!ring) {
+        return 0;
+    }
+    return ring->frame_count - audio_ring_count(ring);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Consumer                                                   */
+/* ------------------------------------------------------------------ */
+
+const uint8_t *audio_ring_peek(audio_ring_t *ring, int *out_len)
+{
+    if (!ring) {
+        return NULL;
+    }
+
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+        return NULL;  /* Empty */
+    }
+
+    int slot = (int)(tail % (unsigned)ring->frame_count);
+    if (out_len) {
+        *out_len = ring->lens[slot];
+    }
+    return &ring->frames[slot * ring->frame_size];
+}
+
+void audio_ring_release(audio_ring_t *ring)
+{
+    if (!ring) {
+        return;
+    }
+
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+        return;
+    }
+
+    /* Slot may be reused by the producer once the new tail is visible */
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+int audio_ring_count(const audio_ring_t *ring)
+{
+    if (!ring) {
+        return 0;
+    }
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    return (int)(head - tail);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file audio_ring.h
+ * @brief Lock-free single-producer/single-consumer ring of audio frames
+ *
+ * One task pushes (capture), one task peeks/releases (sender). No locks:
+ * head is only written by the producer, tail only by the consumer, both
+ * published with acquire/release atomics. Storage is provided by the
+ * caller so it can live in PSRAM.
+ *
+ * A zero-length frame is a valid entry (used as end-of-utterance marker).
+ */
+
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+typedef struct {
+    uint8_t *frames;            /* frame_count * frame_size bytes */
+    int *lens;                  /* frame_count entries */
+    int frame_size;             /* Max bytes per frame */
+    int frame_count;            /* Number of slots */
+    atomic_uint head;           /* Total frames pushed (producer) */
+    atomic_uint tail;           /* Total frames released (consumer) */
+    int high_water;             /* Max observed fill level (producer) */
+} audio_ring_t;
+
+/**
+ * Get storage size needed for a ring
+ * @param frame_size Max bytes per frame
+ * @param frame_count Number of slots
+ * @return Bytes to allocate for audio_ring_init()
+ */
+int audio_ring_storage_size(int frame_size, int frame_count);
+
+/**
+ * Initialize ring on caller-provided storage
+ * @param ring Ring to initialize
+ * @param storage Buffer of audio_ring_storage_size() bytes (int aligned)
+ * @param frame_size Max bytes per frame
+ * @param frame_count Number of slots
+ * @return 0 on success, -1 on error
+ */
+int audio_ring_init(audio_ring_t *ring, void *storage, int frame_size, int frame_count);
+
+/* ------------------------------------------------------------------ */
+/* Producer side                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Copy one frame into the ring
+ * @param data Frame data (may be NULL when len == 0)
+ * @param len Frame length (0..frame_size)
+ * @return 0 on success, -1 if full or invalid
+ */
+int audio_ring_push(audio_ring_t *ring, const uint8_t *data, int len);
+
+/**
+ * Number of free slots (never overestimated when called by the producer)
+ */
+int audio_ring_free(const audio_ring_t *ring);
+
+/* ------------------------------------------------------------------ */
+/* Consumer side                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Get the oldest frame without removing it
+ * @param out_len Frame length
+ * @return Frame data, or NULL if empty
+ */
+const uint8_t *audio_ring_peek(audio_ring_t *ring, int *out_len);
+
+/**
+ * Remove the frame returned by audio_ring_peek()
+ */
+void audio_ring_release(audio_ring_t *ring);
+
+/**
+ * Number of queued frames (never overestimated when called by the consumer)
+ */
+int audio_ring_count(const audio_ring_t *ring);
+
+#endif /* AUDIO_RING_H */
@@ -139,14 +139,19 @@ void boot_anim_set_text(const char *text)
 
 void boot_anim_show_error(const char *error_msg)
 {
-    if (in_error_mode) return;
+    /* Called from boot stage tasks: the flag and widgets need the lock */
+    lvgl_port_lock(0);
+    if (in_error_mode) {
+        lvgl_port_unlock();
+        return;
+    }
     in_error_mode = true;
 
     ESP_LOGE(TAG, "Boot error: %s", error_msg);
 
     /* Hide progress elements */
-    lv_obj_add_flag(progress_arc, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(percent_label, LV_OBJ_FLAG_HIDDEN);
+    if (progress_arc) lv_obj_add_flag(progress_arc, LV_OBJ_FLAG_HIDDEN);
+    if (percent_label) lv_obj_add_flag(percent_label, LV_OBJ_FLAG_HIDDEN);
 
     /* Show error message in red */
     if (status_label && error_msg) {
@@ -168,6 +173,7 @@ void boot_anim_show_error(const char *error_msg)
         lv_label_set_text(countdown_label, "Reboot in 10s");
         lv_obj_clear_flag(countdown_label, LV_OBJ_FLAG_HIDDEN);
     }
+    lvgl_port_unlock();
 
     /* Start countdown task */
     countdown_seconds = 10;
@@ -193,7 +199,9 @@ static void boot_anim_countdown_task(void *param)
             } else {
                 snprintf(buf, sizeof(buf), "Rebooting...");
             }
+            lvgl_port_lock(0);
             lv_label_set_text(countdown_label, buf);
+            lvgl_port_unlock();
         }
 
         if (countdown_seconds == 0) {
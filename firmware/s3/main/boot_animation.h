@@ -45,6 +45,8 @@ void boot_anim_set_text(const char *text);
  * - Countdown timer (10s...1s)
  * - Reboots device after countdown
  *
+ * Takes the LVGL lock itself; safe from any task.
+ *
  * @param error_msg Error message to display
  */
 void boot_anim_show_error(const char *error_msg);
@@ -0,0 +1,227 @@
+/**
+ * @file boot_graph.c
+ * @brief Boot dependency graph implementation
+ */
+
+#include "boot_graph.h"
+#include "boot_animation.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "BOOT"
+
+#define STAGE_TASK_PRIO     5
+
+static const boot_stage_t *g_stages = NULL;
+static int g_count = 0;
+static boot_stage_record_t g_timeline[BOOT_GRAPH_MAX_STAGES];
+static int g_partial[BOOT_GRAPH_MAX_STAGES];    /* Per mille of a running stage */
+static EventGroupHandle_t g_done = NULL;        /* Bit per stage: finished or skipped */
+static SemaphoreHandle_t g_lock = NULL;         /* Timeline, progress, g_failed */
+static uint32_t g_failed = 0;                   /* Failed or skipped stages */
+static bool g_fatal = false;
+static int g_progress_from = 0;
+static int g_progress_to = 100;
+static int g_progress = 0;                      /* Arc percent shown (never goes back) */
+
+/* ------------------------------------------------------------------ */
+/* Private: Progress                                                  */
+/* ------------------------------------------------------------------ */
+
+/* Lock held */
+static void progress_update(void)
+{
+    int64_t total = 0;
+    int64_t done = 0;
+
+    for (int i = 0; i < g_count; i++) {
+        total += g_stages[i].weight * 1000;
+        if (g_timeline[i].state >= BOOT_STAGE_OK) {
+            done += g_stages[i].weight * 1000;
+        } else if (g_timeline[i].state == BOOT_STAGE_RUNNING) {
+            done += g_stages[i].weight * g_partial[i];
+        }
+    }
+    if (total == 0) {
+        return;
+    }
+
+    int percent = g_progress_from + (int)((g_progress_to - g_progress_from) * done / total);
+    if (percent > g_progress && !g_fatal) {
+        g_progress = percent;
+        boot_anim_set_progress(percent);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Stage task                                                */
+/* ------------------------------------------------------------------ */
+
+static void stage_finish(int i, boot_stage_state_t state)
+{
+    const boot_stage_t *st = &g_stages[i];
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    g_timeline[i].state = state;
+    g_timeline[i].end_us = esp_timer_get_time();
+    if (state != BOOT_STAGE_OK) {
+        g_failed |= BOOT_DEP(i);
+    }
+    if (state == BOOT_STAGE_FAILED && st->error_text && !g_fatal) {
+        g_fatal = true;
+        boot_anim_show_error(st->error_text);
+    }
+    progress_update();
+    xSemaphoreGive(g_lock);
+
+    /* Failed bit is visible before dependents wake */
+    xEventGroupSetBits(g_done, BOOT_DEP(i));
+}
+
+static void stage_task(void *arg)
+{
+    int i = (int)(intptr_t)arg;
+    const boot_stage_t *st = &g_stages[i];
+
+    if (st->deps) {
+        xEventGroupWaitBits(g_done, st->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    bool skip = (g_failed & st->deps) != 0;
+    g_timeline[i].start_us = esp_timer_get_time();
+    if (!skip) {
+        g_timeline[i].state = BOOT_STAGE_RUNNING;
+    }
+    xSemaphoreGive(g_lock);
+
+    if (skip) {
+        ESP_LOGW(TAG, "Stage %s skipped (dependency failed)", st->name);
+        stage_finish(i, BOOT_STAGE_SKIPPED);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    char text[32];
+    snprintf(text, sizeof(text), "%s...", st->name);
+    boot_anim_set_text(text);
+
+    int ret = st->run();
+    if (ret != 0) {
+        ESP_LOGE(TAG, "Stage %s failed", st->name);
+    }
+    stage_finish(i, ret == 0 ? BOOT_STAGE_OK : BOOT_STAGE_FAILED);
+    vTaskDelete(NULL);
+}
+
+static const char *state_name(boot_stage_state_t state)
+{
+    switch (state) {
+        case BOOT_STAGE_OK:      return "ok";
+        case BOOT_STAGE_FAILED:  return "FAILED";
+        case BOOT_STAGE_SKIPPED: return "skipped";
+        default:                 return "?";
+    }
+}
+
+static void log_timeline(int64_t t0_us)
+{
+    int64_t end_us = t0_us;
+
+    ESP_LOGI(TAG, "Boot timeline (ms since app start):");
+    for (int i = 0; i < g_count; i++) {
+        const boot_stage_record_t *r = &g_timeline[i];
+        ESP_LOGI(TAG, "  %-12s %6lld -> %6lld  (%5lld ms)  %s", r->name,
+                 r->start_us / 1000, r->end_us / 1000,
+                 (r->end_us - r->start_us) / 1000, state_name(r->state));
+        if (r->end_us > end_us) {
+            end_us = r->end_us;
+        }
+    }
+    ESP_LOGI(TAG, "Boot graph: %lld ms (started at %lld ms)",
+             (end_us - t0_us) / 1000, t0_us / 1000);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+int boot_graph_run(const boot_stage_t *stages, int count, int progress_from, int progress_to)
+{
+    if (!stages || count <= 0 || count > BOOT_GRAPH_MAX_STAGES) {
+        return -1;
+    }
+
+    g_done = xEventGroupCreate();
+    g_lock = xSemaphoreCreateMutex();
+    if (!g_done || !g_lock) {
+        ESP_LOGE(TAG, "Boot graph alloc failed");
+        return -1;
+    }
+
+    g_stages = stages;
+    g_count = count;
+    g_failed = 0;
+    g_fatal = false;
+    g_progress_from = progress_from;
+    g_progress_to = progress_to;
+    g_progress = progress_from;
+    memset(g_timeline, 0, sizeof(g_timeline));
+    memset(g_partial, 0, sizeof(g_partial));
+    for (int i = 0; i < count; i++) {
+        g_timeline[i].name = stages[i].name;
+    }
+
+    int64_t t0_us = esp_timer_get_time();
+    uint32_t all = 0;
+
+    for (int i = 0; i < count; i++) {
+        all |= BOOT_DEP(i);
+        if (xTaskCreate(stage_task, stages[i].name, stages[i].stack, (void *)(intptr_t)i,
+                        STAGE_TASK_PRIO, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Stage %s: task create failed", stages[i].name);
+            g_timeline[i].start_us = esp_timer_get_time();
+            stage_finish(i, BOOT_STAGE_FAILED);
+        }
+    }
+
+    xEventGroupWaitBits(g_done, all, pdFALSE, pdTRUE, portMAX_DELAY);
+    log_timeline(t0_us);
+
+    vEventGroupDelete(g_done);
+    g_done = NULL;
+    vSemaphoreDelete(g_lock);
+    g_lock = NULL;
+    return g_fatal ? -1 : 0;
+}
+
+void boot_graph_stage_progress(int stage, int done, int total)
+{
+    if (stage < 0 || stage >= g_count || total <= 0 || !g_lock) {
+        return;
+    }
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    g_partial[stage] = done >= total ? 1000 : done * 1000 / total;
+    progress_update();
+    xSemaphoreGive(g_lock);
+}
+
+int boot_graph_get_timeline(boot_stage_record_t *out, int max)
+{
+    int n = 0;
+
+    if (!out) {
+        return 0;
+    }
+    for (; n < g_count && n < max; n++) {
+        out[n] = g_timeline[n];
+    }
+    return n;
+}
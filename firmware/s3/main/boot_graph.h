@@ -0,0 +1,64 @@
+/**
+ * @file boot_graph.h
+ * @brief Boot as a dependency graph of init stages
+ *
+ * Each stage runs in its own task as soon as the stages it depends on have
+ * succeeded, so independent chains (network, emoji loading, hardware) overlap
+ * instead of queuing behind the slowest one. A stage whose dependency failed
+ * is skipped. The boot arc shows the weighted share of finished stages, and a
+ * timeline with per-stage start and duration is logged at the end.
+ */
+
+#ifndef BOOT_GRAPH_H
+#define BOOT_GRAPH_H
+
+#include <stdint.h>
+
+#define BOOT_GRAPH_MAX_STAGES   16
+#define BOOT_DEP(stage)         (1u << (stage))
+
+typedef struct {
+    const char *name;           /* Timeline label, boot screen text */
+    int (*run)(void);           /* 0 on success, -1 on failure */
+    uint32_t deps;              /* BOOT_DEP() mask of stages that must succeed first */
+    int weight;                 /* Share of the progress arc */
+    int stack;                  /* Task stack in bytes */
+    const char *error_text;     /* Error screen on failure (NULL: non-fatal) */
+} boot_stage_t;
+
+typedef enum {
+    BOOT_STAGE_PENDING = 0,
+    BOOT_STAGE_RUNNING,
+    BOOT_STAGE_OK,
+    BOOT_STAGE_FAILED,
+    BOOT_STAGE_SKIPPED,         /* A dependency failed */
+} boot_stage_state_t;
+
+typedef struct {
+    const char *name;
+    boot_stage_state_t state;
+    int64_t start_us;           /* esp_timer time (since app start) */
+    int64_t end_us;
+} boot_stage_record_t;
+
+/**
+ * Run all stages and wait until each has finished or been skipped
+ * @param stages Table indexed by stage id (BOOT_DEP() bit numbers)
+ * @param progress_from Arc percent before the first stage
+ * @param progress_to Arc percent once every stage is done
+ * @return 0 on success, -1 if a fatal stage failed (error screen shown)
+ */
+int boot_graph_run(const boot_stage_t *stages, int count, int progress_from, int progress_to);
+
+/**
+ * Report progress inside a long stage (moves the arc within its weight)
+ */
+void boot_graph_stage_progress(int stage, int done, int total);
+
+/**
+ * Copy the timeline of the last run
+ * @return Number of records
+ */
+int boot_graph_get_timeline(boot_stage_record_t *out, int max);
+
+#endif /* BOOT_GRAPH_H */
@@ -5,11 +5,17 @@
 #include "hal_wake_word.h"
 #include "ws_client.h"
 #include "display_ui.h"
+#include "audio_ring.h"
+#include "audio_dsp.h"
+#include "vad_engine.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include <string.h>
-#include <math.h>
+#include <stdatomic.h>
 
 #define TAG "VOICE"
 
@@ -26,6 +32,19 @@ static int wake_word_setup(void);
 static void wake_word_cleanup(void);
 #endif /* CONFIG_ENABLE_WAKE_WORD */
 
+#ifdef CONFIG_AEC_BARGE_IN
+/* AEC barge-in: detection stays on during TTS with the speaker as reference */
+static bool g_barge_in = false;
+static int barge_in(const char *why);
+static int16_t g_ref_buf[960];          /* One 60ms frame of reference */
+#if defined(CONFIG_AEC_BARGE_IN_VAD_MS) && CONFIG_AEC_BARGE_IN_VAD_MS > 0
+static int g_barge_speech_ms = 0;       /* Continuous AFE speech while TTS plays */
+#endif
+#endif
+
+/* Continuous AFE mode: AFE output is the uplink (see on_afe_audio) */
+static bool g_afe_uplink = false;
+
 /* ------------------------------------------------------------------ */
 /* Private: State and statistics                                       */
 /* ------------------------------------------------------------------ */
@@ -33,6 +52,15 @@ static void wake_word_cleanup(void);
 static voice_state_t g_state = VOICE_STATE_IDLE;
 static voice_stats_t g_stats = {0};
 
+/* Bumped by both the capture task and the uplink sender task */
+static atomic_int g_error_count;
+
+/* Count one error, returns the new total */
+static int count_error(void)
+{
+    return atomic_fetch_add_explicit(&g_error_count, 1, memory_order_relaxed) + 1;
+}
+
 /* Track how recording was triggered (for button behavior) */
 static bool g_recording_triggered_by_wake_word = false;
 
@@ -42,30 +70,276 @@ static bool g_recording_triggered_by_wake_word = false;
 static uint8_t g_pcm_buf[PCM_FRAME_SIZE];
 
 /* ------------------------------------------------------------------ */
-/* Private: VAD (Voice Activity Detection)                             */
+/* Private: Capture pacing                                            */
 /* ------------------------------------------------------------------ */
 
+/* One PCM frame = 60ms; capture is paced by blocking reads, not delays */
+#define TICK_INTERVAL_MS    60
+#define FRAME_PERIOD_US     (TICK_INTERVAL_MS * 1000)
+
+static TaskHandle_t g_voice_task_handle = NULL;
+static bool g_frame_read = false;       /* Set by tick when a frame was read */
+static int64_t g_last_frame_us = 0;     /* Completion time of previous read */
+static int g_jitter_ewma_us = 0;        /* Mean |period - 60ms|, EWMA (x16) */
+
+/**
+ * Record read completion time and update frame jitter statistics
+ */
+static void capture_timing_update(void)
+{
+    int64_t now = esp_timer_get_time();
+    g_frame_read = true;
+
+    /* Only consecutive reads count (skip gaps from idle / audio stopped) */
+    if (g_last_frame_us != 0 && now - g_last_frame_us < 2 * FRAME_PERIOD_US) {
+        int dev = (int)(now - g_last_frame_us) - FRAME_PERIOD_US;
+        if (dev < 0) dev = -dev;
+
+        /* EWMA with alpha = 1/16, kept in x16 fixed point */
+        g_jitter_ewma_us += dev - (g_jitter_ewma_us >> 4);
+        g_stats.frame_jitter_avg_us = g_jitter_ewma_us >> 4;
+        if (dev > g_stats.frame_jitter_max_us) {
+            g_stats.frame_jitter_max_us = dev;
+        }
+    }
+    g_last_frame_us = now;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Uplink ring (capture task -> sender task)                 */
+/* ------------------------------------------------------------------ */
+
+#ifdef CONFIG_UPLINK_RING_FRAMES
+#define UPLINK_RING_FRAMES  CONFIG_UPLINK_RING_FRAMES
+#else
+#define UPLINK_RING_FRAMES  32
+#endif
+
+/* Entry with len 0 marks end of utterance (sender sends audio_end) */
+#define UPLINK_END_MARKER   0
+
+static audio_ring_t g_uplink_ring;
+static void *g_uplink_ring_mem = NULL;  /* PSRAM; NULL = send inline */
+static TaskHandle_t g_sender_task_handle = NULL;
+
+/* Set by stop_recording (any task), marker queued by the capture task */
+static volatile bool g_uplink_end_pending = false;
+
+/* ------------------------------------------------------------------ */
+/* Private: Uplink encoding                                            */
+/* ------------------------------------------------------------------ */
+
+/* Encoder frame accumulator (Opus frames may be 20/40/60ms) */
+static uint8_t g_enc_pcm[PCM_FRAME_SIZE];
+static int g_enc_pcm_len = 0;
+static uint8_t g_enc_out[HAL_OPUS_MAX_PACKET];
+
+/**
+ * Encode (if enabled) and send PCM to the server
+ * @return Number of packets sent, or -1 on error
+ */
+static int uplink_send(const uint8_t *pcm, int len)
+{
+    g_stats.pcm_bytes += len;
+
+    /* PCM passthrough: send the frame as-is (no encoding) */
+    if (hal_opus_get_mode() != HAL_OPUS_MODE_OPUS) {
+        if (ws_send_audio(pcm, len) != 0) {
+            return -1;
+        }
+        g_stats.sent_bytes += len;
+        return 1;
+    }
+
+    /* Opus: one WebSocket frame per encoded packet */
+    int frame_bytes = hal_opus_get_frame_bytes();
+    int packets = 0;
+
+    while (len > 0) {
+        int n = frame_bytes - g_enc_pcm_len;
+        if (n > len) n = len;
+        memcpy(&g_enc_pcm[g_enc_pcm_len], pcm, n);
+        g_enc_pcm_len += n;
+        pcm += n;
+        len -= n;
+
+        if (g_enc_pcm_len < frame_bytes) {
+            break;
+        }
+        g_enc_pcm_len = 0;
+
+        int enc_len = hal_opus_encode(g_enc_pcm, frame_bytes, g_enc_out, sizeof(g_enc_out));
+        if (enc_len < 0) {
+            ESP_LOGE(TAG, "Opus encode failed");
+            return -1;
+        }
+        if (ws_send_audio(g_enc_out, enc_len) != 0) {
+            return -1;
+        }
+        g_stats.sent_bytes += enc_len;
+        packets++;
+    }
+
+    return packets;
+}
+
+/**
+ * Pad and send the last partial encoder frame (end of utterance)
+ */
+static void uplink_flush(void)
+{
+    if (hal_opus_get_mode() == HAL_OPUS_MODE_OPUS && g_enc_pcm_len > 0) {
+        int frame_bytes = hal_opus_get_frame_bytes();
+        memset(&g_enc_pcm[g_enc_pcm_len], 0, frame_bytes - g_enc_pcm_len);
+
+        int enc_len = hal_opus_encode(g_enc_pcm, frame_bytes, g_enc_out, sizeof(g_enc_out));
+        if (enc_len > 0 && ws_send_audio(g_enc_out, enc_len) == 0) {
+            g_stats.sent_bytes += enc_len;
+        }
+    }
+    g_enc_pcm_len = 0;
+}
+
+/**
+ * Queue a captured frame for the sender task (never blocks)
+ * @return 0 on success, -1 if the frame was dropped
+ */
+static int uplink_enqueue(const uint8_t *pcm, int len)
+{
+    /* Keep one slot for the end-of-utterance marker */
+    if (audio_ring_free(&g_uplink_ring) <= 1 ||
+        audio_ring_push(&g_uplink_ring, pcm, len) != 0) {
+        g_stats.ring_overruns++;
+        if (g_stats.ring_overruns % 10 == 1) {
+            ESP_LOGW(TAG, "Uplink ring full, frame dropped (overruns: %d)", g_stats.ring_overruns);
+        }
+        return -1;
+    }
+
+    g_stats.ring_high_water = g_uplink_ring.high_water;
+    xTaskNotifyGive(g_sender_task_handle);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Pre-roll (recent mic audio from before the trigger)       */
+/* ------------------------------------------------------------------ */
+
+#if defined(CONFIG_ENABLE_WAKE_WORD) && defined(CONFIG_VOICE_PREROLL_MS) && CONFIG_VOICE_PREROLL_MS > 0
+#define PREROLL_FRAMES      ((CONFIG_VOICE_PREROLL_MS + TICK_INTERVAL_MS - 1) / TICK_INTERVAL_MS)
+#else
+#define PREROLL_FRAMES      0
+#endif
+
+static audio_ring_t g_preroll;
+static void *g_preroll_mem = NULL;              /* PSRAM; NULL = no pre-roll */
+static volatile bool g_preroll_pending = false; /* Flush before first live frame */
+
 #ifdef CONFIG_ENABLE_WAKE_WORD
-/* VAD state */
-static int g_vad_silence_frames = 0;    /* Consecutive silent frames */
-static int g_vad_speech_frames = 0;     /* Total speech frames in this recording */
+static int64_t g_preroll_last_us = 0;           /* Capture time of newest frame */
 
+/* Pre-roll is produced and consumed by the capture task only */
+static void preroll_clear(void)
+{
+    while (audio_ring_peek(&g_preroll, NULL) != NULL) {
+        audio_ring_release(&g_preroll);
+    }
+}
+
+/**
+ * Keep an idle frame, overwriting the oldest one when full
+ */
+static void preroll_store(const uint8_t *pcm, int len)
+{
+    if (!g_preroll_mem) {
+        return;
+    }
+
+    /* Capture gap (TTS, audio stopped): older frames are no longer "just before" */
+    if (g_last_frame_us - g_preroll_last_us > 2 * FRAME_PERIOD_US) {
+        preroll_clear();
+    }
+    g_preroll_last_us = g_last_frame_us;
+
+    if (audio_ring_free(&g_preroll) == 0) {
+        audio_ring_release(&g_preroll);
+    }
+    audio_ring_push(&g_preroll, pcm, len);
+}
+
+/**
+ * Send buffered pre-roll ahead of the first live frame
+ */
+static void preroll_flush(void)
+{
+    const uint8_t *frame;
+    int len;
+    int count = 0;
+
+    g_preroll_pending = false;
+    while ((frame = audio_ring_peek(&g_preroll, &len)) != NULL) {
+        if (g_uplink_ring_mem && g_sender_task_handle) {
+            uplink_enqueue(frame, len);
+        } else if (uplink_send(frame, len) < 0) {
+            count_error();
+        }
+        audio_ring_release(&g_preroll);
+        count++;
+    }
+
+    g_stats.preroll_frames = count;
+    ESP_LOGI(TAG, "Pre-roll: sent %d frames (%d ms)", count, count * TICK_INTERVAL_MS);
+}
+#endif /* CONFIG_ENABLE_WAKE_WORD */
+
+/* ------------------------------------------------------------------ */
+/* Private: VAD (Voice Activity Detection)                             */
+/* ------------------------------------------------------------------ */
+
+#ifdef CONFIG_ENABLE_WAKE_WORD
 /* VAD configuration from Kconfig */
-#define VAD_FRAME_MS            60      /* Each frame is 60ms */
-#define VAD_SILENCE_FRAMES      (CONFIG_VAD_SILENCE_TIMEOUT_MS / VAD_FRAME_MS)
+#define VAD_FRAME_MS            TICK_INTERVAL_MS
 #define VAD_RMS_THRESHOLD       CONFIG_VAD_RMS_THRESHOLD
-#define VAD_MIN_SPEECH_FRAMES   (CONFIG_VAD_MIN_SPEECH_MS / VAD_FRAME_MS)
+
+/* Engine state; the noise floor is learned from idle frames between turns */
+static vad_engine_t g_vad;
+static vad_engine_state_t g_vad_last_state = VAD_ENGINE_SILENCE;
 
 /* VAD control: only enable when wake word triggered */
 static bool g_vad_enabled = false;
 
+/* Continuous AFE: frames an endpoint may wait for the AFE VAD to agree */
+#define VAD_AFE_DEFER_FRAMES    8
+static int g_vad_afe_defer = 0;
+
+static void vad_init(void)
+{
+    vad_engine_config_t cfg;
+
+    vad_engine_default_config(&cfg);
+    cfg.frame_ms = VAD_FRAME_MS;
+    cfg.min_threshold = VAD_RMS_THRESHOLD;
+    cfg.min_speech_ms = CONFIG_VAD_MIN_SPEECH_MS;
+    cfg.confident_speech_ms = CONFIG_VAD_CONFIDENT_SPEECH_MS;
+    cfg.hangover_max_ms = CONFIG_VAD_SILENCE_TIMEOUT_MS;
+    cfg.hangover_min_ms = CONFIG_VAD_HANGOVER_MS < CONFIG_VAD_SILENCE_TIMEOUT_MS ?
+                          CONFIG_VAD_HANGOVER_MS : CONFIG_VAD_SILENCE_TIMEOUT_MS;
+
+    if (vad_engine_init(&g_vad, &cfg) != 0) {
+        ESP_LOGE(TAG, "VAD init failed, check VAD Kconfig values");
+    }
+}
+
 static void vad_reset(void)
 {
-    g_vad_silence_frames = 0;
-    g_vad_speech_frames = 0;
+    vad_engine_start_turn(&g_vad);
+    g_vad_last_state = VAD_ENGINE_SILENCE;
+    g_vad_afe_defer = 0;
     g_vad_enabled = true;
-    ESP_LOGI(TAG, "VAD reset, silence_threshold=%d frames, rms_threshold=%d, min_speech=%d frames",
-             VAD_SILENCE_FRAMES, VAD_RMS_THRESHOLD, VAD_MIN_SPEECH_FRAMES);
+    g_stats.vad_noise_floor = vad_engine_noise_floor(&g_vad);
+    ESP_LOGI(TAG, "VAD reset, noise_floor=%d, hangover=%d->%dms, min_speech=%dms",
+             g_stats.vad_noise_floor, g_vad.cfg.hangover_max_ms,
+             g_vad.cfg.hangover_min_ms, g_vad.cfg.min_speech_ms);
 }
 
 static void vad_disable(void)
@@ -75,46 +349,43 @@ static void vad_disable(void)
 
 /**
  * Process VAD on a frame
- * @param rms RMS value of the audio frame
- * @return true if recording should stop (silence timeout)
+ * @param st Frame statistics
+ * @param n Samples in the frame
+ * @param afe_speech AFE VAD still hears speech (continuous AFE mode)
+ * @return true if recording should stop (end of speech)
  */
-static bool vad_process_frame(int rms)
+static bool vad_process_frame(const audio_stats_t *st, int n, bool afe_speech)
 {
     if (!g_vad_enabled) {
         return false;
     }
 
     /* Skip VAD if silence timeout is disabled (0) */
-    if (VAD_SILENCE_FRAMES <= 0) {
+    if (CONFIG_VAD_SILENCE_TIMEOUT_MS <= 0) {
         return false;
     }
 
-    if (rms < VAD_RMS_THRESHOLD) {
-        /* Silent frame */
-        g_vad_silence_frames++;
+    vad_engine_state_t state = vad_engine_process(&g_vad, st, n);
+    g_stats.vad_noise_floor = vad_engine_noise_floor(&g_vad);
 
-        /* Log every 10 silent frames */
-        if (g_vad_silence_frames % 10 == 0) {
-            ESP_LOGI(TAG, "VAD: silence_frames=%d/%d, rms=%d (threshold=%d)",
-                     g_vad_silence_frames, VAD_SILENCE_FRAMES, rms, VAD_RMS_THRESHOLD);
-        }
+    if (state != g_vad_last_state) {
+        ESP_LOGI(TAG, "VAD: %d -> %d, rms=%d, floor=%d, speech=%dms, hangover=%dms",
+                 g_vad_last_state, state, st->rms, g_stats.vad_noise_floor,
+                 g_vad.speech_ms, g_vad.hangover_ms);
+        g_vad_last_state = state;
+    }
 
-        /* Check if silence timeout reached and minimum speech achieved */
-        if (g_vad_silence_frames >= VAD_SILENCE_FRAMES &&
-            g_vad_speech_frames >= VAD_MIN_SPEECH_FRAMES) {
-            ESP_LOGI(TAG, "VAD: Silence timeout detected! speech_frames=%d, silence_frames=%d",
-                     g_vad_speech_frames, g_vad_silence_frames);
-            return true;  /* Signal to stop recording */
-        }
-    } else {
-        /* Speech frame */
-        g_vad_silence_frames = 0;  /* Reset silence counter */
-        g_vad_speech_frames++;
+    /* Endpoint is sticky: give the AFE VAD a few frames to agree */
+    if (state == VAD_ENGINE_ENDPOINT && afe_speech &&
+        g_vad_afe_defer++ < VAD_AFE_DEFER_FRAMES) {
+        return false;
+    }
 
-        /* Log every 20 speech frames */
-        if (g_vad_speech_frames % 20 == 0) {
-            ESP_LOGI(TAG, "VAD: speech_frames=%d, rms=%d", g_vad_speech_frames, rms);
-        }
+    if (state == VAD_ENGINE_ENDPOINT) {
+        g_stats.vad_hangover_ms = g_vad.hangover_ms;
+        ESP_LOGI(TAG, "VAD: End of speech, speech=%dms, silence=%dms, longest_pause=%dms",
+                 g_vad.speech_ms, g_vad.silence_ms, g_vad.longest_pause_ms);
+        return true;  /* Signal to stop recording */
     }
 
     return false;
@@ -129,6 +400,7 @@ void voice_recorder_init(void)
 {
     g_state = VOICE_STATE_IDLE;
     memset(&g_stats, 0, sizeof(g_stats));
+    atomic_store_explicit(&g_error_count, 0, memory_order_relaxed);
 
 #ifdef CONFIG_ENABLE_WAKE_WORD
     /* Start audio immediately for wake word detection */
@@ -156,7 +428,20 @@ void voice_recorder_reset_stats(void)
 {
     g_stats.record_count = 0;
     g_stats.encode_count = 0;
-    g_stats.error_count = 0;
+    atomic_store_explicit(&g_error_count, 0, memory_order_relaxed);
+    g_stats.pcm_bytes = 0;
+    g_stats.sent_bytes = 0;
+    g_stats.ring_overruns = 0;
+    g_stats.ring_underruns = 0;
+    g_stats.ring_high_water = 0;
+    g_stats.frame_jitter_avg_us = 0;
+    g_stats.frame_jitter_max_us = 0;
+    g_stats.preroll_frames = 0;
+    g_stats.vad_hangover_ms = 0;
+    g_stats.barge_in_count = 0;
+    g_stats.barge_in_latency_ms = 0;
+    g_stats.barge_in_latency_max_ms = 0;
+    g_jitter_ewma_us = 0;
 }
 
 /* ------------------------------------------------------------------ */
@@ -168,8 +453,30 @@ void voice_recorder_get_stats(voice_stats_t *out_stats)
     if (out_stats) {
         out_stats->record_count = g_stats.record_count;
         out_stats->encode_count = g_stats.encode_count;
-        out_stats->error_count = g_stats.error_count;
+        out_stats->error_count = atomic_load_explicit(&g_error_count, memory_order_relaxed);
         out_stats->current_state = (int)g_state;
+        out_stats->pcm_bytes = g_stats.pcm_bytes;
+        out_stats->sent_bytes = g_stats.sent_bytes;
+        out_stats->ring_overruns = g_stats.ring_overruns;
+        out_stats->ring_underruns = g_stats.ring_underruns;
+        out_stats->ring_high_water = g_stats.ring_high_water;
+        out_stats->frame_jitter_avg_us = g_stats.frame_jitter_avg_us;
+        out_stats->frame_jitter_max_us = g_stats.frame_jitter_max_us;
+        out_stats->preroll_frames = g_stats.preroll_frames;
+        out_stats->vad_noise_floor = g_stats.vad_noise_floor;
+        out_stats->vad_hangover_ms = g_stats.vad_hangover_ms;
+        out_stats->aec_erl_db = 0;
+        out_stats->aec_erle_db = 0;
+#ifdef CONFIG_AEC_BARGE_IN
+        wake_word_aec_stats_t aec;
+        if (g_barge_in && hal_wake_word_get_aec_stats(g_wake_word_ctx, &aec) == 0) {
+            out_stats->aec_erl_db = aec.erl_db;
+            out_stats->aec_erle_db = aec.erle_db;
+        }
+#endif
+        out_stats->barge_in_count = g_stats.barge_in_count;
+        out_stats->barge_in_latency_ms = g_stats.barge_in_latency_ms;
+        out_stats->barge_in_latency_max_ms = g_stats.barge_in_latency_max_ms;
     }
 }
 
@@ -182,28 +489,35 @@ static int start_recording(void)
     ESP_LOGI(TAG, "start_recording: calling hal_audio_start()");
     if (hal_audio_start() != 0) {
         ESP_LOGE(TAG, "start_recording: hal_audio_start failed");
-        g_stats.error_count++;
+        count_error();
         return -1;
     }
 
 #ifdef CONFIG_ENABLE_WAKE_WORD
-    /* Stop wake word detection during recording to prevent AFE empty warnings */
-    if (g_wake_word_ctx != NULL) {
+    if (g_afe_uplink) {
+        /* Continuous AFE: its output is the uplink, only mute WakeNet */
+        hal_wake_word_pause_detection(g_wake_word_ctx);
+    } else if (g_wake_word_ctx != NULL) {
+        /* Stop wake word detection during recording to prevent AFE empty warnings */
         hal_wake_word_stop(g_wake_word_ctx);
         /* Wait for detection task to finish current fetch */
         vTaskDelay(pdMS_TO_TICKS(50));
     }
-    
+
     /* Initialize VAD for wake word mode */
     if (g_recording_triggered_by_wake_word) {
         vad_reset();
-        ESP_LOGI(TAG, "VAD enabled: silence_timeout=%dms, rms_threshold=%d, min_speech=%dms",
-                 CONFIG_VAD_SILENCE_TIMEOUT_MS, CONFIG_VAD_RMS_THRESHOLD, CONFIG_VAD_MIN_SPEECH_MS);
     }
 #endif
 
+    g_preroll_pending = (g_preroll_mem != NULL);
     g_state = VOICE_STATE_RECORDING;
     ESP_LOGI(TAG, "start_recording: state -> RECORDING");
+
+    /* Wake the capture task if it is idle-waiting (no wake word mode) */
+    if (g_voice_task_handle) {
+        xTaskNotifyGive(g_voice_task_handle);
+    }
     return 0;
 }
 
@@ -215,7 +529,7 @@ static int stop_recording(void)
 {
     /* In wake word mode, keep audio running for continuous detection */
 #ifdef CONFIG_ENABLE_WAKE_WORD
-    if (!g_recording_triggered_by_wake_word) {
+    if (!g_recording_triggered_by_wake_word && !g_afe_uplink) {
         hal_audio_stop();
     }
     /* Wake word mode: audio stays running for next detection */
@@ -223,10 +537,16 @@ static int stop_recording(void)
     hal_audio_stop();
 #endif
 
-    /* Send audio end marker */
-    if (ws_send_audio_end() != 0) {
-        g_stats.error_count++;
-        /* Still transition to idle */
+    /* End of utterance: queued behind the remaining frames, or sent now */
+    if (g_uplink_ring_mem && g_sender_task_handle) {
+        /* Only the ring producer pushes (see uplink_push_end_marker) */
+        g_uplink_end_pending = true;
+    } else {
+        uplink_flush();
+        if (ws_send_audio_end() != 0) {
+            count_error();
+            /* Still transition to idle */
+        }
     }
 
 #ifdef CONFIG_ENABLE_WAKE_WORD
@@ -268,12 +588,162 @@ void voice_recorder_process_event(voice_event_t event)
     }
 }
 
+/* ------------------------------------------------------------------ */
+/* Private: Uplink frame pipeline                                     */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Queue a pending end-of-utterance marker behind the frames already
+ * captured. Only the uplink ring producer calls this. One slot is always
+ * kept free for it (see uplink_enqueue).
+ */
+static void uplink_push_end_marker(void)
+{
+    if (g_uplink_end_pending) {
+        g_uplink_end_pending = false;
+        audio_ring_push(&g_uplink_ring, NULL, UPLINK_END_MARKER);
+        xTaskNotifyGive(g_sender_task_handle);
+    }
+}
+
+/**
+ * Per-frame uplink pipeline: pre-roll, quality stats, VAD, queue/send.
+ * Runs on the uplink ring producer: the capture task, or the AFE
+ * detection task in continuous AFE mode.
+ *
+ * @param pcm One 60ms frame
+ * @param afe_speech AFE VAD says speech (continuous AFE mode, else false)
+ * @return 1 if the frame was queued/sent, 0 if not, -1 on error
+ */
+static int uplink_process_frame(uint8_t *pcm, int pcm_len, bool afe_speech)
+{
+    int16_t *samples = (int16_t *)pcm;
+    int sample_count = pcm_len / 2;  /* 16-bit samples */
+
+#ifdef CONFIG_ENABLE_WAKE_WORD
+    /* Only send to WebSocket when recording; keep idle audio as pre-roll */
+    if (g_state != VOICE_STATE_RECORDING) {
+        audio_stats_t idle_st;
+        audio_dsp_stats(samples, sample_count, &idle_st);
+        vad_engine_track_noise(&g_vad, &idle_st);
+        preroll_store(pcm, pcm_len);
+        return 0;
+    }
+
+    /* First live frame: send what was said just before the trigger */
+    if (g_preroll_pending) {
+        preroll_flush();
+    }
+#else
+    (void)afe_speech;
+#endif
+
+    /* Audio quality check: RMS, peak, zero count (single integer pass) */
+    audio_stats_t st;
+    audio_dsp_stats(samples, sample_count, &st);
+
+    /* Log every 10 frames */
+    if (g_stats.encode_count % 10 == 0) {
+        ESP_LOGI(TAG, "Audio: frame#%d, rms=%d, peak=%d, zeros=%d/%d, jitter=%d/%dus",
+                 g_stats.encode_count + 1, st.rms, st.peak, st.zero_count, sample_count,
+                 g_stats.frame_jitter_avg_us, g_stats.frame_jitter_max_us);
+    }
+
+#ifdef CONFIG_ENABLE_WAKE_WORD
+    /* VAD: Check for end of speech (only in wake word mode) */
+    if (g_vad_enabled && vad_process_frame(&st, sample_count, afe_speech)) {
+        ESP_LOGI(TAG, "VAD triggered stop - end of speech");
+        /* Stop recording due to silence timeout */
+        voice_recorder_process_event(VOICE_EVENT_TIMEOUT);
+        display_update("Processing...", "thinking", 0, NULL);
+        return 0;  /* Recording stopped, don't send this frame */
+    }
+#endif
+
+    /* Hand the frame to the sender task; capture never waits on the network */
+    if (g_uplink_ring_mem && g_sender_task_handle) {
+        return (uplink_enqueue(pcm, pcm_len) == 0) ? 1 : -1;
+    }
+
+    /* No sender task: send inline (raw PCM or Opus packets, see hal_opus) */
+    if (uplink_send(pcm, pcm_len) < 0) {
+        int errors = count_error();
+        /* Only log every 10 errors to avoid flooding */
+        if (errors % 10 == 1) {
+            ESP_LOGE(TAG, "WS send audio failed (count: %d)", errors);
+        }
+        return -1;
+    }
+
+    g_stats.encode_count++;
+    return 1;  /* One frame sent */
+}
+
+#ifdef CONFIG_AFE_UPLINK_STREAM
+/* ------------------------------------------------------------------ */
+/* Private: Continuous AFE uplink                                     */
+/* ------------------------------------------------------------------ */
+
+/* AFE fetch chunks (512 samples) regrouped into 60ms uplink frames */
+static uint8_t g_afe_frame[PCM_FRAME_SIZE];
+static int g_afe_frame_len = 0;
+static bool g_afe_frame_speech = false;
+
+/**
+ * AFE output callback (detection task): NS-processed audio becomes the
+ * uplink, so this task is the uplink ring producer in this mode.
+ */
+static void on_afe_audio(const int16_t *samples, size_t num_samples, bool speech, void *user_data)
+{
+    (void)user_data;
+    const uint8_t *src = (const uint8_t *)samples;
+    int len = (int)(num_samples * sizeof(int16_t));
+
+    uplink_push_end_marker();
+
+#if defined(CONFIG_AEC_BARGE_IN_VAD_MS) && CONFIG_AEC_BARGE_IN_VAD_MS > 0
+    /* Sustained echo-cancelled speech over TTS starts a turn without the wake word */
+    if (g_state == VOICE_STATE_IDLE && ws_tts_is_playing()) {
+        g_barge_speech_ms = speech ? g_barge_speech_ms + (int)(num_samples / 16) : 0;
+        if (g_barge_speech_ms >= CONFIG_AEC_BARGE_IN_VAD_MS && barge_in("speech") == 0) {
+            g_recording_triggered_by_wake_word = true;  /* VAD ends the turn */
+            display_update("Listening...", "listening", 0, NULL);
+            voice_recorder_process_event(VOICE_EVENT_WAKE_WORD);
+        }
+    } else {
+        g_barge_speech_ms = 0;
+    }
+#endif
+
+    while (len > 0) {
+        int n = PCM_FRAME_SIZE - g_afe_frame_len;
+        if (n > len) n = len;
+        memcpy(&g_afe_frame[g_afe_frame_len], src, n);
+        g_afe_frame_len += n;
+        g_afe_frame_speech |= speech;
+        src += n;
+        len -= n;
+
+        if (g_afe_frame_len == PCM_FRAME_SIZE) {
+            uplink_process_frame(g_afe_frame, PCM_FRAME_SIZE, g_afe_frame_speech);
+            g_afe_frame_len = 0;
+            g_afe_frame_speech = false;
+        }
+    }
+}
+#endif /* CONFIG_AFE_UPLINK_STREAM */
+
 /* ------------------------------------------------------------------ */
 /* Public: Process tick (read, send)                                   */
 /* ------------------------------------------------------------------ */
 
 int voice_recorder_tick(void)
 {
+    /* Continuous AFE mode: the AFE output callback is the ring producer */
+    if (!g_afe_uplink) {
+        uplink_push_end_marker();
+    }
+
     /* Always read audio when wake word detection is enabled */
     int pcm_len = 0;
 
@@ -282,28 +752,40 @@ int voice_recorder_tick(void)
     pcm_len = hal_audio_read(g_pcm_buf, PCM_FRAME_SIZE);
     if (pcm_len < 0) {
         ESP_LOGE(TAG, "Audio read error");
-        g_stats.error_count++;
+        count_error();
         return -1;
     }
     if (pcm_len == 0) {
         return 0;  /* No data available */
     }
+    capture_timing_update();
 
     int16_t *samples = (int16_t *)g_pcm_buf;
     size_t num_samples = pcm_len / 2;  /* 16-bit samples */
 
+#ifdef CONFIG_AEC_BARGE_IN
+    /* Speaker reference for the same span; drained every frame to stay aligned */
+    hal_audio_read_reference(g_ref_buf, (int)num_samples);
+    const int16_t *ref = g_barge_in ? g_ref_buf : NULL;
+#else
+    const int16_t *ref = NULL;
+#endif
+
+    /* Continuous AFE mode: every frame goes through the AFE, whose
+     * NS-processed output is the uplink (see on_afe_audio) */
+    if (g_afe_uplink) {
+        hal_wake_word_feed_with_ref(g_wake_word_ctx, samples, ref, num_samples);
+        taskYIELD();
+        return 0;
+    }
+
     /* Feed wake word detector when idle (local detection, no network) */
     if (g_state == VOICE_STATE_IDLE && g_wake_word_ctx != NULL) {
-        hal_wake_word_feed(g_wake_word_ctx, samples, num_samples);
+        hal_wake_word_feed_with_ref(g_wake_word_ctx, samples, ref, num_samples);
         /* Yield after feed so higher-priority detection task can call fetch()
          * before we loop back. Prevents AFE FEED ring buffer overflow. */
         taskYIELD();
     }
-
-    /* Only send to WebSocket when recording */
-    if (g_state != VOICE_STATE_RECORDING) {
-        return 0;
-    }
 #else
     /* Original behavior: only read when recording */
     if (g_state != VOICE_STATE_RECORDING) {
@@ -313,73 +795,46 @@ int voice_recorder_tick(void)
     pcm_len = hal_audio_read(g_pcm_buf, PCM_FRAME_SIZE);
     if (pcm_len < 0) {
         ESP_LOGE(TAG, "Audio read error");
-        g_stats.error_count++;
+        count_error();
         return -1;
     }
     if (pcm_len == 0) {
         ESP_LOGW(TAG, "Audio read: no data");
         return 0;  /* No data available */
     }
-
-    int16_t *samples = (int16_t *)g_pcm_buf;
-    size_t num_samples = pcm_len / 2;  /* 16-bit samples */
+    capture_timing_update();
 #endif
 
-    /* Audio quality check: calculate RMS and peak */
-    int sample_count = pcm_len / 2;
-    int64_t sum_sq = 0;
-    int16_t peak = 0;
-    int zero_count = 0;
+    return uplink_process_frame(g_pcm_buf, pcm_len, false);
+}
 
-    for (int i = 0; i < sample_count; i++) {
-        int16_t s = samples[i];
-        if (s == 0) zero_count++;
-        if (s < 0) s = -s;  /* abs */
-        sum_sq += (int64_t)s * s;
-        if (s > peak) peak = s;
-    }
+/* ------------------------------------------------------------------ */
+/* Private: Button events                                             */
+/* ------------------------------------------------------------------ */
 
-    int rms = (int)(sum_sq / sample_count);
-    rms = (int)sqrt((double)rms);
+/* Edges from the button poll task, applied by the capture task */
+#define BUTTON_QUEUE_LEN    4
 
-    /* Log every 10 frames */
-    if (g_stats.encode_count % 10 == 0) {
-        ESP_LOGI(TAG, "Audio: frame#%d, rms=%d, peak=%d, zeros=%d/%d",
-                 g_stats.encode_count + 1, rms, peak, zero_count, sample_count);
-    }
+static QueueHandle_t g_button_queue = NULL;
 
-#ifdef CONFIG_ENABLE_WAKE_WORD
-    /* VAD: Check for silence timeout (only in wake word mode) */
-    if (g_vad_enabled && vad_process_frame(rms)) {
-        ESP_LOGI(TAG, "VAD triggered stop - silence timeout");
-        /* Stop recording due to silence timeout */
-        voice_recorder_process_event(VOICE_EVENT_TIMEOUT);
-        display_update("Processing...", "thinking", 0, NULL);
-        return 0;  /* Recording stopped, don't send this frame */
-    }
-#endif
+/* Button poll task: only hand the edge to the capture task, which owns
+ * g_state and the audio start/stop */
+static void button_callback(bool pressed)
+{
+    uint8_t ev = pressed ? 1 : 0;
 
-    /* Send PCM directly via WebSocket (no encoding) */
-    if (ws_send_audio(g_pcm_buf, pcm_len) != 0) {
-        g_stats.error_count++;
-        /* Only log every 10 errors to avoid flooding */
-        if (g_stats.error_count % 10 == 1) {
-            ESP_LOGE(TAG, "WS send audio failed (count: %d)", g_stats.error_count);
-        }
-        return -1;
+    if (!g_button_queue || xQueueSend(g_button_queue, &ev, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Button event dropped");
+        return;
+    }
+    if (g_voice_task_handle) {
+        xTaskNotifyGive(g_voice_task_handle);   /* Wake an idle wait */
     }
-
-    g_stats.encode_count++;
-    return 1;  /* One frame sent */
 }
 
-/* ------------------------------------------------------------------ */
-/* Private: Button callback (called from task context via poll)        */
-/* ------------------------------------------------------------------ */
-
-static void button_callback(bool pressed)
+/* Capture task: apply one button edge to the state machine */
+static void button_apply(bool pressed)
 {
-    /* This is called from task context (via hal_button_poll) */
     if (pressed) {
         if (g_state == VOICE_STATE_IDLE) {
             /* Button triggers recording start */
@@ -408,38 +863,127 @@ static void button_callback(bool pressed)
 /* Private: Voice recorder task                                        */
 /* ------------------------------------------------------------------ */
 
-static TaskHandle_t g_voice_task_handle = NULL;
 static volatile bool g_task_running = false;
 
-/* Tick interval: 60ms for Opus frame size */
-#define TICK_INTERVAL_MS    60
+/* Button poll period (runs in its own task, see hal_button_start) */
+#define BUTTON_POLL_MS      20
 
 static void voice_recorder_task(void *arg)
 {
     ESP_LOGI(TAG, "Voice recorder task started");
 
     while (g_task_running) {
-        /* Poll button state via IO expander */
-        hal_button_poll();
+        uint8_t ev;
+        while (g_button_queue && xQueueReceive(g_button_queue, &ev, 0) == pdTRUE) {
+            button_apply(ev != 0);
+        }
+
+        g_frame_read = false;
 
-        /* Process audio encoding/sending if recording */
+        /* Blocking read of exactly one frame: paced by the I2S clock */
         voice_recorder_tick();
 
-        vTaskDelay(pdMS_TO_TICKS(TICK_INTERVAL_MS));
+        /* No audio read (idle, or audio stopped): wait for start_recording()
+         * or one frame period instead of spinning */
+        if (!g_frame_read) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TICK_INTERVAL_MS));
+        }
     }
 
     g_voice_task_handle = NULL;
     vTaskDelete(NULL);
 }
 
+/* ------------------------------------------------------------------ */
+/* Private: Uplink sender task                                         */
+/* ------------------------------------------------------------------ */
+
+/* Wake at least every two frame periods to detect starvation */
+#define SENDER_WAIT_MS      (2 * TICK_INTERVAL_MS)
+
+/* The Opus encoder runs in the sender task and needs a much deeper stack */
+#ifdef CONFIG_UPLINK_CODEC_OPUS
+#define SENDER_STACK_SIZE   (24 * 1024)
+#else
+#define SENDER_STACK_SIZE   4096
+#endif
+
+static void voice_sender_task(void *arg)
+{
+    ESP_LOGI(TAG, "Voice sender task started");
+
+    while (g_task_running) {
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SENDER_WAIT_MS));
+
+        const uint8_t *frame;
+        int len;
+        if (!notified && g_state == VOICE_STATE_RECORDING &&
+            audio_ring_count(&g_uplink_ring) == 0) {
+            g_stats.ring_underruns++;
+        }
+
+        /* Drain everything queued; the blocking send only stalls this task */
+        while ((frame = audio_ring_peek(&g_uplink_ring, &len)) != NULL) {
+            if (len == UPLINK_END_MARKER) {
+                /* Send the tail of the last encoder frame, then the end marker */
+                uplink_flush();
+                if (ws_send_audio_end() != 0) {
+                    count_error();
+                }
+            } else if (uplink_send(frame, len) < 0) {
+                int errors = count_error();
+                /* Only log every 10 errors to avoid flooding */
+                if (errors % 10 == 1) {
+                    ESP_LOGE(TAG, "WS send audio failed (count: %d)", errors);
+                }
+            } else {
+                g_stats.encode_count++;
+            }
+            audio_ring_release(&g_uplink_ring);
+        }
+    }
+
+    g_sender_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
 /* ------------------------------------------------------------------ */
 /* Private: Wake word callback                                        */
 /* ------------------------------------------------------------------ */
 
 #ifdef CONFIG_ENABLE_WAKE_WORD
+#ifdef CONFIG_AEC_BARGE_IN
+/**
+ * Cut TTS for a detection made during playback. Latency is detection
+ * (callback entry) to speaker muted.
+ */
+static int barge_in(const char *why)
+{
+    int64_t t0 = esp_timer_get_time();
+
+    if (ws_tts_barge_in() != 0) {
+        return -1;
+    }
+
+    int ms = (int)((esp_timer_get_time() - t0) / 1000);
+    g_stats.barge_in_count++;
+    g_stats.barge_in_latency_ms = ms;
+    if (ms > g_stats.barge_in_latency_max_ms) {
+        g_stats.barge_in_latency_max_ms = ms;
+    }
+    ESP_LOGI(TAG, "Barge-in (%s): TTS stopped in %d ms", why, ms);
+    return 0;
+}
+#endif
+
 static void on_wake_word_detected(const char *wake_word, void *user_data)
 {
     ESP_LOGI(TAG, "Wake word detected: %s", wake_word);
+#ifdef CONFIG_AEC_BARGE_IN
+    if (ws_tts_is_playing()) {
+        barge_in("wake word");
+    }
+#endif
     g_recording_triggered_by_wake_word = true;  /* Mark as wake word triggered */
     display_update("Listening...", "listening", 0, NULL);
     voice_recorder_process_event(VOICE_EVENT_WAKE_WORD);
@@ -451,6 +995,12 @@ static int wake_word_setup(void)
         .model_path = NULL,  /* Use default */
         .callback = on_wake_word_detected,
         .user_data = NULL,
+#ifdef CONFIG_AFE_UPLINK_STREAM
+        .afe_stream = true,
+#endif
+#ifdef CONFIG_AEC_BARGE_IN
+        .aec_ref = true,
+#endif
     };
 
 #ifdef CONFIG_WAKE_WORD_CUSTOM
@@ -464,6 +1014,9 @@ static int wake_word_setup(void)
         return -1;
     }
 
+#ifdef CONFIG_AEC_BARGE_IN
+    g_barge_in = true;
+#endif
     hal_wake_word_start(g_wake_word_ctx);
     ESP_LOGI(TAG, "Wake word detection enabled");
     return 0;
@@ -472,11 +1025,16 @@ static int wake_word_setup(void)
 static void wake_word_cleanup(void)
 {
     if (g_wake_word_ctx != NULL) {
+        hal_wake_word_set_audio_callback(g_wake_word_ctx, NULL, NULL);
+        g_afe_uplink = false;
         hal_wake_word_stop(g_wake_word_ctx);
         /* Wait for detection task to finish current fetch */
         vTaskDelay(pdMS_TO_TICKS(50));
         hal_wake_word_deinit(g_wake_word_ctx);
         g_wake_word_ctx = NULL;
+#ifdef CONFIG_AEC_BARGE_IN
+        g_barge_in = false;
+#endif
     }
 }
 #endif /* CONFIG_ENABLE_WAKE_WORD */
@@ -487,7 +1045,26 @@ static void wake_word_cleanup(void)
 
 int voice_recorder_start(void)
 {
+    /* Select uplink codec (Kconfig: Audio Codec Configuration) */
+#ifdef CONFIG_UPLINK_CODEC_OPUS
+    hal_opus_config_t codec_cfg = {
+        .mode = HAL_OPUS_MODE_OPUS,
+        .sample_rate = 16000,
+        .frame_ms = CONFIG_OPUS_FRAME_MS,
+        .bitrate = CONFIG_OPUS_BITRATE,
+        .complexity = CONFIG_OPUS_COMPLEXITY,
+    };
+    if (hal_opus_init(&codec_cfg) != 0) {
+        ESP_LOGW(TAG, "Opus init failed, sending raw PCM");
+    }
+#else
+    hal_opus_init(NULL);
+#endif
+
 #ifdef CONFIG_ENABLE_WAKE_WORD
+    /* End-of-speech detector; learns the noise floor while idle */
+    vad_init();
+
     /* Initialize wake word detector */
     if (wake_word_setup() != 0) {
         ESP_LOGW(TAG, "Wake word setup failed, continuing without wake word");
@@ -501,20 +1078,69 @@ int voice_recorder_start(void)
     }
 #endif
 
-    /* Initialize button via IO expander */
-    if (hal_button_init(button_callback) != 0) {
+    /* Initialize button via IO expander (polled in its own task, events
+     * applied by the capture task) */
+    if (!g_button_queue) {
+        g_button_queue = xQueueCreate(BUTTON_QUEUE_LEN, sizeof(uint8_t));
+    }
+    if (!g_button_queue ||
+        hal_button_init(button_callback) != 0 || hal_button_start(BUTTON_POLL_MS) != 0) {
         ESP_LOGE(TAG, "Button init failed");
         /* Continue anyway - voice recording may still work via other triggers */
     } else {
         ESP_LOGI(TAG, "Button initialized via IO expander");
     }
 
-    /* Start voice recorder task */
+    /* Uplink ring in PSRAM (falls back to inline sending if unavailable) */
+    int ring_size = audio_ring_storage_size(PCM_FRAME_SIZE, UPLINK_RING_FRAMES);
+    if (!g_uplink_ring_mem) {
+        g_uplink_ring_mem = heap_caps_malloc(ring_size, MALLOC_CAP_SPIRAM);
+    }
+    if (g_uplink_ring_mem) {
+        audio_ring_init(&g_uplink_ring, g_uplink_ring_mem, PCM_FRAME_SIZE, UPLINK_RING_FRAMES);
+    } else {
+        ESP_LOGW(TAG, "Uplink ring alloc failed (%d bytes), sending inline", ring_size);
+    }
+
+    /* Pre-roll ring in PSRAM (wake word mode only; audio runs while idle) */
+    if (PREROLL_FRAMES > 0 && !g_preroll_mem) {
+        int preroll_size = audio_ring_storage_size(PCM_FRAME_SIZE, PREROLL_FRAMES);
+        g_preroll_mem = heap_caps_malloc(preroll_size, MALLOC_CAP_SPIRAM);
+        if (g_preroll_mem) {
+            audio_ring_init(&g_preroll, g_preroll_mem, PCM_FRAME_SIZE, PREROLL_FRAMES);
+            ESP_LOGI(TAG, "Pre-roll: %d frames (%d ms)", PREROLL_FRAMES, PREROLL_FRAMES * TICK_INTERVAL_MS);
+        } else {
+            ESP_LOGW(TAG, "Pre-roll alloc failed (%d bytes), disabled", preroll_size);
+        }
+    }
+
     g_task_running = true;
+
+    /* Start sender task (drains the uplink ring, may block on WebSocket) */
+    if (g_uplink_ring_mem &&
+        xTaskCreate(voice_sender_task, "voice_tx", SENDER_STACK_SIZE, NULL, 4,
+                    &g_sender_task_handle) != pdPASS) {
+        ESP_LOGW(TAG, "Sender task create failed, sending inline");
+        g_sender_task_handle = NULL;
+    }
+
+#ifdef CONFIG_AFE_UPLINK_STREAM
+    /* AFE output as uplink; needs the sender task so Opus encoding and
+     * WebSocket sends never run on the AFE fetch task */
+    if (g_wake_word_ctx && g_sender_task_handle &&
+        hal_wake_word_set_audio_callback(g_wake_word_ctx, on_afe_audio, NULL) == 0) {
+        g_afe_uplink = true;
+        ESP_LOGI(TAG, "Uplink: continuous AFE output (NS + VAD)");
+    } else {
+        ESP_LOGW(TAG, "Continuous AFE uplink unavailable, sending raw mic audio");
+    }
+#endif
+
+    /* Start voice recorder (capture) task; it encodes inline without a sender */
     BaseType_t ret = xTaskCreate(
         voice_recorder_task,
         "voice_task",
-        4096,
+        g_sender_task_handle ? 4096 : SENDER_STACK_SIZE,
         NULL,
         5,
         &g_voice_task_handle
@@ -538,6 +1164,10 @@ void voice_recorder_stop(void)
 {
     g_task_running = false;
 
+    if (g_sender_task_handle) {
+        xTaskNotifyGive(g_sender_task_handle);  /* Wake sender so it can exit */
+    }
+
     if (g_voice_task_handle) {
         vTaskDelay(pdMS_TO_TICKS(100));  /* Wait for task to exit */
     }
@@ -557,8 +1187,19 @@ void voice_recorder_stop(void)
 
 void voice_recorder_pause_wake_word(void)
 {
+#ifdef CONFIG_AEC_BARGE_IN
+    /* Echo-cancelled detection keeps listening over TTS for barge-in */
+    if (g_barge_in) {
+        ESP_LOGI(TAG, "TTS starting, wake word stays armed for barge-in");
+        voice_recorder_resume_wake_word();
+        return;
+    }
+#endif
 #ifdef CONFIG_ENABLE_WAKE_WORD
-    if (g_wake_word_ctx != NULL) {
+    if (g_afe_uplink) {
+        ESP_LOGI(TAG, "Pausing wake word detection for TTS (AFE running)");
+        hal_wake_word_pause_detection(g_wake_word_ctx);
+    } else if (g_wake_word_ctx != NULL) {
         ESP_LOGI(TAG, "Pausing wake word detection for TTS");
         hal_wake_word_stop(g_wake_word_ctx);
         /* Wait for detection task to finish current fetch */
@@ -574,7 +1215,10 @@ void voice_recorder_pause_wake_word(void)
 void voice_recorder_resume_wake_word(void)
 {
 #ifdef CONFIG_ENABLE_WAKE_WORD
-    if (g_wake_word_ctx != NULL) {
+    if (g_afe_uplink) {
+        ESP_LOGI(TAG, "Resuming wake word detection");
+        hal_wake_word_resume_detection(g_wake_word_ctx);
+    } else if (g_wake_word_ctx != NULL) {
         ESP_LOGI(TAG, "Resuming wake word detection");
         hal_wake_word_start(g_wake_word_ctx);
     }
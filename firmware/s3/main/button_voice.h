@@ -25,6 +25,21 @@ typedef struct {
     int encode_count;       /* Number of audio frames encoded */
     int error_count;        /* Number of errors */
     int current_state;      /* Current state (voice_state_t) */
+    int pcm_bytes;          /* PCM bytes captured for uplink */
+    int sent_bytes;         /* Bytes sent to WebSocket (after encoding) */
+    int ring_overruns;      /* Frames dropped: uplink ring full (sender stalled) */
+    int ring_underruns;     /* Sender woke while recording but ring was empty */
+    int ring_high_water;    /* Max frames queued in uplink ring */
+    int frame_jitter_avg_us;    /* Mean |read period - 60ms| (EWMA) */
+    int frame_jitter_max_us;    /* Worst |read period - 60ms| */
+    int preroll_frames;     /* Pre-roll frames sent at the last trigger */
+    int vad_noise_floor;    /* VAD noise floor (frame RMS) */
+    int vad_hangover_ms;    /* Hangover in effect at the last VAD endpoint */
+    int aec_erl_db;         /* Echo return loss: speaker reference vs mic (dB) */
+    int aec_erle_db;        /* Echo return loss enhancement of the AFE AEC (dB) */
+    int barge_in_count;     /* TTS replies interrupted */
+    int barge_in_latency_ms;        /* Detection -> speaker muted, last barge-in */
+    int barge_in_latency_max_ms;    /* Max of the above */
 } voice_stats_t;
 
 /**
@@ -43,8 +58,9 @@ voice_state_t voice_recorder_get_state(void);
 void voice_recorder_process_event(voice_event_t event);
 
 /**
- * Process a tick (called periodically to read audio and encode)
- * Should be called at audio frame rate (e.g., every 60ms for Opus)
+ * Process a tick (read one audio frame and queue/send it)
+ * The read blocks for one 60ms frame, so calling this in a loop without
+ * delays keeps capture locked to the I2S clock.
  *
  * @return Number of frames encoded, or -1 on error
  */
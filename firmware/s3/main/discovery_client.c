@@ -10,9 +10,14 @@
 #include "lwip/sockets.h"
 #include "lwip/inet.h"
 #include "cJSON.h"
+#include "json_arena.h"
+#include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <string.h>
+#ifdef CONFIG_DISCOVERY_MDNS
+#include "mdns.h"
+#endif
 
 #define TAG "DISCOVERY"
 
@@ -20,9 +25,23 @@
 #define RX_BUF_SIZE    512
 #define TX_BUF_SIZE    256
 
+/* Cached server (NVS) */
+#define NVS_NAMESPACE  "discovery"
+#define NVS_KEY_SERVER "server"
+
+/* Background discovery */
+#define ASYNC_TASK_STACK  6144
+
+/* cJSON arena for ANNOUNCE replies: internal RAM, a reply needs ~400 B */
+#define JSON_ARENA_SIZE   1024
+
 /* Global state */
 static bool g_initialized = false;
 static server_info_t g_server_info = {0};
+static discovery_found_cb_t g_async_cb = NULL;
+static bool (*g_async_done)(void) = NULL;
+static json_arena_t g_json_arena;
+static uint8_t g_json_buf[JSON_ARENA_SIZE];
 
 /* ------------------------------------------------------------------ */
 /* Helper: Get MAC address string                                      */
@@ -51,7 +70,7 @@ static void get_device_id(char *buf, size_t len)
 /* Helper: Parse ANNOUNCE response                                     */
 /* ------------------------------------------------------------------ */
 
-static int parse_announce(const char *json, server_info_t *info)
+static int parse_announce_json(const char *json, server_info_t *info)
 {
     cJSON *root = cJSON_Parse(json);
     if (!root) {
@@ -98,6 +117,15 @@ static int parse_announce(const char *json, server_info_t *info)
     return 0;
 }
 
+/* Only one discovery runs at a time, so the arena is never shared */
+static int parse_announce(const char *json, server_info_t *info)
+{
+    json_arena_begin(&g_json_arena);
+    int ret = parse_announce_json(json, info);
+    json_arena_end(&g_json_arena);
+    return ret;
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Initialize discovery client                                 */
 /* ------------------------------------------------------------------ */
@@ -105,22 +133,62 @@ static int parse_announce(const char *json, server_info_t *info)
 int discovery_init(void)
 {
     memset(&g_server_info, 0, sizeof(g_server_info));
+    json_arena_init(&g_json_arena, g_json_buf, sizeof(g_json_buf));
     g_initialized = true;
     ESP_LOGI(TAG, "Discovery client initialized");
     return 0;
 }
 
 /* ------------------------------------------------------------------ */
-/* Public: Start service discovery                                     */
+/* Helper: mDNS lookup (fallback when broadcast is filtered)          */
 /* ------------------------------------------------------------------ */
 
-int discovery_start(server_info_t *info)
+#ifdef CONFIG_DISCOVERY_MDNS
+static int discover_mdns(server_info_t *info)
 {
-    if (!g_initialized) {
-        ESP_LOGE(TAG, "Discovery not initialized");
+    esp_err_t err = mdns_init();
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "mDNS init failed: %s", esp_err_to_name(err));
         return -1;
     }
 
+    mdns_result_t *results = NULL;
+    err = mdns_query_ptr(CONFIG_DISCOVERY_MDNS_SERVICE, "_tcp",
+                         DISCOVERY_MDNS_TIMEOUT_MS, 4, &results);
+    if (err != ESP_OK || !results) {
+        ESP_LOGD(TAG, "mDNS: no %s._tcp service", CONFIG_DISCOVERY_MDNS_SERVICE);
+        return -1;
+    }
+
+    int ret = -1;
+    for (mdns_result_t *r = results; r && ret != 0; r = r->next) {
+        for (mdns_ip_addr_t *a = r->addr; a; a = a->next) {
+            if (a->addr.type == ESP_IPADDR_TYPE_V4) {
+                snprintf(info->ip, sizeof(info->ip), IPSTR, IP2STR(&a->addr.u_addr.ip4));
+                info->port = r->port;
+                info->version[0] = '\0';
+                info->discovered = true;
+                ret = 0;
+                break;
+            }
+        }
+    }
+    mdns_query_results_free(results);
+    return ret;
+}
+#endif
+
+/* ------------------------------------------------------------------ */
+/* Helper: Broadcast discovery loop                                   */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Broadcast until a server answers, the timeout expires or done() says the
+ * result is no longer needed. mDNS is tried once after the first silent
+ * broadcast round.
+ */
+static int discover_run(server_info_t *info, bool (*done)(void))
+{
     int sock = -1;
     int ret = -1;
     char tx_buf[TX_BUF_SIZE];
@@ -184,8 +252,16 @@ int discovery_start(server_info_t *info)
 
     int64_t start_time = esp_timer_get_time() / 1000;  /* ms */
     int retry_count = 0;
+#ifdef CONFIG_DISCOVERY_MDNS
+    bool mdns_tried = false;
+#endif
 
     while (1) {
+        if (done && done()) {
+            ESP_LOGI(TAG, "Discovery no longer needed, stopping");
+            break;
+        }
+
         /* Check timeout */
         int64_t elapsed = (esp_timer_get_time() / 1000) - start_time;
         if (elapsed >= DISCOVERY_TIMEOUT_MS) {
@@ -217,13 +293,9 @@ int discovery_start(server_info_t *info)
                      inet_ntoa(from_addr.sin_addr), rx_buf);
 
             /* Parse response */
-            if (parse_announce(rx_buf, &g_server_info) == 0) {
+            if (parse_announce(rx_buf, info) == 0) {
                 ESP_LOGI(TAG, "Discovered server: %s:%u (v%s)",
-                         g_server_info.ip, g_server_info.port, g_server_info.version);
-
-                if (info) {
-                    memcpy(info, &g_server_info, sizeof(server_info_t));
-                }
+                         info->ip, info->port, info->version);
                 ret = 0;
                 break;
             }
@@ -234,6 +306,17 @@ int discovery_start(server_info_t *info)
 
         /* Reset retry count periodically */
         if (retry_count >= DISCOVERY_RETRY_COUNT) {
+#ifdef CONFIG_DISCOVERY_MDNS
+            /* A silent broadcast round: the AP may be filtering it */
+            if (!mdns_tried) {
+                mdns_tried = true;
+                if (discover_mdns(info) == 0) {
+                    ESP_LOGI(TAG, "Discovered server via mDNS: %s:%u", info->ip, info->port);
+                    ret = 0;
+                    break;
+                }
+            }
+#endif
             vTaskDelay(pdMS_TO_TICKS(DISCOVERY_INTERVAL_MS - 1500));
             retry_count = 0;
         }
@@ -243,6 +326,120 @@ int discovery_start(server_info_t *info)
     return ret;
 }
 
+/* ------------------------------------------------------------------ */
+/* Public: Start service discovery                                     */
+/* ------------------------------------------------------------------ */
+
+int discovery_start(server_info_t *info)
+{
+    if (!g_initialized) {
+        ESP_LOGE(TAG, "Discovery not initialized");
+        return -1;
+    }
+
+    server_info_t found = {0};
+    if (discover_run(&found, NULL) != 0) {
+        return -1;
+    }
+
+    g_server_info = found;
+    if (info) {
+        memcpy(info, &g_server_info, sizeof(server_info_t));
+    }
+    return 0;
+}
+
+static void discovery_async_task(void *arg)
+{
+    server_info_t found = {0};
+
+    if (discover_run(&found, g_async_done) == 0) {
+        g_server_info = found;
+        g_async_cb(&g_server_info);
+    } else if (!g_async_done || !g_async_done()) {
+        g_async_cb(NULL);
+    }
+    vTaskDelete(NULL);
+}
+
+int discovery_start_async(discovery_found_cb_t on_found, bool (*done)(void))
+{
+    if (!g_initialized || !on_found) {
+        ESP_LOGE(TAG, "Discovery not initialized");
+        return -1;
+    }
+
+    g_async_cb = on_found;
+    g_async_done = done;
+    if (xTaskCreate(discovery_async_task, "discovery", ASYNC_TASK_STACK, NULL, 4, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create discovery task");
+        return -1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Cached server (NVS)                                         */
+/* ------------------------------------------------------------------ */
+
+int discovery_load_cached(server_info_t *info)
+{
+    nvs_handle_t nvs;
+    server_info_t cached;
+    size_t len = sizeof(cached);
+
+    if (!info || nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return -1;
+    }
+    esp_err_t err = nvs_get_blob(nvs, NVS_KEY_SERVER, &cached, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || len != sizeof(cached) || cached.ip[0] == '\0' || cached.port == 0) {
+        return -1;
+    }
+    cached.ip[sizeof(cached.ip) - 1] = '\0';
+    cached.version[sizeof(cached.version) - 1] = '\0';
+    cached.discovered = true;
+
+    *info = cached;
+    ESP_LOGI(TAG, "Cached server: %s:%u", info->ip, info->port);
+    return 0;
+}
+
+int discovery_save_cached(const server_info_t *info)
+{
+    server_info_t old;
+    nvs_handle_t nvs;
+
+    if (!info || !info->discovered) {
+        return -1;
+    }
+
+    /* Flash wear: the server rarely moves */
+    if (discovery_load_cached(&old) == 0 &&
+        strcmp(old.ip, info->ip) == 0 && old.port == info->port &&
+        strcmp(old.version, info->version) == 0) {
+        return 0;
+    }
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS open failed, server not cached");
+        return -1;
+    }
+    esp_err_t err = nvs_set_blob(nvs, NVS_KEY_SERVER, info, sizeof(*info));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to cache server: %s", esp_err_to_name(err));
+        return -1;
+    }
+    ESP_LOGI(TAG, "Server cached: %s:%u", info->ip, info->port);
+    return 0;
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Get WebSocket URL                                           */
 /* ------------------------------------------------------------------ */
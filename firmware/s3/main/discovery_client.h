@@ -5,6 +5,10 @@
  * Protocol:
  *   ESP32 broadcasts: {"cmd":"DISCOVER","device_id":"xxx","mac":"xx:xx:xx:xx:xx:xx"}
  *   Server responds:  {"cmd":"ANNOUNCE","ip":"x.x.x.x","port":8765,"version":"1.0.0"}
+ *
+ * Fallback: mDNS PTR query for CONFIG_DISCOVERY_MDNS_SERVICE._tcp when the
+ * broadcast round gets no answer. The last good server is kept in NVS so a
+ * reboot can connect straight away and verify in the background.
  */
 
 #ifndef DISCOVERY_CLIENT_H
@@ -18,6 +22,7 @@
 #define DISCOVERY_INTERVAL_MS   5000
 #define DISCOVERY_RETRY_COUNT   3
 #define DISCOVERY_TIMEOUT_MS    30000
+#define DISCOVERY_MDNS_TIMEOUT_MS 2000
 
 /* Server info structure */
 typedef struct {
@@ -45,6 +50,41 @@ int discovery_init(void);
  */
 int discovery_start(server_info_t *info);
 
+/**
+ * @brief Result of a background discovery
+ *
+ * @param info Server found, or NULL if discovery gave up
+ */
+typedef void (*discovery_found_cb_t)(const server_info_t *info);
+
+/**
+ * @brief Run discovery in a background task
+ *
+ * Same broadcast/mDNS sequence as discovery_start(). Stops early, without
+ * calling on_found, once done() returns true (e.g. the WebSocket already
+ * connected to the cached server).
+ *
+ * @param on_found Called from the discovery task
+ * @param done Polled between attempts (may be NULL)
+ * @return 0 if the task started, -1 on error
+ */
+int discovery_start_async(discovery_found_cb_t on_found, bool (*done)(void));
+
+/**
+ * @brief Load the last good server from NVS
+ *
+ * @param info Filled (discovered = true) on success
+ * @return 0 on success, -1 if nothing is cached
+ */
+int discovery_load_cached(server_info_t *info);
+
+/**
+ * @brief Remember a server in NVS (skips the write if unchanged)
+ *
+ * @return 0 on success, -1 on error
+ */
+int discovery_save_cached(const server_info_t *info);
+
 /**
  * @brief Get discovered server URL
  *
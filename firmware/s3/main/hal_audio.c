@@ -1,8 +1,16 @@
 #include "hal_audio.h"
+#include "audio_resampler.h"
 #include "sensecap-watcher.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <string.h>
+#include <stdatomic.h>
+#ifdef CONFIG_AEC_BARGE_IN
+#include "esp_heap_caps.h"
+#endif
 
 #define TAG "HAL_AUDIO"
 
@@ -10,12 +18,145 @@
 #define SAMPLE_RATE_RECORD  16000   /* ASR expects 16kHz */
 #define SAMPLE_RATE_PLAY    24000   /* 火山引擎 TTS uses 24kHz */
 
+/* The codec (shared duplex I2S clock) runs at one fixed rate */
+#ifdef CONFIG_AUDIO_CODEC_SAMPLE_RATE
+#define CODEC_SAMPLE_RATE   CONFIG_AUDIO_CODEC_SAMPLE_RATE
+#else
+#define CODEC_SAMPLE_RATE   SAMPLE_RATE_PLAY
+#endif
+
+/* Resampler work buffers (samples at the codec side, 10ms @ 48kHz) */
+#define RESAMPLE_CHUNK      480
+
 static bool codec_initialized = false;  /* codec init is global, only once */
 static bool is_running = false;         /* current running state */
-static uint32_t current_sample_rate = SAMPLE_RATE_RECORD;  /* current sample rate */
+static uint32_t current_sample_rate = SAMPLE_RATE_PLAY;  /* playback stream rate */
 static esp_codec_dev_handle_t mic_handle = NULL;
 static esp_codec_dev_handle_t speaker_handle = NULL;
 
+/* Codec rate -> 16kHz (capture), stream rate -> codec rate (playback) */
+static audio_resampler_t mic_resampler;
+static audio_resampler_t play_resampler;
+static int16_t mic_raw[RESAMPLE_CHUNK];
+static int16_t play_in[RESAMPLE_CHUNK];
+static int16_t play_out[RESAMPLE_CHUNK + AUDIO_RESAMPLER_MAX_PHASES];
+
+/* Set by hal_audio_abort_playback(), cleared at the next playback start */
+static volatile bool play_aborted = false;
+
+/* ------------------------------------------------------------------ */
+/* Private: Playback drain tracking                                   */
+/* ------------------------------------------------------------------ */
+
+/* Bytes handed to the I2S driver and not yet sent by the DMA. New data is
+ * queued right behind the buffer in flight, so once this reaches 0 the last
+ * sample has left the DAC (to within one DMA buffer). */
+#define DRAIN_FALLBACK_MS   500     /* No sent events: old fixed wait */
+
+static atomic_int tx_pending;
+static bool tx_tracking = false;
+static TaskHandle_t volatile drain_waiter = NULL;
+
+/* I2S ISR: one TX DMA buffer sent (zero fill when idle, so clamp at 0) */
+static void IRAM_ATTR tx_on_sent(size_t bytes, void *user_ctx)
+{
+    int pending = atomic_load_explicit(&tx_pending, memory_order_relaxed);
+    int left;
+
+    (void)user_ctx;
+    do {
+        left = pending > (int)bytes ? pending - (int)bytes : 0;
+    } while (!atomic_compare_exchange_weak_explicit(&tx_pending, &pending, left,
+                                                    memory_order_release, memory_order_relaxed));
+
+    TaskHandle_t waiter = drain_waiter;
+    if (pending > 0 && left == 0 && waiter) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(waiter, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+#ifdef CONFIG_AEC_BARGE_IN
+/* ------------------------------------------------------------------ */
+/* Private: Speaker reference for AEC                                 */
+/* ------------------------------------------------------------------ */
+
+/* What went to the speaker, decimated to 16kHz with the same filter as the
+ * mic path. SPSC: hal_audio_write() pushes, hal_audio_read_reference()
+ * pops one sample per mic sample, so the reference stays in step with the
+ * echo (both are paced by the one I2S clock). */
+#define REF_FIFO_SAMPLES    8192    /* 512ms @ 16kHz, power of 2 */
+
+#ifdef CONFIG_AEC_REF_DELAY_MS
+#define REF_DELAY_SAMPLES   (CONFIG_AEC_REF_DELAY_MS * SAMPLE_RATE_RECORD / 1000)
+#else
+#define REF_DELAY_SAMPLES   0
+#endif
+
+static int16_t *ref_fifo = NULL;
+static atomic_uint ref_head;            /* Samples pushed (writer) */
+static atomic_uint ref_tail;            /* Samples popped (reader) */
+static atomic_uint ref_drop_to;         /* Reader skips to here when ref_drop is set */
+static atomic_bool ref_drop;
+static audio_resampler_t ref_resampler;
+static int16_t ref_chunk[RESAMPLE_CHUNK];
+
+/* Any task: ask the reader to discard everything pushed so far */
+static void ref_flush(void)
+{
+    atomic_store_explicit(&ref_drop_to, atomic_load_explicit(&ref_head, memory_order_acquire),
+                          memory_order_relaxed);
+    atomic_store_explicit(&ref_drop, true, memory_order_release);
+}
+
+static void ref_push(const int16_t *samples, int count)
+{
+    unsigned head = atomic_load_explicit(&ref_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ref_tail, memory_order_acquire);
+    int space = REF_FIFO_SAMPLES - (int)(head - tail);
+
+    /* Reader stalled: drop the newest rather than block playback */
+    if (count > space) {
+        count = space;
+    }
+    for (int i = 0; i < count; i++) {
+        ref_fifo[(head + i) & (REF_FIFO_SAMPLES - 1)] = samples ? samples[i] : 0;
+    }
+    atomic_store_explicit(&ref_head, head + count, memory_order_release);
+}
+
+/* Decimate codec-rate speaker samples and queue them as reference */
+static void ref_push_codec(const int16_t *samples, int count)
+{
+    while (count > 0 && !play_aborted) {
+        int n = audio_resampler_input_len(&ref_resampler, RESAMPLE_CHUNK);
+        if (n > count) {
+            n = count;
+        }
+        int out = audio_resampler_process(&ref_resampler, samples, n, ref_chunk, RESAMPLE_CHUNK);
+        if (out < 0) {
+            return;
+        }
+        ref_push(ref_chunk, out);
+        samples += n;
+        count -= n;
+    }
+}
+
+/* Start of a playback turn: empty the FIFO, then the codec/DMA latency */
+static void ref_start(void)
+{
+    ref_flush();
+    audio_resampler_reset(&ref_resampler);
+    ref_push(NULL, REF_DELAY_SAMPLES);
+}
+
+#define REF_ACTIVE()    (ref_fifo != NULL)
+#else
+#define REF_ACTIVE()    false
+#endif /* CONFIG_AEC_BARGE_IN */
+
 /* Initialize codec once at system startup */
 int hal_audio_init(void)
 {
@@ -48,23 +189,49 @@ int hal_audio_init(void)
     codec_initialized = true;
     is_running = true;  /* Keep codec running always */
 
-    /* Set default sample rate for recording (16kHz) */
-    bsp_codec_set_fs(SAMPLE_RATE_RECORD, 16, 1);
-    current_sample_rate = SAMPLE_RATE_RECORD;
+    /* Fixed codec rate for the lifetime of the device; both directions
+     * are resampled in software instead of reconfiguring the I2S clock */
+    if (audio_resampler_init(&mic_resampler, CODEC_SAMPLE_RATE, SAMPLE_RATE_RECORD) != 0 ||
+        audio_resampler_init(&play_resampler, SAMPLE_RATE_PLAY, CODEC_SAMPLE_RATE) != 0) {
+        ESP_LOGE(TAG, "Unsupported codec rate %d Hz", CODEC_SAMPLE_RATE);
+        return -1;
+    }
+    bsp_codec_set_fs(CODEC_SAMPLE_RATE, 16, 1);
+    current_sample_rate = SAMPLE_RATE_PLAY;
+
+    /* DMA sent events tell when queued playback has actually left the DAC */
+    atomic_init(&tx_pending, 0);
+    tx_tracking = (bsp_i2s_set_tx_sent_callback(tx_on_sent, NULL) == ESP_OK);
+    if (!tx_tracking) {
+        ESP_LOGW(TAG, "No I2S sent events, playback drain uses a fixed %d ms wait",
+                 DRAIN_FALLBACK_MS);
+    }
+
+#ifdef CONFIG_AEC_BARGE_IN
+    /* Speaker reference for the AFE echo canceller (PSRAM) */
+    ref_fifo = heap_caps_calloc(REF_FIFO_SAMPLES, sizeof(int16_t), MALLOC_CAP_SPIRAM);
+    if (!ref_fifo || audio_resampler_init(&ref_resampler, CODEC_SAMPLE_RATE, SAMPLE_RATE_RECORD) != 0) {
+        ESP_LOGW(TAG, "AEC reference unavailable");
+        heap_caps_free(ref_fifo);
+        ref_fifo = NULL;
+    }
+#endif
 
     /* Set volume and unmute (required for speaker output) */
     /* NOTE: Volume 100 can cause clipping distortion, use 80 for cleaner output */
     bsp_codec_mute_set(false);
     bsp_codec_volume_set(80, NULL);
 
-    ESP_LOGI(TAG, "Audio codec initialized (16kHz for recording, volume=100)");
+    ESP_LOGI(TAG, "Audio codec initialized (codec %d Hz, mic -> %d Hz, volume=80)",
+             CODEC_SAMPLE_RATE, SAMPLE_RATE_RECORD);
     return 0;
 }
 
 /* Track audio mode: recording (input) or playback (output) */
 static bool is_playback_mode = false;
 
-/* Set sample rate for playback (call before TTS playback) */
+/* Set the rate of the audio passed to hal_audio_write() (call before TTS playback).
+ * The codec itself stays at CODEC_SAMPLE_RATE; only the resampler changes. */
 void hal_audio_set_sample_rate(uint32_t sample_rate)
 {
     if (!codec_initialized) {
@@ -72,34 +239,39 @@ void hal_audio_set_sample_rate(uint32_t sample_rate)
     }
 
     if (current_sample_rate == sample_rate) {
-        return;  /* No change needed */
+        /* Same stream rate: just drop the previous turn's filter history */
+        audio_resampler_reset(&play_resampler);
+        return;
     }
 
-    ESP_LOGI(TAG, "Switching sample rate: %lu -> %lu (playback_mode=%d)",
-             current_sample_rate, sample_rate, is_playback_mode);
-
-    /* For playback mode, we don't need to stop input channel (which may not be enabled).
-     * Just set the new sample rate directly. */
-    if (is_playback_mode) {
-        /* Set new sample rate (16-bit, mono channel) */
-        bsp_codec_set_fs(sample_rate, 16, 1);
-        current_sample_rate = sample_rate;
-        ESP_LOGI(TAG, "Sample rate switch complete (playback mode, no stop needed)");
+    if (audio_resampler_init(&play_resampler, sample_rate, CODEC_SAMPLE_RATE) != 0) {
+        ESP_LOGE(TAG, "Unsupported playback rate %lu Hz (codec %d Hz)",
+                 sample_rate, CODEC_SAMPLE_RATE);
         return;
     }
 
-    /* For recording mode (input only), we need to reconfigure I2S.
-     * Use bsp_codec_set_fs which handles I2S reconfiguration properly. */
-    bsp_codec_set_fs(sample_rate, 16, 1);
+    ESP_LOGI(TAG, "Playback rate: %lu -> %lu Hz (codec fixed at %d Hz, playback_mode=%d)",
+             current_sample_rate, sample_rate, CODEC_SAMPLE_RATE, is_playback_mode);
     current_sample_rate = sample_rate;
-
-    ESP_LOGI(TAG, "Sample rate switch complete");
 }
 
 /* Mark audio as being used for playback (not just recording) */
 void hal_audio_set_playback_mode(bool enable)
 {
     is_playback_mode = enable;
+
+    if (enable) {
+        /* New playback turn: undo a barge-in abort */
+        if (play_aborted) {
+            play_aborted = false;
+            bsp_codec_mute_set(false);
+        }
+#ifdef CONFIG_AEC_BARGE_IN
+        if (ref_fifo) {
+            ref_start();
+        }
+#endif
+    }
     ESP_LOGI(TAG, "Audio mode: %s", enable ? "playback" : "recording");
 }
 
@@ -118,12 +290,11 @@ int hal_audio_start(void)
 
     /* NOTE: Don't call bsp_codec_dev_resume() here because it uses
      * hardcoded DRV_AUDIO_SAMPLE_RATE (16kHz), which would override
-     * the sample rate we just set in hal_audio_set_sample_rate().
-     * The sample rate is already configured correctly.
+     * the fixed codec rate set in hal_audio_init().
      */
 
     is_running = true;
-    ESP_LOGI(TAG, "Audio started (sample rate: %lu Hz)", current_sample_rate);
+    ESP_LOGI(TAG, "Audio started (codec %d Hz)", CODEC_SAMPLE_RATE);
     return 0;
 }
 
@@ -143,21 +314,67 @@ int hal_audio_read(uint8_t *out_buf, int max_len)
 #endif
     }
 
-    size_t bytes_read = 0;
-    esp_err_t ret = bsp_i2s_read(out_buf, max_len, &bytes_read, 100);
+    int16_t *out = (int16_t *)out_buf;
+    int want = max_len / (int)sizeof(int16_t);
+    int produced = 0;
+
+    /* Read codec-rate chunks and decimate straight into the caller's buffer.
+     * Decimation yields exactly the requested count, so the I2S DMA still
+     * paces the caller (1.5 codec samples per output at 24kHz). */
+    while (produced < want) {
+        int n_in = audio_resampler_input_len(&mic_resampler, want - produced);
+        if (n_in > RESAMPLE_CHUNK) {
+            n_in = RESAMPLE_CHUNK;
+        }
 
-    if (ret != ESP_OK) {
+        size_t bytes_read = 0;
+        esp_err_t ret = bsp_i2s_read(mic_raw, n_in * sizeof(int16_t), &bytes_read, 100);
+
+        if (ret != ESP_OK) {
 #ifdef CONFIG_ENABLE_WAKE_WORD
-        /* In wake word mode, temporary read errors are expected during sample rate switches */
-        ESP_LOGD(TAG, "Read temporarily unavailable: %s", esp_err_to_name(ret));
-        return 0;
+            /* In wake word mode, temporary read errors are not fatal */
+            ESP_LOGD(TAG, "Read temporarily unavailable: %s", esp_err_to_name(ret));
+            return produced * (int)sizeof(int16_t);
 #else
-        ESP_LOGE(TAG, "Read error: %s", esp_err_to_name(ret));
-        return -1;
+            ESP_LOGE(TAG, "Read error: %s", esp_err_to_name(ret));
+            return -1;
 #endif
+        }
+
+        int got = audio_resampler_process(&mic_resampler, mic_raw,
+                                          (int)(bytes_read / sizeof(int16_t)),
+                                          out + produced, want - produced);
+        if (got < 0) {
+            return -1;
+        }
+        produced += got;
+
+        if (bytes_read < n_in * sizeof(int16_t)) {
+            break;  /* Timed out with a short read */
+        }
     }
 
-    return (int)bytes_read;
+    return produced * (int)sizeof(int16_t);
+}
+
+/* Write codec-rate samples, retrying partial DMA writes */
+static int write_codec(const int16_t *samples, int count)
+{
+    size_t bytes_written = 0;
+    size_t len = (size_t)count * sizeof(int16_t);
+
+    ESP_LOGD(TAG, "Writing %d bytes to speaker...", (int)len);
+    /* Count before the write: the DMA may send part of it before we return */
+    atomic_fetch_add_explicit(&tx_pending, (int)len, memory_order_relaxed);
+    esp_err_t ret = bsp_i2s_write((void *)samples, len, &bytes_written, 100);
+    ESP_LOGD(TAG, "Write result: ret=%d, written=%d", ret, (int)bytes_written);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write error: %s", esp_err_to_name(ret));
+        atomic_fetch_sub_explicit(&tx_pending, (int)len, memory_order_relaxed);
+        return -1;
+    }
+    return (int)bytes_written == (int)len ? 0 : -1;
 }
 
 int hal_audio_write(const uint8_t *data, int len)
@@ -167,18 +384,138 @@ int hal_audio_write(const uint8_t *data, int len)
         return -1;
     }
 
-    size_t bytes_written = 0;
+    /* Barge-in: the rest of this turn is dropped, not played */
+    if (play_aborted) {
+        return len;
+    }
+
     /* Use ESP_LOGD for high-frequency audio writes to avoid UART bottleneck */
-    ESP_LOGD(TAG, "Writing %d bytes to speaker...", len);
-    esp_err_t ret = bsp_i2s_write((void *)data, len, &bytes_written, 100);
-    ESP_LOGD(TAG, "Write result: ret=%d, written=%d", ret, (int)bytes_written);
+    if (current_sample_rate == CODEC_SAMPLE_RATE && !REF_ACTIVE()) {
+        size_t bytes_written = 0;
+        ESP_LOGD(TAG, "Writing %d bytes to speaker...", len);
+        atomic_fetch_add_explicit(&tx_pending, len, memory_order_relaxed);
+        esp_err_t ret = bsp_i2s_write((void *)data, len, &bytes_written, 100);
+        ESP_LOGD(TAG, "Write result: ret=%d, written=%d", ret, (int)bytes_written);
+
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Write error: %s", esp_err_to_name(ret));
+            atomic_fetch_sub_explicit(&tx_pending, len, memory_order_relaxed);
+            return -1;
+        }
+        return (int)bytes_written;
+    }
 
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Write error: %s", esp_err_to_name(ret));
-        return -1;
+    /* Resample in small chunks. Input is copied first: WebSocket payloads
+     * are not guaranteed to be 16-bit aligned. */
+    int total = len / (int)sizeof(int16_t);
+    int done = 0;
+
+    while (done < total && !play_aborted) {
+        /* Input that yields at most RESAMPLE_CHUNK (+L/M - 1) codec samples */
+        int n = audio_resampler_input_len(&play_resampler, RESAMPLE_CHUNK);
+        if (n > RESAMPLE_CHUNK) {
+            n = RESAMPLE_CHUNK;
+        }
+        if (n > total - done) {
+            n = total - done;
+        }
+        memcpy(play_in, data + done * sizeof(int16_t), n * sizeof(int16_t));
+
+        int out = audio_resampler_process(&play_resampler, play_in, n, play_out,
+                                          (int)(sizeof(play_out) / sizeof(play_out[0])));
+        if (out < 0 || write_codec(play_out, out) != 0) {
+            break;
+        }
+#ifdef CONFIG_AEC_BARGE_IN
+        if (ref_fifo) {
+            ref_push_codec(play_out, out);
+        }
+#endif
+        done += n;
     }
 
-    return (int)bytes_written;
+    return play_aborted ? len : done * (int)sizeof(int16_t);
+}
+
+void hal_audio_abort_playback(void)
+{
+    if (!codec_initialized || play_aborted) {
+        return;
+    }
+
+    /* Mute first: whatever is still queued in the I2S DMA goes silent now */
+    play_aborted = true;
+    bsp_codec_mute_set(true);
+#ifdef CONFIG_AEC_BARGE_IN
+    if (ref_fifo) {
+        ref_flush();
+    }
+#endif
+    ESP_LOGI(TAG, "Playback aborted (muted until next playback)");
+}
+
+int hal_audio_get_pending_ms(void)
+{
+    int pending = atomic_load_explicit(&tx_pending, memory_order_relaxed);
+    return pending / (CODEC_SAMPLE_RATE / 1000 * (int)sizeof(int16_t));
+}
+
+int hal_audio_wait_drain(uint32_t timeout_ms)
+{
+    if (!tx_tracking) {
+        vTaskDelay(pdMS_TO_TICKS(DRAIN_FALLBACK_MS));
+        return 0;
+    }
+
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    int ret = 0;
+
+    drain_waiter = xTaskGetCurrentTaskHandle();
+    while (atomic_load_explicit(&tx_pending, memory_order_acquire) > 0) {
+        int64_t left_us = deadline - esp_timer_get_time();
+        if (left_us <= 0) {
+            ret = -1;
+            break;
+        }
+        /* Woken by the ISR on the last buffer; other notifications just re-check */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(left_us / 1000) + 1);
+    }
+    drain_waiter = NULL;
+    return ret;
+}
+
+int hal_audio_read_reference(int16_t *out, int count)
+{
+    if (!out || count <= 0) {
+        return 0;
+    }
+
+    int got = 0;
+#ifdef CONFIG_AEC_BARGE_IN
+    if (ref_fifo) {
+        unsigned tail = atomic_load_explicit(&ref_tail, memory_order_relaxed);
+        if (atomic_exchange_explicit(&ref_drop, false, memory_order_acquire)) {
+            unsigned drop_to = atomic_load_explicit(&ref_drop_to, memory_order_relaxed);
+            if ((int)(drop_to - tail) > 0) {
+                tail = drop_to;
+            }
+        }
+
+        unsigned head = atomic_load_explicit(&ref_head, memory_order_acquire);
+        got = (int)(head - tail);
+        if (got > count) {
+            got = count;
+        }
+        for (int i = 0; i < got; i++) {
+            out[i] = ref_fifo[(tail + i) & (REF_FIFO_SAMPLES - 1)];
+        }
+        atomic_store_explicit(&ref_tail, tail + got, memory_order_release);
+    }
+#endif
+
+    /* Nothing playing (or underrun): the speaker is silent too */
+    memset(out + got, 0, (size_t)(count - got) * sizeof(int16_t));
+    return got;
 }
 
 int hal_audio_stop(void)
@@ -16,7 +16,7 @@ int hal_audio_init(void);
 int hal_audio_start(void);
 
 /**
- * Read audio samples from microphone
+ * Read audio samples from microphone (16kHz, resampled from the codec rate)
  * @param out_buf Output buffer
  * @param max_len Maximum length
  * @return Number of bytes read, or -1 on error
@@ -37,7 +37,9 @@ int hal_audio_write(const uint8_t *data, int len);
 int hal_audio_stop(void);
 
 /**
- * Set sample rate for playback (call before TTS playback)
+ * Set the rate of audio passed to hal_audio_write() (call before TTS playback)
+ * The codec runs at a fixed rate (CONFIG_AUDIO_CODEC_SAMPLE_RATE); this only
+ * selects the playback resampler. Reads always return 16kHz.
  * @param sample_rate Sample rate in Hz (e.g., 16000, 24000)
  */
 void hal_audio_set_sample_rate(uint32_t sample_rate);
@@ -48,4 +50,37 @@ void hal_audio_set_sample_rate(uint32_t sample_rate);
  */
 void hal_audio_set_playback_mode(bool enable);
 
+/**
+ * Stop speaker output immediately (barge-in)
+ * Mutes the codec so audio already queued in the I2S DMA is not heard and
+ * drops further hal_audio_write() data until the next
+ * hal_audio_set_playback_mode(true).
+ */
+void hal_audio_abort_playback(void);
+
+/**
+ * Playback still queued in the I2S driver/DMA
+ * @return Milliseconds of audio not yet sent to the DAC
+ */
+int hal_audio_get_pending_ms(void);
+
+/**
+ * Block until everything written has left the DAC (DMA sent events),
+ * returning as soon as the last buffer is sent. Falls back to a fixed
+ * 500ms wait if the BSP provides no sent events.
+ * @param timeout_ms Upper bound on the wait
+ * @return 0 when drained, -1 on timeout
+ */
+int hal_audio_wait_drain(uint32_t timeout_ms);
+
+/**
+ * Read the speaker reference matching the last hal_audio_read() (AEC)
+ * The signal sent to the speaker, at 16kHz, one sample per mic sample.
+ * Zero-filled when nothing is playing or CONFIG_AEC_BARGE_IN is off.
+ * @param out Output buffer (count samples, always filled)
+ * @param count Number of samples
+ * @return Number of samples that came from actual playback
+ */
+int hal_audio_read_reference(int16_t *out, int count);
+
 #endif /* HAL_AUDIO_H */
@@ -18,9 +18,16 @@
 /* Debounce time in ms */
 #define DEBOUNCE_MS             50
 
+/* Poll task (button handling off the audio capture path) */
+#define POLL_TASK_STACK         3072
+#define POLL_TASK_PRIORITY      6
+
 static button_callback_t g_callback = NULL;
 static bool g_is_pressed = false;
 static int64_t g_last_change_time = 0;
+static TaskHandle_t g_poll_task = NULL;
+static volatile bool g_poll_running = false;
+static int g_poll_ms = 20;
 
 /* Poll button state (called from task context) */
 void hal_button_poll(void)
@@ -49,6 +56,47 @@ void hal_button_poll(void)
     }
 }
 
+/*
+ * Poll task: fixed-rate, independent of audio frame timing.
+ * The PCA9535 driver caches the input register and only re-reads it over
+ * I2C after the expander INT line fires, so polling is cheap.
+ */
+static void button_poll_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t period = pdMS_TO_TICKS(g_poll_ms);
+    if (period == 0) {
+        period = 1;
+    }
+
+    while (g_poll_running) {
+        hal_button_poll();
+        vTaskDelayUntil(&last_wake, period);
+    }
+
+    g_poll_task = NULL;
+    vTaskDelete(NULL);
+}
+
+int hal_button_start(int poll_ms)
+{
+    if (g_poll_task) {
+        return 0;
+    }
+
+    g_poll_ms = (poll_ms > 0) ? poll_ms : 20;
+    g_poll_running = true;
+    if (xTaskCreate(button_poll_task, "button", POLL_TASK_STACK, NULL,
+                    POLL_TASK_PRIORITY, &g_poll_task) != pdPASS) {
+        ESP_LOGE(TAG, "Button poll task create failed");
+        g_poll_running = false;
+        return -1;
+    }
+
+    ESP_LOGI(TAG, "Button poll task started (%d ms)", g_poll_ms);
+    return 0;
+}
+
 int hal_button_init(button_callback_t callback)
 {
     ESP_LOGI(TAG, "Initializing button via IO Expander...");
@@ -88,5 +136,6 @@ bool hal_button_is_pressed(void)
 void hal_button_deinit(void)
 {
     /* Don't delete IO expander handle - it's managed by SDK */
+    g_poll_running = false;  /* Poll task exits on its next period */
     g_callback = NULL;
 }
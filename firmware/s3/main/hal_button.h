@@ -30,7 +30,15 @@ bool hal_button_is_pressed(void);
 void hal_button_poll(void);
 
 /**
- * Deinitialize button GPIO
+ * Start a dedicated poll task (callback runs in that task's context)
+ * Keeps button handling out of the audio capture loop.
+ * @param poll_ms Poll period in ms (debounce is DEBOUNCE_MS on top)
+ * @return 0 on success, -1 on error
+ */
+int hal_button_start(int poll_ms);
+
+/**
+ * Deinitialize button GPIO (also stops the poll task)
  */
 void hal_button_deinit(void);
 
@@ -1,31 +1,83 @@
 #include "hal_opus.h"
+#include "opus_codec.h"
 #include "esp_log.h"
 #include <string.h>
 
-#define TAG "HAL_PCM"
+#define TAG "HAL_OPUS"
 
 /**
  * @file hal_opus.c
- * @brief Audio codec HAL - PCM passthrough implementation
+ * @brief Audio codec HAL - PCM passthrough / Opus implementation
  *
- * MVP simplification: Direct PCM transmission without any encoding.
- * This reduces complexity and CPU usage on the ESP32-S3.
+ * PCM passthrough (default):
+ * - Pros: Simple implementation, no CPU overhead
+ * - Cons: ~256 kbps uplink, stalls on congested WiFi
  *
- * Trade-offs:
- * - Pros: Simple implementation, no CPU overhead, no codec library dependency
- * - Cons: Higher bandwidth (~10x compared to Opus), no noise reduction
+ * Opus (CONFIG_UPLINK_CODEC_OPUS):
+ * - VOIP application mode, VBR, voice signal hint
+ * - 20/40/60 ms frames, ~16-32 kbps at default settings
+ * - Downlink: one packet per TTS binary frame, decoded to 24kHz PCM
  *
  * PCM format: 16-bit signed, 16kHz sample rate, mono
  * Frame size: 60ms = 960 samples = 1920 bytes
- * Bandwidth: ~256 kbps (vs ~24 kbps with Opus)
  */
 
-int hal_opus_init(void)
+static hal_opus_mode_t g_mode = HAL_OPUS_MODE_PCM;
+static opus_codec_enc_t *g_encoder = NULL;
+static int g_frame_bytes = 0;
+
+static hal_opus_mode_t g_dec_mode = HAL_OPUS_MODE_PCM;
+static opus_codec_dec_t *g_decoder = NULL;
+
+int hal_opus_init(const hal_opus_config_t *config)
 {
-    ESP_LOGI(TAG, "Audio codec initialized (PCM passthrough mode)");
+    hal_opus_deinit();
+
+    if (!config || config->mode == HAL_OPUS_MODE_PCM) {
+        ESP_LOGI(TAG, "Audio codec initialized (PCM passthrough mode)");
+        return 0;
+    }
+
+    opus_codec_enc_config_t enc_cfg = {
+        .sample_rate = config->sample_rate,
+        .frame_ms    = config->frame_ms,
+        .bitrate     = config->bitrate,
+        .complexity  = config->complexity,
+    };
+
+    g_encoder = opus_codec_enc_create(&enc_cfg);
+    if (!g_encoder) {
+        ESP_LOGE(TAG, "Opus encoder init failed (rate=%d, frame=%dms), using PCM",
+                 config->sample_rate, config->frame_ms);
+        return -1;
+    }
+
+    g_frame_bytes = opus_codec_enc_frame_samples(g_encoder) * (int)sizeof(int16_t);
+    g_mode = HAL_OPUS_MODE_OPUS;
+
+    ESP_LOGI(TAG, "Audio codec initialized (Opus VOIP, %dms frames, %d bps, complexity %d)",
+             config->frame_ms, config->bitrate, config->complexity);
     return 0;
 }
 
+void hal_opus_deinit(void)
+{
+    opus_codec_enc_destroy(g_encoder);
+    g_encoder = NULL;
+    g_frame_bytes = 0;
+    g_mode = HAL_OPUS_MODE_PCM;
+}
+
+hal_opus_mode_t hal_opus_get_mode(void)
+{
+    return g_mode;
+}
+
+int hal_opus_get_frame_bytes(void)
+{
+    return g_frame_bytes;
+}
+
 int hal_opus_encode(const uint8_t *pcm_in, int pcm_len,
                     uint8_t *out_buf, int out_max_len)
 {
@@ -33,6 +85,18 @@ int hal_opus_encode(const uint8_t *pcm_in, int pcm_len,
         return -1;
     }
 
+    if (g_mode == HAL_OPUS_MODE_OPUS) {
+        if (pcm_len != g_frame_bytes) {
+            ESP_LOGW(TAG, "Opus frame size mismatch: %d (expected %d)", pcm_len, g_frame_bytes);
+            return -1;
+        }
+
+        int out_len = opus_codec_encode(g_encoder, (const int16_t *)pcm_in,
+                                        out_buf, out_max_len);
+        ESP_LOGD(TAG, "Opus encode: %d -> %d bytes", pcm_len, out_len);
+        return out_len;
+    }
+
     /* PCM passthrough: just copy the data */
     int out_len = (pcm_len < out_max_len) ? pcm_len : out_max_len;
     memcpy(out_buf, pcm_in, out_len);
@@ -41,6 +105,38 @@ int hal_opus_encode(const uint8_t *pcm_in, int pcm_len,
     return out_len;
 }
 
+int hal_opus_decoder_init(hal_opus_mode_t mode, int sample_rate)
+{
+    hal_opus_decoder_deinit();
+
+    if (mode == HAL_OPUS_MODE_PCM) {
+        ESP_LOGI(TAG, "Audio decoder initialized (PCM passthrough mode)");
+        return 0;
+    }
+
+    g_decoder = opus_codec_dec_create(sample_rate);
+    if (!g_decoder) {
+        ESP_LOGE(TAG, "Opus decoder init failed (rate=%d), using PCM", sample_rate);
+        return -1;
+    }
+
+    g_dec_mode = HAL_OPUS_MODE_OPUS;
+    ESP_LOGI(TAG, "Audio decoder initialized (Opus, %d Hz)", sample_rate);
+    return 0;
+}
+
+void hal_opus_decoder_deinit(void)
+{
+    opus_codec_dec_destroy(g_decoder);
+    g_decoder = NULL;
+    g_dec_mode = HAL_OPUS_MODE_PCM;
+}
+
+hal_opus_mode_t hal_opus_get_decoder_mode(void)
+{
+    return g_dec_mode;
+}
+
 int hal_opus_decode(const uint8_t *in_data, int in_len,
                     uint8_t *pcm_out, int pcm_max_len)
 {
@@ -48,6 +144,17 @@ int hal_opus_decode(const uint8_t *in_data, int in_len,
         return -1;
     }
 
+    if (g_dec_mode == HAL_OPUS_MODE_OPUS) {
+        int samples = opus_codec_decode(g_decoder, in_data, in_len, (int16_t *)pcm_out,
+                                        pcm_max_len / (int)sizeof(int16_t));
+        if (samples < 0) {
+            ESP_LOGW(TAG, "Opus decode failed (%d bytes)", in_len);
+            return -1;
+        }
+        ESP_LOGD(TAG, "Opus decode: %d -> %d samples", in_len, samples);
+        return samples * (int)sizeof(int16_t);
+    }
+
     /* PCM passthrough: just copy the data */
     int out_len = (in_len < pcm_max_len) ? in_len : pcm_max_len;
     memcpy(pcm_out, in_data, out_len);
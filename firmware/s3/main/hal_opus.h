@@ -5,22 +5,59 @@
 
 /**
  * @file hal_opus.h
- * @brief Audio codec HAL - PCM passthrough mode (no compression)
+ * @brief Audio codec HAL - PCM passthrough or Opus encoding
  *
- * MVP simplification: Direct PCM transmission without encoding.
- * Frame format: 16-bit, 16kHz, mono PCM.
+ * PCM mode: Direct PCM transmission without encoding (default, MVP).
+ * Opus mode: VOIP-tuned Opus, one packet per 20/40/60 ms frame.
+ *
+ * Uplink (encode) and downlink (decode) modes are selected independently.
  *
- * Future: Can be upgraded to Opus codec when needed.
+ * Frame format: 16-bit, 16kHz, mono PCM.
  */
 
+/* Largest packet produced by one encoded frame (RFC 6716) */
+#define HAL_OPUS_MAX_PACKET     1276
+
+/* Codec mode */
+typedef enum {
+    HAL_OPUS_MODE_PCM = 0,      /* Passthrough (raw PCM) */
+    HAL_OPUS_MODE_OPUS,         /* Opus encoding */
+} hal_opus_mode_t;
+
+/* Codec configuration */
+typedef struct {
+    hal_opus_mode_t mode;
+    int sample_rate;            /* Hz (16000 for uplink) */
+    int frame_ms;               /* 20, 40 or 60 */
+    int bitrate;                /* bits per second */
+    int complexity;             /* 0 (fastest) - 10 (best) */
+} hal_opus_config_t;
+
 /**
  * Initialize audio codec
- * @return 0 on success, -1 on error
+ * @param config Codec configuration (NULL = PCM passthrough)
+ * @return 0 on success, -1 on error (codec falls back to PCM passthrough)
+ */
+int hal_opus_init(const hal_opus_config_t *config);
+
+/**
+ * Release encoder resources and return to PCM passthrough
+ */
+void hal_opus_deinit(void);
+
+/**
+ * Get active codec mode
  */
-int hal_opus_init(void);
+hal_opus_mode_t hal_opus_get_mode(void);
 
 /**
- * Process audio for transmission (passthrough - no encoding)
+ * Get PCM bytes consumed per encoded frame
+ * @return Frame size in bytes (Opus mode), or 0 in PCM mode (any length)
+ */
+int hal_opus_get_frame_bytes(void);
+
+/**
+ * Process audio for transmission
  * @param pcm_in Input PCM data (16-bit, 16kHz, mono)
  * @param pcm_len Length of PCM data in bytes
  * @param out_buf Output buffer
@@ -28,19 +65,39 @@ int hal_opus_init(void);
  * @return Output bytes on success, -1 on error
  *
  * Note: In PCM mode, this is a simple memcpy passthrough.
+ *       In Opus mode, pcm_len must equal hal_opus_get_frame_bytes().
  */
 int hal_opus_encode(const uint8_t *pcm_in, int pcm_len,
                     uint8_t *out_buf, int out_max_len);
 
 /**
- * Process received audio for playback (passthrough - no decoding)
- * @param in_data Input audio data
+ * Select downlink (TTS) codec
+ * @param mode HAL_OPUS_MODE_PCM or HAL_OPUS_MODE_OPUS
+ * @param sample_rate Playback rate in Hz (24000 for TTS)
+ * @return 0 on success, -1 on error (decoder falls back to PCM passthrough)
+ */
+int hal_opus_decoder_init(hal_opus_mode_t mode, int sample_rate);
+
+/**
+ * Release decoder resources and return to PCM passthrough
+ */
+void hal_opus_decoder_deinit(void);
+
+/**
+ * Get active downlink codec mode
+ */
+hal_opus_mode_t hal_opus_get_decoder_mode(void);
+
+/**
+ * Process received audio for playback
+ * @param in_data Input audio data (raw PCM or one Opus packet)
  * @param in_len Length of input data in bytes
  * @param pcm_out Output buffer for PCM data
  * @param pcm_max_len Max output buffer size
  * @return Output bytes on success, -1 on error
  *
  * Note: In PCM mode, this is a simple memcpy passthrough.
+ *       In Opus mode, pcm_max_len should hold 120 ms at the decoder rate.
  */
 int hal_opus_decode(const uint8_t *in_data, int in_len,
                     uint8_t *pcm_out, int pcm_max_len);
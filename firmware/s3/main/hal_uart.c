@@ -1,5 +1,6 @@
 #include "hal_uart.h"
 #include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
 #include "esp_log.h"
 
 #define TAG "HAL_UART"
@@ -66,3 +67,12 @@ int hal_uart_send(const uint8_t *data, int len)
 
     return sent;
 }
+
+int hal_uart_wait_tx_done(int timeout_ms)
+{
+    if (!is_initialized) {
+        return -1;
+    }
+
+    return uart_wait_tx_done(UART_NUM, pdMS_TO_TICKS(timeout_ms)) == ESP_OK ? 0 : -1;
+}
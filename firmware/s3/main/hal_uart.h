@@ -16,4 +16,11 @@ int hal_uart_init(void);
  */
 int hal_uart_send(const uint8_t *data, int len);
 
+/**
+ * Wait until everything written has left the TX pin
+ * @param timeout_ms Maximum wait
+ * @return 0 when done, -1 on timeout or error
+ */
+int hal_uart_wait_tx_done(int timeout_ms);
+
 #endif /* HAL_UART_H */
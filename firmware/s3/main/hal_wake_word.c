@@ -14,6 +14,7 @@
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "esp_heap_caps.h"
+#include <math.h>
 #include <string.h>
 
 #define TAG "HAL_WAKE_WORD"
@@ -36,8 +37,11 @@
 #define MAX_WAKE_WORDS         16
 #define MAX_WAKE_WORD_LEN      32
 #define DETECTION_TASK_STACK   4096
+#define STREAM_TASK_STACK      6144  /* Continuous mode: audio callback runs here */
 #define DETECTION_TASK_PRIO    6
 #define INPUT_BUFFER_CAPACITY  2048  /* samples */
+#define AEC_FLAG_SLOTS         32    /* Fed chunks awaiting fetch (power of 2) */
+#define AEC_EWMA_SHIFT         5     /* Energy averaging: 32 chunks (~1s) */
 
 /* ------------------------------------------------------------------ */
 /* Context Structure                                                */
@@ -57,6 +61,12 @@ struct wake_word_ctx_s {
     wake_word_callback_t callback;
     void *user_data;
 
+    /* Continuous mode */
+    bool afe_stream;
+    volatile bool wakenet_active;
+    wake_word_audio_callback_t audio_callback;
+    void *audio_user_data;
+
     /* Wake word info */
     char wake_words[MAX_WAKE_WORDS][MAX_WAKE_WORD_LEN];
     int wake_word_count;
@@ -69,8 +79,70 @@ struct wake_word_ctx_s {
     /* Input buffer (for accumulating partial feeds) */
     int16_t *input_buffer;
     size_t input_buffer_size;
+
+    /* AEC ("MR" input): per-chunk energies while the reference is active.
+     * Feed and fetch run on different tasks; flags[] tells fetch whether
+     * the chunk it gets back was fed with a live reference. */
+    bool aec;
+    float mic_energy;                 /* Echo + near end at the mic */
+    float ref_energy;                 /* Speaker reference */
+    float out_energy;                 /* After AEC */
+    uint32_t ref_chunks;
+    uint8_t aec_flags[AEC_FLAG_SLOTS];
+    volatile uint32_t feed_seq;
+    volatile uint32_t fetch_seq;
 };
 
+/* ------------------------------------------------------------------ */
+/* Private: AEC measurement                                           */
+/* ------------------------------------------------------------------ */
+
+static float chunk_energy(const int16_t *samples, int count, int stride)
+{
+    float sum = 0.0f;
+
+    for (int i = 0; i < count; i++) {
+        float x = samples[i * stride];
+        sum += x * x;
+    }
+    return count > 0 ? sum / (float)count : 0.0f;
+}
+
+static void energy_update(float *avg, float value)
+{
+    *avg += (value - *avg) / (float)(1 << AEC_EWMA_SHIFT);
+}
+
+/* Feed side: one interleaved MR chunk about to go to the AFE */
+static void aec_account_feed(wake_word_ctx_t *ctx, const int16_t *chunk)
+{
+    float ref = chunk_energy(chunk + 1, ctx->feed_chunk_size, 2);
+    bool active = ref > 0.0f;
+
+    if (active) {
+        energy_update(&ctx->mic_energy, chunk_energy(chunk, ctx->feed_chunk_size, 2));
+        energy_update(&ctx->ref_energy, ref);
+        ctx->ref_chunks++;
+    }
+    ctx->aec_flags[ctx->feed_seq & (AEC_FLAG_SLOTS - 1)] = active;
+    ctx->feed_seq++;
+}
+
+/* Fetch side: AEC output for the oldest fed chunk */
+static void aec_account_fetch(wake_word_ctx_t *ctx, const afe_fetch_result_t *res)
+{
+    if (ctx->fetch_seq == ctx->feed_seq) {
+        return;  /* Out of step after a reset */
+    }
+    bool active = ctx->aec_flags[ctx->fetch_seq & (AEC_FLAG_SLOTS - 1)];
+    ctx->fetch_seq++;
+
+    if (active && res->data != NULL && res->data_size > 0) {
+        energy_update(&ctx->out_energy,
+                      chunk_energy(res->data, res->data_size / (int)sizeof(int16_t), 1));
+    }
+}
+
 /* ------------------------------------------------------------------ */
 /* Private: Detection Task                                             */
 /* ------------------------------------------------------------------ */
@@ -107,10 +179,27 @@ static void detection_task(void *arg)
             continue;
         }
 
+        if (ctx->aec) {
+            aec_account_fetch(ctx, res);
+        }
+
+        /* Continuous mode: processed audio goes out before the wake callback,
+         * so the chunk containing the end of the wake word is not lost */
+        wake_word_audio_callback_t audio_cb = ctx->audio_callback;
+        if (audio_cb != NULL && res->data != NULL && res->data_size > 0) {
+            audio_cb(res->data, (size_t)res->data_size / sizeof(int16_t),
+                     res->vad_state == VAD_SPEECH, ctx->audio_user_data);
+        }
+
         /* Check for wake word detection */
         if (res->wakeup_state == WAKENET_DETECTED) {
-            /* Stop detection while handling callback */
-            xEventGroupClearBits(ctx->event_group, DETECTION_RUNNING_BIT);
+            /* Stop detection while handling callback; continuous mode
+             * keeps the AFE running and only mutes WakeNet */
+            if (ctx->afe_stream) {
+                hal_wake_word_pause_detection(ctx);
+            } else {
+                xEventGroupClearBits(ctx->event_group, DETECTION_RUNNING_BIT);
+            }
 
             /* Get detected wake word */
             int model_index = res->wakenet_model_index - 1;
@@ -201,6 +290,9 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
     /* Store callback */
     ctx->callback = config->callback;
     ctx->user_data = config->user_data;
+    ctx->afe_stream = config->afe_stream;
+    ctx->aec = config->aec_ref;
+    ctx->wakenet_active = true;
 
     /* Create event group */
     ctx->event_group = xEventGroupCreate();
@@ -258,8 +350,8 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
     }
 
     /* Configure AFE */
-    /* Single microphone, no reference channel */
-    const char *input_format = "M";  /* M = microphone, R = reference */
+    /* Single microphone; with AEC, interleaved speaker reference */
+    const char *input_format = ctx->aec ? "MR" : "M";  /* M = microphone, R = reference */
 
     afe_config_t *afe_config = afe_config_init(input_format, ctx->models, AFE_TYPE_SR, AFE_MODE_HIGH_PERF);
     if (afe_config == NULL) {
@@ -271,11 +363,27 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
     }
 
     /* Configure AFE for ESP32-S3 with PSRAM */
-    afe_config->aec_init = false;             /* No acoustic echo cancellation */
+    afe_config->aec_init = ctx->aec;          /* Echo cancellation needs the R channel */
     afe_config->afe_perferred_core = 1;       /* Run on core 1 */
     afe_config->afe_perferred_priority = 3;    /* Medium priority */
     afe_config->memory_alloc_mode = AFE_MEMORY_ALLOC_MORE_PSRAM;  /* Use PSRAM */
 
+    /* Continuous mode: the output is also the uplink, so clean it up */
+    if (ctx->afe_stream) {
+        char *ns_model = esp_srmodel_filter(ctx->models, ESP_NSNET_PREFIX, NULL);
+        afe_config->ns_init = true;
+        afe_config->ns_model_name = ns_model;
+        afe_config->afe_ns_mode = ns_model ? AFE_NS_MODE_NET : AFE_NS_MODE_WEBRTC;
+        afe_config->vad_init = true;
+        afe_config->vad_mode = VAD_MODE_0;
+        afe_config->vad_min_noise_ms = 100;
+#ifdef CONFIG_AFE_UPLINK_AGC
+        afe_config->agc_init = true;
+        afe_config->agc_mode = AFE_AGC_MODE_WEBRTC;
+#endif
+        ESP_LOGI(TAG, "Continuous AFE: NS=%s, VAD on", ns_model ? ns_model : "webrtc");
+    }
+
     /* Get AFE interface */
     ctx->afe_iface = esp_afe_handle_from_config(afe_config);
     if (ctx->afe_iface == NULL) {
@@ -300,9 +408,10 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
 
     /* Get feed chunk size */
     ctx->feed_chunk_size = ctx->afe_iface->get_feed_chunksize(ctx->afe_data);
-    ctx->input_channels = 1;  /* Single channel */
+    ctx->input_channels = ctx->aec ? 2 : 1;  /* Mic (+ reference) */
 
-    ESP_LOGI(TAG, "AFE initialized, feed chunk size: %d samples", ctx->feed_chunk_size);
+    ESP_LOGI(TAG, "AFE initialized, feed chunk size: %d samples, format %s, AEC %s",
+             ctx->feed_chunk_size, input_format, ctx->aec ? "on" : "off");
 
     /* Allocate input buffer */
     ctx->input_buffer = (int16_t *)heap_caps_calloc(INPUT_BUFFER_CAPACITY, sizeof(int16_t), MALLOC_CAP_SPIRAM);
@@ -323,7 +432,7 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
     BaseType_t ret = xTaskCreate(
         detection_task,
         "wake_detect",
-        DETECTION_TASK_STACK,
+        ctx->afe_stream ? STREAM_TASK_STACK : DETECTION_TASK_STACK,
         ctx,
         DETECTION_TASK_PRIO,
         &ctx->detection_task
@@ -347,35 +456,41 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config)
 /* Public: Feed Audio                                                 */
 /* ------------------------------------------------------------------ */
 
-void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num_samples)
+/* Append frames to the input buffer (interleaving the reference in MR
+ * mode) and feed every complete chunk to the AFE */
+static void feed_frames(wake_word_ctx_t *ctx, const int16_t *mic, const int16_t *ref,
+                        size_t num_samples)
 {
-    if (ctx == NULL || samples == NULL || num_samples == 0) {
-        return;
-    }
-
-    /* Check if detection is running */
-    if (!(xEventGroupGetBits(ctx->event_group) & DETECTION_RUNNING_BIT)) {
-        return;  /* Detection is stopped */
-    }
-
-    /* Accumulate samples in input buffer */
-    size_t samples_needed = num_samples;
-    size_t samples_offset = 0;
-
-    while (samples_needed > 0) {
-        /* Calculate how much we can add to buffer */
-        size_t space_available = INPUT_BUFFER_CAPACITY - ctx->input_buffer_size;
-        size_t samples_to_add = (samples_needed < space_available) ? samples_needed : space_available;
+    const size_t channels = (size_t)ctx->input_channels;
+    const size_t chunk_size = ctx->feed_chunk_size * channels;
+    size_t offset = 0;
+
+    while (offset < num_samples) {
+        /* Calculate how many frames we can add to buffer */
+        size_t frames_free = (INPUT_BUFFER_CAPACITY - ctx->input_buffer_size) / channels;
+        size_t frames = num_samples - offset;
+        if (frames > frames_free) {
+            frames = frames_free;
+        }
 
         /* Copy samples to buffer */
-        memcpy(&ctx->input_buffer[ctx->input_buffer_size], &samples[samples_offset], samples_to_add * sizeof(int16_t));
-        ctx->input_buffer_size += samples_to_add;
-        samples_offset += samples_to_add;
-        samples_needed -= samples_to_add;
+        int16_t *dst = &ctx->input_buffer[ctx->input_buffer_size];
+        if (channels == 1) {
+            memcpy(dst, &mic[offset], frames * sizeof(int16_t));
+        } else {
+            for (size_t i = 0; i < frames; i++) {
+                dst[2 * i] = mic[offset + i];
+                dst[2 * i + 1] = ref ? ref[offset + i] : 0;
+            }
+        }
+        ctx->input_buffer_size += frames * channels;
+        offset += frames;
 
         /* Feed chunks to AFE */
-        size_t chunk_size = ctx->feed_chunk_size * ctx->input_channels;
         while (ctx->input_buffer_size >= chunk_size) {
+            if (ctx->aec) {
+                aec_account_feed(ctx, ctx->input_buffer);
+            }
             ctx->afe_iface->feed(ctx->afe_data, ctx->input_buffer);
 
             /* Notify detection_task that new data has been fed
@@ -395,6 +510,26 @@ void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num
     }
 }
 
+void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num_samples)
+{
+    hal_wake_word_feed_with_ref(ctx, samples, NULL, num_samples);
+}
+
+void hal_wake_word_feed_with_ref(wake_word_ctx_t *ctx, const int16_t *mic, const int16_t *ref,
+                                 size_t num_samples)
+{
+    if (ctx == NULL || mic == NULL || num_samples == 0) {
+        return;
+    }
+
+    /* Check if detection is running */
+    if (!(xEventGroupGetBits(ctx->event_group) & DETECTION_RUNNING_BIT)) {
+        return;  /* Detection is stopped */
+    }
+
+    feed_frames(ctx, mic, ref, num_samples);
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Start/Stop                                                 */
 /* ------------------------------------------------------------------ */
@@ -430,10 +565,84 @@ void hal_wake_word_stop(wake_word_ctx_t *ctx)
     if (ctx->afe_data != NULL && ctx->afe_iface != NULL) {
         ctx->afe_iface->reset_buffer(ctx->afe_data);
     }
+    ctx->fetch_seq = ctx->feed_seq;  /* Nothing left in flight */
 
     ESP_LOGI(TAG, "Wake word detection stopped");
 }
 
+void hal_wake_word_pause_detection(wake_word_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+
+    if (!ctx->afe_stream) {
+        hal_wake_word_stop(ctx);
+        return;
+    }
+
+    if (ctx->wakenet_active) {
+        ctx->afe_iface->disable_wakenet(ctx->afe_data);
+        ctx->wakenet_active = false;
+        ESP_LOGI(TAG, "Wake word detection paused (AFE running)");
+    }
+}
+
+void hal_wake_word_resume_detection(wake_word_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+
+    if (!ctx->afe_stream) {
+        hal_wake_word_start(ctx);
+        return;
+    }
+
+    if (!ctx->wakenet_active) {
+        ctx->afe_iface->enable_wakenet(ctx->afe_data);
+        ctx->wakenet_active = true;
+        ESP_LOGI(TAG, "Wake word detection resumed");
+    }
+}
+
+int hal_wake_word_set_audio_callback(wake_word_ctx_t *ctx, wake_word_audio_callback_t callback,
+                                     void *user_data)
+{
+    if (ctx == NULL || !ctx->afe_stream) {
+        return -1;
+    }
+
+    /* user_data first: the detection task reads the callback pointer */
+    ctx->audio_user_data = user_data;
+    ctx->audio_callback = callback;
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: AEC Statistics                                             */
+/* ------------------------------------------------------------------ */
+
+static int energy_ratio_db(float num, float den)
+{
+    if (num <= 0.0f || den <= 0.0f) {
+        return 0;
+    }
+    return (int)lrintf(10.0f * log10f(num / den));
+}
+
+int hal_wake_word_get_aec_stats(wake_word_ctx_t *ctx, wake_word_aec_stats_t *out)
+{
+    if (ctx == NULL || out == NULL || !ctx->aec) {
+        return -1;
+    }
+
+    out->erl_db = energy_ratio_db(ctx->ref_energy, ctx->mic_energy);
+    out->erle_db = energy_ratio_db(ctx->mic_energy, ctx->out_energy);
+    out->ref_chunks = ctx->ref_chunks;
+    return 0;
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Get Feed Size                                              */
 /* ------------------------------------------------------------------ */
@@ -569,6 +778,22 @@ void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num
     (void)num_samples;
 }
 
+void hal_wake_word_feed_with_ref(wake_word_ctx_t *ctx, const int16_t *mic, const int16_t *ref,
+                                 size_t num_samples)
+{
+    (void)ctx;
+    (void)mic;
+    (void)ref;
+    (void)num_samples;
+}
+
+int hal_wake_word_get_aec_stats(wake_word_ctx_t *ctx, wake_word_aec_stats_t *out)
+{
+    (void)ctx;
+    (void)out;
+    return -1;
+}
+
 void hal_wake_word_start(wake_word_ctx_t *ctx)
 {
     (void)ctx;
@@ -579,6 +804,25 @@ void hal_wake_word_stop(wake_word_ctx_t *ctx)
     (void)ctx;
 }
 
+void hal_wake_word_pause_detection(wake_word_ctx_t *ctx)
+{
+    (void)ctx;
+}
+
+void hal_wake_word_resume_detection(wake_word_ctx_t *ctx)
+{
+    (void)ctx;
+}
+
+int hal_wake_word_set_audio_callback(wake_word_ctx_t *ctx, wake_word_audio_callback_t callback,
+                                     void *user_data)
+{
+    (void)ctx;
+    (void)callback;
+    (void)user_data;
+    return -1;
+}
+
 size_t hal_wake_word_get_feed_size(wake_word_ctx_t *ctx)
 {
     (void)ctx;
@@ -15,6 +15,15 @@
  *                                    Wake Word Detected?
  *                                              ↓
  *                                       callback()
+ *
+ * Continuous mode (afe_stream = true): the AFE also runs noise suppression
+ * and VAD and is never stopped. Every fetch() output chunk is handed to the
+ * audio callback, so the same processed stream serves wake detection and
+ * the uplink. Pausing detection only mutes WakeNet.
+ *
+ * AEC mode (aec_ref = true): input is "MR" - each mic sample is paired with
+ * the speaker reference (hal_wake_word_feed_with_ref) so the AFE cancels
+ * the device's own TTS and detection can keep running during playback.
  */
 
 #ifndef HAL_WAKE_WORD_H
@@ -45,6 +54,17 @@ typedef struct wake_word_ctx_s wake_word_ctx_t;
  */
 typedef void (*wake_word_callback_t)(const char *wake_word, void *user_data);
 
+/**
+ * Processed audio callback (continuous mode, runs on the detection task)
+ *
+ * @param samples AFE output, 16-bit PCM 16kHz mono (noise suppressed)
+ * @param num_samples Number of samples (fetch chunk size)
+ * @param speech AFE VAD state for this chunk
+ * @param user_data User-provided context pointer
+ */
+typedef void (*wake_word_audio_callback_t)(const int16_t *samples, size_t num_samples,
+                                           bool speech, void *user_data);
+
 /* ------------------------------------------------------------------ */
 /* Configuration                                                      */
 /* ------------------------------------------------------------------ */
@@ -58,8 +78,19 @@ typedef struct {
     float detection_threshold;        /*!< Detection threshold (0.0-1.0), lower = more sensitive */
     wake_word_callback_t callback;    /*!< Callback when wake word is detected */
     void *user_data;                  /*!< User data passed to callback */
+    bool afe_stream;                  /*!< Continuous mode: enable NS/VAD, never reset the AFE */
+    bool aec_ref;                     /*!< "MR" input with speaker reference, AEC enabled */
 } wake_word_config_t;
 
+/**
+ * Echo cancellation statistics (AEC mode, averaged over ~1s of playback)
+ */
+typedef struct {
+    int erl_db;                       /*!< Echo return loss: reference vs mic level */
+    int erle_db;                      /*!< Echo return loss enhancement: mic vs AEC output */
+    uint32_t ref_chunks;              /*!< Feed chunks with an active reference */
+} wake_word_aec_stats_t;
+
 /* ------------------------------------------------------------------ */
 /* Core API                                                           */
 /* ------------------------------------------------------------------ */
@@ -88,6 +119,20 @@ wake_word_ctx_t *hal_wake_word_init(const wake_word_config_t *config);
  */
 void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num_samples);
 
+/**
+ * Feed microphone audio with the matching speaker reference (AEC mode)
+ *
+ * Without AEC the reference is ignored; with AEC a NULL reference is
+ * treated as silence.
+ *
+ * @param ctx Context handle
+ * @param mic 16-bit PCM microphone samples (16kHz, mono)
+ * @param ref 16-bit PCM speaker reference, same length (may be NULL)
+ * @param num_samples Number of samples per channel
+ */
+void hal_wake_word_feed_with_ref(wake_word_ctx_t *ctx, const int16_t *mic, const int16_t *ref,
+                                 size_t num_samples);
+
 /**
  * Start wake word detection
  *
@@ -108,6 +153,44 @@ void hal_wake_word_start(wake_word_ctx_t *ctx);
  */
 void hal_wake_word_stop(wake_word_ctx_t *ctx);
 
+/**
+ * Pause wake word detection
+ *
+ * Continuous mode: only WakeNet is disabled; feed/fetch and the audio
+ * callback keep running, nothing is reset. Otherwise same as
+ * hal_wake_word_stop().
+ *
+ * @param ctx Context handle
+ */
+void hal_wake_word_pause_detection(wake_word_ctx_t *ctx);
+
+/**
+ * Resume wake word detection after hal_wake_word_pause_detection()
+ *
+ * @param ctx Context handle
+ */
+void hal_wake_word_resume_detection(wake_word_ctx_t *ctx);
+
+/**
+ * Set the processed audio callback (continuous mode only)
+ *
+ * @param ctx Context handle
+ * @param callback Callback, or NULL to stop delivering audio
+ * @param user_data User data passed to callback
+ * @return 0 on success, -1 if not in continuous mode
+ */
+int hal_wake_word_set_audio_callback(wake_word_ctx_t *ctx, wake_word_audio_callback_t callback,
+                                     void *user_data);
+
+/**
+ * Get echo cancellation statistics
+ *
+ * @param ctx Context handle
+ * @param out Statistics
+ * @return 0 on success, -1 if AEC is not enabled
+ */
+int hal_wake_word_get_aec_stats(wake_word_ctx_t *ctx, wake_word_aec_stats_t *out);
+
 /**
  * Get required feed size
  *
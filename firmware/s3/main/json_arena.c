@@ -0,0 +1,132 @@
+/**
+ * @file json_arena.c
+ * @brief Per-message bump allocator for cJSON implementation
+ */
+
+#include "json_arena.h"
+#include "cJSON.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* Arena current in this task (head of the nesting chain) */
+static __thread json_arena_t *t_arena;
+
+static atomic_uint g_heap_allocs;
+
+/* ------------------------------------------------------------------ */
+/* Private: cJSON hooks                                               */
+/* ------------------------------------------------------------------ */
+
+static bool owned(const json_arena_t *a, const void *ptr)
+{
+    const uint8_t *p = ptr;
+    return p >= a->buf && p < a->buf + a->cap;
+}
+
+static void *arena_malloc(size_t size)
+{
+    json_arena_t *a = t_arena;
+
+    if (a) {
+        size_t need = (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+        if (need <= a->cap - a->used) {
+            void *p = a->buf + a->used;
+            a->used += (uint32_t)need;
+            a->stats.allocs++;
+            if (a->used > a->stats.peak) {
+                a->stats.peak = a->used;
+            }
+            return p;
+        }
+        a->stats.spills++;
+    }
+
+    atomic_fetch_add(&g_heap_allocs, 1);
+    return malloc(size);
+}
+
+static void arena_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    /* Arena blocks are released all at once by json_arena_end() */
+    for (const json_arena_t *a = t_arena; a; a = a->prev) {
+        if (owned(a, ptr)) {
+            return;
+        }
+    }
+    free(ptr);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Setup                                                      */
+/* ------------------------------------------------------------------ */
+
+void json_arena_install(void)
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = arena_malloc,
+        .free_fn = arena_free,
+    };
+    cJSON_InitHooks(&hooks);
+}
+
+int json_arena_init(json_arena_t *arena, void *buf, uint32_t size)
+{
+    if (!arena || !buf || size < JSON_ARENA_ALIGN) {
+        return -1;
+    }
+
+    /* Align the start so every block is aligned */
+    uintptr_t start = ((uintptr_t)buf + JSON_ARENA_ALIGN - 1) & ~(uintptr_t)(JSON_ARENA_ALIGN - 1);
+    arena->buf = (uint8_t *)start;
+    arena->cap = size - (uint32_t)(start - (uintptr_t)buf);
+    arena->used = 0;
+    arena->prev = NULL;
+    arena->stats = (json_arena_stats_t){0};
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Scope                                                      */
+/* ------------------------------------------------------------------ */
+
+void json_arena_begin(json_arena_t *arena)
+{
+    if (!arena || arena == t_arena) {
+        return;
+    }
+    arena->prev = t_arena;
+    arena->used = 0;
+    t_arena = arena;
+}
+
+void json_arena_end(json_arena_t *arena)
+{
+    if (!arena || t_arena != arena) {
+        return;
+    }
+    t_arena = arena->prev;
+    arena->prev = NULL;
+    arena->used = 0;
+    arena->stats.scopes++;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Statistics                                                 */
+/* ------------------------------------------------------------------ */
+
+void json_arena_get_stats(const json_arena_t *arena, json_arena_stats_t *out)
+{
+    if (arena && out) {
+        *out = arena->stats;
+    }
+}
+
+uint32_t json_arena_heap_allocs(void)
+{
+    return atomic_load(&g_heap_allocs);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file json_arena.h
+ * @brief Per-message bump allocator for cJSON (platform independent)
+ *
+ * Every cJSON node, key and string is a separate malloc/free; under steady
+ * traffic the short-lived blocks fragment internal RAM that WiFi/LWIP and
+ * DMA descriptors also need. With the hooks installed, a call site opens an
+ * arena around one parse and everything cJSON allocates meanwhile comes
+ * from that arena's buffer (PSRAM or internal, the caller's choice):
+ *
+ *   json_arena_begin(&arena);
+ *   cJSON *root = cJSON_Parse(text);
+ *   ...
+ *   cJSON_Delete(root);             // no-op for arena blocks
+ *   json_arena_end(&arena);         // whole arena reset at once
+ *
+ * The current arena is per task (thread-local), so other tasks keep using
+ * the heap. An arena that runs out spills to the heap instead of failing.
+ * Trees built inside an arena must be deleted (or dropped) before
+ * json_arena_end(); cJSON_Delete() on an arena block after that would hand
+ * it to free().
+ */
+
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define JSON_ARENA_ALIGN        8       /* cJSON nodes hold a double */
+
+typedef struct {
+    uint32_t scopes;            /* begin/end pairs */
+    uint32_t allocs;            /* Served from the arena */
+    uint32_t spills;            /* Arena full: went to the heap */
+    uint32_t peak;              /* High-water bytes in one scope */
+} json_arena_stats_t;
+
+typedef struct json_arena {
+    uint8_t *buf;
+    uint32_t cap;
+    uint32_t used;
+    struct json_arena *prev;    /* Arena current before begin (nesting) */
+    json_arena_stats_t stats;
+} json_arena_t;
+
+/**
+ * Install the arena-aware allocator as the cJSON hooks (once, at boot)
+ */
+void json_arena_install(void);
+
+/**
+ * Bind an arena to caller-provided storage (static, stack or heap_caps)
+ * @return 0 on success, -1 on bad args
+ */
+int json_arena_init(json_arena_t *arena, void *buf, uint32_t size);
+
+/**
+ * Route this task's cJSON allocations to the arena until json_arena_end()
+ */
+void json_arena_begin(json_arena_t *arena);
+
+/**
+ * Release everything allocated since begin and restore the previous arena
+ */
+void json_arena_end(json_arena_t *arena);
+
+void json_arena_get_stats(const json_arena_t *arena, json_arena_stats_t *out);
+
+/**
+ * cJSON allocations that went to the heap (no arena current, or spilled)
+ */
+uint32_t json_arena_heap_allocs(void);
+
+#endif /* JSON_ARENA_H */
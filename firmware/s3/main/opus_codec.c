@@ -0,0 +1,142 @@
+/**
+ * @file opus_codec.c
+ * @brief Opus encoder/decoder wrapper implementation
+ */
+
+#include "opus_codec.h"
+#include "opus.h"
+#include <stdlib.h>
+
+/* ------------------------------------------------------------------ */
+/* Private: Codec contexts                                            */
+/* ------------------------------------------------------------------ */
+
+struct opus_codec_enc_s {
+    OpusEncoder *enc;
+    int frame_samples;
+};
+
+struct opus_codec_dec_s {
+    OpusDecoder *dec;
+};
+
+/* ------------------------------------------------------------------ */
+/* Private: Validate parameters                                       */
+/* ------------------------------------------------------------------ */
+
+static bool is_valid_sample_rate(int rate)
+{
+    return rate == 8000 || rate == 12000 || rate == 16000 ||
+           rate == 24000 || rate == 48000;
+}
+
+static bool is_valid_frame_ms(int frame_ms)
+{
+    return frame_ms == 20 || frame_ms == 40 || frame_ms == 60;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Encoder                                                    */
+/* ------------------------------------------------------------------ */
+
+opus_codec_enc_t *opus_codec_enc_create(const opus_codec_enc_config_t *config)
+{
+    if (!config || !is_valid_sample_rate(config->sample_rate) ||
+        !is_valid_frame_ms(config->frame_ms)) {
+        return NULL;
+    }
+
+    opus_codec_enc_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    int err = OPUS_OK;
+    ctx->enc = opus_encoder_create(config->sample_rate, 1, OPUS_APPLICATION_VOIP, &err);
+    if (err != OPUS_OK || !ctx->enc) {
+        free(ctx);
+        return NULL;
+    }
+
+    int complexity = config->complexity;
+    if (complexity < 0) complexity = 0;
+    if (complexity > 10) complexity = 10;
+
+    opus_encoder_ctl(ctx->enc, OPUS_SET_BITRATE(config->bitrate));
+    opus_encoder_ctl(ctx->enc, OPUS_SET_COMPLEXITY(complexity));
+    opus_encoder_ctl(ctx->enc, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+    opus_encoder_ctl(ctx->enc, OPUS_SET_VBR(1));
+
+    ctx->frame_samples = config->sample_rate / 1000 * config->frame_ms;
+    return ctx;
+}
+
+int opus_codec_enc_frame_samples(const opus_codec_enc_t *enc)
+{
+    return enc ? enc->frame_samples : 0;
+}
+
+int opus_codec_encode(opus_codec_enc_t *enc, const int16_t *pcm,
+                      uint8_t *out, int out_max)
+{
+    if (!enc || !pcm || !out || out_max <= 0) {
+        return -1;
+    }
+
+    opus_int32 len = opus_encode(enc->enc, pcm, enc->frame_samples, out, out_max);
+    return (len < 0) ? -1 : (int)len;
+}
+
+void opus_codec_enc_destroy(opus_codec_enc_t *enc)
+{
+    if (!enc) {
+        return;
+    }
+    opus_encoder_destroy(enc->enc);
+    free(enc);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Decoder                                                    */
+/* ------------------------------------------------------------------ */
+
+opus_codec_dec_t *opus_codec_dec_create(int sample_rate)
+{
+    if (!is_valid_sample_rate(sample_rate)) {
+        return NULL;
+    }
+
+    opus_codec_dec_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+
+    int err = OPUS_OK;
+    ctx->dec = opus_decoder_create(sample_rate, 1, &err);
+    if (err != OPUS_OK || !ctx->dec) {
+        free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+int opus_codec_decode(opus_codec_dec_t *dec, const uint8_t *data, int len,
+                      int16_t *pcm, int max_samples)
+{
+    if (!dec || !pcm || max_samples <= 0 || (data && len <= 0)) {
+        return -1;
+    }
+
+    int samples = opus_decode(dec->dec, data, data ? len : 0, pcm, max_samples, 0);
+    return (samples < 0) ? -1 : samples;
+}
+
+void opus_codec_dec_destroy(opus_codec_dec_t *dec)
+{
+    if (!dec) {
+        return;
+    }
+    opus_decoder_destroy(dec->dec);
+    free(dec);
+}
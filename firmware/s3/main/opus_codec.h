@@ -0,0 +1,105 @@
+/**
+ * @file opus_codec.h
+ * @brief Opus encoder/decoder wrapper (platform independent)
+ *
+ * Thin C wrapper around libopus used by hal_opus.c. It has no ESP-IDF
+ * dependencies so the same code runs in the host benchmarks.
+ *
+ * Audio format: 16-bit signed PCM, mono.
+ */
+
+#ifndef OPUS_CODEC_H
+#define OPUS_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Largest packet a single Opus frame can produce (RFC 6716) */
+#define OPUS_CODEC_MAX_PACKET   1276
+
+/* ------------------------------------------------------------------ */
+/* Encoder                                                            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Opaque encoder handle
+ */
+typedef struct opus_codec_enc_s opus_codec_enc_t;
+
+/**
+ * Encoder configuration
+ */
+typedef struct {
+    int sample_rate;    /*!< 8000, 12000, 16000, 24000 or 48000 Hz */
+    int frame_ms;       /*!< Frame duration: 20, 40 or 60 ms */
+    int bitrate;        /*!< Target bitrate in bits per second */
+    int complexity;     /*!< 0 (fastest) - 10 (best quality) */
+} opus_codec_enc_config_t;
+
+/**
+ * Create an encoder in VOIP mode
+ * @param config Encoder configuration
+ * @return Encoder handle, or NULL on invalid config / allocation failure
+ */
+opus_codec_enc_t *opus_codec_enc_create(const opus_codec_enc_config_t *config);
+
+/**
+ * Get number of PCM samples consumed per encoded frame
+ * @param enc Encoder handle
+ * @return Samples per frame, or 0 if enc is NULL
+ */
+int opus_codec_enc_frame_samples(const opus_codec_enc_t *enc);
+
+/**
+ * Encode exactly one frame
+ * @param enc Encoder handle
+ * @param pcm Input samples (opus_codec_enc_frame_samples() of them)
+ * @param out Output packet buffer
+ * @param out_max Output buffer size in bytes
+ * @return Packet length in bytes, or -1 on error
+ */
+int opus_codec_encode(opus_codec_enc_t *enc, const int16_t *pcm,
+                      uint8_t *out, int out_max);
+
+/**
+ * Destroy encoder (NULL is allowed)
+ */
+void opus_codec_enc_destroy(opus_codec_enc_t *enc);
+
+/* ------------------------------------------------------------------ */
+/* Decoder                                                            */
+/* ------------------------------------------------------------------ */
+
+/* Longest frame a single packet may carry (120 ms) */
+#define OPUS_CODEC_MAX_FRAME_MS 120
+
+/**
+ * Opaque decoder handle
+ */
+typedef struct opus_codec_dec_s opus_codec_dec_t;
+
+/**
+ * Create a mono decoder
+ * @param sample_rate Output rate: 8000, 12000, 16000, 24000 or 48000 Hz
+ * @return Decoder handle, or NULL on invalid rate / allocation failure
+ */
+opus_codec_dec_t *opus_codec_dec_create(int sample_rate);
+
+/**
+ * Decode one packet
+ * @param dec Decoder handle
+ * @param data Opus packet (NULL = packet loss concealment)
+ * @param len Packet length in bytes
+ * @param pcm Output samples
+ * @param max_samples Capacity of pcm in samples
+ * @return Decoded samples, or -1 on error (corrupt packet / buffer too small)
+ */
+int opus_codec_decode(opus_codec_dec_t *dec, const uint8_t *data, int len,
+                      int16_t *pcm, int max_samples);
+
+/**
+ * Destroy decoder (NULL is allowed)
+ */
+void opus_codec_dec_destroy(opus_codec_dec_t *dec);
+
+#endif /* OPUS_CODEC_H */
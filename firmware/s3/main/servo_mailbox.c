@@ -0,0 +1,192 @@
+/**
+ * @file servo_mailbox.c
+ * @brief Latest-wins servo target mailbox implementation
+ */
+
+#include "servo_mailbox.h"
+#include "uart_frame.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char axis_name[SERVO_AXES] = { 'X', 'Y' };
+
+/* ------------------------------------------------------------------ */
+/* Private: Helpers                                                   */
+/* ------------------------------------------------------------------ */
+
+static int clamp_angle(int angle)
+{
+    if (angle < 0) return 0;
+    if (angle > 180) return 180;
+    return angle;
+}
+
+/* Mark the slot sent and account its latency */
+static void mark_sent(servo_mailbox_t *mb, int axis, uint32_t now_ms)
+{
+    servo_mailbox_slot_t *s = &mb->slot[axis];
+    uint32_t latency = now_ms - s->t_ms;
+    mb->latency_sum_ms += latency;
+    mb->latency_n++;
+    if (latency > mb->stats.latency_max_ms) {
+        mb->stats.latency_max_ms = latency;
+    }
+
+    s->pending = false;
+}
+
+/* One ASCII line per axis: "X:<angle>:<duration>\r\n" */
+static int build_ascii(const servo_mailbox_t *mb, const bool *sel, char *buf, int size)
+{
+    int len = 0;
+    for (int axis = 0; axis < SERVO_AXES; axis++) {
+        if (sel[axis]) {
+            const servo_mailbox_slot_t *s = &mb->slot[axis];
+            len += snprintf(buf + len, size - len, "%c:%d:%d\r\n",
+                            axis_name[axis], s->angle, s->time_ms);
+        }
+    }
+    return len;
+}
+
+/* One binary frame carrying every selected axis */
+static int build_binary(servo_mailbox_t *mb, const bool *sel, char *buf, int size)
+{
+    uart_frame_axis_t axes[SERVO_AXES];
+    int n = 0;
+
+    for (int axis = 0; axis < SERVO_AXES; axis++) {
+        if (sel[axis]) {
+            const servo_mailbox_slot_t *s = &mb->slot[axis];
+            int t = s->time_ms < 0 ? 0 : (s->time_ms > 0xFFFF ? 0xFFFF : s->time_ms);
+            axes[n].axis = axis == SERVO_AXIS_X ? UART_FRAME_AXIS_X : UART_FRAME_AXIS_Y;
+            axes[n].angle_x10 = (uint16_t)(s->angle * 10);
+            axes[n].duration_ms = (uint16_t)t;
+            n++;
+        }
+    }
+    return uart_frame_encode_servo(mb->seq++, axes, n, (uint8_t *)buf, size);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init                                                       */
+/* ------------------------------------------------------------------ */
+
+void servo_mailbox_init(servo_mailbox_t *mb, uint32_t pair_window_ms)
+{
+    if (mb) {
+        memset(mb, 0, sizeof(*mb));
+        mb->pair_window_ms = pair_window_ms;
+    }
+}
+
+void servo_mailbox_set_binary(servo_mailbox_t *mb, bool binary)
+{
+    if (mb) {
+        mb->binary = binary;
+    }
+}
+
+int servo_mailbox_axis(const char *id)
+{
+    if (!id) {
+        return -1;
+    }
+    if ((id[0] == 'x' || id[0] == 'X') && id[1] == '\0') {
+        return SERVO_AXIS_X;
+    }
+    if ((id[0] == 'y' || id[0] == 'Y') && id[1] == '\0') {
+        return SERVO_AXIS_Y;
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Post / Take                                                */
+/* ------------------------------------------------------------------ */
+
+int servo_mailbox_post(servo_mailbox_t *mb, int axis, int angle, int time_ms, uint32_t now_ms)
+{
+    if (!mb) {
+        return -1;
+    }
+    if (axis < 0 || axis >= SERVO_AXES) {
+        mb->stats.dropped++;
+        return -1;
+    }
+
+    servo_mailbox_slot_t *s = &mb->slot[axis];
+    int replaced = s->pending;
+
+    if (replaced) {
+        mb->stats.coalesced++;
+    } else {
+        s->pending = true;
+        s->since_ms = now_ms;
+    }
+    s->angle = clamp_angle(angle);
+    s->time_ms = time_ms;
+    s->t_ms = now_ms;
+    mb->stats.posted++;
+    return replaced;
+}
+
+int servo_mailbox_take(servo_mailbox_t *mb, uint32_t now_ms, char *buf, int size, int *wait_ms)
+{
+    int dummy;
+    if (!wait_ms) {
+        wait_ms = &dummy;
+    }
+    *wait_ms = -1;
+    if (!mb || !buf || size < SERVO_MAILBOX_FRAME_MAX) {
+        return 0;
+    }
+
+    bool x = mb->slot[SERVO_AXIS_X].pending;
+    bool y = mb->slot[SERVO_AXIS_Y].pending;
+    if (!x && !y) {
+        return 0;
+    }
+
+    /* Lone target: give its partner a moment to arrive */
+    if (!x || !y) {
+        const servo_mailbox_slot_t *s = &mb->slot[x ? SERVO_AXIS_X : SERVO_AXIS_Y];
+        uint32_t age = now_ms - s->since_ms;
+        if (age < mb->pair_window_ms) {
+            *wait_ms = (int)(mb->pair_window_ms - age);
+            return 0;
+        }
+    }
+
+    const bool sel[SERVO_AXES] = { x, y };
+    int len = mb->binary ? build_binary(mb, sel, buf, size) : build_ascii(mb, sel, buf, size);
+    for (int axis = 0; axis < SERVO_AXES; axis++) {
+        if (sel[axis]) {
+            mark_sent(mb, axis, now_ms);
+        }
+    }
+
+    mb->stats.frames++;
+    if (x && y) {
+        mb->stats.paired++;
+    }
+    *wait_ms = 0;
+    return len;
+}
+
+void servo_mailbox_send_failed(servo_mailbox_t *mb)
+{
+    if (mb) {
+        mb->stats.dropped++;
+    }
+}
+
+void servo_mailbox_get_stats(const servo_mailbox_t *mb, servo_mailbox_stats_t *out)
+{
+    if (!mb || !out) {
+        return;
+    }
+
+    *out = mb->stats;
+    out->latency_avg_ms = mb->latency_n ? (uint32_t)(mb->latency_sum_ms / mb->latency_n) : 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file servo_mailbox.h
+ * @brief Latest-wins servo target mailbox (platform independent)
+ *
+ * The server can stream servo targets faster than 115200 baud and the
+ * servos can follow. Instead of queueing every command, each axis holds
+ * one pending target: a newer target overwrites it until the UART is free
+ * again, so what goes on the wire is always the latest intent and
+ * command-to-wire latency stays bounded by one frame.
+ *
+ * When both axes are pending they leave as one write
+ * ("X:<a>:<t>\r\nY:<b>:<t>\r\n"), so the head moves on both axes at once.
+ * A lone target waits up to pair_window_ms for its partner (the server
+ * sends X and Y back to back) before it is sent by itself.
+ *
+ * In binary mode the same frame is a COBS/CRC-16 servo frame (uart_frame.h)
+ * with a rolling sequence number instead of ASCII lines.
+ *
+ * Not thread safe: the caller serializes post/take (one lock).
+ */
+
+#ifndef SERVO_MAILBOX_H
+#define SERVO_MAILBOX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    SERVO_AXIS_X = 0,
+    SERVO_AXIS_Y,
+    SERVO_AXES
+} servo_axis_t;
+
+/* Largest wire frame (both axes, ASCII or binary) */
+#define SERVO_MAILBOX_FRAME_MAX 48
+
+typedef struct {
+    uint32_t posted;            /* Targets accepted */
+    uint32_t coalesced;         /* Overwritten before reaching the wire */
+    uint32_t dropped;           /* Rejected (bad axis) or failed to send */
+    uint32_t frames;            /* Writes handed to the UART */
+    uint32_t paired;            /* ...of which carried both axes */
+    uint32_t latency_max_ms;    /* Post to take, target actually sent */
+    uint32_t latency_avg_ms;
+} servo_mailbox_stats_t;
+
+typedef struct {
+    bool pending;
+    int angle;
+    int time_ms;
+    uint32_t t_ms;              /* Post time of the current target */
+    uint32_t since_ms;          /* Pending since (pair window start) */
+} servo_mailbox_slot_t;
+
+typedef struct {
+    servo_mailbox_slot_t slot[SERVO_AXES];
+    uint32_t pair_window_ms;
+    bool binary;                /* uart_frame.h frames instead of ASCII */
+    uint8_t seq;                /* Next binary frame sequence number */
+    servo_mailbox_stats_t stats;
+    uint64_t latency_sum_ms;
+    uint32_t latency_n;
+} servo_mailbox_t;
+
+void servo_mailbox_init(servo_mailbox_t *mb, uint32_t pair_window_ms);
+
+/**
+ * Select the wire format of taken frames (ASCII by default)
+ */
+void servo_mailbox_set_binary(servo_mailbox_t *mb, bool binary);
+
+/**
+ * Axis of a v2.1 servo id ("x"/"X" or "y"/"Y")
+ * @return Axis, or -1 for anything else
+ */
+int servo_mailbox_axis(const char *id);
+
+/**
+ * Set an axis's pending target (angle clamped to 0-180)
+ * @return 1 if it replaced a pending target, 0 if the slot was free,
+ *         -1 on a bad axis (counted as a drop)
+ */
+int servo_mailbox_post(servo_mailbox_t *mb, int axis, int angle, int time_ms, uint32_t now_ms);
+
+/**
+ * Take the pending targets as one wire frame, once the UART is free
+ * @param buf At least SERVO_MAILBOX_FRAME_MAX bytes
+ * @param wait_ms Set to -1 if nothing is pending, 0 if a frame was taken,
+ *                otherwise how long a lone target still waits for its pair
+ * @return Frame length, 0 if nothing is due yet
+ */
+int servo_mailbox_take(servo_mailbox_t *mb, uint32_t now_ms, char *buf, int size, int *wait_ms);
+
+/**
+ * A taken frame could not be written (counted as a drop)
+ */
+void servo_mailbox_send_failed(servo_mailbox_t *mb);
+
+void servo_mailbox_get_stats(const servo_mailbox_t *mb, servo_mailbox_stats_t *out);
+
+#endif /* SERVO_MAILBOX_H */
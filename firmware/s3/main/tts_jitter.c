@@ -0,0 +1,295 @@
+/**
+ * @file tts_jitter.c
+ * @brief TTS playout jitter buffer implementation
+ */
+
+#include "tts_jitter.h"
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Private: Helpers                                                   */
+/* ------------------------------------------------------------------ */
+
+static int bytes_to_ms(const tts_jitter_t *jb, int bytes)
+{
+    return jb->wbytes_per_ms > 0 ? bytes / jb->wbytes_per_ms : 0;
+}
+
+/* Producer: queue a mark at the current write position */
+static int put_mark(tts_jitter_t *jb, int sample_rate)
+{
+    unsigned w = atomic_load_explicit(&jb->marks_w, memory_order_relaxed);
+    unsigned r = atomic_load_explicit(&jb->marks_r, memory_order_acquire);
+
+    if (w - r >= TTS_JITTER_MARKS) {
+        return -1;
+    }
+    jb->marks[w % TTS_JITTER_MARKS].at = jb->wtotal;
+    jb->marks[w % TTS_JITTER_MARKS].sample_rate = sample_rate;
+    atomic_store_explicit(&jb->marks_w, w + 1, memory_order_release);
+    return 0;
+}
+
+/* Consumer: release n bytes at the read position */
+static void skip(tts_jitter_t *jb, int n)
+{
+    jb->rpos = (jb->rpos + n) % jb->capacity;
+    jb->rtotal += n;
+    atomic_fetch_sub_explicit(&jb->fill, n, memory_order_release);
+}
+
+/* Consumer: pass the mark at the read position */
+static void pass_mark(tts_jitter_t *jb, unsigned r, unsigned flush)
+{
+    const tts_jitter_mark_t *m = &jb->marks[r % TTS_JITTER_MARKS];
+
+    if (m->sample_rate > 0) {
+        jb->active = true;
+        jb->dropping = (int)(flush - r) > 0;
+        if (!jb->dropping) {
+            jb->stream++;
+            jb->sample_rate = m->sample_rate;
+            jb->bytes_per_ms = m->sample_rate / 1000 * 2;
+        }
+    } else {
+        jb->active = false;
+        jb->dropping = false;
+    }
+    jb->playing = false;        /* The next stream prefills again */
+    atomic_store_explicit(&jb->marks_r, r + 1, memory_order_release);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init                                                       */
+/* ------------------------------------------------------------------ */
+
+void tts_jitter_default_config(tts_jitter_config_t *cfg)
+{
+    if (!cfg) {
+        return;
+    }
+    cfg->start_ms = 120;
+    cfg->max_ms = 480;
+    cfg->step_ms = 40;
+    cfg->decay_ms = 5000;
+}
+
+int tts_jitter_init(tts_jitter_t *jb, uint8_t *storage, int capacity,
+                    const tts_jitter_config_t *cfg)
+{
+    if (!jb || !storage || capacity <= 0 || (capacity & 1)) {
+        return -1;
+    }
+
+    memset(jb, 0, sizeof(*jb));
+    if (cfg) {
+        jb->cfg = *cfg;
+    } else {
+        tts_jitter_default_config(&jb->cfg);
+    }
+    if (jb->cfg.start_ms < 0 || jb->cfg.max_ms < jb->cfg.start_ms ||
+        jb->cfg.step_ms < 0 || jb->cfg.decay_ms <= 0) {
+        return -1;
+    }
+
+    jb->buf = storage;
+    jb->capacity = capacity;
+    jb->target_ms = jb->cfg.start_ms;
+    atomic_init(&jb->fill, 0);
+    atomic_init(&jb->marks_w, 0);
+    atomic_init(&jb->marks_r, 0);
+    atomic_init(&jb->flush_mark, 0);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Producer                                                   */
+/* ------------------------------------------------------------------ */
+
+int tts_jitter_begin(tts_jitter_t *jb, int sample_rate)
+{
+    if (!jb || sample_rate < 1000 || put_mark(jb, sample_rate) != 0) {
+        return -1;
+    }
+    jb->wbytes_per_ms = sample_rate / 1000 * 2;
+    return 0;
+}
+
+int tts_jitter_push(tts_jitter_t *jb, const uint8_t *data, int len)
+{
+    if (!jb || !data || len <= 0) {
+        return -1;
+    }
+
+    int fill = atomic_load_explicit(&jb->fill, memory_order_acquire);
+    if (len > jb->capacity - fill) {
+        jb->overruns++;
+        return -1;
+    }
+
+    int first = jb->capacity - jb->wpos;
+    if (first > len) first = len;
+    memcpy(&jb->buf[jb->wpos], data, first);
+    memcpy(jb->buf, data + first, len - first);
+    jb->wpos = (jb->wpos + len) % jb->capacity;
+    jb->wtotal += len;
+
+    fill = atomic_fetch_add_explicit(&jb->fill, len, memory_order_release) + len;
+    if (fill > jb->high_water) {
+        jb->high_water = fill;
+    }
+    return 0;
+}
+
+int tts_jitter_free(const tts_jitter_t *jb)
+{
+    if (!jb) {
+        return 0;
+    }
+    return jb->capacity - atomic_load_explicit(&((tts_jitter_t *)jb)->fill, memory_order_acquire);
+}
+
+int tts_jitter_end(tts_jitter_t *jb)
+{
+    if (!jb) {
+        return -1;
+    }
+    return put_mark(jb, 0);
+}
+
+void tts_jitter_flush(tts_jitter_t *jb)
+{
+    if (!jb) {
+        return;
+    }
+
+    unsigned w = atomic_load_explicit(&jb->marks_w, memory_order_acquire);
+    atomic_store_explicit(&jb->flush_mark, w, memory_order_release);
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Consumer                                                   */
+/* ------------------------------------------------------------------ */
+
+int tts_jitter_pop(tts_jitter_t *jb, uint8_t *out, int max_len)
+{
+    if (!jb || !out || max_len <= 0) {
+        return 0;
+    }
+
+    /* Load fill before the marks: every mark placed before those bytes is
+     * visible, so data is never mistaken for an orphan */
+    int fill = atomic_load_explicit(&jb->fill, memory_order_acquire);
+    unsigned w = atomic_load_explicit(&jb->marks_w, memory_order_acquire);
+    unsigned flush = atomic_load_explicit(&jb->flush_mark, memory_order_acquire);
+
+    if (jb->active && !jb->dropping && (int)(flush - jb->stream_mark) > 0) {
+        jb->dropping = true;
+    }
+
+    while (1) {
+        unsigned r = atomic_load_explicit(&jb->marks_r, memory_order_relaxed);
+        bool ahead = r != w;
+        bool reach = false;     /* avail ends at the mark */
+        int avail = fill;
+
+        if (ahead) {
+            uint32_t to_mark = jb->marks[r % TTS_JITTER_MARKS].at - jb->rtotal;
+            if (to_mark <= (uint32_t)avail) {
+                avail = (int)to_mark;
+                reach = true;
+            }
+            if (to_mark == 0) {
+                /* A begin while active ends the stream implicitly */
+                if (jb->marks[r % TTS_JITTER_MARKS].sample_rate > 0) {
+                    jb->stream_mark = r;
+                }
+                pass_mark(jb, r, flush);
+                continue;
+            }
+        }
+
+        if (!jb->active || jb->dropping) {
+            /* Flushed stream, or bytes pushed outside any stream */
+            if (avail > 0) {
+                skip(jb, avail);
+                fill -= avail;
+            }
+            if (reach) {
+                continue;
+            }
+            jb->playing = false;
+            return 0;
+        }
+
+        if (!jb->playing) {
+            /* A mark ahead: the producer is done, play the tail as is */
+            if (avail == 0 || (!ahead && avail < jb->target_ms * jb->bytes_per_ms)) {
+                return 0;
+            }
+            jb->playing = true;
+        }
+
+        if (avail == 0) {
+            jb->playing = false;
+            if (!ahead) {
+                /* Ran dry mid-stream: refill deeper next time */
+                jb->underruns++;
+                jb->target_ms += jb->cfg.step_ms;
+                if (jb->target_ms > jb->cfg.max_ms) {
+                    jb->target_ms = jb->cfg.max_ms;
+                }
+                jb->run_bytes = 0;
+            }
+            return 0;
+        }
+
+        int n = avail < max_len ? avail : max_len & ~1;
+        int first = jb->capacity - jb->rpos;
+        if (first > n) first = n;
+        memcpy(out, &jb->buf[jb->rpos], first);
+        memcpy(out + first, jb->buf, n - first);
+        skip(jb, n);
+
+        /* A long clean run: the network is steadier than the target assumes */
+        jb->run_bytes += n;
+        if (jb->run_bytes >= jb->cfg.decay_ms * jb->bytes_per_ms) {
+            jb->run_bytes = 0;
+            jb->target_ms -= jb->cfg.step_ms;
+            if (jb->target_ms < jb->cfg.start_ms) {
+                jb->target_ms = jb->cfg.start_ms;
+            }
+        }
+        return n;
+    }
+}
+
+bool tts_jitter_drained(const tts_jitter_t *jb)
+{
+    return !jb || !jb->active || jb->dropping;
+}
+
+uint32_t tts_jitter_stream(const tts_jitter_t *jb, int *sample_rate)
+{
+    if (!jb) {
+        return 0;
+    }
+    if (sample_rate) {
+        *sample_rate = jb->sample_rate;
+    }
+    return jb->stream;
+}
+
+void tts_jitter_get_stats(const tts_jitter_t *jb, tts_jitter_stats_t *out)
+{
+    if (!jb || !out) {
+        return;
+    }
+
+    int fill = atomic_load_explicit(&((tts_jitter_t *)jb)->fill, memory_order_relaxed);
+    out->depth_ms = bytes_to_ms(jb, fill);
+    out->target_ms = jb->target_ms;
+    out->high_water_ms = bytes_to_ms(jb, jb->high_water);
+    out->underruns = jb->underruns;
+    out->overruns = jb->overruns;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file tts_jitter.h
+ * @brief TTS playout jitter buffer, PCM16 byte FIFO (platform independent)
+ *
+ * The WebSocket task pushes decoded TTS PCM as it arrives; the playback task
+ * pops it at the I2S rate. Playback starts (and restarts after an underrun)
+ * only once target_ms of audio is queued. Each underrun raises the target by
+ * step_ms up to max_ms; every decay_ms of clean playback lowers it by step_ms
+ * back toward start_ms.
+ *
+ * Stream boundaries travel in band: begin/end marks are queued at the
+ * producer's byte position, so the next reply can be queued while the
+ * previous tail still plays, and the consumer switches streams when it
+ * reaches the mark. The producer never waits for playback.
+ *
+ * Single producer / single consumer, no locks: the byte count and the mark
+ * counters are the only shared words (acquire/release atomics). Storage is
+ * provided by the caller so it can live in PSRAM.
+ */
+
+#ifndef TTS_JITTER_H
+#define TTS_JITTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+typedef struct {
+    int start_ms;               /* Initial and minimum prefill target */
+    int max_ms;                 /* Target ceiling after repeated underruns */
+    int step_ms;                /* Target change per underrun / decay period */
+    int decay_ms;               /* Clean playback before the target drops a step */
+} tts_jitter_config_t;
+
+typedef struct {
+    int depth_ms;               /* Queued audio now */
+    int target_ms;              /* Current prefill target */
+    int high_water_ms;          /* Max queued audio seen */
+    uint32_t underruns;         /* Ran dry mid-stream (playback paused to refill) */
+    uint32_t overruns;          /* Pushes dropped for lack of space */
+} tts_jitter_stats_t;
+
+/* Stream marks in flight (begin + end of a few queued replies) */
+#define TTS_JITTER_MARKS        8
+
+typedef struct {
+    uint32_t at;                /* Producer byte count where the mark sits */
+    int sample_rate;            /* > 0: stream begin, 0: stream end */
+} tts_jitter_mark_t;
+
+typedef struct {
+    uint8_t *buf;
+    int capacity;               /* Bytes */
+    tts_jitter_config_t cfg;
+    atomic_int fill;            /* Queued bytes */
+    atomic_uint marks_w;        /* Marks published (producer) */
+    atomic_uint marks_r;        /* Marks passed (consumer) */
+    atomic_uint flush_mark;     /* Streams begun before this mark are dropped */
+    tts_jitter_mark_t marks[TTS_JITTER_MARKS];
+    /* Producer */
+    int wpos;
+    uint32_t wtotal;            /* Bytes ever pushed */
+    int wbytes_per_ms;          /* Latest stream begun (stats) */
+    int high_water;             /* Bytes */
+    uint32_t overruns;
+    /* Consumer */
+    int rpos;
+    uint32_t rtotal;            /* Bytes ever consumed */
+    uint32_t stream;            /* Streams started (flushed ones not counted) */
+    uint32_t stream_mark;       /* Mark index of the current stream's begin */
+    int sample_rate;            /* Current stream */
+    int bytes_per_ms;
+    bool active;                /* Between a begin and its end mark */
+    bool dropping;              /* Current stream flushed */
+    bool playing;               /* false = prefilling */
+    int target_ms;
+    int run_bytes;              /* Played since the last target change */
+    uint32_t underruns;
+} tts_jitter_t;
+
+/**
+ * Fill a config with the defaults (120 ms start, 480 ms max, 40 ms step,
+ * 5 s decay)
+ */
+void tts_jitter_default_config(tts_jitter_config_t *cfg);
+
+/**
+ * Initialize on caller-provided storage
+ * @param storage Buffer of capacity bytes
+ * @param capacity Bytes (even)
+ * @param cfg Config, NULL for defaults
+ * @return 0 on success, -1 on error
+ */
+int tts_jitter_init(tts_jitter_t *jb, uint8_t *storage, int capacity,
+                    const tts_jitter_config_t *cfg);
+
+/* ------------------------------------------------------------------ */
+/* Producer side                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Begin a stream; may be queued behind the previous stream's tail
+ * @param sample_rate PCM16 mono rate of this stream
+ * @return 0 on success, -1 on error or TTS_JITTER_MARKS marks in flight
+ */
+int tts_jitter_begin(tts_jitter_t *jb, int sample_rate);
+
+/**
+ * Queue PCM, all or nothing
+ * @return 0 on success, -1 if it does not fit (counted as an overrun)
+ */
+int tts_jitter_push(tts_jitter_t *jb, const uint8_t *data, int len);
+
+/**
+ * Free space in bytes (never overestimated when called by the producer)
+ */
+int tts_jitter_free(const tts_jitter_t *jb);
+
+/**
+ * Mark the end of the stream: the tail plays without waiting for the
+ * target and running dry is no longer an underrun
+ * @return 0 on success, -1 if TTS_JITTER_MARKS marks are in flight
+ */
+int tts_jitter_end(tts_jitter_t *jb);
+
+/**
+ * Drop every stream begun so far, including audio still being pushed to
+ * them; streams begun afterwards play normally (barge-in, any task).
+ * The consumer discards the data on its next pop.
+ */
+void tts_jitter_flush(tts_jitter_t *jb);
+
+/* ------------------------------------------------------------------ */
+/* Consumer side                                                      */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Take up to max_len bytes of the current stream for playback. Passes
+ * stream marks at the read position: an end mark stops the stream, a begin
+ * mark starts the next one (prefilling), also when the previous stream was
+ * never ended. Never returns data of two streams.
+ * @return Bytes copied to out; 0 while prefilling, empty or between streams
+ */
+int tts_jitter_pop(tts_jitter_t *jb, uint8_t *out, int max_len);
+
+/**
+ * Current stream ended (or flushed) and played out, no newer one reached
+ * yet (consumer)
+ */
+bool tts_jitter_drained(const tts_jitter_t *jb);
+
+/**
+ * Stream being played
+ * @param sample_rate Receives its rate (may be NULL)
+ * @return Streams started so far (flushed ones not counted); changes when
+ *         pop passes a begin mark, before it returns that stream's data
+ */
+uint32_t tts_jitter_stream(const tts_jitter_t *jb, int *sample_rate);
+
+/**
+ * Snapshot of depth, target and counters (any task; approximate)
+ */
+void tts_jitter_get_stats(const tts_jitter_t *jb, tts_jitter_stats_t *out);
+
+#endif /* TTS_JITTER_H */
@@ -1,6 +1,10 @@
 #include "uart_bridge.h"
 #include "hal_uart.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -9,12 +13,28 @@
 /* Default duration for smooth movement (ms) */
 #define DEFAULT_DURATION_MS 100
 
+/* Servo mailbox: wait this long for the other axis before sending one */
+#define SERVO_PAIR_WINDOW_MS    3
+#define SERVO_TX_TIMEOUT_MS     50      /* One frame is ~3ms at 115200 */
+#define SERVO_TX_STACK          3072
+#define SERVO_TX_PRIO           6
+
 /* ------------------------------------------------------------------ */
 /* Private: Statistics                                                */
 /* ------------------------------------------------------------------ */
 
 static uart_bridge_t g_stats = {0};
 
+/* ------------------------------------------------------------------ */
+/* Private: Servo Mailbox                                             */
+/* ------------------------------------------------------------------ */
+
+static servo_mailbox_t g_mailbox;
+static SemaphoreHandle_t g_mailbox_lock = NULL;
+static TaskHandle_t g_servo_tx_handle = NULL;
+
+static void servo_tx_start(void);
+
 /* ------------------------------------------------------------------ */
 /* Private: Clamp angle to valid range                                */
 /* ------------------------------------------------------------------ */
@@ -40,9 +60,114 @@ void uart_bridge_init(void)
         /* Continue anyway - may be tested separately */
     }
 
+    servo_tx_start();
+
     ESP_LOGI(TAG, "UART bridge initialized");
 }
 
+/* ------------------------------------------------------------------ */
+/* Servo TX Task                                                      */
+/* ------------------------------------------------------------------ */
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/**
+ * Writes the newest pending targets, then waits for the wire to drain;
+ * targets posted meanwhile overwrite each other in the mailbox
+ */
+static void servo_tx_task(void *arg)
+{
+    char frame[SERVO_MAILBOX_FRAME_MAX];
+
+    (void)arg;
+    while (1) {
+        int wait_ms;
+        xSemaphoreTake(g_mailbox_lock, portMAX_DELAY);
+        int len = servo_mailbox_take(&g_mailbox, now_ms(), frame, sizeof(frame), &wait_ms);
+        xSemaphoreGive(g_mailbox_lock);
+
+        if (len > 0) {
+            ESP_LOGD(TAG, "UART servo frame: %d bytes", len);
+            int sent = hal_uart_send((const uint8_t *)frame, len);
+            if (sent != len || hal_uart_wait_tx_done(SERVO_TX_TIMEOUT_MS) != 0) {
+                xSemaphoreTake(g_mailbox_lock, portMAX_DELAY);
+                servo_mailbox_send_failed(&g_mailbox);
+                xSemaphoreGive(g_mailbox_lock);
+                g_stats.error_count++;
+            } else {
+                g_stats.tx_count++;
+            }
+            continue;
+        }
+
+        /* Woken by the next post, or when a lone target's pair window ends */
+        ulTaskNotifyTake(pdTRUE, wait_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms) + 1);
+    }
+}
+
+static void servo_tx_start(void)
+{
+    if (g_servo_tx_handle) {
+        return;
+    }
+
+    servo_mailbox_init(&g_mailbox, SERVO_PAIR_WINDOW_MS);
+#ifdef CONFIG_UART_SERVO_BINARY
+    servo_mailbox_set_binary(&g_mailbox, true);
+#endif
+    g_mailbox_lock = xSemaphoreCreateMutex();
+    if (!g_mailbox_lock ||
+        xTaskCreate(servo_tx_task, "servo_tx", SERVO_TX_STACK, NULL, SERVO_TX_PRIO,
+                    &g_servo_tx_handle) != pdPASS) {
+        ESP_LOGW(TAG, "Servo TX task create failed, sending inline");
+        g_servo_tx_handle = NULL;
+        if (g_mailbox_lock) {
+            vSemaphoreDelete(g_mailbox_lock);
+            g_mailbox_lock = NULL;
+        }
+    }
+}
+
+int uart_bridge_post_servo(const char *id, int angle, int duration_ms)
+{
+    if (!g_servo_tx_handle) {
+        return uart_bridge_send_servo_single(id, angle, duration_ms);
+    }
+
+    if (duration_ms < 0) {
+        duration_ms = DEFAULT_DURATION_MS;
+    }
+
+    xSemaphoreTake(g_mailbox_lock, portMAX_DELAY);
+    int ret = servo_mailbox_post(&g_mailbox, servo_mailbox_axis(id), angle, duration_ms, now_ms());
+    xSemaphoreGive(g_mailbox_lock);
+
+    if (ret < 0) {
+        g_stats.error_count++;
+        return -1;
+    }
+    xTaskNotifyGive(g_servo_tx_handle);
+    return 0;
+}
+
+void uart_bridge_get_servo_stats(servo_mailbox_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    if (!g_mailbox_lock) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    xSemaphoreTake(g_mailbox_lock, portMAX_DELAY);
+    servo_mailbox_get_stats(&g_mailbox, out);
+    xSemaphoreGive(g_mailbox_lock);
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Reset statistics                                           */
 /* ------------------------------------------------------------------ */
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "servo_mailbox.h"
 
 /* UART bridge context */
 typedef struct {
@@ -39,6 +40,25 @@ int uart_bridge_send_servo_single(const char *id, int angle, int duration_ms);
  */
 int uart_bridge_send_servo(int x, int y, int duration_ms);
 
+/**
+ * Post a servo target (v2.1 format) to the latest-wins mailbox
+ *
+ * Returns at once; the servo TX task writes the newest target per axis
+ * when the UART is free, X and Y together when both are pending. Falls
+ * back to uart_bridge_send_servo_single() if the task is not running.
+ *
+ * @param id Servo identifier ("x" or "y")
+ * @param angle Angle value (0-180)
+ * @param duration_ms Movement duration in milliseconds (< 0 = default)
+ * @return 0 if posted or sent, -1 on error
+ */
+int uart_bridge_post_servo(const char *id, int angle, int duration_ms);
+
+/**
+ * Get servo mailbox counters (coalesced, dropped, paired, latency)
+ */
+void uart_bridge_get_servo_stats(servo_mailbox_stats_t *out);
+
 /**
  * Get bridge statistics
  */
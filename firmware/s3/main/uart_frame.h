@@ -0,0 +1,59 @@
+/**
+ * @file uart_frame.h
+ * @brief Binary S3 -> MCU servo frames, COBS + CRC-16 (platform independent)
+ *
+ * Wire format (docs/COMMUNICATION_PROTOCOL.md section 6):
+ *
+ *   0x00 | COBS( seq | type | n | n x axis entry | crc16 ) | 0x00
+ *
+ *   axis entry: axis u8 (0 = X, 1 = Y) | angle u16 (0.1 deg, 0-1800)
+ *               | duration u16 (ms, 0 = MCU default speed)
+ *   crc16: CRC-16/CCITT-FALSE over seq .. last entry
+ *
+ * All multi-byte fields are little endian. COBS removes every 0x00 from
+ * the frame body, so 0x00 only ever appears as the delimiter and the
+ * receiver resynchronizes on the next one after line noise. The leading
+ * delimiter also tells the MCU a binary frame follows, so ASCII lines
+ * ("X:90:500\r\n") keep working on the same link.
+ */
+
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+#include <stdint.h>
+
+#define UART_FRAME_TYPE_SERVO   0x01
+#define UART_FRAME_AXES_MAX     4
+#define UART_FRAME_AXIS_X       0
+#define UART_FRAME_AXIS_Y       1
+
+/* Raw body: header 3 + 5 per axis + CRC 2; COBS adds 1, delimiters 2 */
+#define UART_FRAME_RAW_MAX      (3 + 5 * UART_FRAME_AXES_MAX + 2)
+#define UART_FRAME_MAX          (UART_FRAME_RAW_MAX + 1 + 2)
+
+typedef struct {
+    uint8_t axis;               /* UART_FRAME_AXIS_X / _Y */
+    uint16_t angle_x10;         /* 0.1 degree */
+    uint16_t duration_ms;       /* 0 = MCU default speed */
+} uart_frame_axis_t;
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF); "123456789" -> 0x29B1
+ */
+uint16_t uart_frame_crc16(const uint8_t *data, int len);
+
+/**
+ * COBS-encode (no delimiters)
+ * @return Encoded length, -1 if out is too small
+ */
+int uart_frame_cobs_encode(const uint8_t *in, int len, uint8_t *out, int size);
+
+/**
+ * Build one delimited servo frame
+ * @param n 1..UART_FRAME_AXES_MAX axis entries
+ * @return Frame length including both delimiters, -1 on bad args
+ */
+int uart_frame_encode_servo(uint8_t seq, const uart_frame_axis_t *axes, int n,
+                            uint8_t *out, int size);
+
+#endif /* UART_FRAME_H */
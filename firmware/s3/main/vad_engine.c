@@ -0,0 +1,223 @@
+/**
+ * @file vad_engine.c
+ * @brief Adaptive voice activity endpointing implementation
+ */
+
+#include "vad_engine.h"
+#include <string.h>
+
+/* ZCR bands, crossings per sample in Q8 (16 kHz: voiced < ~0.15, hiss ~0.5) */
+#define ZCR_FRICATIVE_Q8    38      /* 0.15 */
+#define ZCR_NOISE_Q8        115     /* 0.45 */
+
+/* Smoothing toward the window minimum: fast down, slower up */
+#define FLOOR_DOWN_SHIFT    1
+#define FLOOR_UP_SHIFT      3
+
+/* ------------------------------------------------------------------ */
+/* Private: Features                                                  */
+/* ------------------------------------------------------------------ */
+
+static int zcr_q8(const audio_stats_t *st, int n)
+{
+    return n > 0 ? st->zero_crossings * 256 / n : 0;
+}
+
+static int onset_threshold(const vad_engine_t *vad)
+{
+    int thr = (int)(((long)vad->noise_floor_q4 * vad->cfg.onset_ratio_q4) >> 8);
+    int min = vad->cfg.min_threshold * vad->cfg.onset_ratio_q4 / vad->cfg.offset_ratio_q4;
+    return thr > min ? thr : min;
+}
+
+static int offset_threshold(const vad_engine_t *vad)
+{
+    int thr = (int)(((long)vad->noise_floor_q4 * vad->cfg.offset_ratio_q4) >> 8);
+    return thr > vad->cfg.min_threshold ? thr : vad->cfg.min_threshold;
+}
+
+/* Strong enough to start (or resume) speech */
+static int is_loud(const vad_engine_t *vad, const audio_stats_t *st, int n)
+{
+    int thr = onset_threshold(vad);
+    if (zcr_q8(st, n) >= ZCR_NOISE_Q8) {
+        thr *= 2;
+    }
+    return st->rms >= thr;
+}
+
+/* Strong enough to keep speech going */
+static int is_voiced(const vad_engine_t *vad, const audio_stats_t *st, int n)
+{
+    if (st->rms >= offset_threshold(vad)) {
+        return 1;
+    }
+
+    /* Soft fricative tail: above the floor with a consonant-like ZCR */
+    int zcr = zcr_q8(st, n);
+    int floor = vad->noise_floor_q4 >> 4;
+    return zcr >= ZCR_FRICATIVE_Q8 && zcr < ZCR_NOISE_Q8 &&
+           st->rms * 2 >= floor * 3 && st->rms >= vad->cfg.min_threshold;
+}
+
+static void update_floor(vad_engine_t *vad, int rms)
+{
+    vad->floor_window[vad->floor_pos] = rms;
+    vad->floor_pos = (vad->floor_pos + 1) % VAD_ENGINE_FLOOR_WINDOW;
+    if (vad->floor_fill < VAD_ENGINE_FLOOR_WINDOW) {
+        vad->floor_fill++;
+    }
+
+    int min = vad->floor_window[0];
+    for (int i = 1; i < vad->floor_fill; i++) {
+        if (vad->floor_window[i] < min) {
+            min = vad->floor_window[i];
+        }
+    }
+
+    int diff = (min << 4) - vad->noise_floor_q4;
+    vad->noise_floor_q4 += diff >> (diff < 0 ? FLOOR_DOWN_SHIFT : FLOOR_UP_SHIFT);
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Hangover                                                  */
+/* ------------------------------------------------------------------ */
+
+static int compute_hangover(const vad_engine_t *vad)
+{
+    const vad_engine_config_t *c = &vad->cfg;
+    int span = c->hangover_max_ms - c->hangover_min_ms;
+    int speech = vad->speech_ms < c->confident_speech_ms ? vad->speech_ms : c->confident_speech_ms;
+
+    int h = c->hangover_max_ms - span * speech / c->confident_speech_ms;
+
+    /* Speaker already paused this long mid-turn: don't cut the next one */
+    int pause = vad->longest_pause_ms + c->frame_ms;
+    if (pause > h) {
+        h = pause;
+    }
+    return h < c->hangover_max_ms ? h : c->hangover_max_ms;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public API                                                         */
+/* ------------------------------------------------------------------ */
+
+void vad_engine_default_config(vad_engine_config_t *cfg)
+{
+    if (!cfg) {
+        return;
+    }
+    cfg->frame_ms = 60;
+    cfg->min_threshold = 100;
+    cfg->onset_ratio_q4 = 48;
+    cfg->offset_ratio_q4 = 32;
+    cfg->min_speech_ms = 300;
+    cfg->confident_speech_ms = 600;
+    cfg->hangover_max_ms = 1500;
+    cfg->hangover_min_ms = 700;
+}
+
+int vad_engine_init(vad_engine_t *vad, const vad_engine_config_t *cfg)
+{
+    if (!vad || !cfg || cfg->frame_ms <= 0 || cfg->min_threshold <= 0 ||
+        cfg->offset_ratio_q4 <= 0 || cfg->onset_ratio_q4 < cfg->offset_ratio_q4 ||
+        cfg->confident_speech_ms <= 0 || cfg->hangover_min_ms > cfg->hangover_max_ms) {
+        return -1;
+    }
+
+    memset(vad, 0, sizeof(*vad));
+    vad->cfg = *cfg;
+
+    /* Until learned, assume a floor at half the absolute threshold */
+    vad->noise_floor_q4 = (cfg->min_threshold / 2) << 4;
+    vad_engine_start_turn(vad);
+    return 0;
+}
+
+void vad_engine_start_turn(vad_engine_t *vad)
+{
+    if (!vad) {
+        return;
+    }
+    vad->state = VAD_ENGINE_SILENCE;
+    vad->onset_run = 0;
+    vad->speech_ms = 0;
+    vad->silence_ms = 0;
+    vad->longest_pause_ms = 0;
+    vad->hangover_ms = vad->cfg.hangover_max_ms;
+}
+
+void vad_engine_track_noise(vad_engine_t *vad, const audio_stats_t *st)
+{
+    if (!vad || !st) {
+        return;
+    }
+    update_floor(vad, st->rms);
+}
+
+vad_engine_state_t vad_engine_process(vad_engine_t *vad, const audio_stats_t *st, int n)
+{
+    if (!vad || !st) {
+        return VAD_ENGINE_SILENCE;
+    }
+
+    int frame_ms = vad->cfg.frame_ms;
+
+    switch (vad->state) {
+    case VAD_ENGINE_SILENCE:
+        if (is_loud(vad, st, n)) {
+            if (++vad->onset_run >= VAD_ENGINE_ONSET_FRAMES) {
+                vad->state = VAD_ENGINE_SPEECH;
+                vad->speech_ms += vad->onset_run * frame_ms;
+                vad->onset_run = 0;
+            }
+        } else {
+            vad->onset_run = 0;
+        }
+        break;
+
+    case VAD_ENGINE_SPEECH:
+        if (is_voiced(vad, st, n)) {
+            vad->speech_ms += frame_ms;
+        } else {
+            vad->state = VAD_ENGINE_HANGOVER;
+            vad->silence_ms = frame_ms;
+        }
+        break;
+
+    case VAD_ENGINE_HANGOVER:
+        if (is_loud(vad, st, n)) {
+            if (vad->silence_ms > vad->longest_pause_ms) {
+                vad->longest_pause_ms = vad->silence_ms;
+            }
+            vad->state = VAD_ENGINE_SPEECH;
+            vad->silence_ms = 0;
+            vad->speech_ms += frame_ms;
+        } else {
+            vad->silence_ms += frame_ms;
+        }
+        break;
+
+    case VAD_ENGINE_ENDPOINT:
+        return VAD_ENGINE_ENDPOINT;
+    }
+
+    /* Decide against the floor from previous frames, then fold this one in */
+    update_floor(vad, st->rms);
+
+    vad->hangover_ms = compute_hangover(vad);
+
+    if (vad->state == VAD_ENGINE_HANGOVER && vad->cfg.hangover_max_ms > 0 &&
+        vad->speech_ms >= vad->cfg.min_speech_ms &&
+        vad->silence_ms >= vad->hangover_ms) {
+        vad->state = VAD_ENGINE_ENDPOINT;
+    }
+
+    return vad->state;
+}
+
+int vad_engine_noise_floor(const vad_engine_t *vad)
+{
+    return vad ? vad->noise_floor_q4 >> 4 : 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file vad_engine.h
+ * @brief Adaptive voice activity endpointing (platform independent)
+ *
+ * Per-frame decision from RMS energy and zero-crossing rate against a
+ * noise floor tracked as the minimum frame RMS over the last
+ * VAD_ENGINE_FLOOR_WINDOW frames (minimum statistics: follows stationary
+ * noise even while the user keeps talking):
+ * - Onset needs energy >= floor * onset ratio for VAD_ENGINE_ONSET_FRAMES;
+ *   noise-like frames (high ZCR) need twice that.
+ * - Speech continues while energy >= floor * offset ratio (hysteresis), or
+ *   while a softer fricative-like frame (mid ZCR) stays above the floor.
+ * - Hangover shrinks from hangover_max_ms to hangover_min_ms as speech
+ *   accumulates, but never below the longest pause already seen in the turn.
+ *
+ * The noise floor survives vad_engine_start_turn(), so it can be learned
+ * from idle frames (vad_engine_track_noise) before the turn starts.
+ */
+
+#ifndef VAD_ENGINE_H
+#define VAD_ENGINE_H
+
+#include "audio_dsp.h"
+
+/* Consecutive loud frames needed to enter SPEECH */
+#define VAD_ENGINE_ONSET_FRAMES     2
+
+/* Noise floor window (~2.9 s of 60 ms frames) */
+#define VAD_ENGINE_FLOOR_WINDOW     48
+
+typedef struct {
+    int frame_ms;               /* Frame duration (ms) */
+    int min_threshold;          /* Absolute RMS floor for continuing speech */
+    int onset_ratio_q4;         /* Onset: rms >= floor * ratio / 16 */
+    int offset_ratio_q4;        /* Continue: rms >= floor * ratio / 16 (< onset) */
+    int min_speech_ms;          /* Speech required before an endpoint */
+    int confident_speech_ms;    /* Speech after which hangover is at its minimum */
+    int hangover_max_ms;        /* Hangover at speech start (<= 0: never endpoint) */
+    int hangover_min_ms;        /* Hangover once speech is confident */
+} vad_engine_config_t;
+
+typedef enum {
+    VAD_ENGINE_SILENCE = 0,     /* No speech yet in this turn */
+    VAD_ENGINE_SPEECH,          /* Speaking */
+    VAD_ENGINE_HANGOVER,        /* Paused, waiting for more speech */
+    VAD_ENGINE_ENDPOINT,        /* Turn finished (sticky until next turn) */
+} vad_engine_state_t;
+
+typedef struct {
+    vad_engine_config_t cfg;
+    vad_engine_state_t state;
+    int noise_floor_q4;         /* Noise RMS, Q4 fixed point */
+    int floor_window[VAD_ENGINE_FLOOR_WINDOW];  /* Recent frame RMS */
+    int floor_pos;              /* Next window slot */
+    int floor_fill;             /* Valid window entries */
+    int onset_run;              /* Consecutive loud frames while SILENCE */
+    int speech_ms;              /* Speech in this turn */
+    int silence_ms;             /* Current pause length */
+    int longest_pause_ms;       /* Longest pause bridged in this turn */
+    int hangover_ms;            /* Hangover currently in effect */
+} vad_engine_t;
+
+/**
+ * Fill config with defaults (60 ms frames, 3x/2x ratios, 1500->700 ms hangover)
+ */
+void vad_engine_default_config(vad_engine_config_t *cfg);
+
+/**
+ * Initialize engine
+ * @return 0 on success, -1 on invalid config
+ */
+int vad_engine_init(vad_engine_t *vad, const vad_engine_config_t *cfg);
+
+/**
+ * Start a new turn: clear speech/pause state, keep the noise floor
+ */
+void vad_engine_start_turn(vad_engine_t *vad);
+
+/**
+ * Feed an idle frame (outside a turn) to the noise floor tracker
+ */
+void vad_engine_track_noise(vad_engine_t *vad, const audio_stats_t *st);
+
+/**
+ * Process one frame of the current turn
+ * @param st Frame statistics (audio_dsp_stats)
+ * @param n Samples in the frame
+ * @return State after this frame (VAD_ENGINE_ENDPOINT = stop recording)
+ */
+vad_engine_state_t vad_engine_process(vad_engine_t *vad, const audio_stats_t *st, int n);
+
+/**
+ * Current noise floor (RMS)
+ */
+int vad_engine_noise_floor(const vad_engine_t *vad);
+
+#endif /* VAD_ENGINE_H */
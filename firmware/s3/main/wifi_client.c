@@ -2,9 +2,17 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_netif.h"
+#include "esp_mac.h"
 #include "nvs_flash.h"
+#include "nvs.h"
+#include "ping/ping_sock.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <string.h>
 
 #define TAG "WIFI"
 
@@ -14,8 +22,86 @@
 
 #define WIFI_CONNECTED_BIT BIT0
 
+/* Last AP (NVS): lets the next boot skip the full channel scan */
+#define NVS_NAMESPACE   "wifi"
+#define NVS_KEY_AP      "last_ap"
+
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+} wifi_last_ap_t;
+
 static EventGroupHandle_t wifi_event_group;
 static bool is_connected = false;
+static wifi_config_t wifi_cfg;
+static bool fast_attempt = false;      /* Current attempt targets the cached AP */
+static int64_t connect_start_us = 0;
+static wifi_stats_t wifi_stats;
+
+/* ------------------------------------------------------------------ */
+/* Private: Cached AP                                                 */
+/* ------------------------------------------------------------------ */
+
+static int last_ap_load(wifi_last_ap_t *ap)
+{
+    nvs_handle_t nvs;
+    size_t len = sizeof(*ap);
+
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return -1;
+    }
+    esp_err_t err = nvs_get_blob(nvs, NVS_KEY_AP, ap, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || len != sizeof(*ap) || ap->channel == 0 ||
+        strncmp(ap->ssid, WIFI_SSID, sizeof(ap->ssid)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Remember the AP we are associated with (only written when it changed) */
+static void last_ap_save(void)
+{
+    wifi_ap_record_t info;
+    wifi_last_ap_t ap = {0};
+    wifi_last_ap_t old;
+    nvs_handle_t nvs;
+
+    if (esp_wifi_sta_get_ap_info(&info) != ESP_OK) {
+        return;
+    }
+    strncpy(ap.ssid, WIFI_SSID, sizeof(ap.ssid) - 1);
+    memcpy(ap.bssid, info.bssid, sizeof(ap.bssid));
+    ap.channel = info.primary;
+
+    if (last_ap_load(&old) == 0 && memcmp(&old, &ap, sizeof(ap)) == 0) {
+        return;
+    }
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(nvs, NVS_KEY_AP, &ap, sizeof(ap)) == ESP_OK) {
+        nvs_commit(nvs);
+        ESP_LOGI(TAG, "AP cached: " MACSTR " ch %d", MAC2STR(ap.bssid), ap.channel);
+    }
+    nvs_close(nvs);
+}
+
+/* Drop the BSSID/channel pin: the next attempt scans all channels */
+static void fast_connect_disable(void)
+{
+    fast_attempt = false;
+    wifi_cfg.sta.bssid_set = false;
+    wifi_cfg.sta.channel = 0;
+    wifi_cfg.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg);
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Events                                                    */
+/* ------------------------------------------------------------------ */
 
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                                int32_t event_id, void *event_data)
@@ -24,19 +110,66 @@ static void wifi_event_handler(void *arg, esp_event_base_t event_base,
         esp_wifi_connect();
     }
     else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        ESP_LOGW(TAG, "Disconnected, retrying...");
+        wifi_event_sta_disconnected_t *event = (wifi_event_sta_disconnected_t *)event_data;
+        if (fast_attempt && !is_connected) {
+            /* Cached AP gone or moved channel: fall back to a full scan */
+            ESP_LOGW(TAG, "Fast connect failed (reason %d), scanning", event->reason);
+            fast_connect_disable();
+        } else {
+            ESP_LOGW(TAG, "Disconnected (reason %d), retrying...", event->reason);
+        }
+        if (is_connected) {
+            wifi_stats.reconnects++;
+            connect_start_us = esp_timer_get_time();
+        }
         is_connected = false;
         esp_wifi_connect();
         xEventGroupClearBits(wifi_event_group, WIFI_CONNECTED_BIT);
     }
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
-        ESP_LOGI(TAG, "Got IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        wifi_stats.connect_ms = (int)((esp_timer_get_time() - connect_start_us) / 1000);
+        wifi_stats.fast_connect = fast_attempt;
+        ESP_LOGI(TAG, "Got IP: " IPSTR " (%d ms, %s)", IP2STR(&event->ip_info.ip),
+                 wifi_stats.connect_ms, fast_attempt ? "fast connect" : "full scan");
         is_connected = true;
+        last_ap_save();
         xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
 
+#ifdef CONFIG_WIFI_RTT_PROBE
+/**
+ * One-shot after the first connect: gateway RTT with modem sleep and
+ * without, so the cost of power save shows in the boot log
+ */
+static void rtt_probe_task(void *arg)
+{
+    wifi_rtt_t idle, active;
+    bool was_low_latency = wifi_stats.low_latency;
+
+    wifi_set_low_latency(false);
+    int ret = wifi_probe_rtt(10, &idle);
+    wifi_set_low_latency(true);
+    ret |= wifi_probe_rtt(10, &active);
+    wifi_set_low_latency(was_low_latency);
+
+    if (ret == 0) {
+        ESP_LOGI(TAG, "RTT min modem: %d/%d/%d ms (min/avg/max), %d/%d replies",
+                 idle.min_ms, idle.avg_ms, idle.max_ms, idle.received, idle.sent);
+        ESP_LOGI(TAG, "RTT ps none:   %d/%d/%d ms (min/avg/max), %d/%d replies",
+                 active.min_ms, active.avg_ms, active.max_ms, active.received, active.sent);
+    } else {
+        ESP_LOGW(TAG, "RTT probe failed");
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+/* ------------------------------------------------------------------ */
+/* Public: Init / Connect                                             */
+/* ------------------------------------------------------------------ */
+
 int wifi_init(void)
 {
     /* Initialize NVS */
@@ -66,13 +199,23 @@ int wifi_init(void)
                                                         &wifi_event_handler, NULL, NULL));
 
     /* Configure WiFi */
-    wifi_config_t wifi_cfg = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASS,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-        },
-    };
+    memset(&wifi_cfg, 0, sizeof(wifi_cfg));
+    strncpy((char *)wifi_cfg.sta.ssid, WIFI_SSID, sizeof(wifi_cfg.sta.ssid));
+    strncpy((char *)wifi_cfg.sta.password, WIFI_PASS, sizeof(wifi_cfg.sta.password));
+    wifi_cfg.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+
+#ifdef CONFIG_WIFI_FAST_CONNECT
+    /* Known AP: join it directly on its channel instead of scanning all 13 */
+    wifi_last_ap_t ap;
+    if (last_ap_load(&ap) == 0) {
+        memcpy(wifi_cfg.sta.bssid, ap.bssid, sizeof(ap.bssid));
+        wifi_cfg.sta.bssid_set = true;
+        wifi_cfg.sta.channel = ap.channel;
+        wifi_cfg.sta.scan_method = WIFI_FAST_SCAN;
+        fast_attempt = true;
+        ESP_LOGI(TAG, "Fast connect: " MACSTR " ch %d", MAC2STR(ap.bssid), ap.channel);
+    }
+#endif
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg));
@@ -83,14 +226,22 @@ int wifi_init(void)
 
 int wifi_connect(void)
 {
+    connect_start_us = esp_timer_get_time();
     ESP_ERROR_CHECK(esp_wifi_start());
 
+    /* Idle until a turn starts: modem sleep between DTIM beacons */
+    esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+    wifi_stats.low_latency = false;
+
     /* Wait for connection */
     EventBits_t bits = xEventGroupWaitBits(wifi_event_group, WIFI_CONNECTED_BIT,
                                            pdFALSE, pdFALSE, pdMS_TO_TICKS(10000));
 
     if (bits & WIFI_CONNECTED_BIT) {
         ESP_LOGI(TAG, "Connected to WiFi");
+#ifdef CONFIG_WIFI_RTT_PROBE
+        xTaskCreate(rtt_probe_task, "wifi_rtt", 3072, NULL, 3, NULL);
+#endif
         return 0;
     } else {
         ESP_LOGE(TAG, "Failed to connect to WiFi");
@@ -108,3 +259,119 @@ void wifi_disconnect(void)
     esp_wifi_disconnect();
     is_connected = false;
 }
+
+/* ------------------------------------------------------------------ */
+/* Public: Power Save                                                 */
+/* ------------------------------------------------------------------ */
+
+void wifi_set_low_latency(bool on)
+{
+    if (on == wifi_stats.low_latency) {
+        return;
+    }
+
+    /* Modem sleep holds downlink frames until the next DTIM beacon
+     * (typically 100-300ms): fine when idle, audible jitter in a turn */
+    if (esp_wifi_set_ps(on ? WIFI_PS_NONE : WIFI_PS_MIN_MODEM) == ESP_OK) {
+        wifi_stats.low_latency = on;
+        ESP_LOGI(TAG, "Power save: %s", on ? "off (voice active)" : "min modem (idle)");
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: RTT Probe                                                  */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    SemaphoreHandle_t done;
+    wifi_rtt_t *out;
+    uint32_t sum_ms;
+} rtt_probe_t;
+
+static void on_ping_success(esp_ping_handle_t hdl, void *args)
+{
+    rtt_probe_t *p = (rtt_probe_t *)args;
+    uint32_t elapsed;
+
+    esp_ping_get_profile(hdl, ESP_PING_PROF_TIMEGAP, &elapsed, sizeof(elapsed));
+    p->out->received++;
+    p->sum_ms += elapsed;
+    if (p->out->min_ms < 0 || (int)elapsed < p->out->min_ms) {
+        p->out->min_ms = (int)elapsed;
+    }
+    if ((int)elapsed > p->out->max_ms) {
+        p->out->max_ms = (int)elapsed;
+    }
+}
+
+static void on_ping_end(esp_ping_handle_t hdl, void *args)
+{
+    rtt_probe_t *p = (rtt_probe_t *)args;
+    xSemaphoreGive(p->done);
+}
+
+int wifi_probe_rtt(int count, wifi_rtt_t *out)
+{
+    esp_netif_ip_info_t ip_info;
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+
+    if (!out || count <= 0 || !is_connected || !netif ||
+        esp_netif_get_ip_info(netif, &ip_info) != ESP_OK) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->min_ms = -1;
+    rtt_probe_t probe = { .done = xSemaphoreCreateBinary(), .out = out };
+    if (!probe.done) {
+        return -1;
+    }
+
+    /* The gateway: one WiFi hop, so the radio's sleep dominates the RTT */
+    esp_ping_config_t cfg = ESP_PING_DEFAULT_CONFIG();
+    cfg.target_addr.type = IPADDR_TYPE_V4;
+    cfg.target_addr.u_addr.ip4.addr = ip_info.gw.addr;
+    cfg.count = count;
+    cfg.interval_ms = 100;
+    cfg.timeout_ms = 1000;
+
+    esp_ping_callbacks_t cbs = {
+        .cb_args = &probe,
+        .on_ping_success = on_ping_success,
+        .on_ping_end = on_ping_end,
+    };
+    esp_ping_handle_t hdl;
+    if (esp_ping_new_session(&cfg, &cbs, &hdl) != ESP_OK) {
+        vSemaphoreDelete(probe.done);
+        return -1;
+    }
+
+    esp_ping_start(hdl);
+    xSemaphoreTake(probe.done, portMAX_DELAY);
+    esp_ping_delete_session(hdl);
+    vSemaphoreDelete(probe.done);
+
+    out->sent = count;
+    if (out->min_ms < 0) {
+        out->min_ms = 0;
+    }
+    out->avg_ms = out->received ? (int)(probe.sum_ms / out->received) : 0;
+    return 0;
+}
+
+int wifi_get_rssi(void)
+{
+    wifi_ap_record_t info;
+
+    if (!is_connected || esp_wifi_sta_get_ap_info(&info) != ESP_OK) {
+        return 0;
+    }
+    return info.rssi;
+}
+
+void wifi_get_stats(wifi_stats_t *out)
+{
+    if (out) {
+        *out = wifi_stats;
+    }
+}
@@ -1,6 +1,24 @@
 #ifndef WIFI_CLIENT_H
 #define WIFI_CLIENT_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    int connect_ms;             /* Last connect: start (or drop) to IP */
+    bool fast_connect;          /* ...used the cached BSSID/channel */
+    uint32_t reconnects;        /* Drops since boot */
+    bool low_latency;           /* WIFI_PS_NONE active (else min modem sleep) */
+} wifi_stats_t;
+
+typedef struct {
+    int sent;
+    int received;
+    int min_ms;
+    int avg_ms;
+    int max_ms;
+} wifi_rtt_t;
+
 /**
  * Initialize WiFi
  */
@@ -8,6 +26,9 @@ int wifi_init(void);
 
 /**
  * Connect to WiFi
+ *
+ * Uses the BSSID/channel of the last connection (NVS) when available,
+ * falling back to a full scan if that AP does not answer.
  * @return 0 on success, -1 on error
  */
 int wifi_connect(void);
@@ -22,4 +43,28 @@ int wifi_is_connected(void);
  */
 void wifi_disconnect(void);
 
+/**
+ * Select power save: WIFI_PS_NONE for a voice turn or TTS playback,
+ * min modem sleep when idle (no-op if unchanged)
+ */
+void wifi_set_low_latency(bool on);
+
+/**
+ * Ping the gateway in the current power-save mode (blocking)
+ * @param count Echo requests, 100ms apart
+ * @return 0 on success, -1 on error
+ */
+int wifi_probe_rtt(int count, wifi_rtt_t *out);
+
+/**
+ * Signal strength of the current AP
+ * @return RSSI in dBm, or 0 if not connected
+ */
+int wifi_get_rssi(void);
+
+/**
+ * Get connect time, reconnect count and power-save state
+ */
+void wifi_get_stats(wifi_stats_t *out);
+
 #endif /* WIFI_CLIENT_H */
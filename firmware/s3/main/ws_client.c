@@ -5,14 +5,27 @@
 
 #include "ws_client.h"
 #include "ws_router.h"
+#include "ws_handlers.h"
 #include "display_ui.h"
 #include "hal_audio.h"
+#include "hal_opus.h"
 #include "button_voice.h"
+#include "wifi_client.h"
+#include "tts_jitter.h"
+#include "ws_reasm.h"
+#include "ws_sendq.h"
+#include "ws_keepalive.h"
+#include "ws_tlv.h"
+#include "json_arena.h"
 #include "esp_websocket_client.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_random.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,18 +37,239 @@
 #define WS_URL_MAX_LEN 128
 #define RESPONSE_TIMEOUT_MS  30000  /* 30 seconds timeout for server response */
 
+/* TTS audio (default: raw PCM 24kHz; Opus after hello negotiation) */
+#define TTS_DEFAULT_RATE     24000
+#define TTS_PCM_BUF_SIZE     (48000 * 120 / 1000 * 2)  /* One 120ms Opus packet at up to 48kHz */
+
 static esp_websocket_client_handle_t ws_client = NULL;
 static bool is_connected = false;
-static bool tts_playing = false;  /* TTS playback state */
+static volatile bool tts_playing = false;  /* TTS playback state */
+static volatile bool tts_discard = false;  /* Barge-in: drop the rest of this reply */
 static bool waiting_for_response = false;
 static int timeout_display_count = 0;  /* Limit timeout display to 1 time */
 static int64_t response_wait_start_time = 0;  /* Timestamp when response wait started */
 static char ws_server_url[WS_URL_MAX_LEN] = WS_DEFAULT_URL;  /* Dynamic server URL */
+static int tts_rate = TTS_DEFAULT_RATE;  /* Negotiated TTS sample rate */
+static bool ctl_tlv = false;            /* Binary frames carry a channel header */
+static uint8_t *tts_pcm_buf = NULL;     /* Decoded TTS PCM (PSRAM) */
+
+/* TTS playout: this (WS event) task decodes and queues, tts_player drains
+ * the jitter buffer to I2S. Sized for the worst case 48kHz stream. */
+#define TTS_JITTER_BYTES     (48 * 2 * CONFIG_TTS_JITTER_BUF_MS)
+#define TTS_PLAY_CHUNK_MS    20
+#define TTS_PLAYER_STACK     4096
+#define TTS_DRAIN_TIMEOUT_MS 2000      /* Bound on the DMA tail wait */
+
+static tts_jitter_t tts_jb;
+static uint8_t *tts_jb_mem = NULL;      /* Jitter buffer storage (PSRAM) */
+static TaskHandle_t tts_player_handle = NULL;
+static volatile bool tts_rx_open = false;   /* Stream begun in tts_jb, tts_end not yet seen */
+
+/* Receive reassembly: messages split over several DATA events (frames
+ * larger than buffer_size, or fragmented by the server) are rebuilt in a
+ * fixed pool; raw PCM TTS streams through without a copy. */
+#define WS_RX_BUFFER_SIZE    16384
+#define WS_RX_SLOT_SIZE      (32 * 1024)
+#define WS_RX_SLOT_COUNT     2
+
+static ws_reasm_t ws_rx;
+static uint8_t *ws_rx_mem = NULL;       /* Reassembly slots (PSRAM) */
+
+/* Uplink: callers queue and return at once; ws_send is the only task that
+ * writes the socket, so a slow link stalls neither capture nor control.
+ * Control > audio > telemetry; stale audio is dropped oldest-first. */
+#define WS_SEND_CONTROL_BYTES   (4 * 1024)
+#define WS_SEND_AUDIO_BYTES     (64 * 1024)    /* ~2s of 16kHz PCM */
+#define WS_SEND_TELEMETRY_BYTES (4 * 1024)
+#define WS_SEND_MAX_MSG         4096           /* Largest queued message */
+#define WS_SEND_TIMEOUT_MS      1000
+#define WS_SEND_STACK           4096
+
+static ws_sendq_t ws_txq;
+static uint8_t *ws_txq_mem = NULL;      /* Class rings + send buffer (PSRAM) */
+static uint8_t *ws_tx_buf = NULL;
+static SemaphoreHandle_t ws_txq_lock = NULL;
+static TaskHandle_t ws_sender_handle = NULL;
+
+/* WiFi power save is off while audio flows in either direction, and back
+ * to modem sleep once the turn has been quiet this long */
+#define VOICE_IDLE_MS        CONFIG_WIFI_LOW_LATENCY_IDLE_MS
+
+static volatile int64_t voice_activity_us = 0;
+
+static void voice_activity(void)
+{
+    voice_activity_us = esp_timer_get_time();
+    wifi_set_low_latency(true);
+}
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+/* Keepalive: timestamped ping/pong for RTT and half-open detection, link
+ * report to the server, exponential reconnect backoff */
+#define WS_KA_POLL_MS        250
+#define WS_KA_STACK          4096
+
+static ws_keepalive_t ws_ka;
+static SemaphoreHandle_t ws_ka_lock = NULL;
+static TaskHandle_t ws_ka_handle = NULL;
+static volatile bool ws_restart_pending = false;    /* Dead link stopped, restart due */
+static uint32_t ws_restart_at = 0;
+static volatile bool ws_started = false;            /* ws_client_start() has returned */
+
+/* Server switch requested by another task; applied by the keepalive loop
+ * so it never overlaps ws_client_init()/ws_client_start() */
+static portMUX_TYPE ws_switch_mux = portMUX_INITIALIZER_UNLOCKED;
+static char ws_switch_url[WS_URL_MAX_LEN];
+static volatile bool ws_switch_pending = false;
+static int64_t ws_up_us = 0;            /* Current session connected at */
+static uint32_t ws_sessions = 0;
+static int link_rssi = 0;               /* Sampled with every ping */
+static int link_rssi_min = 0;           /* Weakest since the last report */
+
+/* ------------------------------------------------------------------ */
+/* Codec Negotiation                                                  */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Advertise audio codecs to the server (sent on every connect)
+ *
+ * {"type":"hello","data":{"uplink":"pcm","uplink_rate":16000,"frame_ms":60,
+ *                         "tts":["opus","pcm"],"tts_rate":24000,"ctl":["tlv","json"]}}
+ */
+static void ws_send_hello(void)
+{
+    char msg[224];
+    bool uplink_opus = (hal_opus_get_mode() == HAL_OPUS_MODE_OPUS);
+    /* 16kHz mono PCM16 = 32 bytes per ms */
+    int frame_ms = uplink_opus ? hal_opus_get_frame_bytes() / 32 : 60;
+
+#ifdef CONFIG_TTS_CODEC_OPUS
+    const char *tts = "[\"opus\",\"pcm\"]";
+#else
+    const char *tts = "[\"pcm\"]";
+#endif
+#ifdef CONFIG_WS_CONTROL_TLV
+    const char *ctl = "[\"tlv\",\"json\"]";
+#else
+    const char *ctl = "[\"json\"]";
+#endif
+
+    snprintf(msg, sizeof(msg),
+             "{\"type\":\"hello\",\"data\":{\"uplink\":\"%s\",\"uplink_rate\":16000,"
+             "\"frame_ms\":%d,\"tts\":%s,\"tts_rate\":%d,\"ctl\":%s}}",
+             uplink_opus ? "opus" : "pcm", frame_ms, tts, TTS_DEFAULT_RATE, ctl);
+
+    if (ws_client_send_text(msg) < 0) {
+        ESP_LOGW(TAG, "Failed to send hello");
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Received Messages                                                  */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Complete text or buffered binary message (WS task). The slot goes back
+ * to the pool before returning.
+ */
+static void ws_on_message(ws_reasm_msg_t *msg, void *ctx)
+{
+    if (msg->op == WS_REASM_OP_TEXT) {
+        char *text = (char *)msg->data;  /* NUL-terminated by ws_reasm */
+        ESP_LOGD(TAG, "WS received (%d bytes): %s", msg->len, text);
+
+        /* End TTS playback when receiving tts_end or non-TTS message */
+        if (ws_tts_is_playing()) {
+            /* Check if this is tts_end message */
+            if (strstr(text, "\"tts_end\"") != NULL) {
+                /* tts_end will be handled by router */
+            } else if (strstr(text, "\"type\"") == NULL) {
+                /* Not a JSON message, end TTS */
+                ws_tts_complete();
+            }
+        }
+
+        /* Route JSON messages */
+        if (text[0] == '{') {
+            ws_route_message(text);
+        }
+    } else if (!ctl_tlv) {
+        /* Binary message (TTS audio - Opus packet, or PCM when not streamed) */
+        ESP_LOGD(TAG, "WS received binary: %d bytes", msg->len);
+        ws_handle_tts_binary(msg->data, msg->len);
+    } else if (msg->len >= WS_TLV_HDR_LEN && msg->data[0] == WS_TLV_CH_AUDIO) {
+        ESP_LOGD(TAG, "WS received audio: %d bytes", msg->len - WS_TLV_HDR_LEN);
+        ws_handle_tts_binary(msg->data + WS_TLV_HDR_LEN, msg->len - WS_TLV_HDR_LEN);
+    } else if (ws_route_binary(msg->data, msg->len) == WS_MSG_UNKNOWN) {
+        ESP_LOGW(TAG, "Bad binary frame (channel 0x%02x, %d bytes)",
+                 msg->len > 0 ? msg->data[0] : 0, msg->len);
+    }
+
+    ws_reasm_release(&ws_rx, msg);
+}
+
+/**
+ * Raw PCM TTS straight from the client's receive buffer, whole samples
+ */
+static void ws_on_stream(const uint8_t *data, int len, bool last, void *ctx)
+{
+    if (len > 0) {
+        ESP_LOGD(TAG, "WS received PCM: %d bytes%s", len, last ? " (end)" : "");
+        ws_handle_tts_binary(data, len);
+    }
+}
+
+static void ws_rx_init(void)
+{
+    int size = ws_reasm_storage_size(WS_RX_SLOT_SIZE, WS_RX_SLOT_COUNT);
+
+    ws_rx_mem = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    if (!ws_rx_mem) {
+        ws_rx_mem = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if (!ws_rx_mem ||
+        ws_reasm_init(&ws_rx, ws_rx_mem, WS_RX_SLOT_SIZE, WS_RX_SLOT_COUNT,
+                      ws_on_message, ws_on_stream, 2, NULL) != 0) {
+        ESP_LOGE(TAG, "No memory for WS receive buffers");
+        heap_caps_free(ws_rx_mem);
+        ws_rx_mem = NULL;
+        return;
+    }
+    ESP_LOGI(TAG, "WS receive pool: %d x %d KB", WS_RX_SLOT_COUNT, WS_RX_SLOT_SIZE / 1024);
+}
 
 /* ------------------------------------------------------------------ */
 /* WebSocket Event Handler                                            */
 /* ------------------------------------------------------------------ */
 
+/**
+ * Session teardown: on WEBSOCKET_EVENT_DISCONNECTED, and after a dead link
+ * is stopped (esp_websocket_client_stop() posts no DISCONNECTED event)
+ */
+static void ws_session_down(void)
+{
+    is_connected = false;
+    if (ws_ka_lock) {
+        xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+        ws_keepalive_on_disconnected(&ws_ka);
+        xSemaphoreGive(ws_ka_lock);
+    }
+    /* A message cut off by the disconnect never completes */
+    ws_reasm_reset(&ws_rx);
+    /* Queued uplink belongs to the old session (hello is resent) */
+    if (ws_sender_handle) {
+        xSemaphoreTake(ws_txq_lock, portMAX_DELAY);
+        ws_sendq_clear(&ws_txq);
+        xSemaphoreGive(ws_txq_lock);
+    }
+    /* Show standby when disconnected */
+    display_update("Disconnected", "standby", 0, NULL);
+}
+
 static void ws_event_handler(void *handler_args, esp_event_base_t base,
                              int32_t event_id, void *event_data)
 {
@@ -45,48 +279,43 @@ static void ws_event_handler(void *handler_args, esp_event_base_t base,
         case WEBSOCKET_EVENT_CONNECTED:
             ESP_LOGI(TAG, "WebSocket connected");
             is_connected = true;
+            ws_up_us = esp_timer_get_time();
+            ws_sessions++;
+            if (ws_ka_lock) {
+                xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+                ws_keepalive_on_connected(&ws_ka, now_ms());
+                xSemaphoreGive(ws_ka_lock);
+            }
+            /* Raw PCM TTS and JSON control until the server confirms otherwise */
+            ws_client_set_tts_codec("pcm", TTS_DEFAULT_RATE);
+            ws_client_set_control_encoding("json");
+            ws_send_hello();
             /* Show happy greeting when connected */
             display_update(NULL, "happy", 0, NULL);
             break;
 
         case WEBSOCKET_EVENT_DISCONNECTED:
             ESP_LOGW(TAG, "WebSocket disconnected");
-            is_connected = false;
-            /* Show standby when disconnected */
-            display_update("Disconnected", "standby", 0, NULL);
+            ws_session_down();
+            if (ws_ka_lock) {
+                /* Applies to the client's own reconnect loop */
+                xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+                uint32_t delay = ws_keepalive_next_backoff(&ws_ka);
+                xSemaphoreGive(ws_ka_lock);
+                esp_websocket_client_set_reconnect_timeout(ws_client, delay);
+                ESP_LOGI(TAG, "Reconnect in %lu ms", (unsigned long)delay);
+            }
             break;
 
         case WEBSOCKET_EVENT_DATA:
-            if (data->op_code == WS_TRANSPORT_OPCODES_TEXT) {
-                /* Handle server text messages */
-                char *msg = strndup((char *)data->data_ptr, data->data_len);
-                if (msg) {
-                    /* Use ESP_LOGD to avoid flooding logs with high-frequency messages */
-                    ESP_LOGI(TAG, "WS received: %s", msg);
-
-                    /* End TTS playback when receiving tts_end or non-TTS message */
-                    if (tts_playing) {
-                        /* Check if this is tts_end message */
-                        if (strstr(msg, "\"tts_end\"") != NULL) {
-                            /* tts_end will be handled by router */
-                        } else if (strstr(msg, "\"type\"") == NULL) {
-                            /* Not a JSON message, end TTS */
-                            ws_tts_complete();
-                        }
-                    }
-
-                    /* Route JSON messages */
-                    if (msg[0] == '{') {
-                        ws_route_message(msg);
-                    }
-
-                    free(msg);
-                }
+            if (!ws_rx_mem) {
+                break;
             }
-            else if (data->op_code == WS_TRANSPORT_OPCODES_BINARY) {
-                /* Handle binary message (TTS audio - raw PCM) */
-                ESP_LOGI(TAG, "WS received binary: %d bytes", data->data_len);
-                ws_handle_tts_binary((const uint8_t *)data->data_ptr, data->data_len);
+            if (ws_reasm_feed(&ws_rx, data->op_code, data->fin,
+                              (const uint8_t *)data->data_ptr, data->data_len,
+                              data->payload_len, data->payload_offset) < 0) {
+                ESP_LOGW(TAG, "WS message dropped (op %d, %d bytes)",
+                         data->op_code, data->payload_len);
             }
             break;
 
@@ -99,19 +328,550 @@ static void ws_event_handler(void *handler_args, esp_event_base_t base,
     }
 }
 
+/* ------------------------------------------------------------------ */
+/* TTS Playback Task                                                  */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Open the audio path for a TTS stream, or follow a rate change when the
+ * next stream starts while it is still open
+ */
+static void tts_start_playback(int sample_rate)
+{
+    display_update("", "speaking", 0, NULL);
+
+    if (tts_playing) {
+        hal_audio_set_sample_rate(sample_rate);
+        return;
+    }
+
+#ifdef CONFIG_ENABLE_WAKE_WORD
+    /* Pause wake word detection before TTS to avoid I2S conflicts */
+    voice_recorder_pause_wake_word();
+#endif
+
+    hal_audio_set_playback_mode(true);
+
+    /* Tell the HAL the TTS stream rate (火山引擎 TTS, 24kHz by default).
+     * The codec stays at its fixed rate; only the resampler follows. */
+    hal_audio_set_sample_rate(sample_rate);
+    hal_audio_start();
+    tts_playing = true;
+}
+
+/**
+ * Let the last DMA buffers play out, then release the audio path
+ * @return 0 when done, -1 if a barge-in took over meanwhile
+ */
+static int tts_finish_playback(void)
+{
+    /* Wait for the last sample to leave the DAC (DMA sent events) */
+    int64_t t0 = esp_timer_get_time();
+    int queued_ms = hal_audio_get_pending_ms();
+    if (hal_audio_wait_drain(TTS_DRAIN_TIMEOUT_MS) != 0) {
+        ESP_LOGW(TAG, "TTS drain timed out (%d ms still queued)", hal_audio_get_pending_ms());
+    }
+    ESP_LOGI(TAG, "TTS playback complete, tail %d ms queued, drained in %d ms",
+             queued_ms, (int)((esp_timer_get_time() - t0) / 1000));
+    if (!tts_playing) {
+        return -1;
+    }
+
+    hal_audio_stop();
+    hal_audio_set_playback_mode(false);
+    /* No sample rate switch back: the codec rate is fixed, the mic path
+     * is resampled to 16kHz in the HAL */
+
+    display_update(NULL, "happy", 0, NULL);
+    tts_playing = false;
+
+    if (tts_jb_mem) {
+        tts_jitter_stats_t st;
+        tts_jitter_get_stats(&tts_jb, &st);
+        ESP_LOGI(TAG, "TTS jitter: target %d ms, peak %d ms, underruns %lu, overruns %lu",
+                 st.target_ms, st.high_water_ms, st.underruns, st.overruns);
+    }
+    return 0;
+}
+
+static void tts_resume_listening(void)
+{
+#ifdef CONFIG_ENABLE_WAKE_WORD
+    /* Always resume wake word detection after tts_end, regardless of TTS playback state */
+    ESP_LOGI(TAG, "TTS complete, resuming wake word detection");
+    hal_audio_start();
+    voice_recorder_resume_wake_word();
+#endif
+}
+
+/**
+ * Drains the jitter buffer to I2S; hal_audio_write() paces it in real time.
+ * While the buffer prefills (start or after an underrun) the codec idles.
+ * Owns the audio path: opens it when pop reaches a new stream (a reply
+ * queued behind the previous tail only switches the rate) and releases it
+ * once the last stream has played out.
+ */
+static void tts_player_task(void *arg)
+{
+    static uint8_t chunk[48 * 2 * TTS_PLAY_CHUNK_MS];
+    uint32_t stream = 0;
+    int rate = tts_rate;
+
+    (void)arg;
+    while (1) {
+        int n = tts_jitter_pop(&tts_jb, chunk, rate / 1000 * 2 * TTS_PLAY_CHUNK_MS);
+
+        uint32_t s = tts_jitter_stream(&tts_jb, &rate);
+        if (s != stream) {
+            stream = s;
+            ESP_LOGI(TAG, "TTS stream %lu started (%d Hz)", (unsigned long)s, rate);
+            tts_start_playback(rate);
+        }
+
+        if (n > 0) {
+            int written = hal_audio_write(chunk, n);
+            if (written != n) {
+                ESP_LOGW(TAG, "TTS playback incomplete: %d/%d", written, n);
+            }
+            continue;
+        }
+
+        /* After a barge-in tts_playing is already clear: nothing to release */
+        if (tts_playing && tts_jitter_drained(&tts_jb)) {
+            if (tts_finish_playback() == 0) {
+                tts_resume_listening();
+            }
+            continue;
+        }
+
+        /* Woken by the next frame, tts_end or barge-in */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TTS_PLAY_CHUNK_MS));
+    }
+}
+
+static void tts_player_init(void)
+{
+    tts_jitter_config_t jcfg;
+
+    if (tts_player_handle) {
+        return;
+    }
+
+    tts_jitter_default_config(&jcfg);
+    jcfg.start_ms = CONFIG_TTS_JITTER_START_MS;
+    jcfg.max_ms = CONFIG_TTS_JITTER_MAX_MS > jcfg.start_ms ? CONFIG_TTS_JITTER_MAX_MS : jcfg.start_ms;
+
+    tts_jb_mem = heap_caps_malloc(TTS_JITTER_BYTES, MALLOC_CAP_SPIRAM);
+    if (!tts_jb_mem || tts_jitter_init(&tts_jb, tts_jb_mem, TTS_JITTER_BYTES, &jcfg) != 0) {
+        ESP_LOGW(TAG, "TTS jitter buffer alloc failed, playing inline");
+        heap_caps_free(tts_jb_mem);
+        tts_jb_mem = NULL;
+        return;
+    }
+
+    if (xTaskCreate(tts_player_task, "tts_play", TTS_PLAYER_STACK, NULL, 5,
+                    &tts_player_handle) != pdPASS) {
+        ESP_LOGW(TAG, "TTS player task create failed, playing inline");
+        heap_caps_free(tts_jb_mem);
+        tts_jb_mem = NULL;
+        tts_player_handle = NULL;
+        return;
+    }
+
+    ESP_LOGI(TAG, "TTS jitter buffer: %d ms, start %d ms, max %d ms",
+             CONFIG_TTS_JITTER_BUF_MS, jcfg.start_ms, jcfg.max_ms);
+}
+
+/**
+ * Queue decoded PCM for the player. Never waits for room: the receive path
+ * must keep handling pongs, servo and tts_end, so a frame that does not
+ * fit is dropped and counted as an overrun (size CONFIG_TTS_JITTER_BUF_MS
+ * for the server's burst).
+ */
+static void tts_queue_pcm(const uint8_t *data, int len)
+{
+    if (tts_jitter_push(&tts_jb, data, len) != 0) {
+        ESP_LOGW(TAG, "TTS jitter buffer full, %d bytes dropped", len);
+    }
+    xTaskNotifyGive(tts_player_handle);
+}
+
+/* ------------------------------------------------------------------ */
+/* Uplink Send Task                                                   */
+/* ------------------------------------------------------------------ */
+
+static int ws_write(uint8_t op, const uint8_t *data, int len)
+{
+    if (op == WS_TRANSPORT_OPCODES_TEXT) {
+        return esp_websocket_client_send_text(ws_client, (const char *)data, len,
+                                              pdMS_TO_TICKS(WS_SEND_TIMEOUT_MS));
+    }
+    return esp_websocket_client_send_bin(ws_client, (const char *)data, len,
+                                         pdMS_TO_TICKS(WS_SEND_TIMEOUT_MS));
+}
+
+/**
+ * Drain the send queue, highest class first. A socket write may block up
+ * to WS_SEND_TIMEOUT_MS; meanwhile callers keep queuing.
+ */
+static void ws_sender_task(void *arg)
+{
+    uint8_t op;
+    ws_sendq_class_t cls;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (1) {
+            xSemaphoreTake(ws_txq_lock, portMAX_DELAY);
+            int len = ws_sendq_pop(&ws_txq, ws_tx_buf, WS_SEND_MAX_MSG, &op, &cls, now_ms());
+            xSemaphoreGive(ws_txq_lock);
+            if (len < 0) {
+                break;
+            }
+
+            if (!ws_client || !is_connected) {
+                continue;   /* Disconnected meanwhile: the queue is being cleared */
+            }
+            int sent = ws_write(op, ws_tx_buf, len);
+            if (sent != len) {
+                ESP_LOGW(TAG, "WS send failed (class %d): %d/%d", cls, sent, len);
+            }
+        }
+    }
+}
+
+static void ws_sender_init(void)
+{
+    const int budget[WS_SENDQ_CLASSES] = {
+        [WS_SENDQ_CONTROL] = WS_SEND_CONTROL_BYTES,
+        [WS_SENDQ_AUDIO] = WS_SEND_AUDIO_BYTES,
+        [WS_SENDQ_TELEMETRY] = WS_SEND_TELEMETRY_BYTES,
+    };
+    int size = ws_sendq_storage_size(budget);
+
+    if (ws_sender_handle) {
+        return;
+    }
+
+    ws_txq_mem = heap_caps_malloc(size + WS_SEND_MAX_MSG, MALLOC_CAP_SPIRAM);
+    ws_txq_lock = xSemaphoreCreateMutex();
+    if (!ws_txq_mem || !ws_txq_lock || ws_sendq_init(&ws_txq, ws_txq_mem, budget) != 0) {
+        ESP_LOGW(TAG, "WS send queue alloc failed, sending inline");
+        goto fail;
+    }
+    ws_tx_buf = ws_txq_mem + size;
+
+    if (xTaskCreate(ws_sender_task, "ws_send", WS_SEND_STACK, NULL, 5,
+                    &ws_sender_handle) != pdPASS) {
+        ESP_LOGW(TAG, "WS send task create failed, sending inline");
+        ws_sender_handle = NULL;
+        goto fail;
+    }
+
+    ESP_LOGI(TAG, "WS send queue: control %d KB, audio %d KB, telemetry %d KB",
+             WS_SEND_CONTROL_BYTES / 1024, WS_SEND_AUDIO_BYTES / 1024,
+             WS_SEND_TELEMETRY_BYTES / 1024);
+    return;
+
+fail:
+    heap_caps_free(ws_txq_mem);
+    ws_txq_mem = NULL;
+    if (ws_txq_lock) {
+        vSemaphoreDelete(ws_txq_lock);
+        ws_txq_lock = NULL;
+    }
+}
+
+/**
+ * Queue one message for ws_send (or write inline without the task)
+ * @return len if queued or sent, -1 if not connected or dropped
+ */
+static int ws_enqueue(ws_sendq_class_t cls, uint8_t op, uint8_t flags,
+                      const uint8_t *data, int len)
+{
+    if (!ws_client || !is_connected) {
+        return -1;
+    }
+
+    if (!ws_sender_handle) {
+        int sent = ws_write(op, data, len);
+        return sent == len ? len : -1;
+    }
+
+    if (len > WS_SEND_MAX_MSG) {
+        ESP_LOGW(TAG, "WS message too large to queue: %d bytes", len);
+        return -1;
+    }
+
+    xSemaphoreTake(ws_txq_lock, portMAX_DELAY);
+    int ret = ws_sendq_push(&ws_txq, cls, op, flags, data, len, now_ms());
+    xSemaphoreGive(ws_txq_lock);
+
+    if (ret != 0) {
+        return -1;
+    }
+    xTaskNotifyGive(ws_sender_handle);
+    return len;
+}
+
+/* ------------------------------------------------------------------ */
+/* Keepalive Task                                                     */
+/* ------------------------------------------------------------------ */
+
+/**
+ * {"type":"ping","data":{"seq":12,"t":123456}}; the server echoes data in a pong
+ */
+static void ws_send_ping(uint32_t seq)
+{
+    char msg[64];
+
+    snprintf(msg, sizeof(msg), "{\"type\":\"ping\",\"data\":{\"seq\":%lu,\"t\":%lu}}",
+             (unsigned long)seq, (unsigned long)now_ms());
+    if (ws_client_send_text(msg) < 0) {
+        ESP_LOGW(TAG, "Failed to queue ping %lu", (unsigned long)seq);
+    }
+
+    int rssi = wifi_get_rssi();
+    if (rssi != 0) {
+        link_rssi = rssi;
+        if (link_rssi_min == 0 || rssi < link_rssi_min) {
+            link_rssi_min = rssi;
+        }
+    }
+}
+
+/**
+ * Compact link quality summary (telemetry class: dropped first under load)
+ *
+ * {"type":"link","data":{"rtt":42,"var":6,"p50":38,"p90":71,"p99":180,"n":64,
+ *                        "lost":1,"rssi":-58,"rssi_min":-66,"rc":2,"up":3600,
+ *                        "heap":..,"heap_min":..,"frag":..,"json_heap":..,
+ *                        "servo_p99":500,"ui_p99":16000,"q":[1,3],"qdrop":0}}
+ */
+static void ws_send_link_report(void)
+{
+    ws_keepalive_stats_t st;
+    ws_dispatch_queue_stats_t dq[WS_DISPATCH_CLASSES] = { 0 };
+    ws_dispatch_handler_stats_t dh[WS_DISPATCH_HANDLERS] = { 0 };
+    char msg[400];
+
+    /* Internal RAM fragmentation: free space not usable as one block */
+    size_t heap_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    int frag = heap_free ? 100 - (int)(heap_largest * 100 / heap_free) : 0;
+
+    /* Handler latency: servo alone, worst of the ui worker's handlers */
+    uint32_t ui_p99 = 0, qdrop = 0;
+    ws_handlers_get_dispatch_stats(dq, dh);
+    for (int i = WS_DISPATCH_H_DISPLAY; i < WS_DISPATCH_HANDLERS; i++) {
+        uint32_t p = ws_dispatch_percentile_us(&dh[i], 99);
+        if (p > ui_p99) {
+            ui_p99 = p;
+        }
+    }
+    for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+        qdrop += dq[i].dropped;
+    }
+
+    ws_client_get_keepalive_stats(&st);
+    snprintf(msg, sizeof(msg),
+             "{\"type\":\"link\",\"data\":{\"rtt\":%d,\"var\":%d,\"p50\":%d,\"p90\":%d,"
+             "\"p99\":%d,\"n\":%d,\"lost\":%lu,\"rssi\":%d,\"rssi_min\":%d,\"rc\":%lu,\"up\":%lu,"
+             "\"heap\":%u,\"heap_min\":%u,\"frag\":%d,\"json_heap\":%lu,"
+             "\"servo_p99\":%lu,\"ui_p99\":%lu,\"q\":[%d,%d],\"qdrop\":%lu}}",
+             st.rtt_ewma_ms, st.rtt_var_ms, st.rtt_p50_ms, st.rtt_p90_ms, st.rtt_p99_ms,
+             st.samples, (unsigned long)st.missed, link_rssi, link_rssi_min,
+             (unsigned long)(ws_sessions ? ws_sessions - 1 : 0),
+             (unsigned long)((esp_timer_get_time() - ws_up_us) / 1000000),
+             (unsigned)heap_free, (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+             frag, (unsigned long)json_arena_heap_allocs(),
+             (unsigned long)ws_dispatch_percentile_us(&dh[WS_DISPATCH_H_SERVO], 99),
+             (unsigned long)ui_p99, dq[WS_DISPATCH_MOTION].high_water,
+             dq[WS_DISPATCH_DISPLAY].high_water,
+             (unsigned long)qdrop);
+    ws_client_send_telemetry(msg);
+    link_rssi_min = link_rssi;
+}
+
+/**
+ * Schedule the client restart after the next backoff delay; the keepalive
+ * loop starts it once due, so the task keeps polling meanwhile
+ */
+static uint32_t ws_schedule_restart(void)
+{
+    xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+    uint32_t delay = ws_keepalive_next_backoff(&ws_ka);
+    xSemaphoreGive(ws_ka_lock);
+
+    ws_restart_at = now_ms() + delay;
+    ws_restart_pending = true;
+    return delay;
+}
+
+/**
+ * Half-open TCP: writes still succeed locally, nothing comes back. Drop
+ * the session and reconnect after the backoff delay.
+ */
+static void ws_reconnect_dead(void)
+{
+    esp_websocket_client_stop(ws_client);
+    ws_session_down();
+
+    uint32_t delay = ws_schedule_restart();
+    ESP_LOGW(TAG, "No pong for %d pings, reconnecting in %lu ms",
+             CONFIG_WS_PING_MAX_MISSED, (unsigned long)delay);
+}
+
+static void ws_restart_if_due(void)
+{
+    if (!ws_restart_pending || (int32_t)(now_ms() - ws_restart_at) < 0) {
+        return;
+    }
+
+    ws_restart_pending = false;
+    if (ws_client && esp_websocket_client_start(ws_client) != ESP_OK) {
+        uint32_t delay = ws_schedule_restart();
+        ESP_LOGE(TAG, "WebSocket restart failed, retrying in %lu ms", (unsigned long)delay);
+    }
+}
+
+/* Take the requested server URL, if any */
+static bool ws_take_switch(char *url)
+{
+    bool pending;
+
+    taskENTER_CRITICAL(&ws_switch_mux);
+    pending = ws_switch_pending;
+    if (pending) {
+        memcpy(url, ws_switch_url, WS_URL_MAX_LEN);
+        ws_switch_pending = false;
+    }
+    taskEXIT_CRITICAL(&ws_switch_mux);
+    return pending;
+}
+
+static void ws_switch_if_pending(void)
+{
+    char url[WS_URL_MAX_LEN];
+
+    if (!ws_switch_pending || !ws_started || !ws_take_switch(url) ||
+        strcmp(url, ws_server_url) == 0) {
+        return;
+    }
+
+    /* The URI can only change while the client is stopped */
+    ws_restart_pending = false;
+    esp_websocket_client_stop(ws_client);
+    ws_session_down();
+    strcpy(ws_server_url, url);
+    if (esp_websocket_client_set_uri(ws_client, ws_server_url) != ESP_OK ||
+        esp_websocket_client_start(ws_client) != ESP_OK) {
+        uint32_t delay = ws_schedule_restart();
+        ESP_LOGE(TAG, "Failed to switch server to %s, retrying in %lu ms",
+                 ws_server_url, (unsigned long)delay);
+        return;
+    }
+    ESP_LOGI(TAG, "Server switched to: %s", ws_server_url);
+}
+
+static void ws_keepalive_task(void *arg)
+{
+    const uint32_t report_ms = CONFIG_WS_LINK_REPORT_SEC * 1000;
+    uint32_t next_report = now_ms() + report_ms;
+    uint32_t seq = 0;
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(WS_KA_POLL_MS));
+
+        xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+        ws_keepalive_action_t action = ws_keepalive_poll(&ws_ka, now_ms(), &seq);
+        xSemaphoreGive(ws_ka_lock);
+
+        if (action == WS_KEEPALIVE_PING) {
+            ws_send_ping(seq);
+        } else if (action == WS_KEEPALIVE_DEAD && ws_client) {
+            ws_reconnect_dead();
+        }
+        ws_switch_if_pending();
+        ws_restart_if_due();
+
+        if (report_ms > 0 && (int32_t)(now_ms() - next_report) >= 0) {
+            next_report = now_ms() + report_ms;
+            if (is_connected) {
+                ws_send_link_report();
+            }
+        }
+    }
+}
+
+static void ws_keepalive_start(void)
+{
+    const ws_keepalive_config_t cfg = {
+        .interval_ms = CONFIG_WS_PING_INTERVAL_SEC * 1000,
+        .timeout_ms = CONFIG_WS_PONG_TIMEOUT_SEC * 1000,
+        .max_missed = CONFIG_WS_PING_MAX_MISSED,
+        .backoff_min_ms = CONFIG_WS_RECONNECT_MIN_MS,
+        .backoff_max_ms = CONFIG_WS_RECONNECT_MAX_MS,
+    };
+
+    if (ws_ka_handle) {
+        return;
+    }
+    if (ws_keepalive_init(&ws_ka, &cfg, esp_random()) != 0) {
+        ESP_LOGE(TAG, "Invalid keepalive config (pong timeout > ping interval?)");
+        return;
+    }
+
+    ws_ka_lock = xSemaphoreCreateMutex();
+    if (!ws_ka_lock ||
+        xTaskCreate(ws_keepalive_task, "ws_keepalive", WS_KA_STACK, NULL, 4,
+                    &ws_ka_handle) != pdPASS) {
+        ESP_LOGW(TAG, "Keepalive task create failed");
+        ws_ka_handle = NULL;
+        if (ws_ka_lock) {
+            vSemaphoreDelete(ws_ka_lock);
+            ws_ka_lock = NULL;
+        }
+        return;
+    }
+    ESP_LOGI(TAG, "Keepalive: ping every %d s, dead after %d missed",
+             CONFIG_WS_PING_INTERVAL_SEC, CONFIG_WS_PING_MAX_MISSED);
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Initialize WebSocket Client                                */
 /* ------------------------------------------------------------------ */
 
 int ws_client_init(void)
 {
+    char url[WS_URL_MAX_LEN];
+
+    if (ws_take_switch(url)) {
+        strcpy(ws_server_url, url);
+    }
+
     esp_websocket_client_config_t cfg = {
         .uri = ws_server_url,
         .network_timeout_ms = WS_TIMEOUT_MS,
-        .buffer_size = 16384,  /* Increased for audio streaming (16KB) */
+        .buffer_size = WS_RX_BUFFER_SIZE,  /* Increased for audio streaming (16KB) */
         .task_stack = 16384,   /* Increased stack size (16KB) */
     };
 
+    /* Decoded TTS buffer lives in PSRAM (internal RAM fallback) */
+    if (!tts_pcm_buf) {
+        tts_pcm_buf = heap_caps_malloc(TTS_PCM_BUF_SIZE, MALLOC_CAP_SPIRAM);
+        if (!tts_pcm_buf) {
+            tts_pcm_buf = heap_caps_malloc(TTS_PCM_BUF_SIZE, MALLOC_CAP_8BIT);
+        }
+    }
+
+    tts_player_init();
+    if (!ws_rx_mem) {
+        ws_rx_init();
+    }
+    ws_sender_init();
+
     ws_client = esp_websocket_client_init(&cfg);
     if (!ws_client) {
         ESP_LOGE(TAG, "Failed to init WebSocket client");
@@ -119,6 +879,7 @@ int ws_client_init(void)
     }
 
     esp_websocket_register_events(ws_client, WEBSOCKET_EVENT_ANY, ws_event_handler, NULL);
+    ws_keepalive_start();
 
     ESP_LOGI(TAG, "WebSocket client initialized (URL: %s)", ws_server_url);
     return 0;
@@ -152,6 +913,75 @@ const char* ws_client_get_server_url(void)
     return ws_server_url;
 }
 
+int ws_client_switch_server(const char *url)
+{
+    if (!url || strlen(url) >= WS_URL_MAX_LEN) {
+        ESP_LOGE(TAG, "Invalid URL or URL too long");
+        return -1;
+    }
+
+    taskENTER_CRITICAL(&ws_switch_mux);
+    strcpy(ws_switch_url, url);
+    ws_switch_pending = true;
+    taskEXIT_CRITICAL(&ws_switch_mux);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: TTS Codec Selection                                        */
+/* ------------------------------------------------------------------ */
+
+int ws_client_set_tts_codec(const char *codec, int sample_rate)
+{
+    if (!codec) {
+        return -1;
+    }
+
+    /* Never switch codec in the middle of a TTS stream */
+    if (ws_tts_is_playing()) {
+        ESP_LOGW(TAG, "TTS playing, codec change ignored");
+        return -1;
+    }
+
+    if (strcmp(codec, "opus") == 0) {
+#ifdef CONFIG_TTS_CODEC_OPUS
+        if (tts_pcm_buf && hal_opus_decoder_init(HAL_OPUS_MODE_OPUS, sample_rate) == 0) {
+            tts_rate = sample_rate;
+            ws_reasm_set_stream_binary(&ws_rx, false);  /* Decoder needs whole packets */
+            ESP_LOGI(TAG, "TTS codec: Opus %d Hz", tts_rate);
+            return 0;
+        }
+#endif
+        ESP_LOGW(TAG, "TTS Opus not available, using PCM");
+    }
+
+    hal_opus_decoder_init(HAL_OPUS_MODE_PCM, 0);
+    tts_rate = TTS_DEFAULT_RATE;
+    ws_reasm_set_stream_binary(&ws_rx, true);
+    return (strcmp(codec, "pcm") == 0) ? 0 : -1;
+}
+
+int ws_client_set_control_encoding(const char *ctl)
+{
+    if (!ctl) {
+        return -1;
+    }
+
+#ifdef CONFIG_WS_CONTROL_TLV
+    if (strcmp(ctl, "tlv") == 0) {
+        ctl_tlv = true;
+        /* Only the audio channel streams; control frames are buffered */
+        ws_reasm_set_stream_tag(&ws_rx, WS_TLV_CH_AUDIO, WS_TLV_HDR_LEN);
+        ESP_LOGI(TAG, "Control messages: binary TLV");
+        return 0;
+    }
+#endif
+
+    ctl_tlv = false;
+    ws_reasm_set_stream_tag(&ws_rx, -1, 0);
+    return (strcmp(ctl, "json") == 0) ? 0 : -1;
+}
+
 /* ------------------------------------------------------------------ */
 /* Public: Start/Stop Connection                                      */
 /* ------------------------------------------------------------------ */
@@ -169,12 +999,15 @@ int ws_client_start(void)
         return -1;
     }
 
+    ws_started = true;
     return 0;
 }
 
 void ws_client_stop(void)
 {
     if (ws_client) {
+        ws_started = false;
+        ws_restart_pending = false;
         esp_websocket_client_stop(ws_client);
         esp_websocket_client_destroy(ws_client);
         ws_client = NULL;
@@ -188,22 +1021,25 @@ void ws_client_stop(void)
 
 int ws_client_send_binary(const uint8_t *data, int len)
 {
-    if (!ws_client || !is_connected) {
-        return -1;
-    }
-
-    int sent = esp_websocket_client_send_bin(ws_client, (const char *)data, len, pdMS_TO_TICKS(1000));
-    return sent;
+    return ws_enqueue(WS_SENDQ_AUDIO, WS_TRANSPORT_OPCODES_BINARY, 0, data, len);
 }
 
 int ws_client_send_text(const char *text)
 {
-    if (!ws_client || !is_connected) {
+    if (!text) {
         return -1;
     }
+    return ws_enqueue(WS_SENDQ_CONTROL, WS_TRANSPORT_OPCODES_TEXT, 0,
+                      (const uint8_t *)text, strlen(text));
+}
 
-    int sent = esp_websocket_client_send_text(ws_client, text, strlen(text), pdMS_TO_TICKS(1000));
-    return sent;
+int ws_client_send_telemetry(const char *text)
+{
+    if (!text) {
+        return -1;
+    }
+    return ws_enqueue(WS_SENDQ_TELEMETRY, WS_TRANSPORT_OPCODES_TEXT, 0,
+                      (const uint8_t *)text, strlen(text));
 }
 
 int ws_client_is_connected(void)
@@ -211,6 +1047,19 @@ int ws_client_is_connected(void)
     return is_connected ? 1 : 0;
 }
 
+int ws_client_wait_connected(int timeout_ms)
+{
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    while (!is_connected) {
+        if (esp_timer_get_time() >= deadline) {
+            return -1;
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+    return 0;
+}
+
 /* ------------------------------------------------------------------ */
 /* Implementation of WebSocket interface for button_voice             */
 /* ------------------------------------------------------------------ */
@@ -231,12 +1080,11 @@ int ws_send_audio(const uint8_t *data, int len)
         return -1;
     }
 
-    /* Send raw PCM directly, no header */
-    /* Increased timeout to 5 seconds for better reliability */
-    int sent = esp_websocket_client_send_bin(ws_client, (const char *)data, len, pdMS_TO_TICKS(5000));
+    voice_activity();
 
-    if (sent != len) {
-        ESP_LOGW(TAG, "Audio send incomplete: %d/%d", sent, len);
+    /* Send raw PCM directly, no header (queued; never blocks the caller) */
+    if (ws_enqueue(WS_SENDQ_AUDIO, WS_TRANSPORT_OPCODES_BINARY, 0, data, len) != len) {
+        ESP_LOGW(TAG, "Audio frame dropped: %d bytes", len);
         return -1;
     }
 
@@ -245,26 +1093,34 @@ int ws_send_audio(const uint8_t *data, int len)
 
 int ws_send_audio_end(void)
 {
+    /* A new turn is complete: TTS from here on answers it */
+    tts_discard = false;
+
     /* Start response timeout timer */
     waiting_for_response = true;
     timeout_display_count = 0;  /* Reset timeout display counter */
     response_wait_start_time = esp_timer_get_time();
     ESP_LOGI(TAG, "Audio end sent, waiting for response (timeout %dms)", RESPONSE_TIMEOUT_MS);
 
-    /* Send audio end marker (v2.0 protocol: "over") */
-    return ws_client_send_text("over");
+    /* Send audio end marker (v2.0 protocol: "over"). It rides in the audio
+     * class, after the frames it terminates, and is never dropped as stale. */
+    return ws_enqueue(WS_SENDQ_AUDIO, WS_TRANSPORT_OPCODES_TEXT, WS_SENDQ_PINNED,
+                      (const uint8_t *)"over", 4) == 4 ? 0 : -1;
 }
 
 /* ------------------------------------------------------------------ */
-/* TTS Binary Frame Handling (v2.0 - Raw PCM)                         */
+/* TTS Binary Frame Handling (v2.0 - Raw PCM / Opus)                  */
 /* ------------------------------------------------------------------ */
 
 /**
- * Play TTS audio from binary frame (Raw PCM)
+ * Play TTS audio from binary frame
  *
  * Frame format (v2.0):
  *   [0-n]   PCM audio data (16-bit, 24kHz, mono)
  *
+ * Frame format (hello negotiated "opus"):
+ *   [0-n]   One Opus packet, decoded into tts_pcm_buf (PSRAM)
+ *
  * @param data Binary frame data
  * @param len Frame length
  */
@@ -275,28 +1131,49 @@ void ws_handle_tts_binary(const uint8_t *data, int len)
         return;
     }
 
-    /* Only update display and start audio on first chunk */
-    if (!tts_playing) {
+    /* Interrupted reply: the server may still be streaming it */
+    if (tts_discard) {
+        ESP_LOGD(TAG, "TTS frame dropped after barge-in: %d bytes", len);
+        return;
+    }
+
+    voice_activity();
+
+    /* First chunk: with the player task only mark the stream start; it
+     * switches over once the previous reply's tail has played out */
+    if (tts_jb_mem ? !tts_rx_open : !tts_playing) {
+        if (tts_jb_mem && tts_jitter_begin(&tts_jb, tts_rate) != 0) {
+            ESP_LOGW(TAG, "TTS stream marks full, %d bytes dropped", len);
+            return;
+        }
         ESP_LOGI(TAG, "TTS started, first chunk: %d bytes", len);
         /* Clear response wait flag - server has responded with TTS */
         waiting_for_response = false;
-        display_update("", "speaking", 0, NULL);
-
-#ifdef CONFIG_ENABLE_WAKE_WORD
-        /* Pause wake word detection before TTS to avoid I2S conflicts */
-        voice_recorder_pause_wake_word();
-#endif
+        if (tts_jb_mem) {
+            tts_rx_open = true;
+        } else {
+            tts_start_playback(tts_rate);
+        }
+    }
 
-        /* Mark as playback mode to skip unnecessary I2S stop in sample rate switch */
-        hal_audio_set_playback_mode(true);
+    /* Opus: decode into the PSRAM buffer first */
+    if (hal_opus_get_decoder_mode() == HAL_OPUS_MODE_OPUS) {
+        int pcm_len = hal_opus_decode(data, len, tts_pcm_buf, TTS_PCM_BUF_SIZE);
+        if (pcm_len <= 0) {
+            ESP_LOGW(TAG, "TTS Opus packet dropped: %d bytes", len);
+            return;
+        }
+        data = tts_pcm_buf;
+        len = pcm_len;
+    }
 
-        /* Switch to 24kHz for TTS playback (火山引擎 TTS) */
-        hal_audio_set_sample_rate(24000);
-        hal_audio_start();
-        tts_playing = true;
+    /* Raw PCM (no AUD1 header in v2.0): queue for the player task */
+    if (tts_jb_mem) {
+        tts_queue_pcm(data, len);
+        return;
     }
 
-    /* Play raw PCM directly (no AUD1 header in v2.0) */
+    /* No jitter buffer: play inline (blocks this task in real time) */
     ESP_LOGD(TAG, "Playing PCM: %d bytes", len);
     int written = hal_audio_write(data, len);
     if (written != len) {
@@ -306,40 +1183,138 @@ void ws_handle_tts_binary(const uint8_t *data, int len)
 
 /**
  * Signal TTS playback complete (called by application or tts_end handler)
- * Waits for I2S DMA buffer to finish playing before switching state
+ * With the player task this only marks the end of the stream; the player
+ * finishes once the queued tail has played out. Inline playback waits for
+ * the I2S DMA buffer here.
  */
 void ws_tts_complete(void)
 {
+    /* tts_end of an interrupted reply: the barge-in turn owns the state now */
+    if (tts_discard) {
+        tts_discard = false;
+        ESP_LOGI(TAG, "Interrupted TTS ended");
+        if (voice_recorder_get_state() == VOICE_STATE_RECORDING) {
+            return;
+        }
+    }
+
     /* Clear response wait flag regardless of tts_playing state */
     waiting_for_response = false;
 
-    if (tts_playing) {
-        ESP_LOGI(TAG, "TTS playback complete");
+    if (tts_jb_mem) {
+        if (tts_rx_open) {
+            tts_rx_open = false;
+            if (tts_jitter_end(&tts_jb) != 0) {
+                ESP_LOGW(TAG, "TTS stream marks full, end left to the next reply");
+            }
+            xTaskNotifyGive(tts_player_handle);
+            return;
+        }
+        if (tts_playing) {
+            return;  /* The player resumes listening after the tail */
+        }
+    } else if (tts_playing && tts_finish_playback() != 0) {
+        return;
+    }
 
-        /* Wait for I2S DMA buffer to finish playing (~500ms buffer) */
-        vTaskDelay(pdMS_TO_TICKS(500));
+    tts_resume_listening();
+}
 
-        hal_audio_stop();
-        /* Restore recording mode before sample rate switch (avoid I2S error) */
-        hal_audio_set_playback_mode(false);
+bool ws_tts_is_playing(void)
+{
+    return tts_playing || tts_rx_open;
+}
 
-        /* Wait 1 second for DMA buffer to fully drain before switching sample rate */
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        /* Restore 16kHz for recording */
-        hal_audio_set_sample_rate(16000);
+/**
+ * Barge-in (called from the wake word / AFE task while TTS plays)
+ *
+ * Device -> server: {"type":"abort","reason":"barge_in"}
+ */
+int ws_tts_barge_in(void)
+{
+    if (!ws_tts_is_playing()) {
+        return -1;
+    }
 
-        display_update(NULL, "happy", 0, NULL);
-        tts_playing = false;
+    /* Silence first, bookkeeping after: this is what the user hears.
+     * The flush comes first so the player has nothing left to write. */
+    tts_discard = true;
+    if (tts_player_handle) {
+        tts_jitter_flush(&tts_jb);
+        tts_rx_open = false;
+    }
+    hal_audio_abort_playback();
+    tts_playing = false;
+    hal_audio_set_playback_mode(false);
+    if (tts_player_handle) {
+        xTaskNotifyGive(tts_player_handle);
+    }
 
-        /* Restore recording mode for wake word detection */
+    if (ws_client_send_text("{\"type\":\"abort\",\"reason\":\"barge_in\"}") < 0) {
+        ESP_LOGW(TAG, "Failed to send abort");
     }
+    ESP_LOGI(TAG, "TTS interrupted (barge-in)");
+    return 0;
+}
 
-#ifdef CONFIG_ENABLE_WAKE_WORD
-    /* Always resume wake word detection after tts_end, regardless of TTS playback state */
-    ESP_LOGI(TAG, "TTS complete, resuming wake word detection");
-    hal_audio_start();
-    voice_recorder_resume_wake_word();
-#endif
+void ws_tts_get_stats(tts_jitter_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    if (tts_jb_mem) {
+        tts_jitter_get_stats(&tts_jb, out);
+    } else {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+void ws_client_get_rx_stats(ws_reasm_stats_t *out)
+{
+    if (out) {
+        ws_reasm_get_stats(&ws_rx, out);
+    }
+}
+
+void ws_client_get_send_stats(ws_sendq_class_t cls, ws_sendq_class_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (ws_sender_handle) {
+        xSemaphoreTake(ws_txq_lock, portMAX_DELAY);
+        ws_sendq_get_stats(&ws_txq, cls, out);
+        xSemaphoreGive(ws_txq_lock);
+    }
+}
+
+void ws_client_on_pong(uint32_t seq)
+{
+    if (!ws_ka_lock) {
+        return;
+    }
+
+    xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+    int rtt = ws_keepalive_on_pong(&ws_ka, seq, now_ms());
+    xSemaphoreGive(ws_ka_lock);
+
+    if (rtt >= 0) {
+        ESP_LOGD(TAG, "Pong %lu: %d ms", (unsigned long)seq, rtt);
+    }
+}
+
+void ws_client_get_keepalive_stats(ws_keepalive_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (ws_ka_lock) {
+        xSemaphoreTake(ws_ka_lock, portMAX_DELAY);
+        ws_keepalive_get_stats(&ws_ka, out);
+        xSemaphoreGive(ws_ka_lock);
+    }
 }
 
 /**
@@ -367,4 +1342,10 @@ void ws_tts_timeout_check(void)
         }
     }
 #endif
+
+    /* Turn over: let the radio sleep between beacons again */
+    if (!ws_tts_is_playing() && !waiting_for_response &&
+        esp_timer_get_time() - voice_activity_us > (int64_t)VOICE_IDLE_MS * 1000) {
+        wifi_set_low_latency(false);
+    }
 }
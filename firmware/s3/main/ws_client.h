@@ -2,6 +2,11 @@
 #define WS_CLIENT_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "tts_jitter.h"
+#include "ws_reasm.h"
+#include "ws_sendq.h"
+#include "ws_keepalive.h"
 
 /**
  * @file ws_client.h
@@ -26,6 +31,29 @@ int ws_client_set_server_url(const char *url);
  */
 const char* ws_client_get_server_url(void);
 
+/**
+ * Point the client at another server; safe from any task. Taken by
+ * ws_client_init(), or applied by the keepalive task (stop, reconnect)
+ * once ws_client_start() has returned.
+ * @return 0 if queued, -1 on invalid URL
+ */
+int ws_client_switch_server(const char *url);
+
+/**
+ * Select TTS downlink codec (from the server's hello reply)
+ * @param codec "pcm" or "opus"
+ * @param sample_rate TTS sample rate in Hz
+ * @return 0 on success, -1 on error (falls back to raw PCM at 24kHz)
+ */
+int ws_client_set_tts_codec(const char *codec, int sample_rate);
+
+/**
+ * Select control message encoding (from the server's hello reply)
+ * @param ctl "json" or "tlv" (binary frames with a channel header)
+ * @return 0 on success, -1 on error (stays on JSON)
+ */
+int ws_client_set_control_encoding(const char *ctl);
+
 /**
  * Start WebSocket connection
  */
@@ -36,26 +64,43 @@ int ws_client_start(void);
  */
 void ws_client_stop(void);
 
+/*
+ * Send functions queue the message for the ws_send task and return at once
+ * (control > audio > telemetry). Without the task they write inline.
+ */
+
 /**
- * Send binary data via WebSocket
+ * Send binary data via WebSocket (audio class)
  * @param data Data buffer
  * @param len Data length
- * @return Bytes sent on success, -1 on error
+ * @return Bytes queued on success, -1 if not connected or dropped
  */
 int ws_client_send_binary(const uint8_t *data, int len);
 
 /**
- * Send text message via WebSocket
+ * Send text message via WebSocket (control class, sent first)
  * @param text Text message
- * @return Bytes sent on success, -1 on error
+ * @return Bytes queued on success, -1 if not connected or queue full
  */
 int ws_client_send_text(const char *text);
 
+/**
+ * Send a status/telemetry text message (lowest class, dropped oldest-first)
+ * @return Bytes queued on success, -1 on error
+ */
+int ws_client_send_telemetry(const char *text);
+
 /**
  * Check if WebSocket is connected
  */
 int ws_client_is_connected(void);
 
+/**
+ * Wait until the client is connected
+ * @return 0 once connected, -1 on timeout
+ */
+int ws_client_wait_connected(int timeout_ms);
+
 /**
  * Send audio data via WebSocket (v2.0: raw PCM)
  * @param data Audio data (PCM 16-bit, 16kHz, mono)
@@ -71,8 +116,8 @@ int ws_send_audio(const uint8_t *data, int len);
 int ws_send_audio_end(void);
 
 /**
- * Handle TTS binary frame from WebSocket (v2.0: raw PCM)
- * @param data Binary frame data (PCM 16-bit, 24kHz, mono)
+ * Handle TTS binary frame from WebSocket (v2.0: raw PCM, or one Opus packet)
+ * @param data Binary frame data (PCM 16-bit, 24kHz, mono, or Opus packet)
  * @param len Frame length
  */
 void ws_handle_tts_binary(const uint8_t *data, int len);
@@ -83,6 +128,48 @@ void ws_handle_tts_binary(const uint8_t *data, int len);
  */
 void ws_tts_complete(void);
 
+/**
+ * Check whether TTS audio is currently being played
+ * @return true between the first TTS frame and ws_tts_complete()/barge-in
+ */
+bool ws_tts_is_playing(void);
+
+/**
+ * Interrupt TTS playback (barge-in)
+ * Mutes the speaker at once, asks the server to abort the reply and drops
+ * its remaining TTS frames until tts_end or the next audio end marker.
+ * @return 0 if playback was interrupted, -1 if nothing was playing
+ */
+int ws_tts_barge_in(void);
+
+/**
+ * Get TTS jitter buffer depth, target and under/overrun counters
+ * (all zero when playing inline without a jitter buffer)
+ */
+void ws_tts_get_stats(tts_jitter_stats_t *out);
+
+/**
+ * Get receive reassembly counters (fragmented, oversize and dropped messages)
+ */
+void ws_client_get_rx_stats(ws_reasm_stats_t *out);
+
+/**
+ * Get send queue counters and enqueue-to-send latency for one class
+ * (all zero when sending inline)
+ */
+void ws_client_get_send_stats(ws_sendq_class_t cls, ws_sendq_class_stats_t *out);
+
+/**
+ * Keepalive pong received (from the router)
+ * @param seq Sequence number echoed by the server
+ */
+void ws_client_on_pong(uint32_t seq);
+
+/**
+ * Get ping/pong counts, RTT EWMA and percentiles
+ */
+void ws_client_get_keepalive_stats(ws_keepalive_stats_t *out);
+
 /**
  * Check TTS timeout and auto-complete if needed
  * Note: In v2.0, this is a no-op (tts_end message is used instead)
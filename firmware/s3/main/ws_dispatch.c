@@ -0,0 +1,214 @@
+/**
+ * @file ws_dispatch.c
+ * @brief Prioritized command queues implementation
+ */
+
+#include "ws_dispatch.h"
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Private: Type Tables                                               */
+/* ------------------------------------------------------------------ */
+
+/* Statistics slot of a queued type, -1 if it is not queued */
+static int handler_of(ws_msg_type_t type)
+{
+    switch (type) {
+    case WS_MSG_SERVO:      return WS_DISPATCH_H_SERVO;
+    case WS_MSG_DISPLAY:    return WS_DISPATCH_H_DISPLAY;
+    case WS_MSG_STATUS:     return WS_DISPATCH_H_STATUS;
+    case WS_MSG_ASR_RESULT: return WS_DISPATCH_H_ASR_RESULT;
+    case WS_MSG_BOT_REPLY:  return WS_DISPATCH_H_BOT_REPLY;
+    case WS_MSG_ERROR_MSG:  return WS_DISPATCH_H_ERROR;
+    default:                return -1;
+    }
+}
+
+int ws_dispatch_class_of(ws_msg_type_t type)
+{
+    switch (handler_of(type)) {
+    case WS_DISPATCH_H_SERVO:   return WS_DISPATCH_MOTION;
+    case -1:                    return -1;
+    default:                    return WS_DISPATCH_DISPLAY;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init                                                       */
+/* ------------------------------------------------------------------ */
+
+int ws_dispatch_storage_size(const int depth[WS_DISPATCH_CLASSES])
+{
+    int total = 0;
+    for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+        total += depth[i] * (int)sizeof(ws_dispatch_cmd_t);
+    }
+    return total;
+}
+
+int ws_dispatch_init(ws_dispatch_t *d, void *storage, const int depth[WS_DISPATCH_CLASSES])
+{
+    if (!d || !storage || !depth) {
+        return -1;
+    }
+    for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+        if (depth[i] <= 0) {
+            return -1;
+        }
+    }
+
+    ws_dispatch_cmd_t *slot = storage;
+    memset(d, 0, sizeof(*d));
+    for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+        d->ring[i].slot = slot;
+        d->ring[i].cap = depth[i];
+        slot += depth[i];
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Push / Pop                                                 */
+/* ------------------------------------------------------------------ */
+
+int ws_dispatch_push(ws_dispatch_t *d, const ws_dispatch_cmd_t *cmd, uint32_t now_us)
+{
+    if (!d || !cmd) {
+        return -1;
+    }
+
+    int cls = ws_dispatch_class_of(cmd->type);
+    if (cls < 0) {
+        return -1;
+    }
+
+    ws_dispatch_ring_t *r = &d->ring[cls];
+    if (r->count == r->cap) {
+        /* Stale: the newer command supersedes the oldest one */
+        r->stats.dropped++;
+        r->head = (r->head + 1) % r->cap;
+        r->count--;
+    }
+
+    ws_dispatch_cmd_t *slot = &r->slot[(r->head + r->count) % r->cap];
+    *slot = *cmd;
+    slot->t_us = now_us;
+    r->count++;
+
+    r->stats.queued++;
+    if (r->count > r->stats.high_water) {
+        r->stats.high_water = r->count;
+    }
+    return 0;
+}
+
+bool ws_dispatch_pop(ws_dispatch_t *d, unsigned mask, ws_dispatch_cmd_t *out)
+{
+    if (!d || !out) {
+        return false;
+    }
+
+    for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+        ws_dispatch_ring_t *r = &d->ring[i];
+
+        if ((mask & WS_DISPATCH_MASK(i)) && r->count > 0) {
+            *out = r->slot[r->head];
+            r->head = (r->head + 1) % r->cap;
+            r->count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+int ws_dispatch_count(const ws_dispatch_t *d, unsigned mask)
+{
+    int n = 0;
+    if (d) {
+        for (int i = 0; i < WS_DISPATCH_CLASSES; i++) {
+            if (mask & WS_DISPATCH_MASK(i)) {
+                n += d->ring[i].count;
+            }
+        }
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Statistics                                                 */
+/* ------------------------------------------------------------------ */
+
+void ws_dispatch_done(ws_dispatch_t *d, const ws_dispatch_cmd_t *cmd,
+                      uint32_t start_us, uint32_t end_us)
+{
+    if (!d || !cmd) {
+        return;
+    }
+
+    int h = handler_of(cmd->type);
+    if (h < 0) {
+        return;
+    }
+
+    ws_dispatch_handler_stats_t *st = &d->handler[h];
+    uint32_t wait = start_us - cmd->t_us;
+    uint32_t run = end_us - start_us;
+    uint32_t total = end_us - cmd->t_us;
+
+    int b = 0;
+    while (b < WS_DISPATCH_BUCKETS - 1 && total >= ((uint32_t)WS_DISPATCH_BUCKET0_US << b)) {
+        b++;
+    }
+    st->hist[b]++;
+    st->count++;
+
+    if (total > st->latency_max_us) {
+        st->latency_max_us = total;
+    }
+    if (wait > st->wait_max_us) {
+        st->wait_max_us = wait;
+    }
+    if (run > st->run_max_us) {
+        st->run_max_us = run;
+    }
+}
+
+void ws_dispatch_get_queue_stats(const ws_dispatch_t *d, ws_dispatch_class_t cls,
+                                 ws_dispatch_queue_stats_t *out)
+{
+    if (!d || !out || cls < 0 || cls >= WS_DISPATCH_CLASSES) {
+        return;
+    }
+
+    *out = d->ring[cls].stats;
+    out->depth = d->ring[cls].count;
+}
+
+void ws_dispatch_get_handler_stats(const ws_dispatch_t *d, ws_dispatch_handler_t h,
+                                   ws_dispatch_handler_stats_t *out)
+{
+    if (d && out && h >= 0 && h < WS_DISPATCH_HANDLERS) {
+        *out = d->handler[h];
+    }
+}
+
+uint32_t ws_dispatch_percentile_us(const ws_dispatch_handler_stats_t *st, int pct)
+{
+    if (!st || st->count == 0) {
+        return 0;
+    }
+    if (pct < 1) pct = 1;
+    if (pct > 100) pct = 100;
+
+    /* Rank of the sample, rounded up */
+    uint32_t rank = (uint32_t)(((uint64_t)st->count * pct + 99) / 100);
+    uint32_t seen = 0;
+
+    for (int b = 0; b < WS_DISPATCH_BUCKETS - 1; b++) {
+        seen += st->hist[b];
+        if (seen >= rank) {
+            return (uint32_t)WS_DISPATCH_BUCKET0_US << b;
+        }
+    }
+    return st->latency_max_us;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file ws_dispatch.h
+ * @brief Prioritized command queues between ws_router and worker tasks
+ *        (platform independent)
+ *
+ * Router callbacks run on the WebSocket task; the display ones take the
+ * LVGL mutex and the servo one blocks on the UART. With the dispatcher the
+ * callbacks only copy the parsed command into a queue and return, and
+ * worker tasks execute it. Each worker pops from a set of classes, always
+ * the highest-priority class first:
+ *
+ * - Motion (servo): drop-oldest, a newer target beats a stale one.
+ * - Display (display/status/asr_result/bot_reply/error): drop-oldest, the
+ *   newest screen state wins.
+ *
+ * tts_end is not queued: it must take effect before the next reply's audio,
+ * which the WS task handles itself, and it only marks the end of the stream.
+ *
+ * Commands stay in FIFO order within a class. Per handler, the latency from
+ * push to the end of execution goes into a log2 histogram.
+ *
+ * Not thread safe: the caller serializes push/pop/done (one mutex). Storage
+ * is provided by the caller so it can live in PSRAM.
+ */
+
+#ifndef WS_DISPATCH_H
+#define WS_DISPATCH_H
+
+#include "ws_router.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    WS_DISPATCH_MOTION = 0,     /* Servo, highest priority */
+    WS_DISPATCH_DISPLAY,        /* Screen text / emoji, lowest priority */
+    WS_DISPATCH_CLASSES
+} ws_dispatch_class_t;
+
+#define WS_DISPATCH_MASK(cls)   (1u << (cls))
+
+/* Handlers with statistics (one per queued message type) */
+typedef enum {
+    WS_DISPATCH_H_SERVO = 0,
+    WS_DISPATCH_H_DISPLAY,
+    WS_DISPATCH_H_STATUS,
+    WS_DISPATCH_H_ASR_RESULT,
+    WS_DISPATCH_H_BOT_REPLY,
+    WS_DISPATCH_H_ERROR,
+    WS_DISPATCH_HANDLERS
+} ws_dispatch_handler_t;
+
+/* Latency histogram: bucket i counts < (WS_DISPATCH_BUCKET0_US << i),
+ * the last bucket everything slower (250us .. 64ms, then >= 64ms) */
+#define WS_DISPATCH_BUCKETS     10
+#define WS_DISPATCH_BUCKET0_US  250
+
+/* One queued command: the router's parsed struct, copied by value */
+typedef struct {
+    ws_msg_type_t type;
+    uint32_t t_us;              /* Push time */
+    union {
+        ws_servo_cmd_t servo;
+        ws_display_cmd_t display;
+        ws_status_cmd_t status;
+        ws_asr_result_cmd_t asr_result;
+        ws_bot_reply_cmd_t bot_reply;
+        ws_error_cmd_t error;
+    } u;
+} ws_dispatch_cmd_t;
+
+typedef struct {
+    uint32_t queued;            /* Accepted by push */
+    uint32_t dropped;           /* Evicted by a newer command */
+    int depth;                  /* Queued now */
+    int high_water;
+} ws_dispatch_queue_stats_t;
+
+typedef struct {
+    uint32_t count;             /* Executed */
+    uint32_t hist[WS_DISPATCH_BUCKETS];     /* Push to end of execution */
+    uint32_t latency_max_us;    /* Push to end of execution */
+    uint32_t wait_max_us;       /* Push to start */
+    uint32_t run_max_us;        /* Execution alone */
+} ws_dispatch_handler_stats_t;
+
+typedef struct {
+    ws_dispatch_cmd_t *slot;
+    int cap;
+    int head;                   /* Oldest entry */
+    int count;
+    ws_dispatch_queue_stats_t stats;
+} ws_dispatch_ring_t;
+
+typedef struct {
+    ws_dispatch_ring_t ring[WS_DISPATCH_CLASSES];
+    ws_dispatch_handler_stats_t handler[WS_DISPATCH_HANDLERS];
+} ws_dispatch_t;
+
+/**
+ * Class a message type is queued in
+ * @return Class, or -1 for types that run inline (tts_end, hello, pong, ...)
+ */
+int ws_dispatch_class_of(ws_msg_type_t type);
+
+/**
+ * Storage needed for the given per-class depths (in commands)
+ */
+int ws_dispatch_storage_size(const int depth[WS_DISPATCH_CLASSES]);
+
+/**
+ * Initialize on caller-provided storage (aligned for ws_dispatch_cmd_t)
+ * @return 0 on success, -1 on error
+ */
+int ws_dispatch_init(ws_dispatch_t *d, void *storage, const int depth[WS_DISPATCH_CLASSES]);
+
+/**
+ * Queue one command (cmd->type selects the class; t_us is set here); a full
+ * class drops its oldest command
+ * @return 0 if queued, -1 for an inline type
+ */
+int ws_dispatch_push(ws_dispatch_t *d, const ws_dispatch_cmd_t *cmd, uint32_t now_us);
+
+/**
+ * Take the next command from the classes in mask, highest priority first
+ * @return true if out was filled
+ */
+bool ws_dispatch_pop(ws_dispatch_t *d, unsigned mask, ws_dispatch_cmd_t *out);
+
+/**
+ * Record a finished command
+ * @param start_us When the worker started executing it
+ * @param end_us When it returned
+ */
+void ws_dispatch_done(ws_dispatch_t *d, const ws_dispatch_cmd_t *cmd,
+                      uint32_t start_us, uint32_t end_us);
+
+/**
+ * Queued commands in the classes in mask
+ */
+int ws_dispatch_count(const ws_dispatch_t *d, unsigned mask);
+
+void ws_dispatch_get_queue_stats(const ws_dispatch_t *d, ws_dispatch_class_t cls,
+                                 ws_dispatch_queue_stats_t *out);
+
+void ws_dispatch_get_handler_stats(const ws_dispatch_t *d, ws_dispatch_handler_t h,
+                                   ws_dispatch_handler_stats_t *out);
+
+/**
+ * Latency percentile from a handler histogram
+ * @param pct 1..100
+ * @return Upper bound of the bucket holding it (us), 0 if no samples;
+ *         the slowest latency seen if it falls in the open-ended last bucket
+ */
+uint32_t ws_dispatch_percentile_us(const ws_dispatch_handler_stats_t *st, int pct);
+
+#endif /* WS_DISPATCH_H */
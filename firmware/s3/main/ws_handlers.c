@@ -9,6 +9,11 @@
 #include "display_ui.h"
 #include "esp_system.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include <string.h>
 
 #define TAG "WS_HANDLERS"
@@ -16,6 +21,19 @@
 /* Default servo movement duration (ms) */
 #define SERVO_DEFAULT_DURATION_MS 100
 
+/* Dispatch queues (commands per class) and workers */
+#define DISPATCH_MOTION_DEPTH   8
+#define DISPATCH_DISPLAY_DEPTH  8
+#define DISPATCH_STACK          4096
+#define DISPATCH_MOTION_PRIO    6       /* Above the WS task: servo runs at once */
+#define DISPATCH_UI_PRIO        4       /* Below it: LVGL never delays receive */
+
+static ws_dispatch_t disp_q;
+static void *disp_mem = NULL;
+static SemaphoreHandle_t disp_lock = NULL;
+static TaskHandle_t disp_motion_handle = NULL;   /* Motion class */
+static TaskHandle_t disp_ui_handle = NULL;       /* Display class */
+
 /* ------------------------------------------------------------------ */
 /* Helper: Parse status data to determine emoji                       */
 /* ------------------------------------------------------------------ */
@@ -77,12 +95,12 @@ void on_servo_handler(const ws_servo_cmd_t *cmd)
     }
 
     /* Use ESP_LOGD to avoid flooding logs with high-frequency servo commands */
-    ESP_LOGI(TAG, "Servo command: id=%s, angle=%d, time=%d",
+    ESP_LOGD(TAG, "Servo command: id=%s, angle=%d, time=%d",
              cmd->id, cmd->angle, cmd->time_ms);
 
-    /* Send single servo command via UART */
-    /* Protocol: "X:<angle>:<duration>\r\n" or "Y:<angle>:<duration>\r\n" */
-    uart_bridge_send_servo_single(cmd->id, cmd->angle, cmd->time_ms);
+    /* Latest-wins mailbox: the servo TX task sends the newest target per
+     * axis when the UART is free, X and Y paired into one write */
+    uart_bridge_post_servo(cmd->id, cmd->angle, cmd->time_ms);
 }
 
 /* ------------------------------------------------------------------ */
@@ -211,24 +229,247 @@ void on_error_handler(const ws_error_cmd_t *cmd)
     display_update(cmd->message, "sad", 0, NULL);
 }
 
+/* ------------------------------------------------------------------ */
+/* Handler: Hello Reply (codec negotiation)                           */
+/* ------------------------------------------------------------------ */
+
+void on_hello_handler(const ws_hello_cmd_t *cmd)
+{
+    if (!cmd) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "Hello reply: tts=%s @ %d Hz, ctl=%s", cmd->tts_codec, cmd->tts_rate, cmd->ctl);
+
+    /* Switch TTS decoder (falls back to raw PCM on failure) */
+    ws_client_set_tts_codec(cmd->tts_codec, cmd->tts_rate);
+    ws_client_set_control_encoding(cmd->ctl);
+}
+
+/* ------------------------------------------------------------------ */
+/* Handler: Keepalive Pong                                            */
+/* ------------------------------------------------------------------ */
+
+void on_pong_handler(const ws_pong_cmd_t *cmd)
+{
+    if (!cmd) {
+        return;
+    }
+
+    ws_client_on_pong(cmd->seq);
+}
+
+/* ------------------------------------------------------------------ */
+/* Dispatch: Worker Tasks                                             */
+/* ------------------------------------------------------------------ */
+
+static uint32_t now_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+static void dispatch_run(const ws_dispatch_cmd_t *cmd)
+{
+    switch (cmd->type) {
+    case WS_MSG_SERVO:      on_servo_handler(&cmd->u.servo); break;
+    case WS_MSG_DISPLAY:    on_display_handler(&cmd->u.display); break;
+    case WS_MSG_STATUS:     on_status_handler(&cmd->u.status); break;
+    case WS_MSG_ASR_RESULT: on_asr_result_handler(&cmd->u.asr_result); break;
+    case WS_MSG_BOT_REPLY:  on_bot_reply_handler(&cmd->u.bot_reply); break;
+    case WS_MSG_ERROR_MSG:  on_error_handler(&cmd->u.error); break;
+    default:                break;
+    }
+}
+
+/**
+ * Runs the queued commands of its classes, highest priority first
+ * @param arg Class mask (WS_DISPATCH_MASK)
+ */
+static void dispatch_worker(void *arg)
+{
+    const unsigned mask = (unsigned)(uintptr_t)arg;
+    ws_dispatch_cmd_t cmd;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (1) {
+            xSemaphoreTake(disp_lock, portMAX_DELAY);
+            bool got = ws_dispatch_pop(&disp_q, mask, &cmd);
+            xSemaphoreGive(disp_lock);
+            if (!got) {
+                break;
+            }
+
+            uint32_t start = now_us();
+            dispatch_run(&cmd);
+            uint32_t end = now_us();
+
+            xSemaphoreTake(disp_lock, portMAX_DELAY);
+            ws_dispatch_done(&disp_q, &cmd, start, end);
+            xSemaphoreGive(disp_lock);
+        }
+    }
+}
+
+/**
+ * Hand a command to its worker (WS task); runs it inline when the
+ * workers are not running
+ */
+static void dispatch_post(const ws_dispatch_cmd_t *cmd)
+{
+    TaskHandle_t worker = ws_dispatch_class_of(cmd->type) == WS_DISPATCH_MOTION
+                              ? disp_motion_handle : disp_ui_handle;
+
+    if (worker) {
+        xSemaphoreTake(disp_lock, portMAX_DELAY);
+        int ret = ws_dispatch_push(&disp_q, cmd, now_us());
+        xSemaphoreGive(disp_lock);
+        if (ret == 0) {
+            xTaskNotifyGive(worker);
+            return;
+        }
+    }
+    dispatch_run(cmd);
+}
+
+static void post_servo(const ws_servo_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_SERVO, .u.servo = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+static void post_display(const ws_display_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_DISPLAY, .u.display = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+static void post_status(const ws_status_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_STATUS, .u.status = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+static void post_asr_result(const ws_asr_result_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_ASR_RESULT, .u.asr_result = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+static void post_bot_reply(const ws_bot_reply_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_BOT_REPLY, .u.bot_reply = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+static void post_error(const ws_error_cmd_t *c)
+{
+    if (c) {
+        ws_dispatch_cmd_t cmd = { .type = WS_MSG_ERROR_MSG, .u.error = *c };
+        dispatch_post(&cmd);
+    }
+}
+
+int ws_handlers_dispatch_start(void)
+{
+    const int depth[WS_DISPATCH_CLASSES] = {
+        [WS_DISPATCH_MOTION] = DISPATCH_MOTION_DEPTH,
+        [WS_DISPATCH_DISPLAY] = DISPATCH_DISPLAY_DEPTH,
+    };
+    const unsigned ui_mask = WS_DISPATCH_MASK(WS_DISPATCH_DISPLAY);
+
+    if (disp_motion_handle) {
+        return 0;
+    }
+
+    disp_mem = heap_caps_malloc(ws_dispatch_storage_size(depth), MALLOC_CAP_SPIRAM);
+    disp_lock = xSemaphoreCreateMutex();
+    if (!disp_mem || !disp_lock || ws_dispatch_init(&disp_q, disp_mem, depth) != 0) {
+        ESP_LOGW(TAG, "Dispatch queue alloc failed, handlers run inline");
+        goto fail;
+    }
+
+    if (xTaskCreate(dispatch_worker, "ws_ui", DISPATCH_STACK, (void *)(uintptr_t)ui_mask,
+                    DISPATCH_UI_PRIO, &disp_ui_handle) != pdPASS ||
+        xTaskCreate(dispatch_worker, "ws_motion", DISPATCH_STACK,
+                    (void *)(uintptr_t)WS_DISPATCH_MASK(WS_DISPATCH_MOTION),
+                    DISPATCH_MOTION_PRIO, &disp_motion_handle) != pdPASS) {
+        ESP_LOGW(TAG, "Dispatch task create failed, handlers run inline");
+        goto fail;
+    }
+
+    ESP_LOGI(TAG, "Dispatch queues: motion %d, display %d",
+             DISPATCH_MOTION_DEPTH, DISPATCH_DISPLAY_DEPTH);
+    return 0;
+
+fail:
+    /* Workers only exist once the queue does; none may run after this */
+    if (disp_ui_handle) {
+        vTaskDelete(disp_ui_handle);
+        disp_ui_handle = NULL;
+    }
+    disp_motion_handle = NULL;
+    heap_caps_free(disp_mem);
+    disp_mem = NULL;
+    if (disp_lock) {
+        vSemaphoreDelete(disp_lock);
+        disp_lock = NULL;
+    }
+    return -1;
+}
+
+int ws_handlers_get_dispatch_stats(ws_dispatch_queue_stats_t queue[WS_DISPATCH_CLASSES],
+                                   ws_dispatch_handler_stats_t handler[WS_DISPATCH_HANDLERS])
+{
+    if (!disp_lock) {
+        return -1;
+    }
+
+    xSemaphoreTake(disp_lock, portMAX_DELAY);
+    for (int i = 0; i < WS_DISPATCH_CLASSES && queue; i++) {
+        ws_dispatch_get_queue_stats(&disp_q, (ws_dispatch_class_t)i, &queue[i]);
+    }
+    for (int i = 0; i < WS_DISPATCH_HANDLERS && handler; i++) {
+        ws_dispatch_get_handler_stats(&disp_q, (ws_dispatch_handler_t)i, &handler[i]);
+    }
+    xSemaphoreGive(disp_lock);
+    return 0;
+}
+
 /* ------------------------------------------------------------------ */
 /* Convenience: Get Router with All Handlers                          */
 /* ------------------------------------------------------------------ */
 
 ws_router_t ws_handlers_get_router(void)
 {
+    /* Queued types go through the dispatcher; tts_end, hello, pong and
+     * reboot stay inline (cheap, and tts_end / the codec switch must take
+     * effect before the next audio frame) */
     ws_router_t router = {
-        .on_servo   = on_servo_handler,
-        .on_display = on_display_handler,
-        .on_status  = on_status_handler,
+        .on_servo   = post_servo,
+        .on_display = post_display,
+        .on_status  = post_status,
         .on_capture = on_capture_handler,
         .on_reboot  = on_reboot_handler,
 
         /* New handlers - v2.0 */
-        .on_asr_result = on_asr_result_handler,
-        .on_bot_reply  = on_bot_reply_handler,
+        .on_asr_result = post_asr_result,
+        .on_bot_reply  = post_bot_reply,
         .on_tts_end    = on_tts_end_handler,
-        .on_error      = on_error_handler,
+        .on_error      = post_error,
+        .on_hello      = on_hello_handler,
+        .on_pong       = on_pong_handler,
     };
     return router;
 }
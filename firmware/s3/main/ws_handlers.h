@@ -2,6 +2,7 @@
 #define WS_HANDLERS_H
 
 #include "ws_router.h"
+#include "ws_dispatch.h"
 
 /**
  * @file ws_handlers.h
@@ -71,6 +72,18 @@ void on_tts_end_handler(void);
  */
 void on_error_handler(const ws_error_cmd_t *cmd);
 
+/**
+ * Handle hello reply - select TTS codec accepted by the server
+ * @param cmd Hello reply with TTS codec and sample rate
+ */
+void on_hello_handler(const ws_hello_cmd_t *cmd);
+
+/**
+ * Handle keepalive pong - RTT sample for link statistics
+ * @param cmd Pong with the sequence number of our ping
+ */
+void on_pong_handler(const ws_pong_cmd_t *cmd);
+
 /* ------------------------------------------------------------------ */
 /* Helper Functions (for testing)                                     */
 /* ------------------------------------------------------------------ */
@@ -84,8 +97,32 @@ const char* ws_status_data_to_emoji(const char *data);
 
 /**
  * Get all handlers as a router struct (convenience function)
+ *
+ * Servo, display, status, asr_result, bot_reply, error and tts_end are
+ * posted to the dispatch workers once ws_handlers_dispatch_start() ran
+ * (inline before that); the others always run on the calling task.
  * @return ws_router_t with all handlers populated
  */
 ws_router_t ws_handlers_get_router(void);
 
+/* ------------------------------------------------------------------ */
+/* Dispatch (handlers off the WebSocket receive path)                 */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Allocate the dispatch queues and start the workers: "ws_motion" for
+ * servo commands, "ws_ui" for display updates
+ * @return 0 on success, -1 if handlers keep running inline
+ */
+int ws_handlers_dispatch_start(void);
+
+/**
+ * Snapshot of queue depths and per-handler latency
+ * @param queue WS_DISPATCH_CLASSES entries (may be NULL)
+ * @param handler WS_DISPATCH_HANDLERS entries (may be NULL)
+ * @return 0 on success, -1 if the dispatcher is not running
+ */
+int ws_handlers_get_dispatch_stats(ws_dispatch_queue_stats_t queue[WS_DISPATCH_CLASSES],
+                                   ws_dispatch_handler_stats_t handler[WS_DISPATCH_HANDLERS]);
+
 #endif /* WS_HANDLERS_H */
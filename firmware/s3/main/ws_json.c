@@ -0,0 +1,444 @@
+/**
+ * @file ws_json.c
+ * @brief Zero-allocation in-place JSON tokenizer implementation
+ */
+
+#include "ws_json.h"
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+/* Parser expectations between tokens */
+enum {
+    EXPECT_VALUE,
+    EXPECT_KEY,
+    EXPECT_KEY_OR_CLOSE,        /* Just after '{' */
+    EXPECT_VALUE_OR_CLOSE,      /* Just after '[' */
+    EXPECT_COLON,
+    EXPECT_COMMA_OR_CLOSE,
+};
+
+/* Longest key we ever look up, plus room to tell longer keys apart */
+#define KEY_BUF_LEN     32
+
+static int lower(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Strings                                                   */
+/* ------------------------------------------------------------------ */
+
+/* Hex digits of a \u escape; like cJSON, any invalid digit yields 0 */
+static unsigned hex4(const char *p)
+{
+    unsigned h = 0;
+
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        if (c >= '0' && c <= '9') h = (h << 4) | (unsigned)(c - '0');
+        else if (c >= 'A' && c <= 'F') h = (h << 4) | (unsigned)(c - 'A' + 10);
+        else if (c >= 'a' && c <= 'f') h = (h << 4) | (unsigned)(c - 'a' + 10);
+        else return 0;
+    }
+    return h;
+}
+
+/* Append one byte, stopping (but still validating) once dst is full */
+static void out_byte(char *dst, int cap, int *n, char c)
+{
+    if (dst && *n < cap - 1) {
+        dst[*n] = c;
+    }
+    (*n)++;
+}
+
+/*
+ * Unescape [p, e) into dst (may be NULL to only validate). Mirrors cJSON
+ * parse_string(): the same escapes and surrogate rules are rejected.
+ * @return Unescaped length (before truncation), -1 if invalid
+ */
+static int unescape(const char *p, const char *e, char *dst, int cap)
+{
+    int n = 0;
+
+    while (p < e) {
+        if (*p != '\\') {
+            out_byte(dst, cap, &n, *p++);
+            continue;
+        }
+
+        int seq = 2;
+        switch (p[1]) {
+            case 'b': out_byte(dst, cap, &n, '\b'); break;
+            case 'f': out_byte(dst, cap, &n, '\f'); break;
+            case 'n': out_byte(dst, cap, &n, '\n'); break;
+            case 'r': out_byte(dst, cap, &n, '\r'); break;
+            case 't': out_byte(dst, cap, &n, '\t'); break;
+            case '"':
+            case '\\':
+            case '/': out_byte(dst, cap, &n, p[1]); break;
+            case 'u': {
+                if (e - p < 6) return -1;
+                uint32_t cp = hex4(p + 2);
+                seq = 6;
+                if (cp >= 0xDC00 && cp <= 0xDFFF) return -1;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    if (e - p < 12 || p[6] != '\\' || p[7] != 'u') return -1;
+                    uint32_t lo = hex4(p + 8);
+                    if (lo < 0xDC00 || lo > 0xDFFF) return -1;
+                    cp = 0x10000 + (((cp & 0x3FF) << 10) | (lo & 0x3FF));
+                    seq = 12;
+                }
+                if (cp < 0x80) {
+                    out_byte(dst, cap, &n, (char)cp);
+                } else if (cp < 0x800) {
+                    out_byte(dst, cap, &n, (char)(0xC0 | (cp >> 6)));
+                    out_byte(dst, cap, &n, (char)(0x80 | (cp & 0x3F)));
+                } else if (cp < 0x10000) {
+                    out_byte(dst, cap, &n, (char)(0xE0 | (cp >> 12)));
+                    out_byte(dst, cap, &n, (char)(0x80 | ((cp >> 6) & 0x3F)));
+                    out_byte(dst, cap, &n, (char)(0x80 | (cp & 0x3F)));
+                } else {
+                    out_byte(dst, cap, &n, (char)(0xF0 | (cp >> 18)));
+                    out_byte(dst, cap, &n, (char)(0x80 | ((cp >> 12) & 0x3F)));
+                    out_byte(dst, cap, &n, (char)(0x80 | ((cp >> 6) & 0x3F)));
+                    out_byte(dst, cap, &n, (char)(0x80 | (cp & 0x3F)));
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+        p += seq;
+    }
+
+    if (dst && cap > 0) {
+        dst[n < cap - 1 ? n : cap - 1] = '\0';
+    }
+    return n;
+}
+
+/* Closing quote of a string starting after its opening quote, NULL if none */
+static const char *scan_string(const char *p, const char *end, bool *escaped)
+{
+    *escaped = false;
+    while (p < end && *p != '"') {
+        if (*p == '\\') {
+            if (p + 1 >= end) {
+                return NULL;
+            }
+            *escaped = true;
+            p++;
+        }
+        p++;
+    }
+    return p < end ? p : NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Numbers                                                   */
+/* ------------------------------------------------------------------ */
+
+/* Same character set and strtod() conversion as cJSON parse_number() */
+static int scan_number(const char *p, const char *end, double *out)
+{
+    char buf[64];
+    char *after;
+    int i = 0;
+
+    /* Fast path: plain integers (every number we route) skip strtod() */
+    int neg = (p < end && *p == '-');
+    int digits = 0;
+    int32_t iv = 0;
+    while (p + neg + digits < end && digits < 10 &&
+           p[neg + digits] >= '0' && p[neg + digits] <= '9') {
+        iv = iv * 10 + (p[neg + digits] - '0');
+        digits++;
+    }
+    if (digits > 0 && digits < 10) {
+        const char *q = p + neg + digits;
+        if (q >= end || !*q || !strchr("+-eE.", *q)) {
+            if (out) {
+                *out = neg ? -iv : iv;
+            }
+            return neg + digits;
+        }
+    }
+
+    while (i < (int)sizeof(buf) - 1 && p + i < end && p[i] && strchr("0123456789+-eE.", p[i])) {
+        buf[i] = p[i];
+        i++;
+    }
+    buf[i] = '\0';
+
+    double v = strtod(buf, &after);
+    if (after == buf) {
+        return -1;
+    }
+    if (out) {
+        *out = v;
+    }
+    return (int)(after - buf);
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Tokens                                                    */
+/* ------------------------------------------------------------------ */
+
+static int new_token(ws_json_t *js, uint8_t type, int start, int parent)
+{
+    if (js->count >= WS_JSON_MAX_TOKENS) {
+        return -1;
+    }
+    int i = js->count++;
+    ws_json_tok_t *t = &js->tok[i];
+    t->type = type;
+    t->escaped = 0;
+    t->start = (uint16_t)start;
+    t->end = (uint16_t)start;
+    t->next = (uint16_t)(i + 1);
+    t->parent = (int16_t)parent;
+    return i;
+}
+
+/* Primitive or string at p; returns the position after it, NULL if invalid */
+static const char *parse_scalar(ws_json_t *js, const char *p, const char *end, int parent)
+{
+    const char *base = js->json;
+    int t;
+
+    if (end - p >= 4 && strncmp(p, "null", 4) == 0) {
+        t = new_token(js, WS_JSON_NULL, p - base, parent);
+        p += 4;
+    } else if (end - p >= 5 && strncmp(p, "false", 5) == 0) {
+        t = new_token(js, WS_JSON_FALSE, p - base, parent);
+        p += 5;
+    } else if (end - p >= 4 && strncmp(p, "true", 4) == 0) {
+        t = new_token(js, WS_JSON_TRUE, p - base, parent);
+        p += 4;
+    } else if (*p == '"') {
+        bool escaped;
+        const char *q = scan_string(p + 1, end, &escaped);
+        if (!q || (escaped && unescape(p + 1, q, NULL, 0) < 0)) {
+            return NULL;
+        }
+        t = new_token(js, WS_JSON_STRING, p + 1 - base, parent);
+        if (t < 0) {
+            return NULL;
+        }
+        js->tok[t].escaped = escaped;
+        js->tok[t].end = (uint16_t)(q - base);
+        return q + 1;
+    } else if (*p == '-' || (*p >= '0' && *p <= '9')) {
+        int n = scan_number(p, end, NULL);
+        if (n < 0) {
+            return NULL;
+        }
+        t = new_token(js, WS_JSON_NUMBER, p - base, parent);
+        p += n;
+    } else {
+        return NULL;
+    }
+
+    if (t < 0) {
+        return NULL;
+    }
+    js->tok[t].end = (uint16_t)(p - base);
+    return p;
+}
+
+/* Key token i equals name under cJSON's case-insensitive compare */
+static bool key_equals(const ws_json_t *js, int i, const char *name)
+{
+    const ws_json_tok_t *t = &js->tok[i];
+    const char *s = js->json + t->start;
+    int len = t->end - t->start;
+    char buf[KEY_BUF_LEN];
+
+    if (t->escaped) {
+        unescape(s, s + len, buf, sizeof(buf));
+        s = buf;
+        len = (int)strlen(buf);
+    }
+    for (int k = 0; k < len; k++) {
+        if (name[k] == '\0' || lower((unsigned char)s[k]) != lower((unsigned char)name[k])) {
+            return false;
+        }
+    }
+    return name[len] == '\0';
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Parse                                                      */
+/* ------------------------------------------------------------------ */
+
+static int tokenize(ws_json_t *js, const char *json, int len)
+{
+    const char *p = json;
+    const char *end = json + len;
+    int parent = -1;
+    int expect = EXPECT_VALUE;
+
+    js->json = json;
+    js->count = 0;
+
+    if (len >= 4 && strncmp(p, "\xEF\xBB\xBF", 3) == 0) {
+        p += 3;
+    }
+
+    for (;;) {
+        while (p < end && (unsigned char)*p <= 32) {
+            p++;
+        }
+        char c = p < end ? *p : '\0';
+
+        if (expect == EXPECT_COMMA_OR_CLOSE) {
+            if (parent < 0) {
+                return js->count;       /* Root complete; trailing text ignored */
+            }
+            ws_json_tok_t *pt = &js->tok[parent];
+            if (c == ',') {
+                expect = pt->type == WS_JSON_OBJECT ? EXPECT_KEY : EXPECT_VALUE;
+                p++;
+                continue;
+            }
+            if (c != (pt->type == WS_JSON_OBJECT ? '}' : ']')) {
+                return -1;
+            }
+            goto close;
+        }
+
+        if (expect == EXPECT_COLON) {
+            if (c != ':') {
+                return -1;
+            }
+            expect = EXPECT_VALUE;
+            p++;
+            continue;
+        }
+
+        if ((expect == EXPECT_KEY_OR_CLOSE && c == '}') ||
+            (expect == EXPECT_VALUE_OR_CLOSE && c == ']')) {
+            goto close;
+        }
+
+        if (expect == EXPECT_KEY || expect == EXPECT_KEY_OR_CLOSE) {
+            if (c != '"' || !(p = parse_scalar(js, p, end, parent))) {
+                return -1;
+            }
+            expect = EXPECT_COLON;
+            continue;
+        }
+
+        /* Value */
+        if (c == '{' || c == '[') {
+            int t = new_token(js, c == '{' ? WS_JSON_OBJECT : WS_JSON_ARRAY, p - json, parent);
+            if (t < 0) {
+                return -1;
+            }
+            parent = t;
+            expect = c == '{' ? EXPECT_KEY_OR_CLOSE : EXPECT_VALUE_OR_CLOSE;
+            p++;
+            continue;
+        }
+        if (p >= end || !(p = parse_scalar(js, p, end, parent))) {
+            return -1;
+        }
+        expect = EXPECT_COMMA_OR_CLOSE;
+        continue;
+
+close:
+        p++;
+        js->tok[parent].end = (uint16_t)(p - json);
+        js->tok[parent].next = (uint16_t)js->count;
+        parent = js->tok[parent].parent;
+        expect = EXPECT_COMMA_OR_CLOSE;
+    }
+}
+
+int ws_json_parse(ws_json_t *js, const char *json, int len)
+{
+    if (!js || !json || len < 0 || len > WS_JSON_MAX_LEN) {
+        return -1;
+    }
+
+    int n = tokenize(js, json, len);
+
+    /* A failure with every token used: the limit, or an error right after
+     * it; either way only a full parser can tell */
+    if (n < 0 && js->count == WS_JSON_MAX_TOKENS) {
+        return WS_JSON_ERR_TOKENS;
+    }
+    return n;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Access                                                     */
+/* ------------------------------------------------------------------ */
+
+int ws_json_find(const ws_json_t *js, int obj, const char *key)
+{
+    if (!js || !key || obj < 0 || obj >= js->count || js->tok[obj].type != WS_JSON_OBJECT) {
+        return -1;
+    }
+
+    /* Members are key, value subtree, key, ... */
+    int i = obj + 1;
+    while (i < js->tok[obj].next) {
+        if (key_equals(js, i, key)) {
+            return i + 1;
+        }
+        i = js->tok[i + 1].next;
+    }
+    return -1;
+}
+
+int ws_json_type(const ws_json_t *js, int i)
+{
+    if (!js || i < 0 || i >= js->count) {
+        return -1;
+    }
+    return js->tok[i].type;
+}
+
+int ws_json_get_int(const ws_json_t *js, int i, int default_val)
+{
+    double v;
+
+    if (ws_json_type(js, i) != WS_JSON_NUMBER) {
+        return default_val;
+    }
+    scan_number(js->json + js->tok[i].start, js->json + js->tok[i].end, &v);
+
+    if (v >= INT_MAX) return INT_MAX;
+    if (v <= (double)INT_MIN) return INT_MIN;
+    return (int)v;
+}
+
+int ws_json_get_str(const ws_json_t *js, int i, char *dst, int dst_size)
+{
+    if (!dst || dst_size <= 0) {
+        return -1;
+    }
+    if (ws_json_type(js, i) != WS_JSON_STRING) {
+        dst[0] = '\0';
+        return -1;
+    }
+
+    const ws_json_tok_t *t = &js->tok[i];
+    const char *s = js->json + t->start;
+
+    if (t->escaped) {
+        unescape(s, js->json + t->end, dst, dst_size);
+    } else {
+        int n = t->end - t->start;
+        if (n > dst_size - 1) {
+            n = dst_size - 1;
+        }
+        memcpy(dst, s, n);
+        dst[n] = '\0';
+    }
+    return 0;
+}
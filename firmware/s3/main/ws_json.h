@@ -0,0 +1,87 @@
+/**
+ * @file ws_json.h
+ * @brief Zero-allocation in-place JSON tokenizer (platform independent)
+ *
+ * jsmn-style: one pass over the message fills a caller-owned token array
+ * with offsets into the original text; nothing is copied or allocated until
+ * a field is extracted into its destination buffer.
+ *
+ * Accepts and rejects the same input as cJSON_Parse() (trailing text after
+ * the first value ignored, leading UTF-8 BOM skipped), and lookups follow
+ * cJSON_GetObjectItem(): case-insensitive keys, first match wins. String
+ * values are unescaped on extraction; numbers convert like cJSON valueint.
+ */
+
+#ifndef WS_JSON_H
+#define WS_JSON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Enough for any server control message (hello with arrays is ~20);
+ * ws_router builds a cJSON tree for the rare larger one */
+#define WS_JSON_MAX_TOKENS      64
+/* ws_json_parse(): ran out of tokens (the text may still be valid) */
+#define WS_JSON_ERR_TOKENS      (-2)
+/* Offsets are 16-bit; larger messages are rejected */
+#define WS_JSON_MAX_LEN         UINT16_MAX
+
+typedef enum {
+    WS_JSON_NULL = 0,
+    WS_JSON_FALSE,
+    WS_JSON_TRUE,
+    WS_JSON_NUMBER,
+    WS_JSON_STRING,
+    WS_JSON_ARRAY,
+    WS_JSON_OBJECT,
+} ws_json_type_t;
+
+typedef struct {
+    uint8_t type;               /* ws_json_type_t */
+    uint8_t escaped;            /* String contains backslash escapes */
+    uint16_t start;             /* First byte (strings: after the quote) */
+    uint16_t end;               /* One past the last byte */
+    uint16_t next;              /* Token index after this value's subtree */
+    int16_t parent;             /* Enclosing container while parsing */
+} ws_json_tok_t;
+
+typedef struct {
+    const char *json;
+    int count;
+    ws_json_tok_t tok[WS_JSON_MAX_TOKENS];
+} ws_json_t;
+
+/**
+ * Tokenize a message; token 0 is the root value. Object members are stored
+ * as key token followed by the value's subtree.
+ * @param json Text, NUL-terminated (read up to len)
+ * @return Number of tokens, -1 if invalid or too long, WS_JSON_ERR_TOKENS
+ *         if all tokens were used before the input failed or ended
+ */
+int ws_json_parse(ws_json_t *js, const char *json, int len);
+
+/**
+ * Value of the first member named key (ASCII case-insensitive)
+ * @param obj Token index of an object; anything else finds nothing
+ * @return Token index, or -1 if absent
+ */
+int ws_json_find(const ws_json_t *js, int obj, const char *key);
+
+/**
+ * @return Type of token i, or -1 if i < 0
+ */
+int ws_json_type(const ws_json_t *js, int i);
+
+/**
+ * Number as int (truncated, saturated to INT_MIN..INT_MAX)
+ * @return default_val if i < 0 or not a number
+ */
+int ws_json_get_int(const ws_json_t *js, int i, int default_val);
+
+/**
+ * Unescape a string into dst, truncated and NUL-terminated
+ * @return 0 on success, -1 if i < 0 or not a string (dst set to "")
+ */
+int ws_json_get_str(const ws_json_t *js, int i, char *dst, int dst_size);
+
+#endif /* WS_JSON_H */
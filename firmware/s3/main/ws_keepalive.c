@@ -0,0 +1,212 @@
+/**
+ * @file ws_keepalive.c
+ * @brief Application-level WebSocket keepalive implementation
+ */
+
+#include "ws_keepalive.h"
+#include <string.h>
+
+#define BACKOFF_MAX_ATTEMPT     16
+
+/* Wrap-safe "a is at or after b" */
+static bool time_reached(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: RTT Statistics                                            */
+/* ------------------------------------------------------------------ */
+
+static void rtt_add(ws_keepalive_t *ka, int rtt)
+{
+    ws_keepalive_stats_t *st = &ka->stats;
+
+    if (st->pongs == 0) {
+        ka->srtt_x8 = rtt << 3;
+        ka->rttvar_x4 = (rtt / 2) << 2;
+        st->rtt_min_ms = rtt;
+        st->rtt_max_ms = rtt;
+    } else {
+        /* Deviation against the old mean first, then the mean */
+        int err = rtt - (ka->srtt_x8 >> 3);
+        if (err < 0) err = -err;
+        ka->rttvar_x4 += err - (ka->rttvar_x4 >> 2);
+        ka->srtt_x8 += rtt - (ka->srtt_x8 >> 3);
+        if (rtt < st->rtt_min_ms) st->rtt_min_ms = rtt;
+        if (rtt > st->rtt_max_ms) st->rtt_max_ms = rtt;
+    }
+
+    st->pongs++;
+    st->rtt_last_ms = rtt;
+    ka->ring[ka->ring_pos] = (uint16_t)(rtt > UINT16_MAX ? UINT16_MAX : rtt);
+    ka->ring_pos = (ka->ring_pos + 1) % WS_KEEPALIVE_SAMPLES;
+    if (ka->ring_count < WS_KEEPALIVE_SAMPLES) {
+        ka->ring_count++;
+    }
+}
+
+/* Nearest-rank percentile of a sorted window */
+static int percentile(const uint16_t *sorted, int n, int pct)
+{
+    int rank = (pct * n + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init / Link State                                          */
+/* ------------------------------------------------------------------ */
+
+int ws_keepalive_init(ws_keepalive_t *ka, const ws_keepalive_config_t *cfg, uint32_t seed)
+{
+    if (!ka || !cfg || cfg->interval_ms == 0 || cfg->timeout_ms == 0 ||
+        cfg->timeout_ms > cfg->interval_ms || cfg->max_missed < 1 ||
+        cfg->backoff_min_ms == 0 || cfg->backoff_max_ms < cfg->backoff_min_ms) {
+        return -1;
+    }
+
+    memset(ka, 0, sizeof(*ka));
+    ka->cfg = *cfg;
+    ka->rand = seed ? seed : 1;
+    return 0;
+}
+
+void ws_keepalive_on_connected(ws_keepalive_t *ka, uint32_t now_ms)
+{
+    if (!ka) {
+        return;
+    }
+    ka->connected = true;
+    ka->session_ms = now_ms;
+    ka->next_ping_ms = now_ms + ka->cfg.interval_ms;
+    ka->outstanding = false;
+    ka->missed_run = 0;
+}
+
+void ws_keepalive_on_disconnected(ws_keepalive_t *ka)
+{
+    if (!ka) {
+        return;
+    }
+    ka->connected = false;
+    ka->outstanding = false;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Ping / Pong                                                */
+/* ------------------------------------------------------------------ */
+
+ws_keepalive_action_t ws_keepalive_poll(ws_keepalive_t *ka, uint32_t now_ms, uint32_t *seq)
+{
+    if (!ka || !ka->connected) {
+        return WS_KEEPALIVE_IDLE;
+    }
+
+    if (ka->outstanding && time_reached(now_ms, ka->out_sent_ms + ka->cfg.timeout_ms)) {
+        ka->outstanding = false;
+        if (ka->peer_pongs) {
+            ka->stats.missed++;
+            if (++ka->missed_run >= ka->cfg.max_missed) {
+                ka->stats.dead++;
+                ka->connected = false;
+                return WS_KEEPALIVE_DEAD;
+            }
+        }
+    }
+
+    if (!ka->outstanding && time_reached(now_ms, ka->next_ping_ms)) {
+        ka->outstanding = true;
+        ka->out_seq = ++ka->seq;
+        ka->out_sent_ms = now_ms;
+        ka->next_ping_ms = now_ms + ka->cfg.interval_ms;
+        ka->stats.pings++;
+        /* The session lasted a full interval: stop backing off */
+        ka->attempt = 0;
+        if (seq) {
+            *seq = ka->out_seq;
+        }
+        return WS_KEEPALIVE_PING;
+    }
+
+    return WS_KEEPALIVE_IDLE;
+}
+
+int ws_keepalive_on_pong(ws_keepalive_t *ka, uint32_t seq, uint32_t now_ms)
+{
+    if (!ka) {
+        return -1;
+    }
+
+    /* Any pong proves the server answers and the path is not half-open */
+    ka->peer_pongs = true;
+    ka->missed_run = 0;
+
+    if (!ka->outstanding || seq != ka->out_seq) {
+        ka->stats.late++;
+        return -1;
+    }
+
+    ka->outstanding = false;
+    int rtt = (int)(now_ms - ka->out_sent_ms);
+    rtt_add(ka, rtt);
+    return rtt;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Reconnect Backoff                                          */
+/* ------------------------------------------------------------------ */
+
+uint32_t ws_keepalive_next_backoff(ws_keepalive_t *ka)
+{
+    if (!ka) {
+        return 0;
+    }
+
+    uint32_t delay = ka->cfg.backoff_min_ms;
+    for (int i = 0; i < ka->attempt && delay < ka->cfg.backoff_max_ms; i++) {
+        delay *= 2;
+    }
+    if (delay > ka->cfg.backoff_max_ms) {
+        delay = ka->cfg.backoff_max_ms;
+    }
+    if (ka->attempt < BACKOFF_MAX_ATTEMPT) {
+        ka->attempt++;
+    }
+
+    /* Jitter: devices that lost the same server do not return in lockstep */
+    ka->rand = ka->rand * 1103515245u + 12345u;
+    return delay / 2 + (ka->rand >> 8) % (delay / 2 + 1);
+}
+
+void ws_keepalive_get_stats(const ws_keepalive_t *ka, ws_keepalive_stats_t *out)
+{
+    if (!ka || !out) {
+        return;
+    }
+
+    *out = ka->stats;
+    out->rtt_ewma_ms = (ka->srtt_x8 + 4) >> 3;
+    out->rtt_var_ms = (ka->rttvar_x4 + 2) >> 2;
+    out->samples = ka->ring_count;
+
+    if (ka->ring_count == 0) {
+        return;
+    }
+
+    /* Insertion sort of a copy: at most WS_KEEPALIVE_SAMPLES entries */
+    uint16_t sorted[WS_KEEPALIVE_SAMPLES];
+    int n = ka->ring_count;
+    memcpy(sorted, ka->ring, n * sizeof(sorted[0]));
+    for (int i = 1; i < n; i++) {
+        uint16_t v = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+    out->rtt_p50_ms = percentile(sorted, n, 50);
+    out->rtt_p90_ms = percentile(sorted, n, 90);
+    out->rtt_p99_ms = percentile(sorted, n, 99);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file ws_keepalive.h
+ * @brief Application-level WebSocket keepalive and RTT statistics (platform independent)
+ *
+ * A timestamped {"type":"ping"} goes out every interval; the server echoes it
+ * as {"type":"pong"}. Each pong yields one RTT sample, folded into an EWMA
+ * (RFC 6298 gains: 1/8 for the mean, 1/4 for the deviation) and kept in a
+ * ring of the last WS_KEEPALIVE_SAMPLES for percentiles.
+ *
+ * A ping with no pong within the timeout counts as missed; max_missed in a
+ * row declares the link dead (half-open TCP: sends still succeed locally).
+ * Missed pongs only count once the server has answered at least one ping,
+ * so a server without pong support is never declared dead.
+ *
+ * Reconnect delays grow exponentially with jitter and reset once a session
+ * survives to its first ping. Time is passed in by the caller (ms).
+ * Not thread safe: one task calls poll, the caller serializes on_pong.
+ */
+
+#ifndef WS_KEEPALIVE_H
+#define WS_KEEPALIVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WS_KEEPALIVE_SAMPLES    64      /* RTT window for percentiles */
+
+typedef struct {
+    uint32_t interval_ms;       /* Ping period */
+    uint32_t timeout_ms;        /* Pong deadline (< interval) */
+    int max_missed;             /* Missed in a row before the link is dead */
+    uint32_t backoff_min_ms;    /* First reconnect delay */
+    uint32_t backoff_max_ms;    /* Cap */
+} ws_keepalive_config_t;
+
+typedef enum {
+    WS_KEEPALIVE_IDLE = 0,      /* Nothing to do */
+    WS_KEEPALIVE_PING,          /* Send a ping with the returned seq now */
+    WS_KEEPALIVE_DEAD,          /* Too many missed pongs: reconnect */
+} ws_keepalive_action_t;
+
+typedef struct {
+    uint32_t pings;             /* Sent */
+    uint32_t pongs;             /* Matched */
+    uint32_t missed;            /* Timed out (counted after first pong) */
+    uint32_t late;              /* Pong after its deadline or for an old seq */
+    uint32_t dead;              /* Sessions declared dead */
+    int rtt_last_ms;
+    int rtt_ewma_ms;            /* Smoothed RTT */
+    int rtt_var_ms;             /* Smoothed mean deviation */
+    int rtt_min_ms;
+    int rtt_max_ms;
+    int rtt_p50_ms;             /* Over the last WS_KEEPALIVE_SAMPLES */
+    int rtt_p90_ms;
+    int rtt_p99_ms;
+    int samples;                /* In the percentile window */
+} ws_keepalive_stats_t;
+
+typedef struct {
+    ws_keepalive_config_t cfg;
+    bool connected;
+    bool peer_pongs;            /* Server has answered a ping (since init) */
+    uint32_t session_ms;        /* Connect time */
+    uint32_t next_ping_ms;
+    bool outstanding;
+    uint32_t out_seq;
+    uint32_t out_sent_ms;
+    uint32_t seq;
+    int missed_run;             /* Missed in a row */
+    int attempt;                /* Reconnect attempts since the last good session */
+    uint32_t rand;              /* Jitter state */
+    int32_t srtt_x8;            /* EWMA in 1/8 ms */
+    int32_t rttvar_x4;          /* Deviation in 1/4 ms */
+    uint16_t ring[WS_KEEPALIVE_SAMPLES];
+    int ring_pos;
+    int ring_count;
+    ws_keepalive_stats_t stats;
+} ws_keepalive_t;
+
+/**
+ * @param seed Jitter seed (e.g. a hardware random number)
+ * @return 0 on success, -1 on invalid config
+ */
+int ws_keepalive_init(ws_keepalive_t *ka, const ws_keepalive_config_t *cfg, uint32_t seed);
+
+/**
+ * Link up: first ping one interval from now, missed count cleared
+ */
+void ws_keepalive_on_connected(ws_keepalive_t *ka, uint32_t now_ms);
+
+/**
+ * Link down: the outstanding ping is forgotten
+ */
+void ws_keepalive_on_disconnected(ws_keepalive_t *ka);
+
+/**
+ * Call periodically (resolution of a few hundred ms is enough)
+ * @param seq Set when WS_KEEPALIVE_PING is returned
+ */
+ws_keepalive_action_t ws_keepalive_poll(ws_keepalive_t *ka, uint32_t now_ms, uint32_t *seq);
+
+/**
+ * Pong received
+ * @return RTT in ms, or -1 if it does not match the outstanding ping
+ */
+int ws_keepalive_on_pong(ws_keepalive_t *ka, uint32_t seq, uint32_t now_ms);
+
+/**
+ * Delay before the next reconnect attempt (advances the backoff):
+ * min * 2^attempt capped at max, then a random value in [delay/2, delay]
+ */
+uint32_t ws_keepalive_next_backoff(ws_keepalive_t *ka);
+
+void ws_keepalive_get_stats(const ws_keepalive_t *ka, ws_keepalive_stats_t *out);
+
+#endif /* WS_KEEPALIVE_H */
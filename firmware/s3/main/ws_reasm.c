@@ -0,0 +1,267 @@
+/**
+ * @file ws_reasm.c
+ * @brief WebSocket message reassembly implementation
+ */
+
+#include "ws_reasm.h"
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* Private: Message lifecycle                                         */
+/* ------------------------------------------------------------------ */
+
+static ws_reasm_msg_t *slot_acquire(ws_reasm_t *r)
+{
+    for (int i = 0; i < r->slot_count; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&r->slots[i].busy, &expected, true)) {
+            r->slots[i].len = 0;
+            return &r->slots[i];
+        }
+    }
+    return NULL;
+}
+
+/* Forget the message in progress; its slot goes back to the pool */
+static void message_abort(ws_reasm_t *r)
+{
+    if (r->cur) {
+        ws_reasm_release(r, r->cur);
+        r->cur = NULL;
+    }
+    r->active = false;
+    r->dropping = false;
+    r->has_carry = false;
+}
+
+static void message_start(ws_reasm_t *r, uint8_t op, const uint8_t *data, int len)
+{
+    r->active = true;
+    r->dropping = false;
+    r->multi_event = false;
+    r->has_carry = false;
+    r->op = op;
+    r->cur = NULL;
+    r->streaming = (op == WS_REASM_OP_BINARY && r->stream_binary && r->on_stream);
+    r->skip = 0;
+    if (r->streaming && r->stream_tag >= 0) {
+        /* Tagged: other channels (e.g. binary control) are buffered whole */
+        if (len > 0 && data[0] == r->stream_tag) {
+            r->skip = r->stream_hdr;
+        } else {
+            r->streaming = false;
+        }
+    }
+
+    if (op != WS_REASM_OP_TEXT && op != WS_REASM_OP_BINARY) {
+        r->stats.protocol_errors++;
+        r->dropping = true;
+    } else if (!r->streaming) {
+        r->cur = slot_acquire(r);
+        if (!r->cur) {
+            r->stats.no_slot++;
+            r->dropping = true;
+        }
+    }
+}
+
+/* Hand a chunk to the stream sink in whole align-byte units */
+static void stream_chunk(ws_reasm_t *r, const uint8_t *data, int len, bool last)
+{
+    if (r->has_carry && len > 0) {
+        /* The one byte that has to be copied: a sample split across events */
+        uint8_t pair[2] = { r->carry, data[0] };
+        r->has_carry = false;
+        data++;
+        len--;
+        r->on_stream(pair, 2, last && len == 0, r->ctx);
+        if (last && len == 0) {
+            return;
+        }
+    }
+
+    int whole = len - len % r->align;
+    if (whole < len && !last) {
+        r->carry = data[whole];
+        r->has_carry = true;
+    }
+    if (whole > 0 || last) {
+        r->on_stream(data, whole, last, r->ctx);
+    }
+    if (last) {
+        r->has_carry = false;   /* Odd-length message: trailing byte dropped */
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init                                                       */
+/* ------------------------------------------------------------------ */
+
+int ws_reasm_storage_size(int slot_size, int slot_count)
+{
+    if (slot_size <= 0 || slot_count <= 0 || slot_count > WS_REASM_MAX_SLOTS) {
+        return 0;
+    }
+    /* +1 per slot for the terminating NUL */
+    return slot_count * (slot_size + 1);
+}
+
+int ws_reasm_init(ws_reasm_t *r, void *storage, int slot_size, int slot_count,
+                  ws_reasm_msg_cb_t on_message, ws_reasm_stream_cb_t on_stream,
+                  int align, void *ctx)
+{
+    if (!r || !storage || !on_message || slot_size <= 0 ||
+        slot_count <= 0 || slot_count > WS_REASM_MAX_SLOTS || align < 1 || align > 2) {
+        return -1;
+    }
+
+    memset(r, 0, sizeof(*r));
+    for (int i = 0; i < slot_count; i++) {
+        r->slots[i].data = (uint8_t *)storage + i * (slot_size + 1);
+        atomic_init(&r->slots[i].busy, false);
+    }
+    r->slot_count = slot_count;
+    r->slot_size = slot_size;
+    r->on_message = on_message;
+    r->on_stream = on_stream;
+    r->align = align;
+    r->ctx = ctx;
+    r->stream_tag = -1;
+    return 0;
+}
+
+void ws_reasm_set_stream_binary(ws_reasm_t *r, bool stream)
+{
+    if (r) {
+        r->stream_binary = stream && r->on_stream;
+    }
+}
+
+void ws_reasm_set_stream_tag(ws_reasm_t *r, int tag, int hdr_len)
+{
+    if (r) {
+        r->stream_tag = tag;
+        r->stream_hdr = tag >= 0 && hdr_len > 0 ? hdr_len : 0;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Feed                                                       */
+/* ------------------------------------------------------------------ */
+
+int ws_reasm_feed(ws_reasm_t *r, uint8_t op, bool fin, const uint8_t *data, int len,
+                  int payload_len, int payload_offset)
+{
+    if (!r || len < 0 || (len > 0 && !data)) {
+        return -1;
+    }
+
+    /* Control frames may be interleaved with fragments */
+    if (op >= 0x8) {
+        return 0;
+    }
+
+    if (payload_offset < 0 || payload_offset + len > payload_len) {
+        r->stats.protocol_errors++;
+        message_abort(r);
+        return -1;
+    }
+
+    if (payload_offset == 0) {
+        /* First chunk of a frame */
+        if (op == WS_REASM_OP_CONT) {
+            if (!r->active) {
+                r->stats.protocol_errors++;
+                return -1;
+            }
+            r->multi_event = true;
+        } else {
+            if (r->active) {
+                /* Previous message never finished */
+                r->stats.protocol_errors++;
+                message_abort(r);
+            }
+            message_start(r, op, data, len);
+        }
+    } else {
+        /* Later chunk of the same frame: must continue where the last one ended */
+        if (!r->active || payload_offset != r->frame_expect) {
+            r->stats.protocol_errors++;
+            message_abort(r);
+            return -1;
+        }
+        r->multi_event = true;
+    }
+    r->frame_expect = payload_offset + len;
+
+    bool done = fin && (payload_offset + len == payload_len);
+
+    if (!r->dropping) {
+        if (r->streaming) {
+            if (r->skip > 0) {
+                int n = len < r->skip ? len : r->skip;
+                data += n;
+                len -= n;
+                r->skip -= n;
+            }
+            stream_chunk(r, data, len, done);
+        } else if (r->cur->len + len > r->slot_size) {
+            r->stats.oversize++;
+            ws_reasm_release(r, r->cur);
+            r->cur = NULL;
+            r->dropping = true;
+        } else {
+            memcpy(r->cur->data + r->cur->len, data, len);
+            r->cur->len += len;
+        }
+    }
+
+    if (!done) {
+        return 0;
+    }
+
+    r->active = false;
+    if (r->dropping) {
+        r->dropping = false;
+        return -1;
+    }
+
+    r->stats.messages++;
+    if (r->multi_event) {
+        r->stats.fragmented++;
+    }
+    if (!r->streaming) {
+        ws_reasm_msg_t *msg = r->cur;
+        r->cur = NULL;
+        msg->op = r->op;
+        msg->data[msg->len] = '\0';
+        r->on_message(msg, r->ctx);
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Pool and state                                             */
+/* ------------------------------------------------------------------ */
+
+void ws_reasm_release(ws_reasm_t *r, ws_reasm_msg_t *msg)
+{
+    (void)r;
+    if (msg) {
+        atomic_store(&msg->busy, false);
+    }
+}
+
+void ws_reasm_reset(ws_reasm_t *r)
+{
+    if (r) {
+        message_abort(r);
+    }
+}
+
+void ws_reasm_get_stats(const ws_reasm_t *r, ws_reasm_stats_t *out)
+{
+    if (r && out) {
+        *out = r->stats;
+    }
+}
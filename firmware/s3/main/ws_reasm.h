@@ -0,0 +1,146 @@
+/**
+ * @file ws_reasm.h
+ * @brief WebSocket message reassembly on a fixed buffer pool (platform independent)
+ *
+ * esp_websocket_client reports a message as a series of DATA events: a frame
+ * larger than its receive buffer arrives in chunks (payload_offset /
+ * payload_len), and a fragmented message arrives as several frames (fin,
+ * continuation opcode). This layer turns them back into whole messages.
+ *
+ * - Buffered messages are copied into one of a few fixed slots (storage from
+ *   the caller, e.g. PSRAM) and handed over NUL-terminated. The receiver owns
+ *   the slot until ws_reasm_release(), so it may pass it to another task.
+ * - Binary messages can instead be streamed: each chunk goes straight to the
+ *   sink from the client's receive buffer, split on a sample boundary.
+ *
+ * Control frames (ping/pong/close) may sit between fragments and are ignored.
+ *
+ * With a stream tag set, only binary messages whose first byte matches it
+ * are streamed (minus a header); other binary messages are buffered whole.
+ */
+
+#ifndef WS_REASM_H
+#define WS_REASM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* RFC 6455 opcodes */
+#define WS_REASM_OP_CONT        0x0
+#define WS_REASM_OP_TEXT        0x1
+#define WS_REASM_OP_BINARY      0x2
+
+#define WS_REASM_MAX_SLOTS      4
+
+typedef struct {
+    uint8_t op;                 /* WS_REASM_OP_TEXT or WS_REASM_OP_BINARY */
+    int len;                    /* Payload bytes (data[len] is '\0') */
+    uint8_t *data;
+    atomic_bool busy;           /* Filling or owned by the receiver */
+} ws_reasm_msg_t;
+
+/**
+ * Complete buffered message; call ws_reasm_release() when done (any task)
+ */
+typedef void (*ws_reasm_msg_cb_t)(ws_reasm_msg_t *msg, void *ctx);
+
+/**
+ * Streamed binary chunk, a whole number of align-byte units, valid only
+ * during the call. last is set on the message's final chunk (len may be 0).
+ */
+typedef void (*ws_reasm_stream_cb_t)(const uint8_t *data, int len, bool last, void *ctx);
+
+typedef struct {
+    uint32_t messages;          /* Delivered (buffered or streamed) */
+    uint32_t fragmented;        /* ...that needed more than one event */
+    uint32_t oversize;          /* Dropped: larger than a slot */
+    uint32_t no_slot;           /* Dropped: every slot still owned */
+    uint32_t protocol_errors;   /* Continuation without a start, bad offsets */
+} ws_reasm_stats_t;
+
+typedef struct {
+    ws_reasm_msg_t slots[WS_REASM_MAX_SLOTS];
+    int slot_count;
+    int slot_size;              /* Max payload per buffered message */
+    ws_reasm_msg_cb_t on_message;
+    ws_reasm_stream_cb_t on_stream;
+    void *ctx;
+    int align;                  /* Streamed chunk granularity (bytes, 1..2) */
+    bool stream_binary;
+    int stream_tag;             /* First byte of streamable messages, -1: any */
+    int stream_hdr;             /* Header bytes not streamed */
+    /* Message in progress */
+    bool active;
+    bool dropping;              /* Rest of this message is discarded */
+    bool streaming;
+    bool multi_event;
+    int skip;                   /* Header bytes still to drop from the stream */
+    uint8_t op;
+    ws_reasm_msg_t *cur;
+    int frame_expect;           /* Next payload_offset within the current frame */
+    uint8_t carry;              /* Odd byte held back while streaming */
+    bool has_carry;
+    ws_reasm_stats_t stats;
+} ws_reasm_t;
+
+/**
+ * Storage needed for a pool
+ * @param slot_size Max payload per buffered message
+ * @param slot_count Number of slots (1..WS_REASM_MAX_SLOTS)
+ */
+int ws_reasm_storage_size(int slot_size, int slot_count);
+
+/**
+ * Initialize on caller-provided storage
+ * @param on_message Complete buffered messages
+ * @param on_stream Streamed binary chunks (may be NULL: binary is buffered)
+ * @param align Streamed chunk granularity: 2 for PCM16, 1 for none
+ * @return 0 on success, -1 on error
+ */
+int ws_reasm_init(ws_reasm_t *r, void *storage, int slot_size, int slot_count,
+                  ws_reasm_msg_cb_t on_message, ws_reasm_stream_cb_t on_stream,
+                  int align, void *ctx);
+
+/**
+ * Choose how the next binary message is delivered (a message already in
+ * progress keeps its mode). Needs an on_stream callback to enable.
+ */
+void ws_reasm_set_stream_binary(ws_reasm_t *r, bool stream);
+
+/**
+ * Stream only binary messages starting with tag, dropping their first
+ * hdr_len bytes (keep it a multiple of align). tag -1 streams every binary
+ * message unchanged. Applies from the next message.
+ */
+void ws_reasm_set_stream_tag(ws_reasm_t *r, int tag, int hdr_len);
+
+/**
+ * Feed one DATA event
+ * @param op Opcode of the frame this chunk belongs to
+ * @param fin FIN bit of that frame
+ * @param data Chunk bytes
+ * @param len Chunk length
+ * @param payload_len Total payload length of the frame
+ * @param payload_offset Offset of this chunk within the frame payload
+ * @return 1 if a message completed, 0 if more is expected or ignored, -1 if dropped
+ */
+int ws_reasm_feed(ws_reasm_t *r, uint8_t op, bool fin, const uint8_t *data, int len,
+                  int payload_len, int payload_offset);
+
+/**
+ * Return a delivered message's slot to the pool (any task)
+ */
+void ws_reasm_release(ws_reasm_t *r, ws_reasm_msg_t *msg);
+
+/**
+ * Drop any partial message (call on disconnect)
+ */
+void ws_reasm_reset(ws_reasm_t *r);
+
+/**
+ * Copy the counters
+ */
+void ws_reasm_get_stats(const ws_reasm_t *r, ws_reasm_stats_t *out);
+
+#endif /* WS_REASM_H */
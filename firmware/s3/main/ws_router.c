@@ -4,6 +4,8 @@
  */
 
 #include "ws_router.h"
+#include "ws_tlv.h"
+#include "ws_json.h"
 #include "cJSON.h"
 #include <string.h>
 #include <limits.h>
@@ -67,142 +69,447 @@ static void copy_string(char *dst, size_t dst_size, const char *src)
 }
 
 /* ------------------------------------------------------------------ */
-/* Public: Route message to appropriate handler (v2.1 format)          */
+/* Private: Message type lookup                                       */
 /* ------------------------------------------------------------------ */
 
-ws_msg_type_t ws_route_message(const char *json_str)
+/* Dispatch on the first character, at most three compares per type */
+static ws_msg_type_t lookup_type(const char *t)
 {
-    if (!json_str) {
-        return WS_MSG_UNKNOWN;
-    }
+    switch (t[0]) {
+        case 'a':
+            if (strcmp(t, "asr_result") == 0) return WS_MSG_ASR_RESULT;
+            if (strcmp(t, "audio") == 0) return WS_MSG_AUDIO;
+            if (strcmp(t, "audio_end") == 0) return WS_MSG_AUDIO_END;
+            break;
+        case 'b':
+            if (strcmp(t, "bot_reply") == 0) return WS_MSG_BOT_REPLY;
+            break;
+        case 'c':
+            if (strcmp(t, "capture") == 0) return WS_MSG_CAPTURE;
+            if (strcmp(t, "connected") == 0) return WS_MSG_CONNECTED;
+            break;
+        case 'd':
+            if (strcmp(t, "display") == 0) return WS_MSG_DISPLAY;
+            break;
+        case 'e':
+            if (strcmp(t, "error") == 0) return WS_MSG_ERROR_MSG;
+            break;
+        case 'h':
+            if (strcmp(t, "hello") == 0) return WS_MSG_HELLO;
+            break;
+        case 'p':
+            if (strcmp(t, "ping") == 0) return WS_MSG_PING;
+            if (strcmp(t, "pong") == 0) return WS_MSG_PONG;
+            break;
+        case 'r':
+            if (strcmp(t, "reboot") == 0) return WS_MSG_REBOOT;
+            break;
+        case 's':
+            if (strcmp(t, "servo") == 0) return WS_MSG_SERVO;
+            if (strcmp(t, "status") == 0) return WS_MSG_STATUS;
+            if (strcmp(t, "sensor") == 0) return WS_MSG_SENSOR;
+            break;
+        case 't':
+            if (strcmp(t, "tts_end") == 0) return WS_MSG_TTS_END;
+            break;
+        case 'v':
+            if (strcmp(t, "video") == 0) return WS_MSG_VIDEO;
+            break;
+        default:
+            break;
+    }
+    return WS_MSG_UNKNOWN;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: cJSON route for messages beyond the token budget          */
+/* ------------------------------------------------------------------ */
 
+/* Same fields and defaults as the tokenized route below */
+static ws_msg_type_t route_message_cjson(const char *json_str)
+{
     cJSON *root = cJSON_Parse(json_str);
     if (!root) {
         return WS_MSG_UNKNOWN;
     }
 
-    /* Get type field */
     const char *type = get_string(root, "type");
     if (!type) {
         cJSON_Delete(root);
         return WS_MSG_UNKNOWN;
     }
 
-    ws_msg_type_t msg_type = WS_MSG_UNKNOWN;
+    ws_msg_type_t msg_type = lookup_type(type);
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    bool data_obj = data && cJSON_IsObject(data);
 
-    /* Route based on type */
-    if (strcmp(type, "servo") == 0) {
-        msg_type = WS_MSG_SERVO;
-        if (g_router.on_servo) {
-            /* v2.1 format: data.id, data.angle, data.time */
-            cJSON *data = cJSON_GetObjectItem(root, "data");
-            if (data && cJSON_IsObject(data)) {
+    switch (msg_type) {
+        case WS_MSG_SERVO:
+            if (g_router.on_servo && data_obj) {
                 ws_servo_cmd_t cmd = {0};
                 copy_string(cmd.id, sizeof(cmd.id), get_string(data, "id"));
-                int angle1 = get_int(data, "angle", INT_MIN); int angle2 = get_int(data, "Angle", INT_MIN); cmd.angle = (angle1 != INT_MIN) ? angle1 : angle2; if (cmd.angle == INT_MIN) cmd.angle = 90;
+                cmd.angle = get_int(data, "angle", 90);
                 cmd.time_ms = get_int(data, "time", 100);
                 g_router.on_servo(&cmd);
             }
-        }
-    }
-    else if (strcmp(type, "display") == 0) {
-        msg_type = WS_MSG_DISPLAY;
-        if (g_router.on_display) {
-            cJSON *data = cJSON_GetObjectItem(root, "data");
-            if (data && cJSON_IsObject(data)) {
+            break;
+
+        case WS_MSG_DISPLAY:
+            if (g_router.on_display && data_obj) {
                 ws_display_cmd_t cmd = {0};
                 copy_string(cmd.text, sizeof(cmd.text), get_string(data, "text"));
                 copy_string(cmd.emoji, sizeof(cmd.emoji), get_string(data, "emoji"));
                 cmd.size = get_int(data, "size", 0);
                 g_router.on_display(&cmd);
             }
-        }
+            break;
+
+        case WS_MSG_STATUS:
+            if (g_router.on_status) {
+                ws_status_cmd_t cmd = {0};
+                copy_string(cmd.data, sizeof(cmd.data), get_string(root, "data"));
+                g_router.on_status(&cmd);
+            }
+            break;
+
+        case WS_MSG_ASR_RESULT:
+            if (g_router.on_asr_result) {
+                ws_asr_result_cmd_t cmd = {0};
+                copy_string(cmd.text, sizeof(cmd.text), get_string(root, "data"));
+                g_router.on_asr_result(&cmd);
+            }
+            break;
+
+        case WS_MSG_BOT_REPLY:
+            if (g_router.on_bot_reply) {
+                ws_bot_reply_cmd_t cmd = {0};
+                copy_string(cmd.text, sizeof(cmd.text), get_string(root, "data"));
+                g_router.on_bot_reply(&cmd);
+            }
+            break;
+
+        case WS_MSG_TTS_END:
+            if (g_router.on_tts_end) {
+                g_router.on_tts_end();
+            }
+            break;
+
+        case WS_MSG_ERROR_MSG:
+            if (g_router.on_error) {
+                ws_error_cmd_t cmd = {0};
+                cmd.code = get_int(root, "code", 1);
+                copy_string(cmd.message, sizeof(cmd.message), get_string(root, "data"));
+                g_router.on_error(&cmd);
+            }
+            break;
+
+        case WS_MSG_HELLO:
+            if (g_router.on_hello) {
+                ws_hello_cmd_t cmd = {0};
+                const char *codec = data_obj ? get_string(data, "tts") : NULL;
+                const char *ctl = data_obj ? get_string(data, "ctl") : NULL;
+                copy_string(cmd.tts_codec, sizeof(cmd.tts_codec), codec ? codec : "pcm");
+                copy_string(cmd.ctl, sizeof(cmd.ctl), ctl ? ctl : "json");
+                cmd.tts_rate = data_obj ? get_int(data, "tts_rate", 24000) : 24000;
+                g_router.on_hello(&cmd);
+            }
+            break;
+
+        case WS_MSG_CAPTURE:
+            if (g_router.on_capture) {
+                ws_capture_cmd_t cmd = {
+                    .quality = data_obj ? get_int(data, "quality", 80) : 80,
+                };
+                g_router.on_capture(&cmd);
+            }
+            break;
+
+        case WS_MSG_REBOOT:
+            if (g_router.on_reboot) {
+                g_router.on_reboot();
+            }
+            break;
+
+        case WS_MSG_PONG:
+            if (g_router.on_pong) {
+                ws_pong_cmd_t cmd = {
+                    .seq = data_obj ? (uint32_t)get_int(data, "seq", 0) : 0,
+                };
+                g_router.on_pong(&cmd);
+            }
+            break;
+
+        /* Media stream types - recognized but no handler */
+        default:
+            break;
+    }
+
+    cJSON_Delete(root);
+    return msg_type;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Route message to appropriate handler (v2.1 format)          */
+/* ------------------------------------------------------------------ */
+
+ws_msg_type_t ws_route_message(const char *json_str)
+{
+    ws_json_t js;
+    char type[16];
+
+    if (!json_str) {
+        return WS_MSG_UNKNOWN;
+    }
+
+    /* Tokenize in place: no heap, fields go straight into the cmd structs */
+    int n = ws_json_parse(&js, json_str, (int)strlen(json_str));
+    if (n == WS_JSON_ERR_TOKENS) {
+        return route_message_cjson(json_str);
+    }
+    if (n < 0) {
+        return WS_MSG_UNKNOWN;
     }
-    else if (strcmp(type, "status") == 0) {
-        msg_type = WS_MSG_STATUS;
-        if (g_router.on_status) {
-            /* v2.0 format: data is string */
-            const char *data_str = get_string(root, "data");
+    if (ws_json_get_str(&js, ws_json_find(&js, 0, "type"), type, sizeof(type)) != 0) {
+        return WS_MSG_UNKNOWN;
+    }
+
+    ws_msg_type_t msg_type = lookup_type(type);
+    int data = ws_json_find(&js, 0, "data");
+    bool data_obj = ws_json_type(&js, data) == WS_JSON_OBJECT;
+
+    switch (msg_type) {
+        case WS_MSG_SERVO:
+            /* v2.1 format: data.id, data.angle, data.time */
+            if (g_router.on_servo && data_obj) {
+                ws_servo_cmd_t cmd = {0};
+                ws_json_get_str(&js, ws_json_find(&js, data, "id"), cmd.id, sizeof(cmd.id));
+                /* Key lookup is case-insensitive, so "Angle" is covered too */
+                cmd.angle = ws_json_get_int(&js, ws_json_find(&js, data, "angle"), INT_MIN);
+                if (cmd.angle == INT_MIN) cmd.angle = 90;
+                cmd.time_ms = ws_json_get_int(&js, ws_json_find(&js, data, "time"), 100);
+                g_router.on_servo(&cmd);
+            }
+            break;
+
+        case WS_MSG_DISPLAY:
+            if (g_router.on_display && data_obj) {
+                ws_display_cmd_t cmd = {0};
+                ws_json_get_str(&js, ws_json_find(&js, data, "text"), cmd.text, sizeof(cmd.text));
+                ws_json_get_str(&js, ws_json_find(&js, data, "emoji"), cmd.emoji, sizeof(cmd.emoji));
+                cmd.size = ws_json_get_int(&js, ws_json_find(&js, data, "size"), 0);
+                g_router.on_display(&cmd);
+            }
+            break;
+
+        case WS_MSG_STATUS:
+            if (g_router.on_status) {
+                /* v2.0 format: data is string */
+                ws_status_cmd_t cmd = {0};
+                ws_json_get_str(&js, data, cmd.data, sizeof(cmd.data));
+                g_router.on_status(&cmd);
+            }
+            break;
+
+        case WS_MSG_ASR_RESULT:
+            if (g_router.on_asr_result) {
+                ws_asr_result_cmd_t cmd = {0};
+                ws_json_get_str(&js, data, cmd.text, sizeof(cmd.text));
+                g_router.on_asr_result(&cmd);
+            }
+            break;
+
+        case WS_MSG_BOT_REPLY:
+            if (g_router.on_bot_reply) {
+                ws_bot_reply_cmd_t cmd = {0};
+                ws_json_get_str(&js, data, cmd.text, sizeof(cmd.text));
+                g_router.on_bot_reply(&cmd);
+            }
+            break;
+
+        case WS_MSG_TTS_END:
+            if (g_router.on_tts_end) {
+                g_router.on_tts_end();
+            }
+            break;
+
+        case WS_MSG_ERROR_MSG:
+            if (g_router.on_error) {
+                ws_error_cmd_t cmd = {0};
+                cmd.code = ws_json_get_int(&js, ws_json_find(&js, 0, "code"), 1);
+                ws_json_get_str(&js, data, cmd.message, sizeof(cmd.message));
+                g_router.on_error(&cmd);
+            }
+            break;
+
+        case WS_MSG_HELLO:
+            if (g_router.on_hello) {
+                ws_hello_cmd_t cmd = {0};
+                if (ws_json_get_str(&js, ws_json_find(&js, data, "tts"), cmd.tts_codec, sizeof(cmd.tts_codec)) != 0) {
+                    copy_string(cmd.tts_codec, sizeof(cmd.tts_codec), "pcm");
+                }
+                if (ws_json_get_str(&js, ws_json_find(&js, data, "ctl"), cmd.ctl, sizeof(cmd.ctl)) != 0) {
+                    copy_string(cmd.ctl, sizeof(cmd.ctl), "json");
+                }
+                cmd.tts_rate = ws_json_get_int(&js, ws_json_find(&js, data, "tts_rate"), 24000);
+                g_router.on_hello(&cmd);
+            }
+            break;
+
+        case WS_MSG_CAPTURE:
+            if (g_router.on_capture) {
+                ws_capture_cmd_t cmd = {
+                    .quality = ws_json_get_int(&js, ws_json_find(&js, data, "quality"), 80),
+                };
+                g_router.on_capture(&cmd);
+            }
+            break;
+
+        case WS_MSG_REBOOT:
+            if (g_router.on_reboot) {
+                g_router.on_reboot();
+            }
+            break;
+
+        case WS_MSG_PONG:
+            if (g_router.on_pong) {
+                ws_pong_cmd_t cmd = {
+                    .seq = (uint32_t)ws_json_get_int(&js, ws_json_find(&js, data, "seq"), 0),
+                };
+                g_router.on_pong(&cmd);
+            }
+            break;
+
+        /* Media stream types - recognized but no handler */
+        default:
+            break;
+    }
+
+    return msg_type;
+}
+
+/* ------------------------------------------------------------------ */
+/* Private: Route one binary message (ws_tlv.h)                       */
+/* ------------------------------------------------------------------ */
+
+/* Same defaults as the JSON path; unknown tags are skipped */
+static ws_msg_type_t route_tlv_msg(uint8_t type, ws_tlv_reader_t *body)
+{
+    ws_tlv_field_t f;
+    int ret = 1;
+
+    switch (type) {
+        case WS_TLV_SERVO: {
+            ws_servo_cmd_t cmd = { .id = "", .angle = 90, .time_ms = 100 };
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_ID) ws_tlv_field_str(&f, cmd.id, sizeof(cmd.id));
+                else if (f.tag == WS_TLV_F_ANGLE) cmd.angle = ws_tlv_field_int(&f, 90);
+                else if (f.tag == WS_TLV_F_TIME) cmd.time_ms = ws_tlv_field_int(&f, 100);
+            }
+            if (ret < 0) break;
+            if (g_router.on_servo) g_router.on_servo(&cmd);
+            return WS_MSG_SERVO;
+        }
+        case WS_TLV_DISPLAY: {
+            ws_display_cmd_t cmd = {0};
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) ws_tlv_field_str(&f, cmd.text, sizeof(cmd.text));
+                else if (f.tag == WS_TLV_F_EMOJI) ws_tlv_field_str(&f, cmd.emoji, sizeof(cmd.emoji));
+                else if (f.tag == WS_TLV_F_SIZE) cmd.size = ws_tlv_field_int(&f, 0);
+            }
+            if (ret < 0) break;
+            if (g_router.on_display) g_router.on_display(&cmd);
+            return WS_MSG_DISPLAY;
+        }
+        case WS_TLV_STATUS: {
             ws_status_cmd_t cmd = {0};
-            copy_string(cmd.data, sizeof(cmd.data), data_str);
-            g_router.on_status(&cmd);
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) ws_tlv_field_str(&f, cmd.data, sizeof(cmd.data));
+            }
+            if (ret < 0) break;
+            if (g_router.on_status) g_router.on_status(&cmd);
+            return WS_MSG_STATUS;
         }
-    }
-    else if (strcmp(type, "asr_result") == 0) {
-        msg_type = WS_MSG_ASR_RESULT;
-        if (g_router.on_asr_result) {
-            const char *data_str = get_string(root, "data");
+        case WS_TLV_ASR_RESULT: {
             ws_asr_result_cmd_t cmd = {0};
-            copy_string(cmd.text, sizeof(cmd.text), data_str);
-            g_router.on_asr_result(&cmd);
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) ws_tlv_field_str(&f, cmd.text, sizeof(cmd.text));
+            }
+            if (ret < 0) break;
+            if (g_router.on_asr_result) g_router.on_asr_result(&cmd);
+            return WS_MSG_ASR_RESULT;
         }
-    }
-    else if (strcmp(type, "bot_reply") == 0) {
-        msg_type = WS_MSG_BOT_REPLY;
-        if (g_router.on_bot_reply) {
-            const char *data_str = get_string(root, "data");
+        case WS_TLV_BOT_REPLY: {
             ws_bot_reply_cmd_t cmd = {0};
-            copy_string(cmd.text, sizeof(cmd.text), data_str);
-            g_router.on_bot_reply(&cmd);
-        }
-    }
-    else if (strcmp(type, "tts_end") == 0) {
-        msg_type = WS_MSG_TTS_END;
-        if (g_router.on_tts_end) {
-            g_router.on_tts_end();
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) ws_tlv_field_str(&f, cmd.text, sizeof(cmd.text));
+            }
+            if (ret < 0) break;
+            if (g_router.on_bot_reply) g_router.on_bot_reply(&cmd);
+            return WS_MSG_BOT_REPLY;
         }
-    }
-    else if (strcmp(type, "error") == 0) {
-        msg_type = WS_MSG_ERROR_MSG;
-        if (g_router.on_error) {
-            ws_error_cmd_t cmd = {0};
-            cmd.code = get_int(root, "code", 1);
-            const char *data_str = get_string(root, "data");
-            copy_string(cmd.message, sizeof(cmd.message), data_str);
-            g_router.on_error(&cmd);
+        case WS_TLV_TTS_END:
+            if (g_router.on_tts_end) g_router.on_tts_end();
+            return WS_MSG_TTS_END;
+        case WS_TLV_ERROR: {
+            ws_error_cmd_t cmd = { .code = 1 };
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) ws_tlv_field_str(&f, cmd.message, sizeof(cmd.message));
+                else if (f.tag == WS_TLV_F_CODE) cmd.code = ws_tlv_field_int(&f, 1);
+            }
+            if (ret < 0) break;
+            if (g_router.on_error) g_router.on_error(&cmd);
+            return WS_MSG_ERROR_MSG;
         }
-    }
-    else if (strcmp(type, "capture") == 0) {
-        msg_type = WS_MSG_CAPTURE;
-        if (g_router.on_capture) {
-            cJSON *data = cJSON_GetObjectItem(root, "data");
-            ws_capture_cmd_t cmd = {
-                .quality = data ? get_int(data, "quality", 80) : 80,
-            };
-            g_router.on_capture(&cmd);
+        case WS_TLV_CAPTURE: {
+            ws_capture_cmd_t cmd = { .quality = 80 };
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) cmd.quality = ws_tlv_field_int(&f, 80);
+            }
+            if (ret < 0) break;
+            if (g_router.on_capture) g_router.on_capture(&cmd);
+            return WS_MSG_CAPTURE;
         }
-    }
-    else if (strcmp(type, "reboot") == 0) {
-        msg_type = WS_MSG_REBOOT;
-        if (g_router.on_reboot) {
-            g_router.on_reboot();
+        case WS_TLV_REBOOT:
+            if (g_router.on_reboot) g_router.on_reboot();
+            return WS_MSG_REBOOT;
+        case WS_TLV_PONG: {
+            ws_pong_cmd_t cmd = {0};
+            while ((ret = ws_tlv_next_field(body, &f)) > 0) {
+                if (f.tag == WS_TLV_F_TEXT) cmd.seq = (uint32_t)ws_tlv_field_int(&f, 0);
+            }
+            if (ret < 0) break;
+            if (g_router.on_pong) g_router.on_pong(&cmd);
+            return WS_MSG_PONG;
         }
+        default:
+            break;
     }
-    /* Media stream types - recognized but no handler */
-    else if (strcmp(type, "audio") == 0) {
-        msg_type = WS_MSG_AUDIO;
-    }
-    else if (strcmp(type, "audio_end") == 0) {
-        msg_type = WS_MSG_AUDIO_END;
-    }
-    else if (strcmp(type, "video") == 0) {
-        msg_type = WS_MSG_VIDEO;
-    }
-    else if (strcmp(type, "sensor") == 0) {
-        msg_type = WS_MSG_SENSOR;
-    }
-    else if (strcmp(type, "ping") == 0) {
-        msg_type = WS_MSG_PING;
-    }
-    else if (strcmp(type, "pong") == 0) {
-        msg_type = WS_MSG_PONG;
-    }
-    else if (strcmp(type, "connected") == 0) {
-        msg_type = WS_MSG_CONNECTED;
+    return WS_MSG_UNKNOWN;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Route binary control frame                                 */
+/* ------------------------------------------------------------------ */
+
+ws_msg_type_t ws_route_binary(const uint8_t *data, int len)
+{
+    ws_tlv_reader_t r, body;
+    uint8_t type;
+    int ret;
+    ws_msg_type_t last = WS_MSG_UNKNOWN;
+
+    if (ws_tlv_reader_init(&r, data, len) != 0) {
+        return WS_MSG_UNKNOWN;
     }
 
-    cJSON_Delete(root);
-    return msg_type;
+    /* A frame may batch several messages (e.g. both servo axes) */
+    while ((ret = ws_tlv_next_msg(&r, &type, &body)) > 0) {
+        ws_msg_type_t t = route_tlv_msg(type, &body);
+        if (t != WS_MSG_UNKNOWN) {
+            last = t;
+        }
+    }
+    return ret < 0 ? WS_MSG_UNKNOWN : last;
 }
 
 /* ------------------------------------------------------------------ */
@@ -363,3 +670,36 @@ int ws_parse_error(const char *json_str, ws_error_cmd_t *out_cmd)
     cJSON_Delete(root);
     return 0;
 }
+
+/* ------------------------------------------------------------------ */
+/* Public: Parse hello reply (codec negotiation)                      */
+/* ------------------------------------------------------------------ */
+
+int ws_parse_hello(const char *json_str, ws_hello_cmd_t *out_cmd)
+{
+    if (!json_str || !out_cmd) {
+        return -1;
+    }
+
+    cJSON *root = cJSON_Parse(json_str);
+    if (!root) {
+        return -1;
+    }
+
+    memset(out_cmd, 0, sizeof(*out_cmd));
+
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    const char *codec = NULL;
+    const char *ctl = NULL;
+    out_cmd->tts_rate = 24000;
+    if (data && cJSON_IsObject(data)) {
+        codec = get_string(data, "tts");
+        ctl = get_string(data, "ctl");
+        out_cmd->tts_rate = get_int(data, "tts_rate", 24000);
+    }
+    copy_string(out_cmd->tts_codec, sizeof(out_cmd->tts_codec), codec ? codec : "pcm");
+    copy_string(out_cmd->ctl, sizeof(out_cmd->ctl), ctl ? ctl : "json");
+
+    cJSON_Delete(root);
+    return 0;
+}
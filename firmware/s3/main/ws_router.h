@@ -20,6 +20,7 @@ typedef enum {
     WS_MSG_BOT_REPLY,       /* {"type": "bot_reply", "code": 0, "data": "AI回复"} */
     WS_MSG_TTS_END,         /* {"type": "tts_end", "code": 0, "data": "ok"} */
     WS_MSG_ERROR_MSG,       /* {"type": "error", "code": 1, "data": "错误描述"} */
+    WS_MSG_HELLO,           /* {"type": "hello", "code": 0, "data": {"tts": "opus", "tts_rate": 24000, "ctl": "tlv"}} */
 
     /* Media streams (Watcher -> Cloud) */
     WS_MSG_AUDIO,           /* Binary PCM 16kHz */
@@ -29,7 +30,7 @@ typedef enum {
 
     /* System messages */
     WS_MSG_PING,
-    WS_MSG_PONG,
+    WS_MSG_PONG,            /* {"type": "pong", "data": {"seq": 12, "t": 123456}} (echo of our ping) */
     WS_MSG_ERROR,
     WS_MSG_CONNECTED,
 
@@ -78,11 +79,24 @@ typedef struct {
     char message[WS_TEXT_DATA_MAX]; /* error description */
 } ws_error_cmd_t;
 
+/* Hello reply structure (codec negotiation) */
+#define WS_CODEC_NAME_MAX 8
+typedef struct {
+    char tts_codec[WS_CODEC_NAME_MAX];  /* "pcm" or "opus" - accepted TTS codec */
+    int tts_rate;                       /* TTS sample rate in Hz (default 24000) */
+    char ctl[WS_CODEC_NAME_MAX];        /* "json" or "tlv" - control encoding (default "json") */
+} ws_hello_cmd_t;
+
 /* Capture command structure */
 typedef struct {
     int quality;            /* JPEG quality (1-100) */
 } ws_capture_cmd_t;
 
+/* Keepalive pong (echo of the device's ping) */
+typedef struct {
+    uint32_t seq;           /* Sequence number of the ping */
+} ws_pong_cmd_t;
+
 /* Legacy structures (deprecated) */
 typedef struct {
     char format[16];
@@ -107,6 +121,8 @@ typedef void (*ws_asr_result_handler_t)(const ws_asr_result_cmd_t *cmd);
 typedef void (*ws_bot_reply_handler_t)(const ws_bot_reply_cmd_t *cmd);
 typedef void (*ws_tts_end_handler_t)(void);
 typedef void (*ws_error_handler_t)(const ws_error_cmd_t *cmd);
+typedef void (*ws_hello_handler_t)(const ws_hello_cmd_t *cmd);
+typedef void (*ws_pong_handler_t)(const ws_pong_cmd_t *cmd);
 
 /* Router context */
 typedef struct {
@@ -121,6 +137,8 @@ typedef struct {
     ws_bot_reply_handler_t  on_bot_reply;
     ws_tts_end_handler_t    on_tts_end;
     ws_error_handler_t      on_error;
+    ws_hello_handler_t      on_hello;
+    ws_pong_handler_t       on_pong;
 } ws_router_t;
 
 /**
@@ -135,6 +153,14 @@ void ws_router_init(ws_router_t *router);
  */
 ws_msg_type_t ws_route_message(const char *json_str);
 
+/**
+ * Route a binary control frame (ws_tlv.h) to the same handlers
+ * @param data Frame including its 2-byte header
+ * @param len Frame length
+ * @return Type of the last message routed, or WS_MSG_UNKNOWN if malformed
+ */
+ws_msg_type_t ws_route_binary(const uint8_t *data, int len);
+
 /**
  * Parse servo command from JSON (v2.1 format)
  * @param json_str JSON string
@@ -183,4 +209,12 @@ int ws_parse_bot_reply(const char *json_str, ws_bot_reply_cmd_t *out_cmd);
  */
 int ws_parse_error(const char *json_str, ws_error_cmd_t *out_cmd);
 
+/**
+ * Parse hello reply from JSON (codec negotiation)
+ * @param json_str JSON string
+ * @param out_cmd Output structure (tts_codec "pcm" if absent)
+ * @return 0 on success, -1 on error
+ */
+int ws_parse_hello(const char *json_str, ws_hello_cmd_t *out_cmd);
+
 #endif /* WS_ROUTER_H */
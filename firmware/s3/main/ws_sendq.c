@@ -0,0 +1,206 @@
+/**
+ * @file ws_sendq.c
+ * @brief WebSocket send queue implementation
+ */
+
+#include "ws_sendq.h"
+#include <string.h>
+
+/* Stored in front of every payload */
+typedef struct {
+    uint32_t len;
+    uint32_t t_ms;              /* Enqueue time */
+    uint8_t op;
+    uint8_t flags;
+    uint8_t pad[2];
+} entry_hdr_t;
+
+#define HDR_SIZE ((int)sizeof(entry_hdr_t))
+
+/* ------------------------------------------------------------------ */
+/* Private: Ring                                                      */
+/* ------------------------------------------------------------------ */
+
+static void ring_copy_in(ws_sendq_ring_t *r, int pos, const void *src, int len)
+{
+    int first = r->cap - pos;
+    if (first > len) first = len;
+    memcpy(&r->buf[pos], src, first);
+    memcpy(r->buf, (const uint8_t *)src + first, len - first);
+}
+
+static void ring_copy_out(const ws_sendq_ring_t *r, int pos, void *dst, int len)
+{
+    int first = r->cap - pos;
+    if (first > len) first = len;
+    memcpy(dst, &r->buf[pos], first);
+    memcpy((uint8_t *)dst + first, r->buf, len - first);
+}
+
+/* Remove the oldest entry; returns its header */
+static entry_hdr_t ring_drop_head(ws_sendq_ring_t *r)
+{
+    entry_hdr_t h;
+    ring_copy_out(r, r->head, &h, HDR_SIZE);
+    int size = HDR_SIZE + (int)h.len;
+    r->head = (r->head + size) % r->cap;
+    r->used -= size;
+    r->count--;
+    return h;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Init                                                       */
+/* ------------------------------------------------------------------ */
+
+int ws_sendq_storage_size(const int budget[WS_SENDQ_CLASSES])
+{
+    int total = 0;
+    for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+        total += budget[i];
+    }
+    return total;
+}
+
+int ws_sendq_init(ws_sendq_t *q, uint8_t *storage, const int budget[WS_SENDQ_CLASSES])
+{
+    if (!q || !storage || !budget) {
+        return -1;
+    }
+    for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+        if (budget[i] <= HDR_SIZE) {
+            return -1;
+        }
+    }
+
+    memset(q, 0, sizeof(*q));
+    for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+        q->ring[i].buf = storage;
+        q->ring[i].cap = budget[i];
+        q->ring[i].drop_oldest = (i != WS_SENDQ_CONTROL);
+        storage += budget[i];
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Push / Pop                                                 */
+/* ------------------------------------------------------------------ */
+
+int ws_sendq_push(ws_sendq_t *q, ws_sendq_class_t cls, uint8_t op, uint8_t flags,
+                  const uint8_t *data, int len, uint32_t now_ms)
+{
+    if (!q || cls < 0 || cls >= WS_SENDQ_CLASSES || len < 0 || (len > 0 && !data)) {
+        return -1;
+    }
+
+    ws_sendq_ring_t *r = &q->ring[cls];
+    int need = HDR_SIZE + len;
+
+    if (need > r->cap) {
+        r->stats.dropped++;
+        return -1;
+    }
+
+    while (r->cap - r->used < need) {
+        entry_hdr_t head = { 0 };
+        if (r->drop_oldest && r->count > 0) {
+            ring_copy_out(r, r->head, &head, HDR_SIZE);
+        }
+        if (!r->drop_oldest || r->count == 0 || (head.flags & WS_SENDQ_PINNED)) {
+            r->stats.dropped++;
+            return -1;
+        }
+        /* Stale: a newer frame is worth more than the one still waiting */
+        ring_drop_head(r);
+        r->stats.dropped++;
+        r->stats.evicted++;
+    }
+
+    entry_hdr_t h = { .len = (uint32_t)len, .t_ms = now_ms, .op = op, .flags = flags };
+    int tail = (r->head + r->used) % r->cap;
+    ring_copy_in(r, tail, &h, HDR_SIZE);
+    ring_copy_in(r, (tail + HDR_SIZE) % r->cap, data, len);
+    r->used += need;
+    r->count++;
+
+    r->stats.queued++;
+    if (r->used > r->stats.high_water_bytes) {
+        r->stats.high_water_bytes = r->used;
+    }
+    return 0;
+}
+
+int ws_sendq_pop(ws_sendq_t *q, uint8_t *out, int max_len, uint8_t *op,
+                 ws_sendq_class_t *cls, uint32_t now_ms)
+{
+    if (!q || !out || !op) {
+        return -1;
+    }
+
+    for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+        ws_sendq_ring_t *r = &q->ring[i];
+
+        while (r->count > 0) {
+            int payload = (r->head + HDR_SIZE) % r->cap;
+            entry_hdr_t h = ring_drop_head(r);
+
+            if ((int)h.len > max_len) {
+                r->stats.dropped++;
+                continue;
+            }
+            ring_copy_out(r, payload, out, (int)h.len);
+
+            uint32_t latency = now_ms - h.t_ms;
+            r->stats.sent++;
+            r->latency_sum_ms += latency;
+            if (latency > r->stats.latency_max_ms) {
+                r->stats.latency_max_ms = latency;
+            }
+
+            *op = h.op;
+            if (cls) {
+                *cls = (ws_sendq_class_t)i;
+            }
+            return (int)h.len;
+        }
+    }
+    return -1;
+}
+
+int ws_sendq_count(const ws_sendq_t *q)
+{
+    int n = 0;
+    if (q) {
+        for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+            n += q->ring[i].count;
+        }
+    }
+    return n;
+}
+
+void ws_sendq_clear(ws_sendq_t *q)
+{
+    if (!q) {
+        return;
+    }
+    for (int i = 0; i < WS_SENDQ_CLASSES; i++) {
+        ws_sendq_ring_t *r = &q->ring[i];
+        r->stats.dropped += r->count;
+        r->head = 0;
+        r->used = 0;
+        r->count = 0;
+    }
+}
+
+void ws_sendq_get_stats(const ws_sendq_t *q, ws_sendq_class_t cls, ws_sendq_class_stats_t *out)
+{
+    if (!q || !out || cls < 0 || cls >= WS_SENDQ_CLASSES) {
+        return;
+    }
+
+    const ws_sendq_ring_t *r = &q->ring[cls];
+    *out = r->stats;
+    out->depth_bytes = r->used;
+    out->latency_avg_ms = r->stats.sent ? (uint32_t)(r->latency_sum_ms / r->stats.sent) : 0;
+}
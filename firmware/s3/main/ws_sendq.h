@@ -0,0 +1,110 @@
+/**
+ * @file ws_sendq.h
+ * @brief WebSocket send queue with priority classes (platform independent)
+ *
+ * Callers enqueue and return; one sender task drains the queue to the socket,
+ * always taking the highest-priority class first. Each class is a byte ring
+ * with its own budget, so a stalled socket can never hold more than the sum
+ * of the budgets.
+ *
+ * - Control: rejected when its budget is full (never reordered or dropped
+ *   once queued).
+ * - Audio / telemetry: the oldest entries are evicted to make room; an entry
+ *   pushed with WS_SENDQ_PINNED (e.g. the end-of-utterance marker) is never
+ *   evicted, and the new entry is rejected instead.
+ *
+ * Not thread safe: the caller serializes push/pop (one mutex). Storage is
+ * provided by the caller so it can live in PSRAM.
+ */
+
+#ifndef WS_SENDQ_H
+#define WS_SENDQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    WS_SENDQ_CONTROL = 0,       /* Text control messages (hello, abort) */
+    WS_SENDQ_AUDIO,             /* Uplink audio and its in-band end marker */
+    WS_SENDQ_TELEMETRY,         /* Status reports, dropped first */
+    WS_SENDQ_CLASSES
+} ws_sendq_class_t;
+
+/* Push flags */
+#define WS_SENDQ_PINNED         0x01    /* Never evicted by drop-oldest */
+
+typedef struct {
+    uint32_t queued;            /* Accepted by push */
+    uint32_t sent;              /* Handed to the sender */
+    uint32_t dropped;           /* Rejected or evicted */
+    uint32_t evicted;           /* ...of which evicted as stale (drop-oldest) */
+    int depth_bytes;            /* Queued now (including entry headers) */
+    int high_water_bytes;
+    uint32_t latency_max_ms;    /* Enqueue to pop */
+    uint32_t latency_avg_ms;
+} ws_sendq_class_stats_t;
+
+typedef struct {
+    uint8_t *buf;
+    int cap;
+    int head;                   /* Oldest entry */
+    int used;
+    int count;
+    bool drop_oldest;
+    ws_sendq_class_stats_t stats;
+    uint64_t latency_sum_ms;
+} ws_sendq_ring_t;
+
+typedef struct {
+    ws_sendq_ring_t ring[WS_SENDQ_CLASSES];
+} ws_sendq_t;
+
+/**
+ * Storage needed for the given per-class budgets
+ */
+int ws_sendq_storage_size(const int budget[WS_SENDQ_CLASSES]);
+
+/**
+ * Initialize on caller-provided storage
+ * @param budget Bytes per class (each entry costs its payload plus a small header)
+ * @return 0 on success, -1 on error
+ */
+int ws_sendq_init(ws_sendq_t *q, uint8_t *storage, const int budget[WS_SENDQ_CLASSES]);
+
+/**
+ * Queue one message
+ * @param op WebSocket opcode to send it with (stored, returned by pop)
+ * @param flags WS_SENDQ_PINNED or 0
+ * @param now_ms Timestamp for latency accounting
+ * @return 0 if queued, -1 if rejected (counted as a drop)
+ */
+int ws_sendq_push(ws_sendq_t *q, ws_sendq_class_t cls, uint8_t op, uint8_t flags,
+                  const uint8_t *data, int len, uint32_t now_ms);
+
+/**
+ * Take the next message, highest-priority class first
+ * @param out Buffer for the payload
+ * @param max_len Size of out (larger entries are dropped)
+ * @param op Opcode given to push
+ * @param cls Class it came from (may be NULL)
+ * @return Payload length, -1 if the queue is empty
+ */
+int ws_sendq_pop(ws_sendq_t *q, uint8_t *out, int max_len, uint8_t *op,
+                 ws_sendq_class_t *cls, uint32_t now_ms);
+
+/**
+ * Queued messages across all classes
+ */
+int ws_sendq_count(const ws_sendq_t *q);
+
+/**
+ * Drop everything queued (e.g. on disconnect); counted as drops
+ */
+void ws_sendq_clear(ws_sendq_t *q);
+
+/**
+ * Copy one class's counters
+ */
+void ws_sendq_get_stats(const ws_sendq_t *q, ws_sendq_class_t cls, ws_sendq_class_stats_t *out);
+
+#endif /* WS_SENDQ_H */
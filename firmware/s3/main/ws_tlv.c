@@ -0,0 +1,172 @@
+/**
+ * @file ws_tlv.c
+ * @brief Binary control message encoding and decoding
+ */
+
+#include "ws_tlv.h"
+#include <string.h>
+
+#define MSG_HDR_LEN     3       /* type + body_len */
+#define FIELD_HDR_LEN   2       /* tag + len */
+
+/* ------------------------------------------------------------------ */
+/* Private: Writer                                                    */
+/* ------------------------------------------------------------------ */
+
+static void put_bytes(ws_tlv_writer_t *w, const void *data, int len)
+{
+    if (w->overflow || w->len + len > w->cap) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, data, len);
+    w->len += len;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Writer                                                     */
+/* ------------------------------------------------------------------ */
+
+void ws_tlv_writer_init(ws_tlv_writer_t *w, uint8_t *buf, int cap)
+{
+    const uint8_t hdr[WS_TLV_HDR_LEN] = { WS_TLV_CH_CONTROL, 0 };
+
+    w->buf = buf;
+    w->cap = buf ? cap : 0;
+    w->len = 0;
+    w->msg_start = -1;
+    w->overflow = false;
+    put_bytes(w, hdr, sizeof(hdr));
+}
+
+void ws_tlv_msg_begin(ws_tlv_writer_t *w, uint8_t type)
+{
+    const uint8_t hdr[MSG_HDR_LEN] = { type, 0, 0 };    /* Length patched on end */
+
+    w->msg_start = w->len;
+    put_bytes(w, hdr, sizeof(hdr));
+}
+
+void ws_tlv_put_int(ws_tlv_writer_t *w, uint8_t tag, int32_t value)
+{
+    uint8_t field[FIELD_HDR_LEN + 4];
+    uint8_t n = (value >= INT8_MIN && value <= INT8_MAX) ? 1 :
+                (value >= INT16_MIN && value <= INT16_MAX) ? 2 : 4;
+
+    field[0] = tag;
+    field[1] = n;
+    for (int i = 0; i < n; i++) {
+        field[FIELD_HDR_LEN + i] = (uint8_t)((uint32_t)value >> (8 * i));
+    }
+    put_bytes(w, field, FIELD_HDR_LEN + n);
+}
+
+void ws_tlv_put_str(ws_tlv_writer_t *w, uint8_t tag, const char *str)
+{
+    size_t n = str ? strlen(str) : 0;
+    if (n > UINT8_MAX) {
+        n = UINT8_MAX;
+    }
+    uint8_t hdr[FIELD_HDR_LEN] = { tag, (uint8_t)n };
+
+    put_bytes(w, hdr, sizeof(hdr));
+    if (n > 0) {
+        put_bytes(w, str, (int)n);
+    }
+}
+
+void ws_tlv_msg_end(ws_tlv_writer_t *w)
+{
+    if (w->msg_start < 0 || w->overflow) {
+        return;
+    }
+    int body = w->len - w->msg_start - MSG_HDR_LEN;
+    if (body > UINT16_MAX) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->msg_start + 1] = (uint8_t)body;
+    w->buf[w->msg_start + 2] = (uint8_t)(body >> 8);
+    w->msg_start = -1;
+}
+
+int ws_tlv_writer_finish(ws_tlv_writer_t *w)
+{
+    return w->overflow ? -1 : w->len;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Reader                                                     */
+/* ------------------------------------------------------------------ */
+
+int ws_tlv_reader_init(ws_tlv_reader_t *r, const uint8_t *frame, int len)
+{
+    if (!r || !frame || len < WS_TLV_HDR_LEN || frame[0] != WS_TLV_CH_CONTROL) {
+        return -1;
+    }
+    r->p = frame + WS_TLV_HDR_LEN;
+    r->left = len - WS_TLV_HDR_LEN;
+    return 0;
+}
+
+int ws_tlv_next_msg(ws_tlv_reader_t *r, uint8_t *type, ws_tlv_reader_t *body)
+{
+    if (r->left == 0) {
+        return 0;
+    }
+    if (r->left < MSG_HDR_LEN) {
+        return -1;
+    }
+
+    int body_len = r->p[1] | (r->p[2] << 8);
+    if (r->left < MSG_HDR_LEN + body_len) {
+        return -1;
+    }
+
+    *type = r->p[0];
+    body->p = r->p + MSG_HDR_LEN;
+    body->left = body_len;
+    r->p += MSG_HDR_LEN + body_len;
+    r->left -= MSG_HDR_LEN + body_len;
+    return 1;
+}
+
+int ws_tlv_next_field(ws_tlv_reader_t *body, ws_tlv_field_t *f)
+{
+    if (body->left == 0) {
+        return 0;
+    }
+    if (body->left < FIELD_HDR_LEN || body->left < FIELD_HDR_LEN + body->p[1]) {
+        return -1;
+    }
+
+    f->tag = body->p[0];
+    f->len = body->p[1];
+    f->value = body->p + FIELD_HDR_LEN;
+    body->p += FIELD_HDR_LEN + f->len;
+    body->left -= FIELD_HDR_LEN + f->len;
+    return 1;
+}
+
+int32_t ws_tlv_field_int(const ws_tlv_field_t *f, int32_t default_val)
+{
+    const uint8_t *v = f->value;
+
+    switch (f->len) {
+        case 1: return (int8_t)v[0];
+        case 2: return (int16_t)(v[0] | (v[1] << 8));
+        case 4: return (int32_t)((uint32_t)v[0] | ((uint32_t)v[1] << 8) |
+                                 ((uint32_t)v[2] << 16) | ((uint32_t)v[3] << 24));
+        default: return default_val;
+    }
+}
+
+void ws_tlv_field_str(const ws_tlv_field_t *f, char *dst, int dst_size)
+{
+    if (!dst || dst_size <= 0) {
+        return;
+    }
+    int n = f->len < dst_size - 1 ? f->len : dst_size - 1;
+    memcpy(dst, f->value, n);
+    dst[n] = '\0';
+}
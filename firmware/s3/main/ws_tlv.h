@@ -0,0 +1,124 @@
+/**
+ * @file ws_tlv.h
+ * @brief Binary control messages (TLV) for the WebSocket link (platform independent)
+ *
+ * Negotiated in the hello exchange ("ctl":"tlv"); JSON stays the fallback.
+ * Once enabled, every server binary frame starts with a 2-byte header so
+ * control can never be mistaken for TTS audio (raw PCM has no framing):
+ *
+ *   [channel u8][reserved u8]   WS_TLV_CH_AUDIO: TTS payload follows
+ *                               WS_TLV_CH_CONTROL: one or more messages
+ *
+ * The header is 2 bytes so PCM after it stays 16-bit aligned. A control
+ * message is
+ *
+ *   [type u8][body_len u16 LE][field]...    field = [tag u8][len u8][value]
+ *
+ * Integers are little-endian two's complement, 1, 2 or 4 bytes; strings are
+ * raw UTF-8 without a terminator. Unknown types and tags are skipped.
+ */
+
+#ifndef WS_TLV_H
+#define WS_TLV_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Frame header */
+#define WS_TLV_HDR_LEN          2
+#define WS_TLV_CH_AUDIO         0x01
+#define WS_TLV_CH_CONTROL       0x02
+
+/* Message types (wire ids, never renumber) */
+#define WS_TLV_SERVO            0x01    /* 1 id (str), 2 angle, 3 time */
+#define WS_TLV_DISPLAY          0x02    /* 1 text, 2 emoji, 3 size */
+#define WS_TLV_STATUS           0x03    /* 1 data */
+#define WS_TLV_ASR_RESULT       0x04    /* 1 text */
+#define WS_TLV_BOT_REPLY        0x05    /* 1 text */
+#define WS_TLV_TTS_END          0x06    /* (no fields) */
+#define WS_TLV_ERROR            0x07    /* 1 message, 2 code */
+#define WS_TLV_CAPTURE          0x08    /* 1 quality */
+#define WS_TLV_REBOOT           0x09    /* (no fields) */
+#define WS_TLV_PONG             0x0A    /* 1 seq */
+
+/* Field tags shared by most types */
+#define WS_TLV_F_TEXT           0x01
+#define WS_TLV_F_ID             0x01
+#define WS_TLV_F_ANGLE          0x02
+#define WS_TLV_F_EMOJI          0x02
+#define WS_TLV_F_CODE           0x02
+#define WS_TLV_F_TIME           0x03
+#define WS_TLV_F_SIZE           0x03
+
+/* ------------------------------------------------------------------ */
+/* Writer                                                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    uint8_t *buf;
+    int cap;
+    int len;
+    int msg_start;              /* Offset of the open message, -1 if none */
+    bool overflow;
+} ws_tlv_writer_t;
+
+/**
+ * Start a control frame (writes the header)
+ */
+void ws_tlv_writer_init(ws_tlv_writer_t *w, uint8_t *buf, int cap);
+
+void ws_tlv_msg_begin(ws_tlv_writer_t *w, uint8_t type);
+void ws_tlv_put_int(ws_tlv_writer_t *w, uint8_t tag, int32_t value);
+void ws_tlv_put_str(ws_tlv_writer_t *w, uint8_t tag, const char *str);
+void ws_tlv_msg_end(ws_tlv_writer_t *w);
+
+/**
+ * @return Frame length, or -1 if the buffer was too small
+ */
+int ws_tlv_writer_finish(ws_tlv_writer_t *w);
+
+/* ------------------------------------------------------------------ */
+/* Reader                                                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const uint8_t *p;
+    int left;
+} ws_tlv_reader_t;
+
+typedef struct {
+    uint8_t tag;
+    uint8_t len;
+    const uint8_t *value;
+} ws_tlv_field_t;
+
+/**
+ * Check the header of a control frame and position on its first message
+ * @return 0 on success, -1 if not a control frame
+ */
+int ws_tlv_reader_init(ws_tlv_reader_t *r, const uint8_t *frame, int len);
+
+/**
+ * Next message
+ * @param body Reader over the message's fields
+ * @return 1 if a message was read, 0 at the end, -1 if truncated
+ */
+int ws_tlv_next_msg(ws_tlv_reader_t *r, uint8_t *type, ws_tlv_reader_t *body);
+
+/**
+ * Next field of a message body
+ * @return 1 if a field was read, 0 at the end, -1 if truncated
+ */
+int ws_tlv_next_field(ws_tlv_reader_t *body, ws_tlv_field_t *f);
+
+/**
+ * Integer value (1, 2 or 4 bytes, sign-extended)
+ */
+int32_t ws_tlv_field_int(const ws_tlv_field_t *f, int32_t default_val);
+
+/**
+ * Copy a string value, truncated and NUL-terminated
+ */
+void ws_tlv_field_str(const ws_tlv_field_t *f, char *dst, int dst_size);
+
+#endif /* WS_TLV_H */
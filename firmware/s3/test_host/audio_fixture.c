@@ -0,0 +1,263 @@
+/**
+ * @file audio_fixture.c
+ * @brief Reference audio for host tests and benchmarks
+ */
+
+#include "audio_fixture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ------------------------------------------------------------------ */
+/* Private: Little-endian readers                                     */
+/* ------------------------------------------------------------------ */
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: WAV loader                                                 */
+/* ------------------------------------------------------------------ */
+
+int audio_fixture_load_wav(const char *path, audio_fixture_t *out)
+{
+    if (!path || !out) {
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return -1;
+    }
+
+    uint8_t hdr[12];
+    if (fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr) ||
+        memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) {
+        fclose(f);
+        return -1;
+    }
+
+    int have_fmt = 0;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, sizeof(chunk), f) == sizeof(chunk)) {
+        uint32_t size = rd_u32(chunk + 4);
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) {
+                break;
+            }
+            /* PCM, mono, 16-bit only */
+            if (rd_u16(fmt) != 1 || rd_u16(fmt + 2) != 1 || rd_u16(fmt + 14) != 16) {
+                break;
+            }
+            out->sample_rate = (int)rd_u32(fmt + 4);
+            have_fmt = 1;
+            fseek(f, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+            out->num_samples = (int)(size / 2);
+            out->samples = malloc((size_t)out->num_samples * sizeof(int16_t));
+            if (!out->samples) {
+                break;
+            }
+            uint8_t *raw = (uint8_t *)out->samples;
+            if (fread(raw, 2, (size_t)out->num_samples, f) != (size_t)out->num_samples) {
+                break;
+            }
+            /* Host is little-endian on every CI target; convert anyway */
+            for (int i = 0; i < out->num_samples; i++) {
+                out->samples[i] = (int16_t)rd_u16(raw + i * 2);
+            }
+            fclose(f);
+            return 0;
+        } else {
+            fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    fclose(f);
+    audio_fixture_free(out);
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Synthetic speech                                           */
+/* ------------------------------------------------------------------ */
+
+int audio_fixture_synth_speech(int sample_rate, int duration_ms, audio_fixture_t *out)
+{
+    if (!out || sample_rate <= 0 || duration_ms <= 0) {
+        return -1;
+    }
+
+    int n = (int)((int64_t)sample_rate * duration_ms / 1000);
+    out->samples = calloc((size_t)n, sizeof(int16_t));
+    if (!out->samples) {
+        return -1;
+    }
+    out->num_samples = n;
+    out->sample_rate = sample_rate;
+
+    /* Fixed LCG seed so every run encodes the same signal */
+    uint32_t seed = 0x12345678u;
+    double phase = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        double t = (double)i / sample_rate;
+
+        /* 250 ms syllables, every 4th one silent (word gap) */
+        int syllable = (int)(t / 0.25);
+        double in_syl = fmod(t, 0.25) / 0.25;
+        double env = (syllable % 4 == 3) ? 0.0 : sin(M_PI * in_syl);
+
+        /* Pitch glides between 110 and 180 Hz */
+        double f0 = 145.0 + 35.0 * sin(2.0 * M_PI * 0.7 * t);
+        phase += 2.0 * M_PI * f0 / sample_rate;
+
+        /* Voiced part: decaying harmonics up to ~3.5 kHz */
+        double v = 0.0;
+        for (int h = 1; h * f0 < 3500.0; h++) {
+            v += sin(phase * h) / h;
+        }
+
+        /* Breath / fricative noise */
+        seed = seed * 1664525u + 1013904223u;
+        double noise = ((double)(seed >> 16) / 32768.0 - 1.0) * 0.05;
+
+        double s = (0.3 * v * env + noise) * 32767.0 * 0.5;
+        if (s > 32767.0) s = 32767.0;
+        if (s < -32768.0) s = -32768.0;
+        out->samples[i] = (int16_t)s;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Public: Labeled fixtures                                           */
+/* ------------------------------------------------------------------ */
+
+int audio_fixture_load_labels(const char *path, audio_label_t *labels, int max)
+{
+    if (!path || !labels || max <= 0) {
+        return -1;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+
+    int count = 0;
+    char line[256];
+    while (count < max && fgets(line, sizeof(line), f)) {
+        double start, end;
+        /* Point labels and spectral lines ("\t" prefixed) are skipped */
+        if (sscanf(line, "%lf %lf", &start, &end) != 2 || end <= start) {
+            continue;
+        }
+        labels[count].start_ms = (int)(start * 1000.0 + 0.5);
+        labels[count].end_ms = (int)(end * 1000.0 + 0.5);
+        count++;
+    }
+
+    fclose(f);
+    return count;
+}
+
+/* Last voiced instant of audio_fixture_synth_speech(): syllables are 250 ms,
+ * every 4th one silent */
+static int synth_speech_end_ms(int speech_ms)
+{
+    int syl = speech_ms / 250;
+    int rem = speech_ms % 250;
+
+    if (rem > 0 && syl % 4 != 3) {
+        return speech_ms;
+    }
+    while (syl > 0 && (syl - 1) % 4 == 3) {
+        syl--;
+    }
+    return syl * 250;
+}
+
+static void mix_speech(audio_fixture_t *out, int offset, int sample_rate, int ms, int pct)
+{
+    audio_fixture_t sp;
+    if (ms <= 0 || audio_fixture_synth_speech(sample_rate, ms, &sp) != 0) {
+        return;
+    }
+    for (int i = 0; i < sp.num_samples && offset + i < out->num_samples; i++) {
+        int v = out->samples[offset + i] + sp.samples[i] * pct / 100;
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        out->samples[offset + i] = (int16_t)v;
+    }
+    audio_fixture_free(&sp);
+}
+
+int audio_fixture_synth_turn(int sample_rate, const audio_turn_spec_t *spec,
+                             audio_fixture_t *out, audio_label_t *label)
+{
+    if (!spec || !out || !label || sample_rate <= 0 || spec->speech_ms <= 0) {
+        return -1;
+    }
+
+    int total_ms = spec->lead_ms + spec->speech_ms + spec->pause_ms +
+                   spec->speech2_ms + spec->trail_ms;
+    int n = (int)((int64_t)sample_rate * total_ms / 1000);
+    out->samples = calloc((size_t)n, sizeof(int16_t));
+    if (!out->samples) {
+        return -1;
+    }
+    out->num_samples = n;
+    out->sample_rate = sample_rate;
+
+    /* Background: uniform white noise (rms = A / sqrt(3)) + 100/200 Hz hum */
+    uint32_t seed = spec->seed ? spec->seed : 1u;
+    double white_amp = spec->white_rms * sqrt(3.0);
+    double hum_amp = spec->hum_rms * sqrt(2.0) / sqrt(1.25);
+    for (int i = 0; i < n; i++) {
+        double t = (double)i / sample_rate;
+        seed = seed * 1664525u + 1013904223u;
+        double w = ((double)(seed >> 16) / 32768.0 - 1.0) * white_amp;
+        double h = hum_amp * (sin(2.0 * M_PI * 100.0 * t) + 0.5 * sin(2.0 * M_PI * 200.0 * t));
+        out->samples[i] = (int16_t)(w + h);
+    }
+
+    int pct = spec->speech_pct > 0 ? spec->speech_pct : 100;
+    int seg1 = spec->lead_ms;
+    int seg2 = seg1 + spec->speech_ms + spec->pause_ms;
+
+    mix_speech(out, (int)((int64_t)sample_rate * seg1 / 1000), sample_rate, spec->speech_ms, pct);
+    mix_speech(out, (int)((int64_t)sample_rate * seg2 / 1000), sample_rate, spec->speech2_ms, pct);
+
+    label->start_ms = seg1;
+    label->end_ms = spec->speech2_ms > 0 ? seg2 + synth_speech_end_ms(spec->speech2_ms)
+                                         : seg1 + synth_speech_end_ms(spec->speech_ms);
+    return 0;
+}
+
+void audio_fixture_free(audio_fixture_t *fx)
+{
+    if (!fx) {
+        return;
+    }
+    free(fx->samples);
+    fx->samples = NULL;
+    fx->num_samples = 0;
+}
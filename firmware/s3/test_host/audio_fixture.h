@@ -0,0 +1,79 @@
+/**
+ * @file audio_fixture.h
+ * @brief Reference audio for host tests and benchmarks
+ *
+ * Loads 16-bit mono WAV files, or synthesizes a deterministic speech-like
+ * signal (voiced harmonics + syllable envelope + pauses) when no file is given.
+ *
+ * Labeled fixtures (VAD): a WAV plus an Audacity label export
+ * ("start<TAB>end<TAB>text" in seconds per line) marking speech regions,
+ * or a synthesized turn (noise, speech, optional pause, trailing noise)
+ * whose speech region is known exactly.
+ */
+
+#ifndef AUDIO_FIXTURE_H
+#define AUDIO_FIXTURE_H
+
+#include <stdint.h>
+
+typedef struct {
+    int16_t *samples;
+    int num_samples;
+    int sample_rate;
+} audio_fixture_t;
+
+/* Labeled region, in ms from the start of the fixture */
+typedef struct {
+    int start_ms;
+    int end_ms;
+} audio_label_t;
+
+/* Synthetic turn layout */
+typedef struct {
+    int lead_ms;            /* Background only before speech */
+    int speech_ms;          /* First speech segment */
+    int pause_ms;           /* Mid-turn pause (0 = none) */
+    int speech2_ms;         /* Second segment after the pause (0 = none) */
+    int trail_ms;           /* Background only after speech */
+    int speech_pct;         /* Speech level, % of audio_fixture_synth_speech() */
+    int white_rms;          /* Broadband background noise RMS */
+    int hum_rms;            /* Low-frequency (fan / mains) background RMS */
+    uint32_t seed;          /* Background noise seed */
+} audio_turn_spec_t;
+
+/**
+ * Load a PCM16 mono WAV file
+ * @return 0 on success, -1 on error (unsupported format / IO error)
+ */
+int audio_fixture_load_wav(const char *path, audio_fixture_t *out);
+
+/**
+ * Synthesize speech-like reference audio
+ * @param sample_rate Sample rate in Hz
+ * @param duration_ms Length in milliseconds
+ * @return 0 on success, -1 on allocation failure
+ */
+int audio_fixture_synth_speech(int sample_rate, int duration_ms, audio_fixture_t *out);
+
+/**
+ * Load an Audacity label file
+ * @param labels Output array
+ * @param max Capacity of labels
+ * @return Number of labels read, or -1 on error
+ */
+int audio_fixture_load_labels(const char *path, audio_label_t *labels, int max);
+
+/**
+ * Synthesize a labeled voice turn
+ * @param label Speech region (first speech onset to last speech offset)
+ * @return 0 on success, -1 on error
+ */
+int audio_fixture_synth_turn(int sample_rate, const audio_turn_spec_t *spec,
+                             audio_fixture_t *out, audio_label_t *label);
+
+/**
+ * Release fixture samples
+ */
+void audio_fixture_free(audio_fixture_t *fx);
+
+#endif /* AUDIO_FIXTURE_H */
@@ -0,0 +1,160 @@
+/**
+ * @file bench_audio_stats.c
+ * @brief Host benchmark for the per-frame audio statistics (audio_dsp.c)
+ *
+ * Usage: bench_audio_stats [reference.wav]
+ *
+ * Runs the previous voice_recorder_tick() loop (int64 accumulate + double
+ * sqrt), the portable kernel audio_dsp_stats_c() and the PIE path
+ * audio_dsp_stats() over the same 60 ms frames, checks that the results
+ * agree and reports ns per frame.
+ *
+ * Host timings are only relative - the gain on target is larger since the
+ * S3 has no double-precision FPU and no 64-bit multiply-accumulate. On the
+ * host the PIE row runs the C model of audio_dsp_aes3.S (AUDIO_DSP_PIE_MODEL):
+ * it checks the head/chunk/tail split, not the vector speed.
+ */
+
+#include "audio_dsp.h"
+#include "audio_fixture.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define SAMPLE_RATE     16000
+#define FRAME_SAMPLES   960
+#define SYNTH_MS        10000
+#define ROUNDS          200
+
+/* Keeps the compiler from dropping the loops */
+static volatile int g_sink;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* ------------------------------------------------------------------ */
+/* Legacy loop (button_voice.c before audio_dsp)                      */
+/* ------------------------------------------------------------------ */
+
+static void legacy_stats(const int16_t *samples, int sample_count,
+                         int *out_rms, int *out_peak, int *out_zeros)
+{
+    int64_t sum_sq = 0;
+    int16_t peak = 0;
+    int zero_count = 0;
+
+    for (int i = 0; i < sample_count; i++) {
+        int16_t s = samples[i];
+        if (s == 0) zero_count++;
+        if (s < 0) s = -s;  /* abs */
+        sum_sq += (int64_t)s * s;
+        if (s > peak) peak = s;
+    }
+
+    int rms = (int)(sum_sq / sample_count);
+    rms = (int)sqrt((double)rms);
+
+    *out_rms = rms;
+    *out_peak = peak;
+    *out_zeros = zero_count;
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    audio_fixture_t fx;
+
+    if (argc > 1) {
+        if (audio_fixture_load_wav(argv[1], &fx) != 0 || fx.sample_rate != SAMPLE_RATE) {
+            fprintf(stderr, "%s: need 16-bit mono %d Hz WAV\n", argv[1], SAMPLE_RATE);
+            return 1;
+        }
+        printf("Reference: %s (%.1f s)\n", argv[1], (double)fx.num_samples / SAMPLE_RATE);
+    } else {
+        if (audio_fixture_synth_speech(SAMPLE_RATE, SYNTH_MS, &fx) != 0) {
+            return 1;
+        }
+        printf("Reference: synthetic speech (%.1f s)\n", SYNTH_MS / 1000.0);
+    }
+
+    int frames = fx.num_samples / FRAME_SAMPLES;
+    if (frames == 0) {
+        fprintf(stderr, "reference shorter than one frame\n");
+        audio_fixture_free(&fx);
+        return 1;
+    }
+
+    /* Correctness: same rms / zeros; peak differs only on -32768 (legacy abs overflow) */
+    int mismatches = 0;
+    for (int f = 0; f < frames; f++) {
+        const int16_t *s = &fx.samples[f * FRAME_SAMPLES];
+        int rms, peak, zeros;
+        audio_stats_t st;
+
+        audio_stats_t pie;
+
+        legacy_stats(s, FRAME_SAMPLES, &rms, &peak, &zeros);
+        audio_dsp_stats_c(s, FRAME_SAMPLES, &st);
+        audio_dsp_stats(s + (f & 7), FRAME_SAMPLES - 8, &pie);
+        if (rms != st.rms || zeros != st.zero_count || (peak != st.peak && st.peak != 32768)) {
+            mismatches++;
+        }
+
+        /* PIE path vs C kernel, also from unaligned starts */
+        audio_stats_t c;
+        audio_dsp_stats_c(s + (f & 7), FRAME_SAMPLES - 8, &c);
+        if (pie.sum_sq != c.sum_sq || pie.peak != c.peak || pie.rms != c.rms ||
+            pie.zero_count != c.zero_count || pie.zero_crossings != c.zero_crossings) {
+            mismatches++;
+        }
+    }
+
+    /* Timing */
+    double legacy_us = now_us();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int f = 0; f < frames; f++) {
+            int rms, peak, zeros;
+            legacy_stats(&fx.samples[f * FRAME_SAMPLES], FRAME_SAMPLES, &rms, &peak, &zeros);
+            g_sink = rms + peak + zeros;
+        }
+    }
+    legacy_us = now_us() - legacy_us;
+
+    double dsp_us = now_us();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int f = 0; f < frames; f++) {
+            audio_stats_t st;
+            audio_dsp_stats_c(&fx.samples[f * FRAME_SAMPLES], FRAME_SAMPLES, &st);
+            g_sink = st.rms + st.peak + st.zero_count;
+        }
+    }
+    dsp_us = now_us() - dsp_us;
+
+    double pie_us = now_us();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int f = 0; f < frames; f++) {
+            audio_stats_t st;
+            audio_dsp_stats(&fx.samples[f * FRAME_SAMPLES], FRAME_SAMPLES, &st);
+            g_sink = st.rms + st.peak + st.zero_count;
+        }
+    }
+    pie_us = now_us() - pie_us;
+
+    long runs = (long)ROUNDS * frames;
+    printf("%d frames x %d rounds, %d samples/frame\n\n", frames, ROUNDS, FRAME_SAMPLES);
+    printf("impl       ns/frame  ns/sample\n");
+    printf("legacy     %8.1f  %9.3f\n", legacy_us * 1e3 / runs, legacy_us * 1e3 / runs / FRAME_SAMPLES);
+    printf("dsp C      %8.1f  %9.3f\n", dsp_us * 1e3 / runs, dsp_us * 1e3 / runs / FRAME_SAMPLES);
+    printf("dsp PIE    %8.1f  %9.3f\n", pie_us * 1e3 / runs, pie_us * 1e3 / runs / FRAME_SAMPLES);
+    printf("\nspeedup %.2fx, mismatched frames %d\n", legacy_us / dsp_us, mismatches);
+
+    audio_fixture_free(&fx);
+    return mismatches ? 1 : 0;
+}
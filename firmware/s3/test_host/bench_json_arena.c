@@ -0,0 +1,112 @@
+/**
+ * @file bench_json_arena.c
+ * @brief Host benchmark for cJSON parse + delete: heap vs json_arena.c
+ *
+ * Usage: bench_json_arena
+ *
+ * Parses and deletes the same documents with every node on the heap and
+ * inside a per-message arena, and reports ns per document, heap
+ * allocations per document and the arena high-water mark (the buffer size
+ * a call site needs).
+ *
+ * Host timings are only relative - desktop malloc is a thread cache hit,
+ * while on target each block is a heap_caps walk under a lock, and the
+ * short-lived blocks are what fragments internal RAM.
+ */
+
+#include "json_arena.h"
+#include "cJSON.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define ROUNDS          50000
+#define ARENA_SIZE      (16 * 1024)
+
+/* Keeps the compiler from dropping the loops */
+static volatile int g_sink;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* ------------------------------------------------------------------ */
+/* Fixtures                                                           */
+/* ------------------------------------------------------------------ */
+
+static char g_model[4096];
+
+/* Model description as the sscma client receives it: many small strings */
+static void build_model_doc(void)
+{
+    int n = snprintf(g_model, sizeof(g_model),
+                     "{\"uuid\":\"60086\",\"name\":\"Person Detection\",\"version\":\"1.0.0\","
+                     "\"category\":\"Object Detection\",\"model_type\":\"TFLite\",\"classes\":[");
+    for (int i = 0; i < 80 && n < (int)sizeof(g_model) - 32; i++) {
+        n += snprintf(g_model + n, sizeof(g_model) - n, "%s\"class_%02d\"", i ? "," : "", i);
+    }
+    snprintf(g_model + n, sizeof(g_model) - n, "]}");
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void)
+{
+    static uint8_t arena_buf[ARENA_SIZE];
+    json_arena_t arena;
+    struct {
+        const char *name;
+        const char *json;
+    } docs[] = {
+        { "announce", "{\"cmd\":\"ANNOUNCE\",\"ip\":\"192.168.1.10\",\"port\":8765,\"version\":\"2.1\"}" },
+        { "hello",    "{\"type\":\"hello\",\"code\":0,\"data\":{\"tts\":\"opus\",\"tts_rate\":24000,"
+                      "\"ctl\":\"tlv\",\"caps\":[\"asr\",\"tts\",\"vision\"]}}" },
+        { "model",    g_model },
+    };
+    const int n = (int)(sizeof(docs) / sizeof(docs[0]));
+
+    build_model_doc();
+    json_arena_install();
+    json_arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+    printf("%d rounds per document, arena %d KB\n\n", ROUNDS, ARENA_SIZE / 1024);
+    printf("doc        bytes  heap ns  arena ns  speedup  allocs  peak B\n");
+
+    for (int d = 0; d < n; d++) {
+        json_arena_stats_t st;
+
+        uint32_t heap_before = json_arena_heap_allocs();
+        double heap_us = now_us();
+        for (int r = 0; r < ROUNDS; r++) {
+            cJSON *root = cJSON_Parse(docs[d].json);
+            g_sink = root != NULL;
+            cJSON_Delete(root);
+        }
+        heap_us = now_us() - heap_us;
+        double allocs = (double)(json_arena_heap_allocs() - heap_before) / ROUNDS;
+
+        json_arena_init(&arena, arena_buf, sizeof(arena_buf));
+        double arena_us = now_us();
+        for (int r = 0; r < ROUNDS; r++) {
+            json_arena_begin(&arena);
+            cJSON *root = cJSON_Parse(docs[d].json);
+            g_sink = root != NULL;
+            cJSON_Delete(root);
+            json_arena_end(&arena);
+        }
+        arena_us = now_us() - arena_us;
+        json_arena_get_stats(&arena, &st);
+
+        printf("%-9s  %5d  %7.1f  %8.1f  %6.2fx  %6.1f  %6lu%s\n", docs[d].name,
+               (int)strlen(docs[d].json), heap_us * 1e3 / ROUNDS, arena_us * 1e3 / ROUNDS,
+               heap_us / arena_us, allocs, (unsigned long)st.peak,
+               st.spills ? " (spilled)" : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file bench_opus_encode.c
+ * @brief Host benchmark for the Opus uplink encoder (opus_codec.c)
+ *
+ * Usage: bench_opus_encode [reference.wav]
+ *
+ * Encodes the reference audio (16 kHz mono PCM16; synthetic speech when no
+ * file is given) and reports encode time per 60 ms frame and compression
+ * ratio against raw PCM for a few bitrate / complexity settings.
+ *
+ * Host timings are only relative - re-check on target with the
+ * voice_stats_t pcm_bytes / sent_bytes counters.
+ */
+
+#include "opus_codec.h"
+#include "audio_fixture.h"
+#include <stdio.h>
+#include <time.h>
+
+#define SAMPLE_RATE     16000
+#define FRAME_MS        60
+#define SYNTH_MS        10000
+
+typedef struct {
+    int bitrate;
+    int complexity;
+} bench_case_t;
+
+static const bench_case_t CASES[] = {
+    { 16000, 0 },
+    { 16000, 5 },
+    { 24000, 0 },
+    { 24000, 5 },
+    { 24000, 10 },
+    { 32000, 5 },
+};
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int run_case(const audio_fixture_t *fx, const bench_case_t *bc)
+{
+    opus_codec_enc_config_t cfg = {
+        .sample_rate = SAMPLE_RATE,
+        .frame_ms = FRAME_MS,
+        .bitrate = bc->bitrate,
+        .complexity = bc->complexity,
+    };
+    opus_codec_enc_t *enc = opus_codec_enc_create(&cfg);
+    if (!enc) {
+        fprintf(stderr, "encoder create failed (%d bps, c%d)\n", bc->bitrate, bc->complexity);
+        return -1;
+    }
+
+    int frame = opus_codec_enc_frame_samples(enc);
+    int frames = fx->num_samples / frame;
+    uint8_t pkt[OPUS_CODEC_MAX_PACKET];
+    long enc_bytes = 0;
+    double total_us = 0.0;
+    double max_us = 0.0;
+
+    for (int i = 0; i < frames; i++) {
+        double t0 = now_us();
+        int len = opus_codec_encode(enc, &fx->samples[i * frame], pkt, sizeof(pkt));
+        double dt = now_us() - t0;
+
+        if (len < 0) {
+            fprintf(stderr, "encode failed at frame %d\n", i);
+            opus_codec_enc_destroy(enc);
+            return -1;
+        }
+        enc_bytes += len;
+        total_us += dt;
+        if (dt > max_us) max_us = dt;
+    }
+    opus_codec_enc_destroy(enc);
+
+    long pcm_bytes = (long)frames * frame * 2;
+    double audio_s = (double)frames * FRAME_MS / 1000.0;
+
+    printf("%7d  %3d  %8.1f  %8.1f  %7.4f  %8ld  %7.1fx  %7.1f\n",
+           bc->bitrate, bc->complexity,
+           total_us / frames, max_us,
+           total_us / (frames * FRAME_MS * 1000.0),
+           enc_bytes, (double)pcm_bytes / enc_bytes,
+           enc_bytes * 8 / audio_s / 1000.0);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    audio_fixture_t fx;
+
+    if (argc > 1) {
+        if (audio_fixture_load_wav(argv[1], &fx) != 0 || fx.sample_rate != SAMPLE_RATE) {
+            fprintf(stderr, "%s: need 16-bit mono %d Hz WAV\n", argv[1], SAMPLE_RATE);
+            return 1;
+        }
+        printf("Reference: %s (%.1f s)\n", argv[1], (double)fx.num_samples / SAMPLE_RATE);
+    } else {
+        if (audio_fixture_synth_speech(SAMPLE_RATE, SYNTH_MS, &fx) != 0) {
+            return 1;
+        }
+        printf("Reference: synthetic speech (%.1f s)\n", SYNTH_MS / 1000.0);
+    }
+
+    printf("Opus VOIP, %d Hz mono, %d ms frames\n\n", SAMPLE_RATE, FRAME_MS);
+    printf("bitrate  cpx  us/frame    max_us      RTF     bytes    ratio     kbps\n");
+
+    int rc = 0;
+    for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+        if (run_case(&fx, &CASES[i]) != 0) {
+            rc = 1;
+        }
+    }
+
+    audio_fixture_free(&fx);
+    return rc;
+}
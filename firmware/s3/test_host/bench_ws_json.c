@@ -0,0 +1,258 @@
+/**
+ * @file bench_ws_json.c
+ * @brief Host benchmark for JSON message routing: cJSON DOM vs in-place tokens
+ *
+ * Usage: bench_ws_json
+ *
+ * Runs the previous ws_route_message() (cJSON_Parse + cJSON_GetObjectItem +
+ * strcmp chain on "type") and the current ws_json.c based router over the
+ * same mix of server messages, checks that the handlers see identical
+ * commands and reports ns per message and heap allocations per message.
+ *
+ * Host timings are only relative - on target every cJSON node is a
+ * malloc/free pair in internal RAM, which costs more than on a desktop libc.
+ */
+
+#include "ws_router.h"
+#include "cJSON.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+
+#define ROUNDS          100000
+
+/* Keeps the compiler from dropping the loops */
+static volatile int g_sink;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* ------------------------------------------------------------------ */
+/* Allocation counter (cJSON hooks)                                   */
+/* ------------------------------------------------------------------ */
+
+static long g_allocs;
+
+static void *count_malloc(size_t size)
+{
+    g_allocs++;
+    return malloc(size);
+}
+
+/* ------------------------------------------------------------------ */
+/* Handlers: checksum of everything delivered                         */
+/* ------------------------------------------------------------------ */
+
+static unsigned g_sum;
+
+static unsigned hash_str(const char *s)
+{
+    unsigned h = 5381;
+    while (*s) h = h * 33 + (unsigned char)*s++;
+    return h;
+}
+
+static void on_servo(const ws_servo_cmd_t *c) { g_sum += hash_str(c->id) + c->angle * 7 + c->time_ms; }
+static void on_display(const ws_display_cmd_t *c) { g_sum += hash_str(c->text) + hash_str(c->emoji) + c->size; }
+static void on_status(const ws_status_cmd_t *c) { g_sum += hash_str(c->data); }
+static void on_asr_result(const ws_asr_result_cmd_t *c) { g_sum += hash_str(c->text); }
+static void on_bot_reply(const ws_bot_reply_cmd_t *c) { g_sum += hash_str(c->text); }
+static void on_tts_end(void) { g_sum += 1; }
+static void on_pong(const ws_pong_cmd_t *c) { g_sum += c->seq; }
+
+/* ------------------------------------------------------------------ */
+/* Legacy router (ws_router.c before ws_json)                         */
+/* ------------------------------------------------------------------ */
+
+static const char *get_string(cJSON *obj, const char *key)
+{
+    cJSON *item = cJSON_GetObjectItem(obj, key);
+    return (item && cJSON_IsString(item)) ? item->valuestring : NULL;
+}
+
+static int get_int(cJSON *obj, const char *key, int default_val)
+{
+    cJSON *item = cJSON_GetObjectItem(obj, key);
+    return (item && cJSON_IsNumber(item)) ? item->valueint : default_val;
+}
+
+static void copy_string(char *dst, size_t dst_size, const char *src)
+{
+    if (src) {
+        strncpy(dst, src, dst_size - 1);
+        dst[dst_size - 1] = '\0';
+    } else {
+        dst[0] = '\0';
+    }
+}
+
+static ws_msg_type_t legacy_route(const char *json_str)
+{
+    cJSON *root = cJSON_Parse(json_str);
+    if (!root) {
+        return WS_MSG_UNKNOWN;
+    }
+    const char *type = get_string(root, "type");
+    if (!type) {
+        cJSON_Delete(root);
+        return WS_MSG_UNKNOWN;
+    }
+
+    ws_msg_type_t msg_type = WS_MSG_UNKNOWN;
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+
+    if (strcmp(type, "servo") == 0) {
+        msg_type = WS_MSG_SERVO;
+        if (data && cJSON_IsObject(data)) {
+            ws_servo_cmd_t cmd = {0};
+            copy_string(cmd.id, sizeof(cmd.id), get_string(data, "id"));
+            int angle1 = get_int(data, "angle", INT_MIN);
+            int angle2 = get_int(data, "Angle", INT_MIN);
+            cmd.angle = (angle1 != INT_MIN) ? angle1 : angle2;
+            if (cmd.angle == INT_MIN) cmd.angle = 90;
+            cmd.time_ms = get_int(data, "time", 100);
+            on_servo(&cmd);
+        }
+    } else if (strcmp(type, "display") == 0) {
+        msg_type = WS_MSG_DISPLAY;
+        if (data && cJSON_IsObject(data)) {
+            ws_display_cmd_t cmd = {0};
+            copy_string(cmd.text, sizeof(cmd.text), get_string(data, "text"));
+            copy_string(cmd.emoji, sizeof(cmd.emoji), get_string(data, "emoji"));
+            cmd.size = get_int(data, "size", 0);
+            on_display(&cmd);
+        }
+    } else if (strcmp(type, "status") == 0) {
+        ws_status_cmd_t cmd = {0};
+        msg_type = WS_MSG_STATUS;
+        copy_string(cmd.data, sizeof(cmd.data), get_string(root, "data"));
+        on_status(&cmd);
+    } else if (strcmp(type, "asr_result") == 0) {
+        ws_asr_result_cmd_t cmd = {0};
+        msg_type = WS_MSG_ASR_RESULT;
+        copy_string(cmd.text, sizeof(cmd.text), get_string(root, "data"));
+        on_asr_result(&cmd);
+    } else if (strcmp(type, "bot_reply") == 0) {
+        ws_bot_reply_cmd_t cmd = {0};
+        msg_type = WS_MSG_BOT_REPLY;
+        copy_string(cmd.text, sizeof(cmd.text), get_string(root, "data"));
+        on_bot_reply(&cmd);
+    } else if (strcmp(type, "tts_end") == 0) {
+        msg_type = WS_MSG_TTS_END;
+        on_tts_end();
+    } else if (strcmp(type, "error") == 0) {
+        msg_type = WS_MSG_ERROR_MSG;
+    } else if (strcmp(type, "hello") == 0) {
+        msg_type = WS_MSG_HELLO;
+    } else if (strcmp(type, "capture") == 0) {
+        msg_type = WS_MSG_CAPTURE;
+    } else if (strcmp(type, "reboot") == 0) {
+        msg_type = WS_MSG_REBOOT;
+    } else if (strcmp(type, "audio") == 0) {
+        msg_type = WS_MSG_AUDIO;
+    } else if (strcmp(type, "audio_end") == 0) {
+        msg_type = WS_MSG_AUDIO_END;
+    } else if (strcmp(type, "video") == 0) {
+        msg_type = WS_MSG_VIDEO;
+    } else if (strcmp(type, "sensor") == 0) {
+        msg_type = WS_MSG_SENSOR;
+    } else if (strcmp(type, "ping") == 0) {
+        msg_type = WS_MSG_PING;
+    } else if (strcmp(type, "pong") == 0) {
+        ws_pong_cmd_t cmd = {
+            .seq = (data && cJSON_IsObject(data)) ? (uint32_t)get_int(data, "seq", 0) : 0,
+        };
+        msg_type = WS_MSG_PONG;
+        on_pong(&cmd);
+    } else if (strcmp(type, "connected") == 0) {
+        msg_type = WS_MSG_CONNECTED;
+    }
+
+    cJSON_Delete(root);
+    return msg_type;
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void)
+{
+    /* One voice turn's worth of server traffic */
+    static const char *msgs[] = {
+        "{\"type\":\"status\",\"code\":0,\"data\":\"thinking\"}",
+        "{\"type\":\"asr_result\",\"code\":0,\"data\":\"\\u4eca\\u5929\\u5929\\u6c14\\u600e\\u4e48\\u6837\"}",
+        "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"x\",\"angle\":120,\"time\":300}}",
+        "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"y\",\"Angle\":60,\"time\":300}}",
+        "{\"type\":\"display\",\"code\":0,\"data\":{\"text\":\"Sunny, 24 degrees\",\"emoji\":\"happy\",\"size\":24}}",
+        "{\"type\":\"bot_reply\",\"code\":0,\"data\":\"It is sunny today with a light breeze, a good day for a walk.\"}",
+        "{\"type\":\"pong\",\"code\":0,\"data\":{\"seq\":42,\"t\":123456}}",
+        "{\"type\":\"tts_end\",\"code\":0,\"data\":\"ok\"}",
+    };
+    const int n = (int)(sizeof(msgs) / sizeof(msgs[0]));
+    ws_router_t router = {
+        .on_servo      = on_servo,
+        .on_display    = on_display,
+        .on_status     = on_status,
+        .on_asr_result = on_asr_result,
+        .on_bot_reply  = on_bot_reply,
+        .on_tts_end    = on_tts_end,
+        .on_pong       = on_pong,
+    };
+    cJSON_Hooks hooks = { .malloc_fn = count_malloc, .free_fn = free };
+    int mismatches = 0;
+
+    ws_router_init(&router);
+    cJSON_InitHooks(&hooks);
+
+    /* Correctness: same type and same delivered fields per message */
+    for (int i = 0; i < n; i++) {
+        g_sum = 0;
+        ws_msg_type_t lt = legacy_route(msgs[i]);
+        unsigned legacy_sum = g_sum;
+        g_sum = 0;
+        ws_msg_type_t nt = ws_route_message(msgs[i]);
+        if (lt != nt || legacy_sum != g_sum) {
+            printf("mismatch: %s\n", msgs[i]);
+            mismatches++;
+        }
+    }
+
+    /* Timing */
+    g_allocs = 0;
+    double legacy_us = now_us();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < n; i++) {
+            g_sink = legacy_route(msgs[i]);
+        }
+    }
+    legacy_us = now_us() - legacy_us;
+    long legacy_allocs = g_allocs;
+
+    g_allocs = 0;
+    double tok_us = now_us();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < n; i++) {
+            g_sink = ws_route_message(msgs[i]);
+        }
+    }
+    tok_us = now_us() - tok_us;
+    long tok_allocs = g_allocs;
+
+    long runs = (long)ROUNDS * n;
+    printf("%d messages x %d rounds\n\n", n, ROUNDS);
+    printf("impl       ns/msg  msg/s      allocs/msg\n");
+    printf("cJSON    %8.1f  %9.0f  %10.1f\n", legacy_us * 1e3 / runs, runs / legacy_us * 1e6,
+           (double)legacy_allocs / runs);
+    printf("ws_json  %8.1f  %9.0f  %10.1f\n", tok_us * 1e3 / runs, runs / tok_us * 1e6,
+           (double)tok_allocs / runs);
+    printf("\nspeedup %.2fx, mismatched messages %d\n", legacy_us / tok_us, mismatches);
+
+    return mismatches ? 1 : 0;
+}
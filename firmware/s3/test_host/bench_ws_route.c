@@ -0,0 +1,150 @@
+/**
+ * @file bench_ws_route.c
+ * @brief Host benchmark for JSON vs TLV control message routing (ws_router.c)
+ *
+ * Usage: bench_ws_route
+ *
+ * Encodes the same servo / display / status commands both as JSON text and
+ * as TLV control frames, routes them through ws_route_message() and
+ * ws_route_binary(), checks that the handlers see identical commands and
+ * reports ns and bytes per message.
+ *
+ * Host timings are only relative - on target the JSON path also pays for
+ * the cJSON heap allocations, which the TLV path does not make at all.
+ */
+
+#include "ws_router.h"
+#include "ws_tlv.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define ROUNDS          200000
+
+/* Keeps the compiler from dropping the loops */
+static volatile int g_sink;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* ------------------------------------------------------------------ */
+/* Handlers: keep the last command for the comparison                 */
+/* ------------------------------------------------------------------ */
+
+static ws_servo_cmd_t g_servo;
+static ws_display_cmd_t g_display;
+static ws_status_cmd_t g_status;
+
+static void on_servo(const ws_servo_cmd_t *cmd) { g_servo = *cmd; g_sink = cmd->angle; }
+static void on_display(const ws_display_cmd_t *cmd) { g_display = *cmd; g_sink = cmd->size; }
+static void on_status(const ws_status_cmd_t *cmd) { g_status = *cmd; g_sink = cmd->data[0]; }
+
+/* ------------------------------------------------------------------ */
+/* Fixtures                                                           */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const char *name;
+    const char *json;
+    uint8_t tlv[128];
+    int tlv_len;
+} bench_msg_t;
+
+static void encode_tlv(bench_msg_t *m, int which)
+{
+    ws_tlv_writer_t w;
+
+    ws_tlv_writer_init(&w, m->tlv, sizeof(m->tlv));
+    switch (which) {
+        case 0:
+            ws_tlv_msg_begin(&w, WS_TLV_SERVO);
+            ws_tlv_put_str(&w, WS_TLV_F_ID, "x");
+            ws_tlv_put_int(&w, WS_TLV_F_ANGLE, 120);
+            ws_tlv_put_int(&w, WS_TLV_F_TIME, 300);
+            break;
+        case 1:
+            ws_tlv_msg_begin(&w, WS_TLV_DISPLAY);
+            ws_tlv_put_str(&w, WS_TLV_F_TEXT, "Hello, nice to meet you");
+            ws_tlv_put_str(&w, WS_TLV_F_EMOJI, "happy");
+            ws_tlv_put_int(&w, WS_TLV_F_SIZE, 24);
+            break;
+        default:
+            ws_tlv_msg_begin(&w, WS_TLV_STATUS);
+            ws_tlv_put_str(&w, WS_TLV_F_TEXT, "thinking");
+            break;
+    }
+    ws_tlv_msg_end(&w);
+    m->tlv_len = ws_tlv_writer_finish(&w);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void)
+{
+    bench_msg_t msgs[] = {
+        { "servo",   "{\"type\":\"servo\",\"data\":{\"id\":\"x\",\"angle\":120,\"time\":300}}" },
+        { "display", "{\"type\":\"display\",\"data\":{\"text\":\"Hello, nice to meet you\","
+                     "\"emoji\":\"happy\",\"size\":24}}" },
+        { "status",  "{\"type\":\"status\",\"data\":\"thinking\"}" },
+    };
+    const int n = (int)(sizeof(msgs) / sizeof(msgs[0]));
+    ws_router_t router = {
+        .on_servo   = on_servo,
+        .on_display = on_display,
+        .on_status  = on_status,
+    };
+    int mismatches = 0;
+
+    ws_router_init(&router);
+
+    printf("%d rounds per message\n\n", ROUNDS);
+    printf("msg       json B  tlv B   json ns   tlv ns  speedup\n");
+
+    for (int i = 0; i < n; i++) {
+        bench_msg_t *m = &msgs[i];
+        ws_servo_cmd_t servo;
+        ws_display_cmd_t display;
+        ws_status_cmd_t status;
+
+        encode_tlv(m, i);
+
+        /* Correctness: both encodings deliver the same command */
+        ws_msg_type_t jt = ws_route_message(m->json);
+        servo = g_servo;
+        display = g_display;
+        status = g_status;
+        ws_msg_type_t tt = ws_route_binary(m->tlv, m->tlv_len);
+        if (jt != tt || jt == WS_MSG_UNKNOWN ||
+            memcmp(&servo, &g_servo, sizeof(servo)) != 0 ||
+            memcmp(&display, &g_display, sizeof(display)) != 0 ||
+            memcmp(&status, &g_status, sizeof(status)) != 0) {
+            mismatches++;
+        }
+
+        /* Timing */
+        double json_us = now_us();
+        for (int r = 0; r < ROUNDS; r++) {
+            ws_route_message(m->json);
+        }
+        json_us = now_us() - json_us;
+
+        double tlv_us = now_us();
+        for (int r = 0; r < ROUNDS; r++) {
+            ws_route_binary(m->tlv, m->tlv_len);
+        }
+        tlv_us = now_us() - tlv_us;
+
+        printf("%-8s  %6d  %5d  %8.1f  %7.1f  %6.1fx\n", m->name,
+               (int)strlen(m->json), m->tlv_len,
+               json_us * 1e3 / ROUNDS, tlv_us * 1e3 / ROUNDS, json_us / tlv_us);
+    }
+
+    printf("\nmismatched messages %d\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file esp_log.h
+ * @brief Host stub: ESP-IDF logging compiled out
+ */
+
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#define ESP_LOGE(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGW(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGD(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGV(tag, fmt, ...) ((void)(tag))
+
+#endif /* ESP_LOG_H */
@@ -0,0 +1,25 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stub: FreeRTOS base types
+ *
+ * Host tests are single threaded. Task creation fails (modules take their
+ * inline fallback), mutexes always succeed, waits return at once.
+ */
+
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+
+#endif /* FREERTOS_H */
@@ -0,0 +1,33 @@
+/**
+ * @file queue.h
+ * @brief Host stub: FreeRTOS queues (see FreeRTOS.h)
+ *
+ * Queue creation fails, so nothing is ever queued or received.
+ */
+
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *QueueHandle_t;
+
+static inline QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    (void)len; (void)item_size;
+    return 0;
+}
+
+static inline BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    (void)q; (void)item; (void)ticks;
+    return pdFAIL;
+}
+
+static inline BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    (void)q; (void)item; (void)ticks;
+    return pdFALSE;
+}
+
+#endif /* QUEUE_H */
@@ -0,0 +1,27 @@
+/**
+ * @file semphr.h
+ * @brief Host stub: FreeRTOS mutexes (see FreeRTOS.h)
+ */
+
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    static int mutex;
+    return &mutex;
+}
+
+static inline void vSemaphoreDelete(SemaphoreHandle_t sem) { (void)sem; }
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    (void)sem; (void)ticks;
+    return pdTRUE;
+}
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) { (void)sem; return pdTRUE; }
+
+#endif /* SEMPHR_H */
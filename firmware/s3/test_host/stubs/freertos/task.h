@@ -0,0 +1,37 @@
+/**
+ * @file task.h
+ * @brief Host stub: FreeRTOS tasks (see FreeRTOS.h)
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+static inline BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack,
+                                     void *arg, UBaseType_t prio, TaskHandle_t *handle)
+{
+    (void)fn; (void)name; (void)stack; (void)arg; (void)prio;
+    if (handle) {
+        *handle = 0;
+    }
+    return pdFAIL;
+}
+
+static inline void vTaskDelete(TaskHandle_t task) { (void)task; }
+static inline void vTaskDelay(TickType_t ticks) { (void)ticks; }
+static inline TickType_t xTaskGetTickCount(void) { return 0; }
+static inline void vTaskDelayUntil(TickType_t *last, TickType_t period) { *last += period; }
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task) { (void)task; return pdPASS; }
+static inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    (void)clear; (void)ticks;
+    return 0;
+}
+
+#define taskYIELD()     ((void)0)
+
+#endif /* TASK_H */
@@ -0,0 +1,215 @@
+#include "unity.h"
+#include "audio_dsp.h"
+#include "audio_fixture.h"
+#include <math.h>
+#include <stdlib.h>
+
+/* Uplink capture frame: 60ms @ 16kHz */
+#define FRAME_SAMPLES   960
+
+/* ------------------------------------------------------------------ */
+/* Reference: straightforward 64-bit / double implementation          */
+/* ------------------------------------------------------------------ */
+
+static void ref_stats(const int16_t *s, int n, audio_stats_t *out)
+{
+    uint64_t sum_sq = 0;
+    int peak = 0;
+    int zeros = 0;
+    int crossings = 0;
+
+    for (int i = 0; i < n; i++) {
+        int x = s[i];
+        if (i > 0 && ((s[i - 1] < 0) != (x < 0))) crossings++;
+        int a = x < 0 ? -x : x;
+        sum_sq += (uint64_t)((int64_t)x * x);
+        if (a > peak) peak = a;
+        if (x == 0) zeros++;
+    }
+    out->sum_sq = sum_sq;
+    out->peak = peak;
+    out->zero_count = zeros;
+    out->zero_crossings = crossings;
+    out->rms = n > 0 ? (int)floor(sqrt((double)(sum_sq / (uint64_t)n))) : 0;
+}
+
+static void assert_matches_ref(const int16_t *s, int n)
+{
+    audio_stats_t got, ref;
+
+    ref_stats(s, n, &ref);
+
+    /* Dispatching entry (PIE path, host C model) and the C kernel */
+    for (int k = 0; k < 2; k++) {
+        if (k == 0) {
+            audio_dsp_stats(s, n, &got);
+        } else {
+            audio_dsp_stats_c(s, n, &got);
+        }
+        TEST_ASSERT_TRUE(got.sum_sq == ref.sum_sq);
+        TEST_ASSERT_EQUAL_INT(ref.peak, got.peak);
+        TEST_ASSERT_EQUAL_INT(ref.zero_count, got.zero_count);
+        TEST_ASSERT_EQUAL_INT(ref.zero_crossings, got.zero_crossings);
+        TEST_ASSERT_EQUAL_INT(ref.rms, got.rms);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Integer Square Root                                          */
+/* ------------------------------------------------------------------ */
+
+void test_isqrt_small_values(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, audio_dsp_isqrt(0));
+    TEST_ASSERT_EQUAL_UINT32(1, audio_dsp_isqrt(1));
+    TEST_ASSERT_EQUAL_UINT32(1, audio_dsp_isqrt(3));
+    TEST_ASSERT_EQUAL_UINT32(2, audio_dsp_isqrt(4));
+    TEST_ASSERT_EQUAL_UINT32(9, audio_dsp_isqrt(99));
+    TEST_ASSERT_EQUAL_UINT32(10, audio_dsp_isqrt(100));
+}
+
+void test_isqrt_matches_floor_sqrt(void) {
+    /* Perfect squares and their neighbours across the PCM16 range */
+    for (uint32_t r = 1; r <= 32768; r += 7) {
+        uint32_t sq = r * r;
+        TEST_ASSERT_EQUAL_UINT32(r, audio_dsp_isqrt(sq));
+        TEST_ASSERT_EQUAL_UINT32(r - 1, audio_dsp_isqrt(sq - 1));
+        TEST_ASSERT_EQUAL_UINT32(r, audio_dsp_isqrt(sq + 1));
+    }
+    TEST_ASSERT_EQUAL_UINT32(65535, audio_dsp_isqrt(0xFFFFFFFFu));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Frame Statistics                                             */
+/* ------------------------------------------------------------------ */
+
+void test_stats_empty_and_null(void) {
+    audio_stats_t st;
+
+    audio_dsp_stats(NULL, 0, &st);
+    TEST_ASSERT_TRUE(st.sum_sq == 0);
+    TEST_ASSERT_EQUAL_INT(0, st.peak);
+    TEST_ASSERT_EQUAL_INT(0, st.zero_count);
+    TEST_ASSERT_EQUAL_INT(0, st.rms);
+
+    audio_dsp_stats(NULL, 10, NULL);  /* must not crash */
+}
+
+void test_stats_silence(void) {
+    int16_t frame[FRAME_SAMPLES] = {0};
+    audio_stats_t st;
+
+    audio_dsp_stats(frame, FRAME_SAMPLES, &st);
+    TEST_ASSERT_EQUAL_INT(FRAME_SAMPLES, st.zero_count);
+    TEST_ASSERT_EQUAL_INT(0, st.peak);
+    TEST_ASSERT_EQUAL_INT(0, st.rms);
+}
+
+void test_stats_full_scale_negative(void) {
+    /* -32768 everywhere: worst case for accumulator width and abs() */
+    static int16_t frame[FRAME_SAMPLES];
+    audio_stats_t st;
+
+    for (int i = 0; i < FRAME_SAMPLES; i++) {
+        frame[i] = -32768;
+    }
+    audio_dsp_stats(frame, FRAME_SAMPLES, &st);
+
+    TEST_ASSERT_TRUE(st.sum_sq == (uint64_t)FRAME_SAMPLES * 32768u * 32768u);
+    TEST_ASSERT_EQUAL_INT(32768, st.peak);
+    TEST_ASSERT_EQUAL_INT(32768, st.rms);
+}
+
+void test_stats_zero_crossings_alternating(void) {
+    int16_t frame[8] = {100, -100, 100, -100, 0, -1, 0, 5};
+    audio_stats_t st;
+
+    /* 0 counts as positive: crossings at 1,2,3,4(-100->0),5,6 */
+    audio_dsp_stats(frame, 8, &st);
+    TEST_ASSERT_EQUAL_INT(6, st.zero_crossings);
+}
+
+void test_stats_odd_lengths_use_tail(void) {
+    int16_t frame[7] = {0, -5, 3, 0, 100, -200, 0};
+
+    for (int n = 1; n <= 7; n++) {
+        assert_matches_ref(frame, n);
+    }
+}
+
+void test_stats_random_frames_match_reference(void) {
+    int16_t frame[FRAME_SAMPLES];
+    uint32_t seed = 0xC0FFEEu;
+
+    for (int iter = 0; iter < 200; iter++) {
+        for (int i = 0; i < FRAME_SAMPLES; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            /* Mix of loud, quiet and exact-zero samples */
+            int16_t v = (int16_t)(seed >> 16);
+            frame[i] = (iter % 3 == 0) ? (int16_t)(v >> 8) : v;
+            if ((seed & 0xF) == 0) frame[i] = 0;
+        }
+        assert_matches_ref(frame, FRAME_SAMPLES);
+    }
+}
+
+void test_stats_unaligned_and_chunked(void) {
+    /* Every start alignment (scalar head), lengths across the 8-lane body,
+     * the 256-sample ACCX chunk and the tail; full scale for the widest sums */
+    static int16_t buf[FRAME_SAMPLES + 16] __attribute__((aligned(16)));
+    uint32_t seed = 0x5EEDu;
+
+    for (int i = 0; i < FRAME_SAMPLES + 16; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        buf[i] = (seed & 0x100) ? -32768 : (int16_t)(seed >> 16);
+    }
+    for (int off = 0; off < 8; off++) {
+        const int lens[] = {1, 7, 8, 9, 15, 16, 255, 256, 257, 263, 512, 769, FRAME_SAMPLES};
+        for (unsigned k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+            assert_matches_ref(&buf[off], lens[k]);
+        }
+    }
+}
+
+void test_stats_speech_fixture_matches_reference(void) {
+    audio_fixture_t fx;
+    TEST_ASSERT_EQUAL_INT(0, audio_fixture_synth_speech(16000, 3000, &fx));
+
+    for (int off = 0; off + FRAME_SAMPLES <= fx.num_samples; off += FRAME_SAMPLES) {
+        assert_matches_ref(&fx.samples[off], FRAME_SAMPLES);
+    }
+    audio_fixture_free(&fx);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Integer square root */
+    RUN_TEST(test_isqrt_small_values);
+    RUN_TEST(test_isqrt_matches_floor_sqrt);
+
+    /* Frame statistics */
+    RUN_TEST(test_stats_empty_and_null);
+    RUN_TEST(test_stats_silence);
+    RUN_TEST(test_stats_full_scale_negative);
+    RUN_TEST(test_stats_zero_crossings_alternating);
+    RUN_TEST(test_stats_odd_lengths_use_tail);
+    RUN_TEST(test_stats_random_frames_match_reference);
+    RUN_TEST(test_stats_unaligned_and_chunked);
+    RUN_TEST(test_stats_speech_fixture_matches_reference);
+
+    return UNITY_END();
+}
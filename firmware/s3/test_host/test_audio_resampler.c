@@ -0,0 +1,346 @@
+#include "unity.h"
+#include "audio_resampler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TONE_AMPLITUDE  10000.0
+#define TONE_SECONDS    1
+#define WARMUP_SAMPLES  256     /* Skip filter delay / start-up transient */
+#define CHUNK_SAMPLES   160     /* Arbitrary feed size (10ms @ 16kHz) */
+#define MAX_RATE        48000
+
+static int16_t g_in[MAX_RATE * TONE_SECONDS];
+static int16_t g_out[MAX_RATE * TONE_SECONDS * 3 + 16];
+static audio_resampler_t g_rs;
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static int make_tone(int16_t *buf, uint32_t rate, double freq, int n)
+{
+    for (int i = 0; i < n; i++) {
+        buf[i] = (int16_t)lrint(TONE_AMPLITUDE * sin(2.0 * M_PI * freq * i / rate));
+    }
+    return n;
+}
+
+/* Feed in fixed chunks, as the HAL does */
+static int run_chunked(audio_resampler_t *rs, const int16_t *in, int n_in,
+                       int16_t *out, int max_out, int chunk)
+{
+    int total = 0;
+
+    for (int i = 0; i < n_in; i += chunk) {
+        int n = (n_in - i < chunk) ? n_in - i : chunk;
+        int got = audio_resampler_process(rs, in + i, n, out + total, max_out - total);
+        TEST_ASSERT_TRUE(got >= 0);
+        total += got;
+    }
+    return total;
+}
+
+/* Amplitude of one frequency component (projection onto sin/cos) */
+static double tone_amplitude(const int16_t *buf, int n, uint32_t rate, double freq)
+{
+    double re = 0.0, im = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        double w = 2.0 * M_PI * freq * i / rate;
+        re += buf[i] * cos(w);
+        im += buf[i] * sin(w);
+    }
+    return 2.0 * sqrt(re * re + im * im) / n;
+}
+
+static double rms(const int16_t *buf, int n)
+{
+    double sum = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        sum += (double)buf[i] * buf[i];
+    }
+    return sqrt(sum / n);
+}
+
+/* Gain in dB of a tone through in_rate -> out_rate (component at out_freq) */
+static double tone_gain_db(uint32_t in_rate, uint32_t out_rate, double in_freq, double out_freq)
+{
+    int n_in = make_tone(g_in, in_rate, in_freq, (int)in_rate * TONE_SECONDS);
+
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, in_rate, out_rate));
+    int n_out = run_chunked(&g_rs, g_in, n_in, g_out, (int)(sizeof(g_out) / sizeof(g_out[0])),
+                            CHUNK_SAMPLES);
+
+    double amp = tone_amplitude(g_out + WARMUP_SAMPLES, n_out - WARMUP_SAMPLES, out_rate, out_freq);
+    return 20.0 * log10(amp / TONE_AMPLITUDE + 1e-12);
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_args(void) {
+    TEST_ASSERT_EQUAL_INT(-1, audio_resampler_init(NULL, 24000, 16000));
+    TEST_ASSERT_EQUAL_INT(-1, audio_resampler_init(&g_rs, 0, 16000));
+    TEST_ASSERT_EQUAL_INT(-1, audio_resampler_init(&g_rs, 24000, 0));
+    /* 44.1k <-> 16k reduces to 160/441: too many branches */
+    TEST_ASSERT_EQUAL_INT(-1, audio_resampler_init(&g_rs, 44100, 16000));
+}
+
+void test_init_reduces_ratio(void) {
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 24000, 16000));
+    TEST_ASSERT_EQUAL_INT(2, g_rs.up);
+    TEST_ASSERT_EQUAL_INT(3, g_rs.down);
+
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 16000, 24000));
+    TEST_ASSERT_EQUAL_INT(3, g_rs.up);
+    TEST_ASSERT_EQUAL_INT(2, g_rs.down);
+
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 48000, 16000));
+    TEST_ASSERT_EQUAL_INT(1, g_rs.up);
+    TEST_ASSERT_EQUAL_INT(3, g_rs.down);
+}
+
+void test_same_rate_is_copy(void) {
+    int16_t in[64];
+    int16_t out[64];
+
+    for (int i = 0; i < 64; i++) {
+        in[i] = (int16_t)(i * 517 - 16000);
+    }
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 24000, 24000));
+    TEST_ASSERT_EQUAL_INT(64, audio_resampler_process(&g_rs, in, 64, out, 64));
+    TEST_ASSERT_EQUAL_INT16_ARRAY(in, out, 64);
+}
+
+void test_process_rejects_small_output(void) {
+    int16_t in[30] = {0};
+    int16_t out[64];
+
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 16000, 24000));
+    TEST_ASSERT_EQUAL_INT(45, audio_resampler_output_len(&g_rs, 30));
+    TEST_ASSERT_EQUAL_INT(-1, audio_resampler_process(&g_rs, in, 30, out, 44));
+    TEST_ASSERT_EQUAL_INT(45, audio_resampler_process(&g_rs, in, 30, out, 45));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Streaming                                                    */
+/* ------------------------------------------------------------------ */
+
+void test_output_len_is_exact(void) {
+    static const uint32_t rates[][2] = {
+        {24000, 16000}, {16000, 24000}, {48000, 16000}, {16000, 48000}, {24000, 48000},
+    };
+    unsigned int seed = 7;
+
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, rates[r][0], rates[r][1]));
+        int total_in = 0;
+        int total_out = 0;
+
+        for (int k = 0; k < 200; k++) {
+            int n = 1 + rand_r(&seed) % 97;
+            int expect = audio_resampler_output_len(&g_rs, n);
+            int got = audio_resampler_process(&g_rs, g_in, n, g_out, expect);
+            TEST_ASSERT_EQUAL_INT(expect, got);
+            total_in += n;
+            total_out += got;
+        }
+        /* Over the whole stream the ratio is exact */
+        TEST_ASSERT_EQUAL_INT((int)((int64_t)total_in * rates[r][1] / rates[r][0]) +
+                              ((int64_t)total_in * rates[r][1] % rates[r][0] ? 1 : 0),
+                              total_out);
+    }
+}
+
+void test_input_len_exact_for_decimation(void) {
+    /* Capture path: codec 24kHz -> 60ms frames of 960 samples @ 16kHz */
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 24000, 16000));
+    int total_in = 0;
+
+    for (int frame = 0; frame < 50; frame++) {
+        int n_in = audio_resampler_input_len(&g_rs, 960);
+        TEST_ASSERT_EQUAL_INT(960, audio_resampler_output_len(&g_rs, n_in));
+        TEST_ASSERT_EQUAL_INT(960, audio_resampler_process(&g_rs, g_in, n_in, g_out, 960));
+        total_in += n_in;
+    }
+    /* 1.5 inputs per output; the final input is not needed yet */
+    TEST_ASSERT_INT_WITHIN(1, 1440 * 50, total_in);
+}
+
+void test_chunked_matches_one_shot(void) {
+    static int16_t one_shot[MAX_RATE];
+    int n_in = make_tone(g_in, 16000, 1234.0, 16000);
+
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 16000, 24000));
+    int n_ref = audio_resampler_process(&g_rs, g_in, n_in, one_shot, MAX_RATE);
+
+    audio_resampler_reset(&g_rs);
+    int n_out = run_chunked(&g_rs, g_in, n_in, g_out, MAX_RATE, 37);
+
+    TEST_ASSERT_EQUAL_INT(n_ref, n_out);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(one_shot, g_out, n_out);
+}
+
+void test_dc_gain_is_unity_on_every_branch(void) {
+    for (int i = 0; i < 4800; i++) {
+        g_in[i] = 10000;
+    }
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 16000, 48000));
+    int n_out = audio_resampler_process(&g_rs, g_in, 4800, g_out, MAX_RATE);
+
+    for (int i = WARMUP_SAMPLES; i < n_out; i++) {
+        TEST_ASSERT_INT_WITHIN(2, 10000, g_out[i]);
+    }
+}
+
+void test_full_scale_saturates_without_wrap(void) {
+    /* 50 Hz full-scale square wave (240-sample halves): overshoot must clip, not wrap */
+    for (int i = 0; i < 24000; i++) {
+        g_in[i] = ((i / 240) % 2) ? -32768 : 32767;
+    }
+    TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 24000, 16000));
+    int n_out = audio_resampler_process(&g_rs, g_in, 24000, g_out, MAX_RATE);
+
+    /* Away from the edges (filter delay is ~24 input samples) each half keeps its sign */
+    for (int i = WARMUP_SAMPLES; i < n_out; i++) {
+        int t = i * 3 / 2;
+        if (t % 240 < 80 || t % 240 > 200) {
+            continue;
+        }
+        if ((t / 240) % 2) {
+            TEST_ASSERT_TRUE(g_out[i] < -30000);
+        } else {
+            TEST_ASSERT_TRUE(g_out[i] > 30000);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Frequency Response                                           */
+/* ------------------------------------------------------------------ */
+
+static const double k_passband[] = {100.0, 300.0, 1000.0, 3000.0, 5000.0, 6500.0};
+
+void test_decimate_24k_16k_passband_flat(void) {
+    for (size_t i = 0; i < sizeof(k_passband) / sizeof(k_passband[0]); i++) {
+        double db = tone_gain_db(24000, 16000, k_passband[i], k_passband[i]);
+        printf("  24k->16k %6.0f Hz: %+.3f dB\n", k_passband[i], db);
+        TEST_ASSERT_TRUE(fabs(db) < 0.1);
+    }
+}
+
+void test_decimate_24k_16k_alias_rejection(void) {
+    /* Above the 8kHz output Nyquist: whatever comes out is alias */
+    static const double freqs[] = {9500.0, 10000.0, 11000.0};
+
+    for (size_t i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++) {
+        int n_in = make_tone(g_in, 24000, freqs[i], 24000);
+        TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, 24000, 16000));
+        int n_out = audio_resampler_process(&g_rs, g_in, n_in, g_out, MAX_RATE);
+        double level = rms(g_out + WARMUP_SAMPLES, n_out - WARMUP_SAMPLES) * sqrt(2.0);
+        double db = 20.0 * log10(level / TONE_AMPLITUDE + 1e-12);
+        printf("  24k->16k %6.0f Hz alias: %+.1f dB\n", freqs[i], db);
+        TEST_ASSERT_TRUE(db < -60.0);
+    }
+}
+
+void test_interpolate_16k_24k_passband_flat(void) {
+    for (size_t i = 0; i < sizeof(k_passband) / sizeof(k_passband[0]); i++) {
+        double db = tone_gain_db(16000, 24000, k_passband[i], k_passband[i]);
+        printf("  16k->24k %6.0f Hz: %+.3f dB\n", k_passband[i], db);
+        TEST_ASSERT_TRUE(fabs(db) < 0.1);
+    }
+}
+
+void test_interpolate_16k_24k_image_rejection(void) {
+    /* Zero-stuffing mirrors f to 16k - f */
+    static const double freqs[] = {1000.0, 3000.0, 6500.0};
+
+    for (size_t i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++) {
+        double db = tone_gain_db(16000, 24000, freqs[i], 16000.0 - freqs[i]);
+        printf("  16k->24k %6.0f Hz image @ %.0f Hz: %+.1f dB\n",
+               freqs[i], 16000.0 - freqs[i], db);
+        TEST_ASSERT_TRUE(db < -60.0);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: CPU Cost                                                     */
+/* ------------------------------------------------------------------ */
+
+void test_cpu_cost_per_second_of_audio(void) {
+    static const uint32_t rates[][2] = {
+        {24000, 16000}, {16000, 24000}, {48000, 16000}, {24000, 48000},
+    };
+    const int seconds = 10;
+
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        uint32_t in_rate = rates[r][0];
+        uint32_t out_rate = rates[r][1];
+        int n_in = make_tone(g_in, in_rate, 997.0, (int)in_rate);
+
+        TEST_ASSERT_EQUAL_INT(0, audio_resampler_init(&g_rs, in_rate, out_rate));
+        double t0 = now_us();
+        for (int s = 0; s < seconds; s++) {
+            run_chunked(&g_rs, g_in, n_in, g_out, (int)(sizeof(g_out) / sizeof(g_out[0])),
+                        (int)in_rate / 50);
+        }
+        double us_per_sec = (now_us() - t0) / seconds;
+
+        printf("  %5lu -> %5lu Hz: %7.1f us per second of audio (%lu MAC/s)\n",
+               (unsigned long)in_rate, (unsigned long)out_rate, us_per_sec,
+               (unsigned long)out_rate * AUDIO_RESAMPLER_TAPS);
+        /* Generous bound: a host core must stay far below real time */
+        TEST_ASSERT_TRUE(us_per_sec < 50000.0);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_invalid_args);
+    RUN_TEST(test_init_reduces_ratio);
+    RUN_TEST(test_same_rate_is_copy);
+    RUN_TEST(test_process_rejects_small_output);
+
+    /* Streaming */
+    RUN_TEST(test_output_len_is_exact);
+    RUN_TEST(test_input_len_exact_for_decimation);
+    RUN_TEST(test_chunked_matches_one_shot);
+    RUN_TEST(test_dc_gain_is_unity_on_every_branch);
+    RUN_TEST(test_full_scale_saturates_without_wrap);
+
+    /* Frequency response */
+    RUN_TEST(test_decimate_24k_16k_passband_flat);
+    RUN_TEST(test_decimate_24k_16k_alias_rejection);
+    RUN_TEST(test_interpolate_16k_24k_passband_flat);
+    RUN_TEST(test_interpolate_16k_24k_image_rejection);
+
+    /* CPU cost */
+    RUN_TEST(test_cpu_cost_per_second_of_audio);
+
+    return UNITY_END();
+}
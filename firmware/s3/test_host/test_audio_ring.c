@@ -0,0 +1,285 @@
+#include "unity.h"
+#include "audio_ring.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Same shape as the firmware uplink ring: 60ms PCM frames */
+#define FRAME_SIZE      1920
+#define FRAME_COUNT     8
+
+static uint8_t *g_storage = NULL;
+static audio_ring_t g_ring;
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    g_storage = malloc(audio_ring_storage_size(FRAME_SIZE, FRAME_COUNT));
+    TEST_ASSERT_NOT_NULL(g_storage);
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_init(&g_ring, g_storage, FRAME_SIZE, FRAME_COUNT));
+}
+
+void tearDown(void) {
+    free(g_storage);
+    g_storage = NULL;
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Basic Operation                                              */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_args(void) {
+    audio_ring_t ring;
+
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_init(NULL, g_storage, FRAME_SIZE, FRAME_COUNT));
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_init(&ring, NULL, FRAME_SIZE, FRAME_COUNT));
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_init(&ring, g_storage, 0, FRAME_COUNT));
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_init(&ring, g_storage, FRAME_SIZE, 0));
+}
+
+void test_empty_ring_peek_returns_null(void) {
+    int len = -1;
+
+    TEST_ASSERT_NULL(audio_ring_peek(&g_ring, &len));
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_count(&g_ring));
+    TEST_ASSERT_EQUAL_INT(FRAME_COUNT, audio_ring_free(&g_ring));
+}
+
+void test_push_peek_release(void) {
+    uint8_t in[16] = {1, 2, 3, 4, 5};
+    int len = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_push(&g_ring, in, sizeof(in)));
+    TEST_ASSERT_EQUAL_INT(1, audio_ring_count(&g_ring));
+
+    const uint8_t *out = audio_ring_peek(&g_ring, &len);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL_INT(sizeof(in), len);
+    TEST_ASSERT_EQUAL_MEMORY(in, out, sizeof(in));
+
+    audio_ring_release(&g_ring);
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_count(&g_ring));
+}
+
+void test_push_full_ring_fails(void) {
+    uint8_t frame[FRAME_SIZE] = {0};
+
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        TEST_ASSERT_EQUAL_INT(0, audio_ring_push(&g_ring, frame, FRAME_SIZE));
+    }
+
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_push(&g_ring, frame, FRAME_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_free(&g_ring));
+    TEST_ASSERT_EQUAL_INT(FRAME_COUNT, g_ring.high_water);
+}
+
+void test_push_oversized_frame_fails(void) {
+    uint8_t frame[FRAME_SIZE + 1] = {0};
+
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_push(&g_ring, frame, FRAME_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(-1, audio_ring_push(&g_ring, NULL, 10));
+}
+
+void test_zero_length_marker(void) {
+    int len = -1;
+
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_push(&g_ring, NULL, 0));
+    TEST_ASSERT_NOT_NULL(audio_ring_peek(&g_ring, &len));
+    TEST_ASSERT_EQUAL_INT(0, len);
+}
+
+void test_release_empty_is_noop(void) {
+    audio_ring_release(&g_ring);
+
+    TEST_ASSERT_EQUAL_INT(0, audio_ring_count(&g_ring));
+    TEST_ASSERT_EQUAL_INT(FRAME_COUNT, audio_ring_free(&g_ring));
+}
+
+void test_wraparound_preserves_order(void) {
+    uint32_t expected = 0;
+    uint32_t seq;
+    int len;
+    const uint8_t *out;
+
+    for (uint32_t i = 0; i < FRAME_COUNT * 5; i++) {
+        TEST_ASSERT_EQUAL_INT(0, audio_ring_push(&g_ring, (const uint8_t *)&i, sizeof(i)));
+
+        /* Keep the ring partly filled so head/tail keep wrapping */
+        if (audio_ring_count(&g_ring) > FRAME_COUNT / 2) {
+            out = audio_ring_peek(&g_ring, &len);
+            memcpy(&seq, out, sizeof(seq));
+            TEST_ASSERT_EQUAL_UINT32(expected++, seq);
+            audio_ring_release(&g_ring);
+        }
+    }
+
+    while ((out = audio_ring_peek(&g_ring, &len)) != NULL) {
+        memcpy(&seq, out, sizeof(seq));
+        TEST_ASSERT_EQUAL_UINT32(expected++, seq);
+        audio_ring_release(&g_ring);
+    }
+    TEST_ASSERT_EQUAL_UINT32(FRAME_COUNT * 5, expected);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Producer/Consumer Stress (capture task vs stalling sender)    */
+/* ------------------------------------------------------------------ */
+
+#define STRESS_FRAMES   20000
+
+typedef struct {
+    int retry_on_full;      /* 1 = producer waits (lossless), 0 = drop (firmware) */
+    int accepted;           /* Frames pushed successfully */
+    int overruns;           /* Push attempts that found the ring full */
+    int received;           /* Frames consumed */
+    int errors;             /* Lost / reordered / corrupted frames */
+    atomic_int done;        /* Producer finished */
+} stress_ctx_t;
+
+static void sleep_us(long us)
+{
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = us * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+/* Frame: [seq:4][len-4 bytes of (seq + i)] with varying length */
+static int make_frame(uint8_t *buf, uint32_t seq)
+{
+    int len = 4 + (int)(seq * 37u % (FRAME_SIZE - 4));
+    memcpy(buf, &seq, sizeof(seq));
+    for (int i = 4; i < len; i++) {
+        buf[i] = (uint8_t)(seq + i);
+    }
+    return len;
+}
+
+static void *producer_thread(void *arg)
+{
+    stress_ctx_t *ctx = arg;
+    uint8_t frame[FRAME_SIZE];
+
+    for (uint32_t seq = 0; seq < STRESS_FRAMES; seq++) {
+        int len = make_frame(frame, seq);
+        while (audio_ring_push(&g_ring, frame, len) != 0) {
+            ctx->overruns++;
+            if (!ctx->retry_on_full) {
+                goto next;
+            }
+            sched_yield();
+        }
+        ctx->accepted++;
+next:
+        if (seq % 64 == 0) {
+            sched_yield();
+        }
+    }
+
+    atomic_store(&ctx->done, 1);
+    return NULL;
+}
+
+static void *consumer_thread(void *arg)
+{
+    stress_ctx_t *ctx = arg;
+    unsigned int seed = 12345;
+    int64_t last_seq = -1;
+
+    for (;;) {
+        int len;
+        const uint8_t *out = audio_ring_peek(&g_ring, &len);
+        if (!out) {
+            if (atomic_load(&ctx->done) && audio_ring_count(&g_ring) == 0) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+
+        uint32_t seq;
+        memcpy(&seq, out, sizeof(seq));
+        uint8_t expect[FRAME_SIZE];
+        int expect_len = make_frame(expect, seq);
+
+        /* In order (strictly increasing), and intact */
+        if ((int64_t)seq <= last_seq || len != expect_len ||
+            memcmp(out, expect, len) != 0) {
+            ctx->errors++;
+        }
+        /* Lossless mode: no gaps either */
+        if (ctx->retry_on_full && (int64_t)seq != last_seq + 1) {
+            ctx->errors++;
+        }
+        last_seq = seq;
+        ctx->received++;
+        audio_ring_release(&g_ring);
+
+        /* Random sender stalls (WebSocket send blocking) */
+        int r = rand_r(&seed) % 1000;
+        if (r < 5) {
+            sleep_us(2000);
+        } else if (r < 50) {
+            sleep_us(50);
+        }
+    }
+    return NULL;
+}
+
+static void run_stress(stress_ctx_t *ctx)
+{
+    pthread_t prod, cons;
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&cons, NULL, consumer_thread, ctx));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&prod, NULL, producer_thread, ctx));
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+}
+
+void test_stress_lossless_with_sender_stalls(void) {
+    stress_ctx_t ctx = { .retry_on_full = 1 };
+
+    run_stress(&ctx);
+
+    TEST_ASSERT_EQUAL_INT(0, ctx.errors);
+    TEST_ASSERT_EQUAL_INT(STRESS_FRAMES, ctx.accepted);
+    TEST_ASSERT_EQUAL_INT(STRESS_FRAMES, ctx.received);
+}
+
+void test_stress_drop_on_full_keeps_order(void) {
+    stress_ctx_t ctx = { .retry_on_full = 0 };
+
+    run_stress(&ctx);
+
+    /* Every accepted frame arrives intact and in order; drops are counted */
+    TEST_ASSERT_EQUAL_INT(0, ctx.errors);
+    TEST_ASSERT_EQUAL_INT(ctx.accepted, ctx.received);
+    TEST_ASSERT_EQUAL_INT(STRESS_FRAMES, ctx.accepted + ctx.overruns);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Basic operation */
+    RUN_TEST(test_init_invalid_args);
+    RUN_TEST(test_empty_ring_peek_returns_null);
+    RUN_TEST(test_push_peek_release);
+    RUN_TEST(test_push_full_ring_fails);
+    RUN_TEST(test_push_oversized_frame_fails);
+    RUN_TEST(test_zero_length_marker);
+    RUN_TEST(test_release_empty_is_noop);
+    RUN_TEST(test_wraparound_preserves_order);
+
+    /* Producer/consumer stress */
+    RUN_TEST(test_stress_lossless_with_sender_stalls);
+    RUN_TEST(test_stress_drop_on_full_keeps_order);
+
+    return UNITY_END();
+}
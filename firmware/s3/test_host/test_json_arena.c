@@ -0,0 +1,196 @@
+#include "unity.h"
+#include "json_arena.h"
+#include "cJSON.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+static const char *MSG =
+    "{\"cmd\":\"ANNOUNCE\",\"ip\":\"192.168.1.10\",\"port\":8765,\"version\":\"2.1\","
+    "\"caps\":[\"opus\",\"tlv\"]}";
+
+static uint8_t g_buf[2048];
+static json_arena_t g_arena;
+
+static bool in_arena(const json_arena_t *a, const void *p) {
+    return (const uint8_t *)p >= a->buf && (const uint8_t *)p < a->buf + a->cap;
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    json_arena_install();
+    TEST_ASSERT_EQUAL_INT(0, json_arena_init(&g_arena, g_buf, sizeof(g_buf)));
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Init                                                         */
+/* ------------------------------------------------------------------ */
+
+void test_init_aligns_buffer(void) {
+    json_arena_t a;
+
+    TEST_ASSERT_EQUAL_INT(0, json_arena_init(&a, g_buf + 3, 100));
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)a.buf % JSON_ARENA_ALIGN);
+    TEST_ASSERT_EQUAL_UINT32(100 - (uint32_t)(a.buf - (g_buf + 3)), a.cap);
+
+    TEST_ASSERT_EQUAL_INT(-1, json_arena_init(NULL, g_buf, 100));
+    TEST_ASSERT_EQUAL_INT(-1, json_arena_init(&a, NULL, 100));
+    TEST_ASSERT_EQUAL_INT(-1, json_arena_init(&a, g_buf, 4));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Scoped Parsing                                               */
+/* ------------------------------------------------------------------ */
+
+void test_parse_in_scope_uses_arena_only(void) {
+    json_arena_stats_t st;
+    uint32_t heap_before = json_arena_heap_allocs();
+
+    json_arena_begin(&g_arena);
+    cJSON *root = cJSON_Parse(MSG);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_TRUE(in_arena(&g_arena, root));
+    TEST_ASSERT_EQUAL_STRING("192.168.1.10", cJSON_GetObjectItem(root, "ip")->valuestring);
+    TEST_ASSERT_EQUAL_INT(8765, cJSON_GetObjectItem(root, "port")->valueint);
+    cJSON_Delete(root);
+    uint32_t used = g_arena.used;
+    json_arena_end(&g_arena);
+
+    json_arena_get_stats(&g_arena, &st);
+    TEST_ASSERT_EQUAL_UINT32(heap_before, json_arena_heap_allocs());
+    TEST_ASSERT_GREATER_THAN_UINT32(8, st.allocs);
+    TEST_ASSERT_EQUAL_UINT32(0, st.spills);
+    TEST_ASSERT_EQUAL_UINT32(1, st.scopes);
+    TEST_ASSERT_EQUAL_UINT32(used, st.peak);
+    TEST_ASSERT_EQUAL_UINT32(0, g_arena.used);
+}
+
+void test_arena_is_reused_every_scope(void) {
+    json_arena_stats_t st;
+    cJSON *first;
+
+    json_arena_begin(&g_arena);
+    first = cJSON_Parse(MSG);
+    cJSON_Delete(first);
+    json_arena_end(&g_arena);
+
+    for (int i = 0; i < 100; i++) {
+        json_arena_begin(&g_arena);
+        cJSON *root = cJSON_Parse(MSG);
+        TEST_ASSERT_EQUAL_PTR(first, root);
+        cJSON_Delete(root);
+        json_arena_end(&g_arena);
+    }
+
+    json_arena_get_stats(&g_arena, &st);
+    TEST_ASSERT_EQUAL_UINT32(101, st.scopes);
+    TEST_ASSERT_EQUAL_UINT32(0, st.spills);
+}
+
+void test_full_arena_spills_to_heap(void) {
+    static uint8_t small[64];
+    json_arena_t a;
+    json_arena_stats_t st;
+    uint32_t heap_before = json_arena_heap_allocs();
+
+    TEST_ASSERT_EQUAL_INT(0, json_arena_init(&a, small, sizeof(small)));
+    json_arena_begin(&a);
+    cJSON *root = cJSON_Parse(MSG);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_EQUAL_STRING("2.1", cJSON_GetObjectItem(root, "version")->valuestring);
+    cJSON_Delete(root);                 /* Mix of arena and heap blocks */
+    json_arena_end(&a);
+
+    json_arena_get_stats(&a, &st);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, st.spills);
+    TEST_ASSERT_EQUAL_UINT32(heap_before + st.spills, json_arena_heap_allocs());
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(a.cap, st.peak);
+}
+
+void test_outside_scope_uses_heap(void) {
+    uint32_t heap_before = json_arena_heap_allocs();
+
+    cJSON *root = cJSON_Parse(MSG);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_FALSE(in_arena(&g_arena, root));
+    TEST_ASSERT_GREATER_THAN_UINT32(heap_before, json_arena_heap_allocs());
+
+    /* A heap tree deleted inside a scope is really freed */
+    json_arena_begin(&g_arena);
+    cJSON_Delete(root);
+    json_arena_end(&g_arena);
+}
+
+void test_nested_scopes_restore_outer(void) {
+    static uint8_t inner_buf[1024];
+    json_arena_t inner;
+
+    TEST_ASSERT_EQUAL_INT(0, json_arena_init(&inner, inner_buf, sizeof(inner_buf)));
+
+    json_arena_begin(&g_arena);
+    cJSON *outer_root = cJSON_Parse(MSG);
+    json_arena_begin(&inner);
+    cJSON *inner_root = cJSON_Parse(MSG);
+    TEST_ASSERT_TRUE(in_arena(&inner, inner_root));
+    cJSON_Delete(outer_root);           /* Outer block freed from inner scope */
+    cJSON_Delete(inner_root);
+    json_arena_end(&inner);
+
+    cJSON *again = cJSON_Parse(MSG);
+    TEST_ASSERT_TRUE(in_arena(&g_arena, again));
+    cJSON_Delete(again);
+    json_arena_end(&g_arena);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Per-task Scope                                               */
+/* ------------------------------------------------------------------ */
+
+static void *parse_in_thread(void *arg) {
+    cJSON *root = cJSON_Parse(MSG);
+    *(bool *)arg = root && !in_arena(&g_arena, root);
+    cJSON_Delete(root);
+    return NULL;
+}
+
+void test_other_threads_keep_using_heap(void) {
+    pthread_t th;
+    bool heap = false;
+
+    json_arena_begin(&g_arena);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&th, NULL, parse_in_thread, &heap));
+    pthread_join(th, NULL);
+    json_arena_end(&g_arena);
+
+    TEST_ASSERT_TRUE(heap);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Init */
+    RUN_TEST(test_init_aligns_buffer);
+
+    /* Scoped parsing */
+    RUN_TEST(test_parse_in_scope_uses_arena_only);
+    RUN_TEST(test_arena_is_reused_every_scope);
+    RUN_TEST(test_full_arena_spills_to_heap);
+    RUN_TEST(test_outside_scope_uses_heap);
+    RUN_TEST(test_nested_scopes_restore_outer);
+
+    /* Per-task scope */
+    RUN_TEST(test_other_threads_keep_using_heap);
+
+    return UNITY_END();
+}
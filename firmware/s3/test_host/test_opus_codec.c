@@ -0,0 +1,175 @@
+#include "unity.h"
+#include "opus_codec.h"
+#include "audio_fixture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* TTS downlink format */
+#define TTS_RATE        24000
+#define TTS_FRAME_MS    60
+#define TTS_FRAME       (TTS_RATE / 1000 * TTS_FRAME_MS)
+#define STREAM_MS       5000
+#define MAX_DEC_SAMPLES (TTS_RATE / 1000 * OPUS_CODEC_MAX_FRAME_MS)
+
+/* ------------------------------------------------------------------ */
+/* Packet stream fixture (encoded once, as the server would send it)  */
+/* ------------------------------------------------------------------ */
+
+static uint8_t *g_packets = NULL;
+static int g_packet_len[STREAM_MS / TTS_FRAME_MS];
+static int g_packet_count = 0;
+
+static void build_packet_stream(void)
+{
+    audio_fixture_t fx;
+    TEST_ASSERT_EQUAL_INT(0, audio_fixture_synth_speech(TTS_RATE, STREAM_MS, &fx));
+
+    opus_codec_enc_config_t cfg = {
+        .sample_rate = TTS_RATE,
+        .frame_ms = TTS_FRAME_MS,
+        .bitrate = 24000,
+        .complexity = 5,
+    };
+    opus_codec_enc_t *enc = opus_codec_enc_create(&cfg);
+    TEST_ASSERT_NOT_NULL(enc);
+
+    g_packets = malloc((size_t)(STREAM_MS / TTS_FRAME_MS) * OPUS_CODEC_MAX_PACKET);
+    TEST_ASSERT_NOT_NULL(g_packets);
+
+    g_packet_count = fx.num_samples / TTS_FRAME;
+    for (int i = 0; i < g_packet_count; i++) {
+        g_packet_len[i] = opus_codec_encode(enc, &fx.samples[i * TTS_FRAME],
+                                            &g_packets[i * OPUS_CODEC_MAX_PACKET],
+                                            OPUS_CODEC_MAX_PACKET);
+        TEST_ASSERT_GREATER_THAN(0, g_packet_len[i]);
+    }
+
+    opus_codec_enc_destroy(enc);
+    audio_fixture_free(&fx);
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    if (!g_packets) {
+        build_packet_stream();
+    }
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Decoder Creation                                             */
+/* ------------------------------------------------------------------ */
+
+void test_dec_create_valid_rate(void) {
+    opus_codec_dec_t *dec = opus_codec_dec_create(TTS_RATE);
+
+    TEST_ASSERT_NOT_NULL(dec);
+    opus_codec_dec_destroy(dec);
+}
+
+void test_dec_create_invalid_rate(void) {
+    TEST_ASSERT_NULL(opus_codec_dec_create(44100));
+    TEST_ASSERT_NULL(opus_codec_dec_create(0));
+}
+
+void test_dec_destroy_null(void) {
+    opus_codec_dec_destroy(NULL);  /* must not crash */
+}
+
+void test_decode_invalid_args(void) {
+    opus_codec_dec_t *dec = opus_codec_dec_create(TTS_RATE);
+    int16_t pcm[MAX_DEC_SAMPLES];
+
+    TEST_ASSERT_EQUAL_INT(-1, opus_codec_decode(NULL, g_packets, g_packet_len[0], pcm, MAX_DEC_SAMPLES));
+    TEST_ASSERT_EQUAL_INT(-1, opus_codec_decode(dec, g_packets, g_packet_len[0], NULL, MAX_DEC_SAMPLES));
+    TEST_ASSERT_EQUAL_INT(-1, opus_codec_decode(dec, g_packets, 0, pcm, MAX_DEC_SAMPLES));
+    TEST_ASSERT_EQUAL_INT(-1, opus_codec_decode(dec, g_packets, g_packet_len[0], pcm, 0));
+
+    opus_codec_dec_destroy(dec);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Packet Stream Decode                                         */
+/* ------------------------------------------------------------------ */
+
+void test_decode_stream_frame_sizes(void) {
+    opus_codec_dec_t *dec = opus_codec_dec_create(TTS_RATE);
+    int16_t pcm[MAX_DEC_SAMPLES];
+    long total = 0;
+
+    for (int i = 0; i < g_packet_count; i++) {
+        int n = opus_codec_decode(dec, &g_packets[i * OPUS_CODEC_MAX_PACKET],
+                                  g_packet_len[i], pcm, MAX_DEC_SAMPLES);
+        TEST_ASSERT_EQUAL_INT(TTS_FRAME, n);
+        total += n;
+    }
+
+    TEST_ASSERT_EQUAL_INT(g_packet_count * TTS_FRAME, total);
+    opus_codec_dec_destroy(dec);
+}
+
+void test_decode_packet_loss_concealment(void) {
+    opus_codec_dec_t *dec = opus_codec_dec_create(TTS_RATE);
+    int16_t pcm[MAX_DEC_SAMPLES];
+
+    opus_codec_decode(dec, g_packets, g_packet_len[0], pcm, MAX_DEC_SAMPLES);
+    int n = opus_codec_decode(dec, NULL, 0, pcm, TTS_FRAME);
+
+    TEST_ASSERT_EQUAL_INT(TTS_FRAME, n);
+    opus_codec_dec_destroy(dec);
+}
+
+void test_decode_cpu_time_per_second(void) {
+    opus_codec_dec_t *dec = opus_codec_dec_create(TTS_RATE);
+    int16_t pcm[MAX_DEC_SAMPLES];
+    long samples = 0;
+    long bytes = 0;
+
+    clock_t t0 = clock();
+    for (int i = 0; i < g_packet_count; i++) {
+        int n = opus_codec_decode(dec, &g_packets[i * OPUS_CODEC_MAX_PACKET],
+                                  g_packet_len[i], pcm, MAX_DEC_SAMPLES);
+        TEST_ASSERT_GREATER_THAN(0, n);
+        samples += n;
+        bytes += g_packet_len[i];
+    }
+    double cpu_ms = (double)(clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+    opus_codec_dec_destroy(dec);
+
+    double audio_s = (double)samples / TTS_RATE;
+    double ms_per_s = cpu_ms / audio_s;
+    printf("Opus decode: %.2f s audio, %ld bytes (%.1f kbps), %.3f ms CPU per second of audio\n",
+           audio_s, bytes, bytes * 8 / audio_s / 1000.0, ms_per_s);
+
+    /* Host must decode far faster than real time */
+    TEST_ASSERT_TRUE(ms_per_s < 250.0);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Decoder creation */
+    RUN_TEST(test_dec_create_valid_rate);
+    RUN_TEST(test_dec_create_invalid_rate);
+    RUN_TEST(test_dec_destroy_null);
+    RUN_TEST(test_decode_invalid_args);
+
+    /* Packet stream decode */
+    RUN_TEST(test_decode_stream_frame_sizes);
+    RUN_TEST(test_decode_packet_loss_concealment);
+    RUN_TEST(test_decode_cpu_time_per_second);
+
+    int rc = UNITY_END();
+    free(g_packets);
+    return rc;
+}
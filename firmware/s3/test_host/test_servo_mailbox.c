@@ -0,0 +1,222 @@
+#include "unity.h"
+#include "servo_mailbox.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PAIR_MS     3
+
+static servo_mailbox_t g_mb;
+static char g_frame[SERVO_MAILBOX_FRAME_MAX];
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    servo_mailbox_init(&g_mb, PAIR_MS);
+    memset(g_frame, 0, sizeof(g_frame));
+}
+
+void tearDown(void) {
+}
+
+static int take(uint32_t now, int *wait) {
+    int len = servo_mailbox_take(&g_mb, now, g_frame, sizeof(g_frame), wait);
+    g_frame[len] = '\0';
+    return len;
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Post                                                         */
+/* ------------------------------------------------------------------ */
+
+void test_axis_from_id(void) {
+    TEST_ASSERT_EQUAL_INT(SERVO_AXIS_X, servo_mailbox_axis("x"));
+    TEST_ASSERT_EQUAL_INT(SERVO_AXIS_X, servo_mailbox_axis("X"));
+    TEST_ASSERT_EQUAL_INT(SERVO_AXIS_Y, servo_mailbox_axis("y"));
+    TEST_ASSERT_EQUAL_INT(-1, servo_mailbox_axis("z"));
+    TEST_ASSERT_EQUAL_INT(-1, servo_mailbox_axis("xy"));
+    TEST_ASSERT_EQUAL_INT(-1, servo_mailbox_axis(NULL));
+}
+
+void test_newer_target_overwrites(void) {
+    servo_mailbox_stats_t st;
+    int wait;
+
+    TEST_ASSERT_EQUAL_INT(0, servo_mailbox_post(&g_mb, SERVO_AXIS_X, 10, 100, 0));
+    TEST_ASSERT_EQUAL_INT(1, servo_mailbox_post(&g_mb, SERVO_AXIS_X, 20, 100, 1));
+    TEST_ASSERT_EQUAL_INT(1, servo_mailbox_post(&g_mb, SERVO_AXIS_X, 200, 150, 2));
+
+    /* Latest wins, clamped */
+    TEST_ASSERT_GREATER_THAN_INT(0, take(PAIR_MS, &wait));
+    TEST_ASSERT_EQUAL_STRING("X:180:150\r\n", g_frame);
+
+    servo_mailbox_get_stats(&g_mb, &st);
+    TEST_ASSERT_EQUAL_UINT32(3, st.posted);
+    TEST_ASSERT_EQUAL_UINT32(2, st.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(1, st.frames);
+}
+
+void test_bad_axis_is_dropped(void) {
+    servo_mailbox_stats_t st;
+    int wait;
+
+    TEST_ASSERT_EQUAL_INT(-1, servo_mailbox_post(&g_mb, -1, 90, 100, 0));
+    TEST_ASSERT_EQUAL_INT(0, take(100, &wait));
+    TEST_ASSERT_EQUAL_INT(-1, wait);
+
+    servo_mailbox_send_failed(&g_mb);
+    servo_mailbox_get_stats(&g_mb, &st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, st.posted);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Pairing                                                      */
+/* ------------------------------------------------------------------ */
+
+void test_both_axes_leave_as_one_frame(void) {
+    servo_mailbox_stats_t st;
+    int wait;
+
+    servo_mailbox_post(&g_mb, SERVO_AXIS_Y, 45, 300, 0);
+    servo_mailbox_post(&g_mb, SERVO_AXIS_X, 90, 500, 1);
+
+    TEST_ASSERT_EQUAL_INT(20, take(1, &wait));
+    TEST_ASSERT_EQUAL_STRING("X:90:500\r\nY:45:300\r\n", g_frame);
+    TEST_ASSERT_EQUAL_INT(0, wait);
+
+    servo_mailbox_get_stats(&g_mb, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.paired);
+    TEST_ASSERT_EQUAL_INT(0, take(2, &wait));
+    TEST_ASSERT_EQUAL_INT(-1, wait);
+}
+
+void test_lone_target_waits_pair_window(void) {
+    int wait;
+
+    servo_mailbox_post(&g_mb, SERVO_AXIS_X, 90, 100, 10);
+
+    TEST_ASSERT_EQUAL_INT(0, take(10, &wait));
+    TEST_ASSERT_EQUAL_INT(PAIR_MS, wait);
+    TEST_ASSERT_EQUAL_INT(0, take(12, &wait));
+    TEST_ASSERT_EQUAL_INT(1, wait);
+
+    /* Still overwritten meanwhile, but the window runs from the first post */
+    servo_mailbox_post(&g_mb, SERVO_AXIS_X, 95, 100, 12);
+    TEST_ASSERT_EQUAL_INT(10, take(13, &wait));
+    TEST_ASSERT_EQUAL_STRING("X:95:100\r\n", g_frame);
+}
+
+void test_no_pair_window_sends_at_once(void) {
+    int wait;
+
+    servo_mailbox_init(&g_mb, 0);
+    servo_mailbox_post(&g_mb, SERVO_AXIS_Y, 30, 100, 5);
+    TEST_ASSERT_EQUAL_INT(10, take(5, &wait));
+    TEST_ASSERT_EQUAL_STRING("Y:30:100\r\n", g_frame);
+}
+
+void test_binary_mode_frames(void) {
+    servo_mailbox_stats_t st;
+    int wait;
+
+    servo_mailbox_set_binary(&g_mb, true);
+    servo_mailbox_post(&g_mb, SERVO_AXIS_X, 90, 500, 0);
+    servo_mailbox_post(&g_mb, SERVO_AXIS_Y, 45, 300, 0);
+
+    /* Both axes in one delimited frame */
+    TEST_ASSERT_EQUAL_INT(18, take(0, &wait));
+    TEST_ASSERT_EQUAL_HEX8(0x00, g_frame[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, g_frame[17]);
+
+    /* Lone axis: 1 entry; the sequence number moved on */
+    servo_mailbox_post(&g_mb, SERVO_AXIS_Y, 45, 300, 10);
+    TEST_ASSERT_EQUAL_INT(13, take(10 + PAIR_MS, &wait));
+    TEST_ASSERT_EQUAL_UINT8(2, g_mb.seq);
+
+    servo_mailbox_get_stats(&g_mb, &st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, st.paired);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Bounded Latency                                              */
+/* ------------------------------------------------------------------ */
+
+/* 115200 baud 8N1: 11.52 bytes per ms, rounded up */
+static uint32_t wire_ms(int len) {
+    return (uint32_t)((len * 10 + 114) / 115);
+}
+
+void test_stream_latency_stays_bounded(void) {
+    servo_mailbox_stats_t st;
+    uint32_t busy_until = 0;
+    uint32_t sent_targets = 0;
+    int angle = 0, last_x = -1, wait = -1;
+    bool busy = false;
+    uint32_t now;
+
+    /* For 2s the server streams X every 1ms and Y every 7ms, faster than
+     * the wire; the sender retries every 1ms once the UART is free. Then
+     * the stream stops and the mailbox drains. */
+    for (now = 0; now < 2000 || busy || wait >= 0; now++) {
+        if (now < 2000) {
+            angle = (int)now % 181;
+            servo_mailbox_post(&g_mb, SERVO_AXIS_X, angle, 100, now);
+            if (now % 7 == 0) {
+                servo_mailbox_post(&g_mb, SERVO_AXIS_Y, 180 - angle, 100, now);
+            }
+        }
+
+        busy = (int32_t)(now - busy_until) < 0;
+        if (!busy && take(now, &wait) > 0) {
+            busy_until = now + wire_ms((int)strlen(g_frame));
+            busy = true;
+            sent_targets += (strstr(g_frame, "Y:") != NULL);
+            if (g_frame[0] == 'X') {
+                sent_targets++;
+                sscanf(g_frame, "X:%d", &last_x);
+            }
+        }
+    }
+
+    /* The head ends on the server's last intent */
+    TEST_ASSERT_EQUAL_INT(angle, last_x);
+
+    servo_mailbox_get_stats(&g_mb, &st);
+
+    /* Nothing queues up: every target is either sent or superseded */
+    TEST_ASSERT_EQUAL_UINT32(st.posted, st.coalesced + sent_targets);
+    TEST_ASSERT_GREATER_THAN_UINT32(st.frames, st.coalesced);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, st.paired);
+
+    /* A sent target is never older than one frame on the wire plus the
+     * pair window (a FIFO would lag by the whole backlog) */
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(wire_ms(SERVO_MAILBOX_FRAME_MAX) + PAIR_MS, st.latency_max_ms);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Post */
+    RUN_TEST(test_axis_from_id);
+    RUN_TEST(test_newer_target_overwrites);
+    RUN_TEST(test_bad_axis_is_dropped);
+
+    /* Pairing */
+    RUN_TEST(test_both_axes_leave_as_one_frame);
+    RUN_TEST(test_lone_target_waits_pair_window);
+    RUN_TEST(test_no_pair_window_sends_at_once);
+    RUN_TEST(test_binary_mode_frames);
+
+    /* Bounded latency */
+    RUN_TEST(test_stream_latency_stays_bounded);
+
+    return UNITY_END();
+}
@@ -0,0 +1,603 @@
+#include "unity.h"
+#include "tts_jitter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* TTS default stream: 24kHz PCM16 mono = 48 bytes per ms */
+#define RATE            24000
+#define BPM             48
+#define TICK_MS         10              /* I2S pull granularity in the sim */
+#define CAPACITY_MS     4000
+#define MAX_PACKETS     1024
+
+static uint8_t g_storage[CAPACITY_MS * BPM];
+static tts_jitter_t g_jb;
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_init(&g_jb, g_storage, sizeof(g_storage), NULL));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+}
+
+void tearDown(void) {
+}
+
+static void push_ms(int ms) {
+    static uint8_t pcm[CAPACITY_MS * BPM];
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, pcm, ms * BPM));
+}
+
+/* ------------------------------------------------------------------ */
+/* Trace replay                                                       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int reply;                  /* TTS reply (stream) this frame belongs to */
+    int arrival_ms;             /* When the frame reaches the WS task, from reply start */
+    int audio_ms;               /* Audio it carries */
+} trace_pkt_t;
+
+typedef struct {
+    int replies;
+    int startup_max_ms;         /* Worst first arrival -> first sample played */
+    int gap_ms;                 /* Silence inserted mid-stream, all replies */
+    int stuttered;              /* Replies with at least one underrun */
+    int audio_ms;               /* Audio actually played */
+    uint32_t underruns;
+    uint32_t overruns;
+    int target_ms;              /* Target at the end */
+    int high_water_ms;
+} sim_result_t;
+
+/* Deterministic LCG so traces are identical on every host */
+static uint32_t g_seed;
+static int rand_below(int n) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return (int)((g_seed >> 8) % (uint32_t)n);
+}
+
+/* Server paces 60ms frames in real time */
+static int trace_steady(trace_pkt_t *t, int replies, int frames) {
+    int n = 0;
+    for (int r = 0; r < replies; r++) {
+        for (int i = 0; i < frames; i++, n++) {
+            t[n] = (trace_pkt_t){ r, i * 60, 60 };
+        }
+    }
+    return n;
+}
+
+/* Real-time pacing plus 0..max_ms network delay, delivered in order (TCP) */
+static int trace_jitter(trace_pkt_t *t, int replies, int frames, int max_ms, uint32_t seed) {
+    int n = 0;
+    g_seed = seed;
+    for (int r = 0; r < replies; r++) {
+        for (int i = 0; i < frames; i++, n++) {
+            int a = i * 60 + rand_below(max_ms + 1);
+            if (i > 0 && a < t[n - 1].arrival_ms) a = t[n - 1].arrival_ms;
+            t[n] = (trace_pkt_t){ r, a, 60 };
+        }
+    }
+    return n;
+}
+
+/* The link stalls for stall_ms at stall_at_ms into every reply, then the
+ * backlog lands at once (Wi-Fi retry burst) */
+static int trace_stalls(trace_pkt_t *t, int replies, int frames, int stall_at_ms, int stall_ms) {
+    int n = 0;
+    for (int r = 0; r < replies; r++) {
+        for (int i = 0; i < frames; i++, n++) {
+            int a = i * 60;
+            if (a >= stall_at_ms && a < stall_at_ms + stall_ms) a = stall_at_ms + stall_ms;
+            t[n] = (trace_pkt_t){ r, a, 60 };
+        }
+    }
+    return n;
+}
+
+/* Play one reply to the end; the buffer (and its target) carries over */
+static void simulate_reply(tts_jitter_t *jb, const trace_pkt_t *t, int count, sim_result_t *r) {
+    static uint8_t pcm[CAPACITY_MS * BPM];
+    uint8_t out[TICK_MS * BPM];
+    tts_jitter_stats_t st;
+    uint32_t underruns_before;
+    int next = 0;
+    bool started = false;
+
+    tts_jitter_get_stats(jb, &st);
+    underruns_before = st.underruns;
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(jb, RATE));
+
+    for (int now = t[0].arrival_ms; now < t[count - 1].arrival_ms + 60000; now += TICK_MS) {
+        while (next < count && t[next].arrival_ms <= now) {
+            tts_jitter_push(jb, pcm, t[next].audio_ms * BPM);
+            if (++next == count) {
+                tts_jitter_end(jb);
+            }
+        }
+
+        /* The codec pulls one tick of audio; whatever is missing is silence */
+        int got = 0;
+        int n;
+        while (got < (int)sizeof(out) && (n = tts_jitter_pop(jb, out, sizeof(out) - got)) > 0) {
+            got += n;
+        }
+        if (got > 0 && !started) {
+            started = true;
+            if (now - t[0].arrival_ms > r->startup_max_ms) {
+                r->startup_max_ms = now - t[0].arrival_ms;
+            }
+        }
+        r->audio_ms += got / BPM;
+        if (started && got < (int)sizeof(out) && !tts_jitter_drained(jb)) {
+            r->gap_ms += TICK_MS - got / BPM;
+        }
+        if (tts_jitter_drained(jb)) {
+            break;
+        }
+    }
+
+    tts_jitter_get_stats(jb, &st);
+    r->replies++;
+    r->stuttered += st.underruns != underruns_before;
+}
+
+static void simulate(const trace_pkt_t *t, int count, const tts_jitter_config_t *cfg,
+                     int capacity_ms, sim_result_t *r) {
+    static uint8_t storage[CAPACITY_MS * BPM];
+    tts_jitter_t jb;
+    tts_jitter_stats_t st;
+
+    memset(r, 0, sizeof(*r));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_init(&jb, storage, capacity_ms * BPM, cfg));
+
+    for (int first = 0; first < count; ) {
+        int last = first;
+        while (last < count && t[last].reply == t[first].reply) last++;
+        simulate_reply(&jb, &t[first], last - first, r);
+        first = last;
+    }
+
+    tts_jitter_get_stats(&jb, &st);
+    r->underruns = st.underruns;
+    r->overruns = st.overruns;
+    r->target_ms = st.target_ms;
+    r->high_water_ms = st.high_water_ms;
+}
+
+static int trace_audio_ms(const trace_pkt_t *t, int count) {
+    int ms = 0;
+    for (int i = 0; i < count; i++) ms += t[i].audio_ms;
+    return ms;
+}
+
+static void print_result(const char *name, const sim_result_t *r) {
+    printf("  %-30s %2d/%2d replies stutter, gaps %5d ms, underruns %3u, overruns %u, "
+           "startup <= %3d ms, target %3d ms, peak %4d ms\n",
+           name, r->stuttered, r->replies, r->gap_ms, (unsigned)r->underruns,
+           (unsigned)r->overruns, r->startup_max_ms, r->target_ms, r->high_water_ms);
+}
+
+/* Fixed prefill (step 0): the pre-adaptive behavior, for comparison */
+static void fixed_config(tts_jitter_config_t *cfg) {
+    tts_jitter_default_config(cfg);
+    cfg->step_ms = 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_args(void) {
+    tts_jitter_t jb;
+    tts_jitter_config_t cfg;
+
+    tts_jitter_default_config(&cfg);
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_init(NULL, g_storage, sizeof(g_storage), NULL));
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_init(&jb, NULL, sizeof(g_storage), NULL));
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_init(&jb, g_storage, 0, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_init(&jb, g_storage, 1001, NULL));
+
+    cfg.max_ms = cfg.start_ms - 1;
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_init(&jb, g_storage, sizeof(g_storage), &cfg));
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_begin(&g_jb, 0));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Prefill, End, Underrun                                       */
+/* ------------------------------------------------------------------ */
+
+void test_waits_for_start_threshold(void) {
+    uint8_t out[TICK_MS * BPM];
+    tts_jitter_config_t cfg;
+    tts_jitter_default_config(&cfg);
+
+    push_ms(cfg.start_ms - TICK_MS);
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));
+
+    push_ms(TICK_MS);
+    TEST_ASSERT_EQUAL_INT(sizeof(out), tts_jitter_pop(&g_jb, out, sizeof(out)));
+}
+
+void test_end_plays_short_tail_without_underrun(void) {
+    uint8_t out[1000 * BPM];
+    tts_jitter_stats_t st;
+
+    push_ms(30);    /* Below the start threshold */
+    tts_jitter_end(&g_jb);
+
+    TEST_ASSERT_EQUAL_INT(30 * BPM, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_FALSE(tts_jitter_drained(&g_jb));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_TRUE(tts_jitter_drained(&g_jb));
+
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.underruns);
+}
+
+void test_underrun_raises_target_to_cap(void) {
+    uint8_t out[1000 * BPM];
+    tts_jitter_stats_t st;
+    tts_jitter_config_t cfg;
+    tts_jitter_default_config(&cfg);
+
+    for (int i = 0; i < 20; i++) {
+        tts_jitter_get_stats(&g_jb, &st);
+        push_ms(st.target_ms);
+        TEST_ASSERT_EQUAL_INT(st.target_ms * BPM, tts_jitter_pop(&g_jb, out, sizeof(out)));
+        TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));   /* Underrun */
+    }
+
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_UINT32(20, st.underruns);
+    TEST_ASSERT_EQUAL_INT(cfg.max_ms, st.target_ms);
+}
+
+void test_clean_playback_decays_target(void) {
+    uint8_t out[100 * BPM];
+    tts_jitter_stats_t st;
+    tts_jitter_config_t cfg;
+    tts_jitter_default_config(&cfg);
+
+    /* Two underruns: target start + 2 steps */
+    for (int i = 0; i < 2; i++) {
+        tts_jitter_get_stats(&g_jb, &st);
+        push_ms(st.target_ms);
+        tts_jitter_pop(&g_jb, out, sizeof(out));
+        while (tts_jitter_pop(&g_jb, out, sizeof(out)) > 0) {
+        }
+    }
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_INT(cfg.start_ms + 2 * cfg.step_ms, st.target_ms);
+
+    /* One decay period of uninterrupted audio drops one step */
+    push_ms(st.target_ms);
+    for (int played = 0; played < cfg.decay_ms; played += 100) {
+        push_ms(100);
+        TEST_ASSERT_EQUAL_INT(sizeof(out), tts_jitter_pop(&g_jb, out, sizeof(out)));
+    }
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_INT(cfg.start_ms + cfg.step_ms, st.target_ms);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Capacity                                                     */
+/* ------------------------------------------------------------------ */
+
+void test_push_that_does_not_fit_is_overrun(void) {
+    tts_jitter_stats_t st;
+    uint8_t pcm[BPM];
+
+    push_ms(CAPACITY_MS - 1);
+    TEST_ASSERT_EQUAL_INT(BPM, tts_jitter_free(&g_jb));
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_push(&g_jb, pcm, BPM + 2));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, pcm, BPM));
+
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.overruns);
+    TEST_ASSERT_EQUAL_INT(CAPACITY_MS, st.depth_ms);
+    TEST_ASSERT_EQUAL_INT(CAPACITY_MS, st.high_water_ms);
+}
+
+void test_data_survives_wraparound(void) {
+    static uint8_t in[700 * BPM];
+    static uint8_t out[700 * BPM];
+    uint8_t seq_in = 0;
+    uint8_t seq_out = 0;
+    tts_jitter_config_t cfg;
+
+    /* No prefill wait: pop whatever is queued */
+    tts_jitter_default_config(&cfg);
+    cfg.start_ms = 0;
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_init(&g_jb, g_storage, sizeof(g_storage), &cfg));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+    for (int round = 0; round < 40; round++) {
+        int len = (100 + (round * 37) % 600) * BPM;
+        for (int i = 0; i < len; i++) in[i] = seq_in++;
+        TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, in, len));
+
+        int n = tts_jitter_pop(&g_jb, out, len);
+        TEST_ASSERT_EQUAL_INT(len, n);
+        for (int i = 0; i < n; i++) {
+            TEST_ASSERT_EQUAL_UINT8(seq_out++, out[i]);
+        }
+    }
+}
+
+void test_flush_discards_and_prefills_again(void) {
+    uint8_t out[TICK_MS * BPM];
+
+    push_ms(500);
+    TEST_ASSERT_EQUAL_INT(sizeof(out), tts_jitter_pop(&g_jb, out, sizeof(out)));
+
+    /* The consumer drops the flushed stream, including late frames */
+    tts_jitter_flush(&g_jb);
+    push_ms(TICK_MS);
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(sizeof(g_storage), tts_jitter_free(&g_jb));
+    TEST_ASSERT_TRUE(tts_jitter_drained(&g_jb));
+
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+    push_ms(TICK_MS);
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_FALSE(tts_jitter_drained(&g_jb));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Stream Switch                                                */
+/* ------------------------------------------------------------------ */
+
+void test_next_stream_queues_behind_tail(void) {
+    static uint8_t out[1000 * BPM];
+    tts_jitter_stats_t st;
+    int rate = 0;
+
+    push_ms(200);
+    TEST_ASSERT_EQUAL_INT(TICK_MS * BPM, tts_jitter_pop(&g_jb, out, TICK_MS * BPM));
+    TEST_ASSERT_EQUAL_UINT32(1, tts_jitter_stream(&g_jb, &rate));
+    TEST_ASSERT_EQUAL_INT(RATE, rate);
+
+    /* tts_end, then the next reply at 16kHz before the tail has played */
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_end(&g_jb));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, 16000));
+    static uint8_t pcm[200 * 32];
+    memset(pcm, 0x5a, sizeof(pcm));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, pcm, sizeof(pcm)));
+
+    /* The tail comes out alone, still as the first stream */
+    TEST_ASSERT_EQUAL_INT(190 * BPM, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT32(1, tts_jitter_stream(&g_jb, NULL));
+    for (int i = 0; i < 190 * BPM; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0, out[i]);
+    }
+
+    /* Then the second stream at its own rate */
+    TEST_ASSERT_EQUAL_INT(sizeof(pcm), tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT32(2, tts_jitter_stream(&g_jb, &rate));
+    TEST_ASSERT_EQUAL_INT(16000, rate);
+    TEST_ASSERT_EQUAL_UINT8(0x5a, out[0]);
+    TEST_ASSERT_FALSE(tts_jitter_drained(&g_jb));
+
+    tts_jitter_get_stats(&g_jb, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.underruns);
+}
+
+void test_begin_without_end_ends_previous_stream(void) {
+    static uint8_t out[1000 * BPM];
+
+    push_ms(200);
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+    push_ms(200);
+
+    TEST_ASSERT_EQUAL_INT(200 * BPM, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT32(1, tts_jitter_stream(&g_jb, NULL));
+    TEST_ASSERT_EQUAL_INT(200 * BPM, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT32(2, tts_jitter_stream(&g_jb, NULL));
+}
+
+void test_flush_drops_only_older_streams(void) {
+    static uint8_t out[1000 * BPM];
+    static uint8_t pcm[200 * BPM];
+
+    push_ms(200);
+    TEST_ASSERT_EQUAL_INT(TICK_MS * BPM, tts_jitter_pop(&g_jb, out, TICK_MS * BPM));
+
+    /* Barge-in while the next reply is already queued behind the tail */
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_end(&g_jb));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+    push_ms(100);
+    tts_jitter_flush(&g_jb);
+
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+    memset(pcm, 0xa5, sizeof(pcm));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, pcm, sizeof(pcm)));
+
+    TEST_ASSERT_EQUAL_INT(sizeof(pcm), tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8(0xa5, out[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, tts_jitter_stream(&g_jb, NULL));
+    TEST_ASSERT_EQUAL_INT(sizeof(g_storage), tts_jitter_free(&g_jb));
+}
+
+void test_marks_in_flight_are_bounded(void) {
+    for (int i = 1; i < TTS_JITTER_MARKS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, tts_jitter_end(&g_jb));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, tts_jitter_begin(&g_jb, RATE));
+
+    uint8_t out[TICK_MS * BPM];
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, RATE));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Arrival Traces                                               */
+/* ------------------------------------------------------------------ */
+
+void test_trace_steady_has_no_gaps(void) {
+    static trace_pkt_t t[MAX_PACKETS];
+    sim_result_t r;
+    tts_jitter_config_t cfg;
+    tts_jitter_default_config(&cfg);
+
+    int count = trace_steady(t, 5, 50);
+    simulate(t, count, &cfg, CAPACITY_MS, &r);
+    print_result("steady 60ms", &r);
+
+    TEST_ASSERT_EQUAL_INT(0, r.gap_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, r.underruns);
+    TEST_ASSERT_EQUAL_INT(trace_audio_ms(t, count), r.audio_ms);
+    /* Start latency is the threshold, rounded down to the packet size */
+    TEST_ASSERT_INT_WITHIN(60, cfg.start_ms, r.startup_max_ms);
+}
+
+void test_trace_jitter_adaptive_beats_fixed(void) {
+    static trace_pkt_t t[MAX_PACKETS];
+    tts_jitter_config_t adaptive, fixed;
+    sim_result_t ra, rf;
+
+    tts_jitter_default_config(&adaptive);
+    fixed_config(&fixed);
+
+    int count = trace_jitter(t, 16, 50, 400, 0x5eed);
+    simulate(t, count, &fixed, CAPACITY_MS, &rf);
+    simulate(t, count, &adaptive, CAPACITY_MS, &ra);
+    print_result("jitter 0-400ms, fixed", &rf);
+    print_result("jitter 0-400ms, adaptive", &ra);
+
+    TEST_ASSERT_EQUAL_INT(trace_audio_ms(t, count), ra.audio_ms);
+    TEST_ASSERT_TRUE(rf.stuttered > 0);
+    TEST_ASSERT_TRUE(ra.stuttered < rf.stuttered);
+    TEST_ASSERT_TRUE(ra.gap_ms < rf.gap_ms);
+    TEST_ASSERT_TRUE(ra.target_ms > adaptive.start_ms);
+}
+
+void test_trace_stalls_adaptive_beats_fixed(void) {
+    static trace_pkt_t t[MAX_PACKETS];
+    tts_jitter_config_t adaptive, fixed;
+    sim_result_t ra, rf;
+
+    tts_jitter_default_config(&adaptive);
+    fixed_config(&fixed);
+
+    int count = trace_stalls(t, 16, 50, 1000, 250);
+    simulate(t, count, &fixed, CAPACITY_MS, &rf);
+    simulate(t, count, &adaptive, CAPACITY_MS, &ra);
+    print_result("250ms stall per reply, fixed", &rf);
+    print_result("250ms stall per reply, adaptive", &ra);
+
+    TEST_ASSERT_EQUAL_INT(trace_audio_ms(t, count), ra.audio_ms);
+    TEST_ASSERT_EQUAL_INT(rf.replies, rf.stuttered);
+    TEST_ASSERT_TRUE(ra.stuttered <= rf.stuttered / 2);
+    TEST_ASSERT_TRUE(ra.gap_ms < rf.gap_ms);
+    TEST_ASSERT_TRUE(ra.target_ms <= adaptive.max_ms);
+}
+
+void test_trace_faster_than_realtime_fits_capacity(void) {
+    static trace_pkt_t t[MAX_PACKETS];
+    sim_result_t r;
+    tts_jitter_config_t cfg;
+    tts_jitter_default_config(&cfg);
+
+    /* Whole 3 s reply pushed at 6x real time */
+    for (int i = 0; i < 50; i++) {
+        t[i] = (trace_pkt_t){ 0, i * 10, 60 };
+    }
+    simulate(t, 50, &cfg, CAPACITY_MS, &r);
+    print_result("6x real time burst", &r);
+
+    TEST_ASSERT_EQUAL_UINT32(0, r.overruns);
+    TEST_ASSERT_EQUAL_INT(0, r.gap_ms);
+    TEST_ASSERT_EQUAL_INT(3000, r.audio_ms);
+
+    /* Same burst into a 1 s buffer: the excess is dropped and counted */
+    simulate(t, 50, &cfg, 1000, &r);
+    TEST_ASSERT_TRUE(r.overruns > 0);
+}
+
+/* ------------------------------------------------------------------ */
+/* Trace files: test_tts_jitter [trace.txt ...]                       */
+/*   "<reply> <arrival_ms> <audio_ms>" per line (e.g. from WS logs)   */
+/* ------------------------------------------------------------------ */
+
+static int report_trace(const char *path)
+{
+    static trace_pkt_t t[MAX_PACKETS * 8];
+    FILE *f = fopen(path, "r");
+    int count = 0;
+
+    if (!f) {
+        printf("  %s: cannot open\n", path);
+        return -1;
+    }
+    while (count < (int)(sizeof(t) / sizeof(t[0])) &&
+           fscanf(f, "%d %d %d", &t[count].reply, &t[count].arrival_ms, &t[count].audio_ms) == 3) {
+        if (t[count].audio_ms > 0) count++;
+    }
+    fclose(f);
+    if (count == 0) {
+        printf("  %s: no packets\n", path);
+        return -1;
+    }
+
+    tts_jitter_config_t adaptive, fixed;
+    sim_result_t ra, rf;
+    char name[64];
+
+    tts_jitter_default_config(&adaptive);
+    fixed_config(&fixed);
+    simulate(t, count, &fixed, CAPACITY_MS, &rf);
+    simulate(t, count, &adaptive, CAPACITY_MS, &ra);
+
+    snprintf(name, sizeof(name), "%.20s fixed", path);
+    print_result(name, &rf);
+    snprintf(name, sizeof(name), "%.20s adaptive", path);
+    print_result(name, &ra);
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_invalid_args);
+
+    /* Prefill, end, underrun */
+    RUN_TEST(test_waits_for_start_threshold);
+    RUN_TEST(test_end_plays_short_tail_without_underrun);
+    RUN_TEST(test_underrun_raises_target_to_cap);
+    RUN_TEST(test_clean_playback_decays_target);
+
+    /* Capacity */
+    RUN_TEST(test_push_that_does_not_fit_is_overrun);
+    RUN_TEST(test_data_survives_wraparound);
+    RUN_TEST(test_flush_discards_and_prefills_again);
+
+    /* Stream switch */
+    RUN_TEST(test_next_stream_queues_behind_tail);
+    RUN_TEST(test_begin_without_end_ends_previous_stream);
+    RUN_TEST(test_flush_drops_only_older_streams);
+    RUN_TEST(test_marks_in_flight_are_bounded);
+
+    /* Arrival traces */
+    RUN_TEST(test_trace_steady_has_no_gaps);
+    RUN_TEST(test_trace_jitter_adaptive_beats_fixed);
+    RUN_TEST(test_trace_stalls_adaptive_beats_fixed);
+    RUN_TEST(test_trace_faster_than_realtime_fits_capacity);
+
+    int rc = UNITY_END();
+
+    for (int i = 1; i < argc; i++) {
+        if (report_trace(argv[i]) != 0) {
+            rc = 1;
+        }
+    }
+    return rc;
+}
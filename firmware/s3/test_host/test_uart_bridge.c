@@ -1,5 +1,17 @@
+/**
+ * @file test_uart_bridge.c
+ * @brief Host tests for the S3 -> MCU servo link
+ *
+ * The bridge runs without its TX task here (FreeRTOS stubs), so posts take
+ * the inline ASCII path. Round-trip cases feed what the S3 puts on the
+ * wire - bridge ASCII lines and the mailbox's binary frames - through the
+ * MCU receiver (firmware/mcu/main/uart_protocol.c).
+ */
+
 #include "unity.h"
 #include "uart_bridge.h"
+#include "servo_mailbox.h"
+#include "uart_protocol.h"
 #include <string.h>
 
 /* ------------------------------------------------------------------ */
@@ -30,6 +42,17 @@ int hal_uart_send(const uint8_t *data, int len)
     return len;
 }
 
+int hal_uart_init(void)
+{
+    return 0;
+}
+
+int hal_uart_wait_tx_done(int timeout_ms)
+{
+    (void)timeout_ms;
+    return 0;
+}
+
 void reset_mock(void)
 {
     memset(last_sent, 0, sizeof(last_sent));
@@ -59,38 +82,64 @@ void tearDown(void)
 
 void test_send_servo_center(void)
 {
-    int ret = uart_bridge_send_servo(90, 90);
+    int ret = uart_bridge_send_servo(90, 90, 100);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
     TEST_ASSERT_EQUAL_INT(1, send_call_count);
-    TEST_ASSERT_EQUAL_STRING("X:90\r\nY:90\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:90:100\r\nY:90:100\r\n", last_sent);
 }
 
 void test_send_servo_min(void)
 {
-    int ret = uart_bridge_send_servo(0, 0);
+    int ret = uart_bridge_send_servo(0, 0, 0);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
     TEST_ASSERT_EQUAL_INT(1, send_call_count);
-    TEST_ASSERT_EQUAL_STRING("X:0\r\nY:0\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:0:0\r\nY:0:0\r\n", last_sent);
 }
 
 void test_send_servo_max(void)
 {
-    int ret = uart_bridge_send_servo(180, 180);
+    int ret = uart_bridge_send_servo(180, 180, 500);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
     TEST_ASSERT_EQUAL_INT(1, send_call_count);
-    TEST_ASSERT_EQUAL_STRING("X:180\r\nY:180\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:180:500\r\nY:180:500\r\n", last_sent);
 }
 
 void test_send_servo_asymmetric(void)
 {
-    int ret = uart_bridge_send_servo(45, 135);
+    int ret = uart_bridge_send_servo(45, 135, 100);
+
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_INT(1, send_call_count);
+    TEST_ASSERT_EQUAL_STRING("X:45:100\r\nY:135:100\r\n", last_sent);
+}
+
+void test_send_servo_default_duration(void)
+{
+    int ret = uart_bridge_send_servo(90, 90, -1);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_STRING("X:90:100\r\nY:90:100\r\n", last_sent);
+}
+
+void test_send_servo_single(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, uart_bridge_send_servo_single("x", 90, 500));
+    TEST_ASSERT_EQUAL_STRING("X:90:500\r\n", last_sent);
+
+    TEST_ASSERT_EQUAL_INT(0, uart_bridge_send_servo_single("Y", 45, -1));
+    TEST_ASSERT_EQUAL_STRING("Y:45:100\r\n", last_sent);
+
+    TEST_ASSERT_EQUAL_INT(-1, uart_bridge_send_servo_single(NULL, 45, 0));
+}
+
+void test_post_servo_without_task_sends_inline(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, uart_bridge_post_servo("x", 120, 300));
     TEST_ASSERT_EQUAL_INT(1, send_call_count);
-    TEST_ASSERT_EQUAL_STRING("X:45\r\nY:135\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:120:300\r\n", last_sent);
 }
 
 /* ------------------------------------------------------------------ */
@@ -99,26 +148,26 @@ void test_send_servo_asymmetric(void)
 
 void test_send_servo_clamp_negative(void)
 {
-    int ret = uart_bridge_send_servo(-10, -5);
+    int ret = uart_bridge_send_servo(-10, -5, 100);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
-    TEST_ASSERT_EQUAL_STRING("X:0\r\nY:0\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:0:100\r\nY:0:100\r\n", last_sent);
 }
 
 void test_send_servo_clamp_over_180(void)
 {
-    int ret = uart_bridge_send_servo(200, 255);
+    int ret = uart_bridge_send_servo(200, 255, 100);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
-    TEST_ASSERT_EQUAL_STRING("X:180\r\nY:180\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:180:100\r\nY:180:100\r\n", last_sent);
 }
 
 void test_send_servo_clamp_mixed(void)
 {
-    int ret = uart_bridge_send_servo(-10, 200);
+    int ret = uart_bridge_send_servo(-10, 200, 100);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
-    TEST_ASSERT_EQUAL_STRING("X:0\r\nY:180\r\n", last_sent);
+    TEST_ASSERT_EQUAL_STRING("X:0:100\r\nY:180:100\r\n", last_sent);
 }
 
 /* ------------------------------------------------------------------ */
@@ -127,8 +176,8 @@ void test_send_servo_clamp_mixed(void)
 
 void test_stats_increment(void)
 {
-    uart_bridge_send_servo(90, 90);
-    uart_bridge_send_servo(45, 45);
+    uart_bridge_send_servo(90, 90, 100);
+    uart_bridge_send_servo(45, 45, 100);
 
     uart_bridge_t stats;
     uart_bridge_get_stats(&stats);
@@ -141,7 +190,7 @@ void test_stats_error_count(void)
 {
     mock_error = 1;  /* Simulate UART error */
 
-    int ret = uart_bridge_send_servo(90, 90);
+    int ret = uart_bridge_send_servo(90, 90, 100);
     TEST_ASSERT_EQUAL_INT(-1, ret);
 
     uart_bridge_t stats;
@@ -153,7 +202,7 @@ void test_stats_error_count(void)
 
 void test_stats_reset(void)
 {
-    uart_bridge_send_servo(90, 90);
+    uart_bridge_send_servo(90, 90, 100);
 
     uart_bridge_reset_stats();
 
@@ -170,32 +219,194 @@ void test_stats_reset(void)
 
 void test_protocol_format_length(void)
 {
-    /* "X:90\r\nY:90\r\n" = 12 chars */
-    uart_bridge_send_servo(90, 90);
-    TEST_ASSERT_EQUAL_INT(12, last_sent_len);
+    /* "X:90:100\r\nY:90:100\r\n" = 20 chars */
+    uart_bridge_send_servo(90, 90, 100);
+    TEST_ASSERT_EQUAL_INT(20, last_sent_len);
 
     reset_mock();
 
-    /* "X:180\r\nY:180\r\n" = 14 chars */
-    uart_bridge_send_servo(180, 180);
-    TEST_ASSERT_EQUAL_INT(14, last_sent_len);
+    /* "X:180:100\r\nY:180:100\r\n" = 22 chars */
+    uart_bridge_send_servo(180, 180, 100);
+    TEST_ASSERT_EQUAL_INT(22, last_sent_len);
 
     reset_mock();
 
-    /* "X:0\r\nY:0\r\n" = 10 chars */
-    uart_bridge_send_servo(0, 0);
-    TEST_ASSERT_EQUAL_INT(10, last_sent_len);
+    /* "X:0:0\r\nY:0:0\r\n" = 14 chars */
+    uart_bridge_send_servo(0, 0, 0);
+    TEST_ASSERT_EQUAL_INT(14, last_sent_len);
 }
 
 void test_protocol_has_crlf(void)
 {
-    uart_bridge_send_servo(90, 90);
+    uart_bridge_send_servo(90, 90, 100);
 
     /* Check for \r\n at correct positions */
-    TEST_ASSERT_EQUAL('\r', last_sent[4]);
-    TEST_ASSERT_EQUAL('\n', last_sent[5]);
-    TEST_ASSERT_EQUAL('\r', last_sent[10]);
-    TEST_ASSERT_EQUAL('\n', last_sent[11]);
+    TEST_ASSERT_EQUAL('\r', last_sent[8]);
+    TEST_ASSERT_EQUAL('\n', last_sent[9]);
+    TEST_ASSERT_EQUAL('\r', last_sent[18]);
+    TEST_ASSERT_EQUAL('\n', last_sent[19]);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Round trip through the MCU receiver                          */
+/* ------------------------------------------------------------------ */
+
+/* Feed bytes to the MCU receiver, collect up to max commands */
+static int mcu_feed(uart_rx_t *rx, const uint8_t *data, int len, uart_cmd_t *out, int max)
+{
+    int n = 0;
+    uart_cmd_t cmd;
+
+    for (int i = 0; i < len; i++) {
+        if (uart_rx_feed(rx, data[i], &cmd) && n < max) {
+            out[n++] = cmd;
+        }
+    }
+    return n;
+}
+
+/* Both axes as one binary frame from the servo mailbox (servo TX path) */
+static int binary_frame(servo_mailbox_t *mb, int x, int y, int time_ms, uint8_t *out)
+{
+    int wait_ms;
+
+    servo_mailbox_post(mb, SERVO_AXIS_X, x, time_ms, 0);
+    servo_mailbox_post(mb, SERVO_AXIS_Y, y, time_ms, 0);
+    return servo_mailbox_take(mb, 0, (char *)out, SERVO_MAILBOX_FRAME_MAX, &wait_ms);
+}
+
+void test_ascii_round_trip(void)
+{
+    uart_rx_t rx;
+    uart_cmd_t got[2];
+
+    uart_rx_init(&rx);
+    for (int a = 0; a <= 180; a++) {
+        uart_bridge_send_servo(a, 180 - a, a * 10);
+        TEST_ASSERT_EQUAL_INT(2, mcu_feed(&rx, (const uint8_t *)last_sent, last_sent_len, got, 2));
+        TEST_ASSERT_EQUAL_CHAR('X', got[0].axis[0].axis);
+        TEST_ASSERT_EQUAL_INT(a * 10, got[0].axis[0].angle_x10);
+        TEST_ASSERT_EQUAL_INT(a * 10, got[0].axis[0].duration_ms);
+        TEST_ASSERT_EQUAL_CHAR('Y', got[1].axis[0].axis);
+        TEST_ASSERT_EQUAL_INT((180 - a) * 10, got[1].axis[0].angle_x10);
+    }
+    TEST_ASSERT_EQUAL_UINT32(362, rx.stats.lines);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.bad);
+}
+
+void test_binary_round_trip(void)
+{
+    servo_mailbox_t mb;
+    uart_rx_t rx;
+    uart_cmd_t got[2];
+    uint8_t frame[SERVO_MAILBOX_FRAME_MAX];
+
+    servo_mailbox_init(&mb, 3);
+    servo_mailbox_set_binary(&mb, true);
+    uart_rx_init(&rx);
+
+    for (int a = 0; a <= 180; a++) {
+        int n = binary_frame(&mb, a, 180 - a, a * 300, frame);
+        TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, frame, n, got, 2));
+        TEST_ASSERT_TRUE(got[0].binary);
+        TEST_ASSERT_EQUAL_INT(2, got[0].count);
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)a, got[0].seq);
+        TEST_ASSERT_EQUAL_INT(a * 10, got[0].axis[0].angle_x10);
+        TEST_ASSERT_EQUAL_INT((180 - a) * 10, got[0].axis[1].angle_x10);
+        TEST_ASSERT_EQUAL_INT(a * 300, got[0].axis[1].duration_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT32(181, rx.stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats.seq_gaps);
+}
+
+void test_ascii_and_binary_interleave(void)
+{
+    servo_mailbox_t mb;
+    uart_rx_t rx;
+    uart_cmd_t got[4];
+    uint8_t frame[SERVO_MAILBOX_FRAME_MAX];
+
+    servo_mailbox_init(&mb, 3);
+    servo_mailbox_set_binary(&mb, true);
+    uart_rx_init(&rx);
+
+    int n = binary_frame(&mb, 10, 20, 0, frame);
+    uart_bridge_send_servo_single("x", 30, 100);
+    TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, frame, n, got, 4));
+    TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, (const uint8_t *)last_sent, last_sent_len, got, 4));
+    TEST_ASSERT_EQUAL_INT(300, got[0].axis[0].angle_x10);
+    TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, frame, n, got, 4));
+    TEST_ASSERT_EQUAL_INT(100, got[0].axis[0].angle_x10);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Corruption                                                   */
+/* ------------------------------------------------------------------ */
+
+void test_binary_single_bit_errors_rejected(void)
+{
+    servo_mailbox_t mb;
+    uart_rx_t rx;
+    uart_cmd_t got[2];
+    uint8_t frame[SERVO_MAILBOX_FRAME_MAX];
+    uint8_t bad[SERVO_MAILBOX_FRAME_MAX];
+
+    servo_mailbox_init(&mb, 3);
+    servo_mailbox_set_binary(&mb, true);
+    uart_rx_init(&rx);
+    int n = binary_frame(&mb, 90, 45, 500, frame);
+
+    /* Every bit of the COBS body: never accepted, the next frame still is */
+    for (int i = 1; i < n - 1; i++) {
+        for (int b = 0; b < 8; b++) {
+            memcpy(bad, frame, n);
+            bad[i] ^= (uint8_t)(1 << b);
+            TEST_ASSERT_EQUAL_INT(0, mcu_feed(&rx, bad, n, got, 2));
+            TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, frame, n, got, 2));
+            TEST_ASSERT_EQUAL_INT(900, got[0].axis[0].angle_x10);
+            TEST_ASSERT_EQUAL_INT(450, got[0].axis[1].angle_x10);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(n - 2) * 8, rx.stats.frames);
+    TEST_ASSERT_TRUE(rx.stats.crc_errors > 0);
+}
+
+void test_binary_truncated_frame_resyncs(void)
+{
+    servo_mailbox_t mb;
+    uart_rx_t rx;
+    uart_cmd_t got[2];
+    uint8_t frame[SERVO_MAILBOX_FRAME_MAX];
+    const uint8_t noise[] = { 0x55, 0xAA, 0x13, 0xFF };
+
+    servo_mailbox_init(&mb, 3);
+    servo_mailbox_set_binary(&mb, true);
+    uart_rx_init(&rx);
+    int n = binary_frame(&mb, 90, 45, 500, frame);
+
+    /* Cut off before the trailing delimiter, then line noise */
+    TEST_ASSERT_EQUAL_INT(0, mcu_feed(&rx, frame, n - 4, got, 2));
+    TEST_ASSERT_EQUAL_INT(0, mcu_feed(&rx, noise, sizeof(noise), got, 2));
+
+    n = binary_frame(&mb, 100, 50, 0, frame);
+    TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, frame, n, got, 2));
+    TEST_ASSERT_EQUAL_INT(1000, got[0].axis[0].angle_x10);
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.frames);
+}
+
+void test_ascii_corruption_rejected(void)
+{
+    uart_rx_t rx;
+    uart_cmd_t got[2];
+
+    uart_rx_init(&rx);
+    uart_bridge_send_servo_single("x", 90, 500);
+    last_sent[2] = 'Q';     /* "X:Q0:500" */
+    TEST_ASSERT_EQUAL_INT(0, mcu_feed(&rx, (const uint8_t *)last_sent, last_sent_len, got, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, rx.stats.bad);
+
+    uart_bridge_send_servo_single("x", 90, 500);
+    TEST_ASSERT_EQUAL_INT(1, mcu_feed(&rx, (const uint8_t *)last_sent, last_sent_len, got, 2));
 }
 
 /* ------------------------------------------------------------------ */
@@ -211,6 +422,9 @@ int main(void)
     RUN_TEST(test_send_servo_min);
     RUN_TEST(test_send_servo_max);
     RUN_TEST(test_send_servo_asymmetric);
+    RUN_TEST(test_send_servo_default_duration);
+    RUN_TEST(test_send_servo_single);
+    RUN_TEST(test_post_servo_without_task_sends_inline);
 
     /* Boundary clamping */
     RUN_TEST(test_send_servo_clamp_negative);
@@ -226,5 +440,15 @@ int main(void)
     RUN_TEST(test_protocol_format_length);
     RUN_TEST(test_protocol_has_crlf);
 
+    /* Round trip through the MCU receiver */
+    RUN_TEST(test_ascii_round_trip);
+    RUN_TEST(test_binary_round_trip);
+    RUN_TEST(test_ascii_and_binary_interleave);
+
+    /* Corruption */
+    RUN_TEST(test_binary_single_bit_errors_rejected);
+    RUN_TEST(test_binary_truncated_frame_resyncs);
+    RUN_TEST(test_ascii_corruption_rejected);
+
     return UNITY_END();
 }
@@ -0,0 +1,107 @@
+#include "unity.h"
+#include "uart_frame.h"
+#include <string.h>
+
+/* Same frame is decoded by firmware/mcu/test_host/test_uart_protocol.c */
+static const uint8_t FRAME_X90_Y45[] = {
+    0x00, 0x04, 0x05, 0x01, 0x02, 0x0C, 0x84, 0x03, 0xF4, 0x01,
+    0x01, 0xC2, 0x01, 0x2C, 0x01, 0xD5, 0x1B, 0x00,
+};
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: CRC / COBS                                                   */
+/* ------------------------------------------------------------------ */
+
+void test_crc16_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, uart_frame_crc16((const uint8_t *)"123456789", 9));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, uart_frame_crc16(NULL, 0));
+}
+
+void test_cobs_vectors(void) {
+    uint8_t out[16];
+    const uint8_t zero[] = { 0x00 };
+    const uint8_t mid[] = { 0x11, 0x22, 0x00, 0x33 };
+    const uint8_t tail[] = { 0x11, 0x00, 0x00, 0x00 };
+
+    TEST_ASSERT_EQUAL_INT(2, uart_frame_cobs_encode(zero, 1, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((const uint8_t[]){ 0x01, 0x01 }), out, 2);
+
+    TEST_ASSERT_EQUAL_INT(5, uart_frame_cobs_encode(mid, 4, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((const uint8_t[]){ 0x03, 0x11, 0x22, 0x02, 0x33 }), out, 5);
+
+    TEST_ASSERT_EQUAL_INT(5, uart_frame_cobs_encode(tail, 4, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(((const uint8_t[]){ 0x02, 0x11, 0x01, 0x01, 0x01 }), out, 5);
+
+    TEST_ASSERT_EQUAL_INT(-1, uart_frame_cobs_encode(mid, 4, out, 4));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Servo Frame                                                  */
+/* ------------------------------------------------------------------ */
+
+void test_servo_frame_bytes(void) {
+    const uart_frame_axis_t axes[] = {
+        { UART_FRAME_AXIS_X, 900, 500 },
+        { UART_FRAME_AXIS_Y, 450, 300 },
+    };
+    uint8_t out[UART_FRAME_MAX];
+
+    int len = uart_frame_encode_servo(5, axes, 2, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(FRAME_X90_Y45), len);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(FRAME_X90_Y45, out, len);
+}
+
+void test_servo_frame_has_no_inner_zero(void) {
+    uart_frame_axis_t axes[UART_FRAME_AXES_MAX];
+    uint8_t out[UART_FRAME_MAX];
+
+    /* Zero-heavy payload: seq 0, angle 0, duration 0 */
+    memset(axes, 0, sizeof(axes));
+    int len = uart_frame_encode_servo(0, axes, UART_FRAME_AXES_MAX, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT(UART_FRAME_MAX, len);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[len - 1]);
+    for (int i = 1; i < len - 1; i++) {
+        TEST_ASSERT_NOT_EQUAL(0x00, out[i]);
+    }
+}
+
+void test_servo_frame_bad_args(void) {
+    const uart_frame_axis_t axis = { UART_FRAME_AXIS_X, 900, 0 };
+    uint8_t out[UART_FRAME_MAX];
+
+    TEST_ASSERT_EQUAL_INT(-1, uart_frame_encode_servo(0, &axis, 0, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(-1, uart_frame_encode_servo(0, &axis, UART_FRAME_AXES_MAX + 1,
+                                                      out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(-1, uart_frame_encode_servo(0, NULL, 1, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_INT(-1, uart_frame_encode_servo(0, &axis, 1, out, 8));
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* CRC / COBS */
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_cobs_vectors);
+
+    /* Servo frame */
+    RUN_TEST(test_servo_frame_bytes);
+    RUN_TEST(test_servo_frame_has_no_inner_zero);
+    RUN_TEST(test_servo_frame_bad_args);
+
+    return UNITY_END();
+}
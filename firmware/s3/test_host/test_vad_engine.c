@@ -0,0 +1,438 @@
+#include "unity.h"
+#include "vad_engine.h"
+#include "audio_dsp.h"
+#include "audio_fixture.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Uplink capture frame: 60ms @ 16kHz */
+#define SAMPLE_RATE     16000
+#define FRAME_MS        60
+#define FRAME_SAMPLES   (SAMPLE_RATE / 1000 * FRAME_MS)
+
+/* Idle audio before the wake word that the noise tracker sees */
+#define IDLE_MS         1500
+#define SEEDS           5
+
+/* Previous firmware VAD (fixed RMS threshold, fixed silence timeout) */
+#define LEGACY_RMS_THRESHOLD    100
+#define LEGACY_SILENCE_MS       3000
+#define LEGACY_MIN_SPEECH_MS    300
+
+/* ------------------------------------------------------------------ */
+/* Endpointing simulation                                             */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    int endpoint_ms;        /* End of the frame that stopped recording, -1 = never */
+} endpoint_result_t;
+
+static void run_engine(const audio_fixture_t *fx, endpoint_result_t *res)
+{
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t st;
+
+    vad_engine_default_config(&cfg);
+    TEST_ASSERT_EQUAL_INT(0, vad_engine_init(&vad, &cfg));
+
+    int frames = fx->num_samples / FRAME_SAMPLES;
+    int idle_frames = IDLE_MS / FRAME_MS;
+    res->endpoint_ms = -1;
+
+    for (int f = 0; f < frames; f++) {
+        audio_dsp_stats(&fx->samples[f * FRAME_SAMPLES], FRAME_SAMPLES, &st);
+
+        /* Wake word fires after IDLE_MS; the turn starts there */
+        if (f < idle_frames) {
+            vad_engine_track_noise(&vad, &st);
+            continue;
+        }
+        if (f == idle_frames) {
+            vad_engine_start_turn(&vad);
+        }
+        if (vad_engine_process(&vad, &st, FRAME_SAMPLES) == VAD_ENGINE_ENDPOINT) {
+            res->endpoint_ms = (f + 1) * FRAME_MS;
+            return;
+        }
+    }
+}
+
+static void run_legacy(const audio_fixture_t *fx, endpoint_result_t *res)
+{
+    audio_stats_t st;
+    int silence = 0;
+    int speech = 0;
+
+    int frames = fx->num_samples / FRAME_SAMPLES;
+    res->endpoint_ms = -1;
+
+    for (int f = IDLE_MS / FRAME_MS; f < frames; f++) {
+        audio_dsp_stats(&fx->samples[f * FRAME_SAMPLES], FRAME_SAMPLES, &st);
+        if (st.rms < LEGACY_RMS_THRESHOLD) {
+            if (++silence >= LEGACY_SILENCE_MS / FRAME_MS &&
+                speech >= LEGACY_MIN_SPEECH_MS / FRAME_MS) {
+                res->endpoint_ms = (f + 1) * FRAME_MS;
+                return;
+            }
+        } else {
+            silence = 0;
+            speech++;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Labeled scenarios                                                  */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const char *name;
+    audio_turn_spec_t spec;
+} scenario_t;
+
+/* lead, speech, pause, speech2, trail, level%, white, hum */
+static const scenario_t SCENARIOS[] = {
+    { "quiet room",          { 2000, 2750,   0,    0, 4000, 100,  30,   0 } },
+    { "office",              { 2000, 2750,   0,    0, 4000, 100, 150, 100 } },
+    { "fan noise",           { 2000, 2750,   0,    0, 4000, 100, 250, 250 } },
+    { "soft talker, noise",  { 2000, 2750,   0,    0, 4000,  40, 120,  60 } },
+    { "mid-turn pause",      { 2000, 1750, 500, 1750, 4000, 100,  80,  40 } },
+    { "short command",       { 2000,  750,   0,    0, 4000, 100,  80,  40 } },
+};
+#define SCENARIO_COUNT  (int)(sizeof(SCENARIOS) / sizeof(SCENARIOS[0]))
+
+typedef struct {
+    int runs;
+    int endpoints;          /* Turns that ended before the trailing audio ran out */
+    int false_cutoffs;      /* Endpoint before the labeled end of speech */
+    long latency_sum_ms;    /* Endpoint - labeled end, over endpoints */
+    int latency_max_ms;
+} scenario_report_t;
+
+static void report_add(scenario_report_t *r, const endpoint_result_t *res, const audio_label_t *label)
+{
+    r->runs++;
+    if (res->endpoint_ms < 0) {
+        return;
+    }
+    r->endpoints++;
+    if (res->endpoint_ms < label->end_ms) {
+        r->false_cutoffs++;
+        return;
+    }
+    int lat = res->endpoint_ms - label->end_ms;
+    r->latency_sum_ms += lat;
+    if (lat > r->latency_max_ms) r->latency_max_ms = lat;
+}
+
+static void report_print(const char *impl, const char *name, const scenario_report_t *r)
+{
+    int ok = r->endpoints - r->false_cutoffs;
+    if (ok > 0) {
+        printf("  %-20s %-7s %2d/%-2d %6ld %6d %5d\n", name, impl, r->endpoints, r->runs,
+               r->latency_sum_ms / ok, r->latency_max_ms, r->false_cutoffs);
+    } else {
+        printf("  %-20s %-7s %2d/%-2d %6s %6s %5d\n", name, impl, r->endpoints, r->runs,
+               "-", "-", r->false_cutoffs);
+    }
+}
+
+static scenario_report_t g_engine[SCENARIO_COUNT];
+static scenario_report_t g_legacy[SCENARIO_COUNT];
+
+static void run_scenarios(void)
+{
+    memset(g_engine, 0, sizeof(g_engine));
+    memset(g_legacy, 0, sizeof(g_legacy));
+
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        for (int seed = 1; seed <= SEEDS; seed++) {
+            audio_turn_spec_t spec = SCENARIOS[s].spec;
+            audio_fixture_t fx;
+            audio_label_t label;
+            endpoint_result_t res;
+
+            spec.seed = (uint32_t)(seed * 7919);
+            TEST_ASSERT_EQUAL_INT(0, audio_fixture_synth_turn(SAMPLE_RATE, &spec, &fx, &label));
+
+            run_engine(&fx, &res);
+            report_add(&g_engine[s], &res, &label);
+            run_legacy(&fx, &res);
+            report_add(&g_legacy[s], &res, &label);
+
+            audio_fixture_free(&fx);
+        }
+    }
+
+    printf("\nEnd-of-speech report (%d seeds, latency = endpoint - labeled end, ms)\n", SEEDS);
+    printf("  %-20s %-7s %5s %6s %6s %5s\n", "scenario", "impl", "ended", "mean", "max", "cut");
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        report_print("legacy", SCENARIOS[s].name, &g_legacy[s]);
+        report_print("engine", SCENARIOS[s].name, &g_engine[s]);
+    }
+    printf("\n");
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* Default engine after a quiet idle period (floor learned at ~40) */
+static void init_idle(vad_engine_t *vad, vad_engine_config_t *cfg)
+{
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+
+    vad_engine_default_config(cfg);
+    TEST_ASSERT_EQUAL_INT(0, vad_engine_init(vad, cfg));
+    for (int i = 0; i < VAD_ENGINE_FLOOR_WINDOW; i++) {
+        vad_engine_track_noise(vad, &quiet);
+    }
+    vad_engine_start_turn(vad);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_config(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+
+    vad_engine_default_config(&cfg);
+    TEST_ASSERT_EQUAL_INT(-1, vad_engine_init(NULL, &cfg));
+    TEST_ASSERT_EQUAL_INT(-1, vad_engine_init(&vad, NULL));
+
+    cfg.onset_ratio_q4 = cfg.offset_ratio_q4 - 1;
+    TEST_ASSERT_EQUAL_INT(-1, vad_engine_init(&vad, &cfg));
+
+    vad_engine_default_config(&cfg);
+    cfg.hangover_min_ms = cfg.hangover_max_ms + 1;
+    TEST_ASSERT_EQUAL_INT(-1, vad_engine_init(&vad, &cfg));
+}
+
+void test_start_turn_keeps_noise_floor(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t st = { .rms = 400, .zero_crossings = 100 };
+
+    vad_engine_default_config(&cfg);
+    vad_engine_init(&vad, &cfg);
+    for (int i = 0; i < 200; i++) {
+        vad_engine_track_noise(&vad, &st);
+    }
+    int floor = vad_engine_noise_floor(&vad);
+    TEST_ASSERT_INT_WITHIN(20, 400, floor);
+
+    vad_engine_start_turn(&vad);
+    TEST_ASSERT_EQUAL_INT(floor, vad_engine_noise_floor(&vad));
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SILENCE, vad.state);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: State Machine                                                */
+/* ------------------------------------------------------------------ */
+
+void test_single_loud_frame_is_not_onset(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+    audio_stats_t loud = { .rms = 3000, .zero_crossings = 50 };
+
+    init_idle(&vad, &cfg);
+
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SILENCE, vad_engine_process(&vad, &loud, FRAME_SAMPLES));
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SILENCE, vad_engine_process(&vad, &quiet, FRAME_SAMPLES));
+    vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SPEECH, vad_engine_process(&vad, &loud, FRAME_SAMPLES));
+}
+
+void test_hiss_needs_more_energy_for_onset(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    /* 3x floor but white-noise ZCR (~0.5) */
+    audio_stats_t hiss = { .rms = 200, .zero_crossings = FRAME_SAMPLES / 2 };
+
+    init_idle(&vad, &cfg);
+
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SILENCE, vad_engine_process(&vad, &hiss, FRAME_SAMPLES));
+    }
+}
+
+void test_hangover_shrinks_with_confident_speech(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+    audio_stats_t loud = { .rms = 3000, .zero_crossings = 50 };
+    int silent_frames = 0;
+
+    init_idle(&vad, &cfg);
+
+    /* 1.2 s of speech: well past confident_speech_ms */
+    for (int i = 0; i < 20; i++) {
+        vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    }
+    while (vad_engine_process(&vad, &quiet, FRAME_SAMPLES) != VAD_ENGINE_ENDPOINT) {
+        silent_frames++;
+        TEST_ASSERT_TRUE(silent_frames < 100);
+    }
+    silent_frames++;
+
+    TEST_ASSERT_EQUAL_INT(cfg.hangover_min_ms, vad.hangover_ms);
+    TEST_ASSERT_EQUAL_INT((cfg.hangover_min_ms + FRAME_MS - 1) / FRAME_MS, silent_frames);
+}
+
+void test_hangover_covers_longest_pause(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+    audio_stats_t loud = { .rms = 3000, .zero_crossings = 50 };
+
+    init_idle(&vad, &cfg);
+
+    for (int i = 0; i < 20; i++) vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    /* 660 ms pause, just under hangover_min_ms */
+    for (int i = 0; i < 11; i++) vad_engine_process(&vad, &quiet, FRAME_SAMPLES);
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_HANGOVER, vad.state);
+    vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+
+    /* The speaker paused 660 ms once; the next pause gets at least that + 1 frame */
+    TEST_ASSERT_TRUE(vad.hangover_ms >= 660 + FRAME_MS);
+}
+
+void test_no_endpoint_before_min_speech(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+    audio_stats_t loud = { .rms = 3000, .zero_crossings = 50 };
+
+    init_idle(&vad, &cfg);
+
+    /* 2 frames = 120 ms < min_speech_ms */
+    vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_NOT_EQUAL(VAD_ENGINE_ENDPOINT, vad_engine_process(&vad, &quiet, FRAME_SAMPLES));
+    }
+}
+
+void test_endpoint_is_sticky(void) {
+    vad_engine_config_t cfg;
+    vad_engine_t vad;
+    audio_stats_t quiet = { .rms = 40, .zero_crossings = 50 };
+    audio_stats_t loud = { .rms = 3000, .zero_crossings = 50 };
+
+    init_idle(&vad, &cfg);
+
+    for (int i = 0; i < 20; i++) vad_engine_process(&vad, &loud, FRAME_SAMPLES);
+    while (vad_engine_process(&vad, &quiet, FRAME_SAMPLES) != VAD_ENGINE_ENDPOINT) {
+    }
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_ENDPOINT, vad_engine_process(&vad, &loud, FRAME_SAMPLES));
+
+    vad_engine_start_turn(&vad);
+    TEST_ASSERT_EQUAL_INT(VAD_ENGINE_SILENCE, vad_engine_process(&vad, &quiet, FRAME_SAMPLES));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Labeled Fixtures                                             */
+/* ------------------------------------------------------------------ */
+
+void test_fixtures_no_false_cutoffs(void) {
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(0, g_engine[s].false_cutoffs, SCENARIOS[s].name);
+    }
+}
+
+void test_fixtures_every_turn_ends(void) {
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(SEEDS, g_engine[s].endpoints, SCENARIOS[s].name);
+    }
+}
+
+void test_fixtures_latency_bounded(void) {
+    vad_engine_config_t cfg;
+    vad_engine_default_config(&cfg);
+
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        /* Never worse than the max hangover plus frame quantization */
+        TEST_ASSERT_TRUE_MESSAGE(g_engine[s].latency_max_ms <= cfg.hangover_max_ms + 2 * FRAME_MS,
+                                 SCENARIOS[s].name);
+        /* And well under the old fixed 3 s wait */
+        TEST_ASSERT_TRUE_MESSAGE(g_engine[s].latency_max_ms < LEGACY_SILENCE_MS, SCENARIOS[s].name);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Labeled WAV files: test_vad_engine [a.wav ...], labels in a.txt    */
+/* ------------------------------------------------------------------ */
+
+static int report_wav(const char *path)
+{
+    audio_fixture_t fx;
+    audio_label_t labels[64];
+    char lab_path[512];
+
+    snprintf(lab_path, sizeof(lab_path), "%s", path);
+    char *dot = strrchr(lab_path, '.');
+    if (dot) *dot = '\0';
+    strncat(lab_path, ".txt", sizeof(lab_path) - strlen(lab_path) - 1);
+
+    int count = audio_fixture_load_labels(lab_path, labels, 64);
+    if (audio_fixture_load_wav(path, &fx) != 0 || fx.sample_rate != SAMPLE_RATE || count <= 0) {
+        printf("  %s: need 16-bit mono %d Hz WAV and labels in %s\n", path, SAMPLE_RATE, lab_path);
+        return -1;
+    }
+
+    audio_label_t last = labels[count - 1];
+    endpoint_result_t eng, leg;
+    run_engine(&fx, &eng);
+    run_legacy(&fx, &leg);
+
+    printf("  %s: speech end %d ms, engine %d ms (%+d), legacy %d ms\n",
+           path, last.end_ms, eng.endpoint_ms,
+           eng.endpoint_ms >= 0 ? eng.endpoint_ms - last.end_ms : 0, leg.endpoint_ms);
+    audio_fixture_free(&fx);
+    return (eng.endpoint_ms >= 0 && eng.endpoint_ms < last.end_ms) ? -1 : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_invalid_config);
+    RUN_TEST(test_start_turn_keeps_noise_floor);
+
+    /* State machine */
+    RUN_TEST(test_single_loud_frame_is_not_onset);
+    RUN_TEST(test_hiss_needs_more_energy_for_onset);
+    RUN_TEST(test_hangover_shrinks_with_confident_speech);
+    RUN_TEST(test_hangover_covers_longest_pause);
+    RUN_TEST(test_no_endpoint_before_min_speech);
+    RUN_TEST(test_endpoint_is_sticky);
+
+    /* Labeled fixtures */
+    run_scenarios();
+    RUN_TEST(test_fixtures_no_false_cutoffs);
+    RUN_TEST(test_fixtures_every_turn_ends);
+    RUN_TEST(test_fixtures_latency_bounded);
+
+    int rc = UNITY_END();
+
+    for (int i = 1; i < argc; i++) {
+        if (report_wav(argv[i]) != 0) {
+            rc = 1;
+        }
+    }
+    return rc;
+}
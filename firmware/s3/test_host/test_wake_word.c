@@ -11,6 +11,8 @@
 
 #include "unity.h"
 #include "button_voice.h"
+#include "hal_wake_word.h"
+#include "hal_opus.h"
 #include <string.h>
 
 /* ------------------------------------------------------------------ */
@@ -56,12 +58,36 @@ void hal_wake_word_stop(wake_word_ctx_t *ctx)
     wake_word_stop_count++;
 }
 
+/* Mock: Pause/resume detection (continuous AFE mode not used here) */
+void hal_wake_word_pause_detection(wake_word_ctx_t *ctx)
+{
+    wake_word_stop_count++;
+}
+
+void hal_wake_word_resume_detection(wake_word_ctx_t *ctx)
+{
+    wake_word_start_count++;
+}
+
+/* Mock: Processed audio callback (continuous AFE mode only) */
+int hal_wake_word_set_audio_callback(wake_word_ctx_t *ctx, wake_word_audio_callback_t callback,
+                                     void *user_data)
+{
+    return -1;
+}
+
 /* Mock: Feed audio samples */
 void hal_wake_word_feed(wake_word_ctx_t *ctx, const int16_t *samples, size_t num_samples)
 {
     wake_word_feed_count++;
 }
 
+void hal_wake_word_feed_with_ref(wake_word_ctx_t *ctx, const int16_t *mic, const int16_t *ref,
+                                 size_t num_samples)
+{
+    wake_word_feed_count++;
+}
+
 /* Mock: Deinitialize */
 void hal_wake_word_deinit(wake_word_ctx_t *ctx)
 {
@@ -133,6 +159,22 @@ int hal_opus_encode(const uint8_t *pcm_in, int pcm_len,
     return out_len;
 }
 
+/* Uplink stays raw PCM */
+int hal_opus_init(const hal_opus_config_t *config)
+{
+    return 0;
+}
+
+hal_opus_mode_t hal_opus_get_mode(void)
+{
+    return HAL_OPUS_MODE_PCM;
+}
+
+int hal_opus_get_frame_bytes(void)
+{
+    return 0;
+}
+
 int ws_send_audio(const uint8_t *data, int len)
 {
     if (mock_error) return -1;
@@ -153,6 +195,11 @@ int hal_button_init(void *callback)
     return 0;
 }
 
+int hal_button_start(int poll_ms)
+{
+    return 0;
+}
+
 void hal_button_deinit(void)
 {
 }
@@ -207,9 +254,10 @@ void reset_mocks(void)
 
 void setUp(void)
 {
-    reset_mocks();
+    /* Wake word mode starts audio in init; count only recording's starts */
     voice_recorder_init();
     voice_recorder_reset_stats();
+    reset_mocks();
 }
 
 void tearDown(void)
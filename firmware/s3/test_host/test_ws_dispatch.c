@@ -0,0 +1,293 @@
+#include "unity.h"
+#include "ws_dispatch.h"
+#include "tts_jitter.h"
+#include <stdio.h>
+#include <string.h>
+
+static const int g_depth[WS_DISPATCH_CLASSES] = { 4, 3 };
+static ws_dispatch_cmd_t g_storage[4 + 3];
+static ws_dispatch_t g_d;
+
+#define ALL (WS_DISPATCH_MASK(WS_DISPATCH_MOTION) | WS_DISPATCH_MASK(WS_DISPATCH_DISPLAY))
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, ws_dispatch_init(&g_d, g_storage, g_depth));
+}
+
+void tearDown(void) {
+}
+
+static int push_servo(int angle, uint32_t now) {
+    ws_dispatch_cmd_t cmd = { .type = WS_MSG_SERVO };
+    strcpy(cmd.u.servo.id, "x");
+    cmd.u.servo.angle = angle;
+    return ws_dispatch_push(&g_d, &cmd, now);
+}
+
+static int push_display(const char *text, uint32_t now) {
+    ws_dispatch_cmd_t cmd = { .type = WS_MSG_DISPLAY };
+    snprintf(cmd.u.display.text, sizeof(cmd.u.display.text), "%s", text);
+    return ws_dispatch_push(&g_d, &cmd, now);
+}
+
+static int push_type(ws_msg_type_t type, uint32_t now) {
+    ws_dispatch_cmd_t cmd = { .type = type };
+    return ws_dispatch_push(&g_d, &cmd, now);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_rejects_bad_args(void) {
+    const int zero[WS_DISPATCH_CLASSES] = { 4, 0 };
+
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_init(NULL, g_storage, g_depth));
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_init(&g_d, NULL, g_depth));
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_init(&g_d, g_storage, zero));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(g_storage), ws_dispatch_storage_size(g_depth));
+}
+
+void test_class_of_types(void) {
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_MOTION, ws_dispatch_class_of(WS_MSG_SERVO));
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_DISPLAY, ws_dispatch_class_of(WS_MSG_DISPLAY));
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_DISPLAY, ws_dispatch_class_of(WS_MSG_STATUS));
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_DISPLAY, ws_dispatch_class_of(WS_MSG_ASR_RESULT));
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_DISPLAY, ws_dispatch_class_of(WS_MSG_BOT_REPLY));
+    TEST_ASSERT_EQUAL_INT(WS_DISPATCH_DISPLAY, ws_dispatch_class_of(WS_MSG_ERROR_MSG));
+
+    /* Inline: end of stream, codec switch, RTT sample, reboot */
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_class_of(WS_MSG_TTS_END));
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_class_of(WS_MSG_HELLO));
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_class_of(WS_MSG_PONG));
+    TEST_ASSERT_EQUAL_INT(-1, ws_dispatch_class_of(WS_MSG_REBOOT));
+    TEST_ASSERT_EQUAL_INT(-1, push_type(WS_MSG_HELLO, 0));
+    TEST_ASSERT_EQUAL_INT(-1, push_type(WS_MSG_TTS_END, 0));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Priority and Order                                           */
+/* ------------------------------------------------------------------ */
+
+void test_pop_highest_priority_first(void) {
+    ws_dispatch_cmd_t out;
+
+    push_display("a", 0);
+    push_servo(10, 0);
+
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_INT(WS_MSG_SERVO, out.type);
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_INT(WS_MSG_DISPLAY, out.type);
+    TEST_ASSERT_FALSE(ws_dispatch_pop(&g_d, ALL, &out));
+}
+
+void test_fifo_within_class(void) {
+    ws_dispatch_cmd_t out;
+
+    push_display("one", 0);
+    push_type(WS_MSG_STATUS, 0);
+    push_display("two", 0);
+
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_STRING("one", out.u.display.text);
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_INT(WS_MSG_STATUS, out.type);
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_STRING("two", out.u.display.text);
+}
+
+void test_mask_selects_worker_classes(void) {
+    const unsigned ui = WS_DISPATCH_MASK(WS_DISPATCH_DISPLAY);
+    ws_dispatch_cmd_t out;
+
+    push_servo(10, 0);
+    push_display("a", 0);
+
+    TEST_ASSERT_EQUAL_INT(1, ws_dispatch_count(&g_d, ui));
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ui, &out));
+    TEST_ASSERT_EQUAL_INT(WS_MSG_DISPLAY, out.type);
+    TEST_ASSERT_FALSE(ws_dispatch_pop(&g_d, ui, &out));
+    TEST_ASSERT_EQUAL_INT(1, ws_dispatch_count(&g_d, ALL));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Full Queues                                                  */
+/* ------------------------------------------------------------------ */
+
+void test_motion_full_drops_oldest(void) {
+    ws_dispatch_queue_stats_t st;
+    ws_dispatch_cmd_t out;
+
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_INT(0, push_servo(i, 0));
+    }
+
+    ws_dispatch_get_queue_stats(&g_d, WS_DISPATCH_MOTION, &st);
+    TEST_ASSERT_EQUAL_INT(4, st.depth);
+    TEST_ASSERT_EQUAL_INT(4, st.high_water);
+    TEST_ASSERT_EQUAL_UINT32(6, st.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dropped);
+
+    /* Newest targets survive, in order */
+    for (int i = 2; i < 6; i++) {
+        TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+        TEST_ASSERT_EQUAL_INT(i, out.u.servo.angle);
+    }
+}
+
+void test_display_full_drops_oldest(void) {
+    ws_dispatch_queue_stats_t st;
+    ws_dispatch_cmd_t out;
+
+    push_display("one", 0);
+    push_display("two", 0);
+    push_display("three", 0);
+    TEST_ASSERT_EQUAL_INT(0, push_display("four", 0));
+
+    ws_dispatch_get_queue_stats(&g_d, WS_DISPATCH_DISPLAY, &st);
+    TEST_ASSERT_EQUAL_INT(3, st.depth);
+    TEST_ASSERT_EQUAL_UINT32(1, st.dropped);
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &out));
+    TEST_ASSERT_EQUAL_STRING("two", out.u.display.text);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Stream Order                                                 */
+/* ------------------------------------------------------------------ */
+
+/* WS task as in ws_client: queued types go to a worker that has not run
+ * yet, inline ones (tts_end) take effect at once; audio frames begin a
+ * stream on their first chunk */
+static tts_jitter_t g_jb;
+static bool g_rx_open;
+
+static void ws_task_message(ws_msg_type_t type) {
+    ws_dispatch_cmd_t cmd = { .type = type };
+    if (ws_dispatch_push(&g_d, &cmd, 0) != 0 && type == WS_MSG_TTS_END) {
+        tts_jitter_end(&g_jb);
+        g_rx_open = false;
+    }
+}
+
+static void ws_task_audio(uint8_t fill, int len) {
+    static uint8_t pcm[48 * 200];
+    if (!g_rx_open) {
+        TEST_ASSERT_EQUAL_INT(0, tts_jitter_begin(&g_jb, 24000));
+        g_rx_open = true;
+    }
+    memset(pcm, fill, len);
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_push(&g_jb, pcm, len));
+}
+
+void test_stream_end_precedes_next_stream_audio(void) {
+    static uint8_t storage[48 * 1000];
+    static uint8_t out[48 * 1000];
+    ws_dispatch_cmd_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(0, tts_jitter_init(&g_jb, storage, sizeof(storage), NULL));
+    g_rx_open = false;
+
+    /* Reply A, its tts_end behind a display update, then reply B at once */
+    ws_task_audio(0xAA, 4800);
+    ws_task_message(WS_MSG_BOT_REPLY);
+    ws_task_message(WS_MSG_TTS_END);
+    ws_task_audio(0xBB, 48 * 150);     /* Past the 120 ms prefill */
+
+    /* The worker has not run: the display update is still queued */
+    TEST_ASSERT_EQUAL_INT(1, ws_dispatch_count(&g_d, ALL));
+
+    /* A plays out alone, then B starts as a stream of its own */
+    TEST_ASSERT_EQUAL_INT(4800, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8(0xAA, out[4799]);
+    TEST_ASSERT_EQUAL_UINT32(1, tts_jitter_stream(&g_jb, NULL));
+    TEST_ASSERT_EQUAL_INT(48 * 150, tts_jitter_pop(&g_jb, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_UINT8(0xBB, out[0]);
+    TEST_ASSERT_EQUAL_UINT32(2, tts_jitter_stream(&g_jb, NULL));
+
+    TEST_ASSERT_TRUE(ws_dispatch_pop(&g_d, ALL, &cmd));
+    TEST_ASSERT_EQUAL_INT(WS_MSG_BOT_REPLY, cmd.type);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Latency Statistics                                           */
+/* ------------------------------------------------------------------ */
+
+void test_done_fills_histogram(void) {
+    ws_dispatch_handler_stats_t st;
+    ws_dispatch_cmd_t out;
+
+    /* 100 servo commands: 98 finish in 300us, 2 in 20ms */
+    for (int i = 0; i < 100; i++) {
+        push_servo(i, 1000);
+        ws_dispatch_pop(&g_d, ALL, &out);
+        uint32_t run = i < 98 ? 300 : 20000;
+        ws_dispatch_done(&g_d, &out, 1100, 1100 + run);
+    }
+
+    ws_dispatch_get_handler_stats(&g_d, WS_DISPATCH_H_SERVO, &st);
+    TEST_ASSERT_EQUAL_UINT32(100, st.count);
+    TEST_ASSERT_EQUAL_UINT32(98, st.hist[1]);       /* 400us: < 500 */
+    TEST_ASSERT_EQUAL_UINT32(2, st.hist[7]);        /* 20.1ms: < 32ms */
+    TEST_ASSERT_EQUAL_UINT32(100, st.wait_max_us);
+    TEST_ASSERT_EQUAL_UINT32(20000, st.run_max_us);
+    TEST_ASSERT_EQUAL_UINT32(20100, st.latency_max_us);
+
+    TEST_ASSERT_EQUAL_UINT32(500, ws_dispatch_percentile_us(&st, 50));
+    TEST_ASSERT_EQUAL_UINT32(500, ws_dispatch_percentile_us(&st, 98));
+    TEST_ASSERT_EQUAL_UINT32(32000, ws_dispatch_percentile_us(&st, 99));
+
+    /* Other handlers untouched */
+    ws_dispatch_get_handler_stats(&g_d, WS_DISPATCH_H_DISPLAY, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.count);
+    TEST_ASSERT_EQUAL_UINT32(0, ws_dispatch_percentile_us(&st, 99));
+}
+
+void test_slow_bucket_reports_max(void) {
+    ws_dispatch_handler_stats_t st;
+    ws_dispatch_cmd_t out;
+
+    /* Timer wrap between push and done is still a short latency */
+    push_display("slow", 0xFFFFFF00u);
+    ws_dispatch_pop(&g_d, ALL, &out);
+    ws_dispatch_done(&g_d, &out, 0x100, 0x100 + 90000);
+
+    ws_dispatch_get_handler_stats(&g_d, WS_DISPATCH_H_DISPLAY, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.hist[WS_DISPATCH_BUCKETS - 1]);
+    TEST_ASSERT_EQUAL_UINT32(0x200, st.wait_max_us);
+    TEST_ASSERT_EQUAL_UINT32(90000 + 0x200, ws_dispatch_percentile_us(&st, 99));
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_rejects_bad_args);
+    RUN_TEST(test_class_of_types);
+
+    /* Priority and order */
+    RUN_TEST(test_pop_highest_priority_first);
+    RUN_TEST(test_fifo_within_class);
+    RUN_TEST(test_mask_selects_worker_classes);
+
+    /* Full queues */
+    RUN_TEST(test_motion_full_drops_oldest);
+    RUN_TEST(test_display_full_drops_oldest);
+
+    /* Stream order */
+    RUN_TEST(test_stream_end_precedes_next_stream_audio);
+
+    /* Latency statistics */
+    RUN_TEST(test_done_fills_histogram);
+    RUN_TEST(test_slow_bucket_reports_max);
+
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+#include "unity.h"
+#include "ws_json.h"
+#include "cJSON.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+static ws_json_t g_js;
+
+static int parse(const char *json) {
+    return ws_json_parse(&g_js, json, (int)strlen(json));
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    memset(&g_js, 0, sizeof(g_js));
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Tokenizer                                                    */
+/* ------------------------------------------------------------------ */
+
+void test_tokens_of_nested_message(void) {
+    const char *json = "{\"type\":\"hello\",\"data\":{\"tts\":[\"opus\",\"pcm\"],\"rate\":24000},\"code\":0}";
+
+    /* root, type, "hello", data, {}, tts, [], 2 strings, rate, 24000, code, 0 */
+    TEST_ASSERT_EQUAL_INT(13, parse(json));
+    TEST_ASSERT_EQUAL_INT(WS_JSON_OBJECT, ws_json_type(&g_js, 0));
+
+    int data = ws_json_find(&g_js, 0, "data");
+    TEST_ASSERT_EQUAL_INT(WS_JSON_OBJECT, ws_json_type(&g_js, data));
+    TEST_ASSERT_EQUAL_INT(WS_JSON_ARRAY, ws_json_type(&g_js, ws_json_find(&g_js, data, "tts")));
+    TEST_ASSERT_EQUAL_INT(24000, ws_json_get_int(&g_js, ws_json_find(&g_js, data, "rate"), -1));
+
+    /* Lookup skips the whole data subtree to reach code */
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_int(&g_js, ws_json_find(&g_js, 0, "code"), -1));
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_find(&g_js, 0, "rate"));
+}
+
+void test_keys_are_case_insensitive_first_match(void) {
+    char buf[8];
+
+    TEST_ASSERT_GREATER_THAN(0, parse("{\"Angle\":45,\"angle\":90,\"ID\":\"y\"}"));
+    TEST_ASSERT_EQUAL_INT(45, ws_json_get_int(&g_js, ws_json_find(&g_js, 0, "angle"), 0));
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_str(&g_js, ws_json_find(&g_js, 0, "id"), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("y", buf);
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_find(&g_js, 0, "ang"));
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_find(&g_js, 0, "angles"));
+}
+
+void test_string_unescape_and_truncation(void) {
+    char buf[32];
+    char small[4];
+
+    TEST_ASSERT_GREATER_THAN(0, parse("{\"t\":\"a\\\"b\\\\c\\/\\n\\u00e9\\u4f60\\ud83d\\ude00\"}"));
+    int t = ws_json_find(&g_js, 0, "t");
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_str(&g_js, t, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("a\"b\\c/\n\xC3\xA9\xE4\xBD\xA0\xF0\x9F\x98\x80", buf);
+
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_str(&g_js, t, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("a\"b", small);
+
+    /* Escaped key */
+    TEST_ASSERT_GREATER_THAN(0, parse("{\"ty\\u0070e\":\"servo\"}"));
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_str(&g_js, ws_json_find(&g_js, 0, "type"), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("servo", buf);
+}
+
+void test_type_mismatch_returns_defaults(void) {
+    char buf[8] = "xx";
+
+    TEST_ASSERT_GREATER_THAN(0, parse("{\"n\":\"12\",\"s\":12,\"a\":[]}"));
+    TEST_ASSERT_EQUAL_INT(7, ws_json_get_int(&g_js, ws_json_find(&g_js, 0, "n"), 7));
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_get_str(&g_js, ws_json_find(&g_js, 0, "s"), buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_find(&g_js, ws_json_find(&g_js, 0, "a"), "x"));
+    TEST_ASSERT_EQUAL_INT(7, ws_json_get_int(&g_js, -1, 7));
+}
+
+void test_numbers_convert_like_valueint(void) {
+    TEST_ASSERT_GREATER_THAN(0, parse("[1.9,-1.9,1e3,3000000000,-3000000000,-0]"));
+    TEST_ASSERT_EQUAL_INT(1, ws_json_get_int(&g_js, 1, 0));
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_get_int(&g_js, 2, 0));
+    TEST_ASSERT_EQUAL_INT(1000, ws_json_get_int(&g_js, 3, 0));
+    TEST_ASSERT_EQUAL_INT(INT_MAX, ws_json_get_int(&g_js, 4, 0));
+    TEST_ASSERT_EQUAL_INT(INT_MIN, ws_json_get_int(&g_js, 5, 0));
+    TEST_ASSERT_EQUAL_INT(0, ws_json_get_int(&g_js, 6, 7));
+}
+
+void test_out_of_tokens_is_reported(void) {
+    char json[4 * WS_JSON_MAX_TOKENS];
+    int n = 0;
+
+    json[n++] = '[';
+    for (int i = 0; i < WS_JSON_MAX_TOKENS; i++) {
+        n += sprintf(json + n, i ? ",%d" : "%d", i % 10);
+    }
+    json[n++] = ']';
+    json[n] = '\0';
+
+    TEST_ASSERT_EQUAL_INT(WS_JSON_ERR_TOKENS, parse(json));
+    TEST_ASSERT_EQUAL_INT(-1, ws_json_parse(&g_js, NULL, 0));
+
+    /* One token fewer fits */
+    strcpy(json + n - 3, "]");
+    TEST_ASSERT_EQUAL_INT(WS_JSON_MAX_TOKENS, parse(json));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Same acceptance as cJSON_Parse                               */
+/* ------------------------------------------------------------------ */
+
+void test_accepts_and_rejects_like_cjson(void) {
+    static const char *cases[] = {
+        "{}", "[]", "{\"a\":{}}", "{\"a\":[[],{}]}", " \t\r\n{ \"a\" : 1 } ",
+        "\xEF\xBB\xBF{\"a\":1}", "\xEF\xBB\xBF", "{\"a\":1} trailing", "{\"a\":1}}",
+        "", "   ", "{", "}", "{\"a\"}", "{\"a\":}", "{\"a\":1,}", "[1,]", "[,1]", "{,}",
+        "{\"a\" 1}", "{a:1}", "{'a':1}", "{\"a\":1 \"b\":2}", "[1 2]", "{\"a\":[}]",
+        "null", "true", "false", "nul", "tru", "truex", "[truex]", "[nullnull]",
+        "0", "-", "-0", "+1", "[+1]", ".5", "[1.]", "[01]", "[1e]", "[1e+]", "[1-2]",
+        "[0x1A]", "[inf]", "[1.5e3]", "[-1e-2]",
+        "\"abc\"", "\"abc", "\"a\\\"", "\"\\x\"", "\"\\u12\"", "\"\\u12g4\"", "\"\\uZZZZ\"",
+        "\"\\ud83d\"", "\"\\ud83dx\"", "\"\\ud83d\\u0041\"", "\"\\ude00\"", "\"\\ud83d\\ude00\"",
+        "\"tab\tin\"", "\"\\", "[\"a\\\\\"]",
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        cJSON *root = cJSON_Parse(cases[i]);
+        int ours = parse(cases[i]);
+        char msg[96];
+        snprintf(msg, sizeof(msg), "case %u: %s", (unsigned)i, cases[i]);
+        TEST_ASSERT_EQUAL_MESSAGE(root != NULL, ours > 0, msg);
+        cJSON_Delete(root);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Tokenizer */
+    RUN_TEST(test_tokens_of_nested_message);
+    RUN_TEST(test_keys_are_case_insensitive_first_match);
+    RUN_TEST(test_string_unescape_and_truncation);
+    RUN_TEST(test_type_mismatch_returns_defaults);
+    RUN_TEST(test_numbers_convert_like_valueint);
+    RUN_TEST(test_out_of_tokens_is_reported);
+
+    /* cJSON compatibility */
+    RUN_TEST(test_accepts_and_rejects_like_cjson);
+
+    return UNITY_END();
+}
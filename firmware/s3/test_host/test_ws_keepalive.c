@@ -0,0 +1,257 @@
+#include "unity.h"
+#include "ws_keepalive.h"
+#include <string.h>
+
+static const ws_keepalive_config_t g_cfg = {
+    .interval_ms = 10000,
+    .timeout_ms = 5000,
+    .max_missed = 3,
+    .backoff_min_ms = 1000,
+    .backoff_max_ms = 30000,
+};
+static ws_keepalive_t g_ka;
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, ws_keepalive_init(&g_ka, &g_cfg, 42));
+    ws_keepalive_on_connected(&g_ka, 0);
+}
+
+void tearDown(void) {
+}
+
+/* Ping at t and answer it after rtt ms; returns the next ping time */
+static uint32_t ping_pong(uint32_t t, int rtt) {
+    uint32_t seq = 0;
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_PING, ws_keepalive_poll(&g_ka, t, &seq));
+    TEST_ASSERT_EQUAL_INT(rtt, ws_keepalive_on_pong(&g_ka, seq, t + rtt));
+    return t + g_cfg.interval_ms;
+}
+
+/* Ping at t and let it time out; returns the poll result at the deadline */
+static ws_keepalive_action_t ping_lost(uint32_t t) {
+    uint32_t seq;
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_PING, ws_keepalive_poll(&g_ka, t, &seq));
+    return ws_keepalive_poll(&g_ka, t + g_cfg.timeout_ms, &seq);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration and Schedule                                   */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_config(void) {
+    ws_keepalive_config_t bad = g_cfg;
+
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_init(NULL, &g_cfg, 1));
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_init(&g_ka, NULL, 1));
+    bad.timeout_ms = bad.interval_ms + 1;
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_init(&g_ka, &bad, 1));
+    bad = g_cfg;
+    bad.max_missed = 0;
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_init(&g_ka, &bad, 1));
+    bad = g_cfg;
+    bad.backoff_max_ms = bad.backoff_min_ms - 1;
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_init(&g_ka, &bad, 1));
+}
+
+void test_first_ping_after_one_interval(void) {
+    uint32_t seq = 0;
+
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ws_keepalive_poll(&g_ka, 9999, &seq));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_PING, ws_keepalive_poll(&g_ka, 10000, &seq));
+    TEST_ASSERT_EQUAL_UINT32(1, seq);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ws_keepalive_poll(&g_ka, 10001, &seq));
+}
+
+void test_no_ping_while_disconnected(void) {
+    uint32_t seq;
+
+    ws_keepalive_on_disconnected(&g_ka);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ws_keepalive_poll(&g_ka, 50000, &seq));
+}
+
+void test_schedule_survives_clock_wrap(void) {
+    uint32_t seq;
+    uint32_t t0 = 0xFFFFF000u;
+
+    ws_keepalive_on_connected(&g_ka, t0);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ws_keepalive_poll(&g_ka, t0 + 5000, &seq));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_PING, ws_keepalive_poll(&g_ka, t0 + 10000, &seq));
+    TEST_ASSERT_EQUAL_INT(30, ws_keepalive_on_pong(&g_ka, seq, t0 + 10030));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: RTT Statistics                                               */
+/* ------------------------------------------------------------------ */
+
+void test_rtt_ewma_follows_rfc6298_gains(void) {
+    ws_keepalive_stats_t st;
+    uint32_t t = 10000;
+
+    t = ping_pong(t, 100);
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_INT(100, st.rtt_ewma_ms);
+    TEST_ASSERT_EQUAL_INT(50, st.rtt_var_ms);
+
+    /* srtt = 7/8 * 100 + 1/8 * 180 = 110; var = 3/4 * 50 + 1/4 * 80 = 57.5 */
+    ping_pong(t, 180);
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_INT(110, st.rtt_ewma_ms);
+    TEST_ASSERT_INT_WITHIN(1, 58, st.rtt_var_ms);
+    TEST_ASSERT_EQUAL_INT(180, st.rtt_last_ms);
+    TEST_ASSERT_EQUAL_INT(100, st.rtt_min_ms);
+    TEST_ASSERT_EQUAL_INT(180, st.rtt_max_ms);
+}
+
+void test_percentiles_over_window(void) {
+    ws_keepalive_stats_t st;
+    uint32_t t = 10000;
+
+    /* 1..100 ms in shuffled order; percentiles cover only the last 64 */
+    for (int i = 0; i < 100; i++) {
+        t = ping_pong(t, 1 + (i * 37) % 100);
+    }
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_SAMPLES, st.samples);
+    TEST_ASSERT_EQUAL_UINT32(100, st.pongs);
+    TEST_ASSERT_EQUAL_INT(1, st.rtt_min_ms);
+    TEST_ASSERT_EQUAL_INT(100, st.rtt_max_ms);
+    TEST_ASSERT_TRUE(st.rtt_p50_ms <= st.rtt_p90_ms);
+    TEST_ASSERT_TRUE(st.rtt_p90_ms <= st.rtt_p99_ms);
+    TEST_ASSERT_TRUE(st.rtt_p99_ms <= 100);
+}
+
+void test_percentiles_exact_small_window(void) {
+    ws_keepalive_stats_t st;
+    const int rtt[] = { 50, 10, 40, 20, 30, 100, 60, 90, 70, 80 };
+    uint32_t t = 10000;
+
+    for (int i = 0; i < 10; i++) {
+        t = ping_pong(t, rtt[i]);
+    }
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_INT(50, st.rtt_p50_ms);
+    TEST_ASSERT_EQUAL_INT(90, st.rtt_p90_ms);
+    TEST_ASSERT_EQUAL_INT(100, st.rtt_p99_ms);
+}
+
+void test_stale_pong_is_ignored(void) {
+    ws_keepalive_stats_t st;
+    uint32_t seq;
+
+    ws_keepalive_poll(&g_ka, 10000, &seq);
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_on_pong(&g_ka, seq + 7, 10020));
+    TEST_ASSERT_EQUAL_INT(30, ws_keepalive_on_pong(&g_ka, seq, 10030));
+    TEST_ASSERT_EQUAL_INT(-1, ws_keepalive_on_pong(&g_ka, seq, 10040));
+
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.pongs);
+    TEST_ASSERT_EQUAL_UINT32(2, st.late);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Dead Link Detection                                          */
+/* ------------------------------------------------------------------ */
+
+void test_missed_pongs_declare_link_dead(void) {
+    ws_keepalive_stats_t st;
+    uint32_t t = ping_pong(10000, 20);
+
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t + 10000));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_DEAD, ping_lost(t + 20000));
+
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_UINT32(3, st.missed);
+    TEST_ASSERT_EQUAL_UINT32(1, st.dead);
+
+    /* Dead until the caller reconnects */
+    uint32_t seq;
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ws_keepalive_poll(&g_ka, t + 60000, &seq));
+}
+
+void test_pong_clears_missed_run(void) {
+    uint32_t t = ping_pong(10000, 20);
+
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t + 10000));
+    t = ping_pong(t + 20000, 20);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t));
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t + 10000));
+}
+
+void test_server_without_pong_is_never_dead(void) {
+    ws_keepalive_stats_t st;
+    uint32_t t = 10000;
+
+    for (int i = 0; i < 10; i++, t += 10000) {
+        TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_IDLE, ping_lost(t));
+    }
+    ws_keepalive_get_stats(&g_ka, &st);
+    TEST_ASSERT_EQUAL_UINT32(10, st.pings);
+    TEST_ASSERT_EQUAL_UINT32(0, st.missed);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Reconnect Backoff                                            */
+/* ------------------------------------------------------------------ */
+
+void test_backoff_doubles_within_jitter_and_caps(void) {
+    uint32_t base = g_cfg.backoff_min_ms;
+
+    for (int i = 0; i < 10; i++) {
+        uint32_t d = ws_keepalive_next_backoff(&g_ka);
+        uint32_t hi = base < g_cfg.backoff_max_ms ? base : g_cfg.backoff_max_ms;
+        TEST_ASSERT_TRUE(d >= hi / 2);
+        TEST_ASSERT_TRUE(d <= hi);
+        base *= 2;
+    }
+}
+
+void test_backoff_resets_after_stable_session(void) {
+    uint32_t seq;
+
+    for (int i = 0; i < 6; i++) {
+        ws_keepalive_next_backoff(&g_ka);
+    }
+    TEST_ASSERT_TRUE(ws_keepalive_next_backoff(&g_ka) >= g_cfg.backoff_max_ms / 2);
+
+    /* Reconnected and survived to the first ping */
+    ws_keepalive_on_connected(&g_ka, 100000);
+    TEST_ASSERT_EQUAL_INT(WS_KEEPALIVE_PING, ws_keepalive_poll(&g_ka, 110000, &seq));
+    TEST_ASSERT_TRUE(ws_keepalive_next_backoff(&g_ka) <= g_cfg.backoff_min_ms);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Configuration and schedule */
+    RUN_TEST(test_init_invalid_config);
+    RUN_TEST(test_first_ping_after_one_interval);
+    RUN_TEST(test_no_ping_while_disconnected);
+    RUN_TEST(test_schedule_survives_clock_wrap);
+
+    /* RTT statistics */
+    RUN_TEST(test_rtt_ewma_follows_rfc6298_gains);
+    RUN_TEST(test_percentiles_over_window);
+    RUN_TEST(test_percentiles_exact_small_window);
+    RUN_TEST(test_stale_pong_is_ignored);
+
+    /* Dead link detection */
+    RUN_TEST(test_missed_pongs_declare_link_dead);
+    RUN_TEST(test_pong_clears_missed_run);
+    RUN_TEST(test_server_without_pong_is_never_dead);
+
+    /* Reconnect backoff */
+    RUN_TEST(test_backoff_doubles_within_jitter_and_caps);
+    RUN_TEST(test_backoff_resets_after_stable_session);
+
+    return UNITY_END();
+}
@@ -0,0 +1,377 @@
+#include "unity.h"
+#include "ws_reasm.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Slot a bit above the WS client's 16KB receive buffer */
+#define SLOT_SIZE       20000
+#define SLOT_COUNT      2
+#define RX_BUF          16384           /* esp_websocket_client buffer_size */
+#define OP_PING         0x9
+
+static uint8_t g_storage[SLOT_COUNT * (SLOT_SIZE + 1)];
+static ws_reasm_t g_r;
+
+/* What the receiver saw */
+#define MAX_RECEIVED    4
+static uint8_t g_msg_data[MAX_RECEIVED][SLOT_SIZE + 1];
+static int g_msg_len[MAX_RECEIVED];
+static uint8_t g_msg_op[MAX_RECEIVED];
+static int g_msg_count;
+static bool g_hold;                     /* Keep slots instead of releasing */
+static ws_reasm_msg_t *g_held[SLOT_COUNT + 1];
+static int g_held_count;
+
+static uint8_t g_stream[SLOT_SIZE * 4];
+static int g_stream_len;
+static int g_stream_last;
+static int g_stream_odd_chunks;
+
+/* ------------------------------------------------------------------ */
+/* Receiver callbacks                                                 */
+/* ------------------------------------------------------------------ */
+
+static void on_message(ws_reasm_msg_t *msg, void *ctx) {
+    (void)ctx;
+    int i = g_msg_count % MAX_RECEIVED;
+
+    TEST_ASSERT_EQUAL_UINT8('\0', msg->data[msg->len]);
+    memcpy(g_msg_data[i], msg->data, msg->len + 1);
+    g_msg_len[i] = msg->len;
+    g_msg_op[i] = msg->op;
+    g_msg_count++;
+
+    if (g_hold) {
+        g_held[g_held_count++] = msg;
+    } else {
+        ws_reasm_release(&g_r, msg);
+    }
+}
+
+static void on_stream(const uint8_t *data, int len, bool last, void *ctx) {
+    (void)ctx;
+    TEST_ASSERT_TRUE(len >= 0);
+    if (len % 2) {
+        g_stream_odd_chunks++;
+    }
+    memcpy(&g_stream[g_stream_len], data, len);
+    g_stream_len += len;
+    g_stream_last += last;
+}
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, ws_reasm_init(&g_r, g_storage, SLOT_SIZE, SLOT_COUNT,
+                                           on_message, on_stream, 2, NULL));
+    g_msg_count = 0;
+    g_hold = false;
+    g_held_count = 0;
+    g_stream_len = 0;
+    g_stream_last = 0;
+    g_stream_odd_chunks = 0;
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------------------------ */
+/* Fragmenter: message -> frames (fin / CONT) -> RX-buffer chunks     */
+/* ------------------------------------------------------------------ */
+
+/* Deterministic LCG so runs are identical on every host */
+static uint32_t g_seed;
+static int rand_below(int n) {
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return n > 0 ? (int)((g_seed >> 8) % (uint32_t)n) : 0;
+}
+
+static void fill_random(uint8_t *buf, int len) {
+    for (int i = 0; i < len; i++) buf[i] = (uint8_t)rand_below(256);
+}
+
+/* Feed one message the way esp_websocket_client reports it; returns the
+ * result of the final event */
+static int feed_fragmented(uint8_t op, const uint8_t *msg, int len, int max_frames, int max_chunk) {
+    int frames = 1 + rand_below(max_frames);
+    int pos = 0;
+    int rc = 0;
+
+    for (int f = 0; f < frames; f++) {
+        bool fin = (f == frames - 1);
+        int frame_len = fin ? len - pos : rand_below(len - pos + 1);
+        uint8_t frame_op = (f == 0) ? op : WS_REASM_OP_CONT;
+
+        /* A ping may arrive between frames of a fragmented message */
+        if (f > 0 && rand_below(4) == 0) {
+            TEST_ASSERT_EQUAL_INT(0, ws_reasm_feed(&g_r, OP_PING, true, (const uint8_t *)"hi", 2, 2, 0));
+        }
+
+        int off = 0;
+        do {
+            int chunk = 1 + rand_below(max_chunk);
+            if (chunk > frame_len - off) chunk = frame_len - off;
+            rc = ws_reasm_feed(&g_r, frame_op, fin, msg + pos + off, chunk, frame_len, off);
+            off += chunk;
+        } while (off < frame_len);
+        pos += frame_len;
+    }
+    return rc;
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_args(void) {
+    ws_reasm_t r;
+
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(NULL, g_storage, SLOT_SIZE, 1, on_message, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(&r, NULL, SLOT_SIZE, 1, on_message, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(&r, g_storage, SLOT_SIZE, 1, NULL, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(&r, g_storage, SLOT_SIZE, 0, on_message, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(&r, g_storage, SLOT_SIZE, WS_REASM_MAX_SLOTS + 1,
+                                            on_message, NULL, 2, NULL));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_init(&r, g_storage, SLOT_SIZE, 1, on_message, NULL, 3, NULL));
+    TEST_ASSERT_EQUAL_INT(SLOT_COUNT * (SLOT_SIZE + 1), ws_reasm_storage_size(SLOT_SIZE, SLOT_COUNT));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Buffered Messages                                            */
+/* ------------------------------------------------------------------ */
+
+void test_single_event_text_is_nul_terminated(void) {
+    const char *json = "{\"type\":\"tts_end\"}";
+    int len = (int)strlen(json);
+
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, (const uint8_t *)json,
+                                           len, len, 0));
+    TEST_ASSERT_EQUAL_INT(1, g_msg_count);
+    TEST_ASSERT_EQUAL_UINT8(WS_REASM_OP_TEXT, g_msg_op[0]);
+    TEST_ASSERT_EQUAL_STRING(json, (const char *)g_msg_data[0]);
+}
+
+void test_randomized_fragmentation_round_trips(void) {
+    static uint8_t msg[SLOT_SIZE];
+    ws_reasm_stats_t st;
+
+    g_seed = 0xf4a6;
+    for (int i = 0; i < 2000; i++) {
+        int len = rand_below(SLOT_SIZE + 1);
+        uint8_t op = rand_below(2) ? WS_REASM_OP_TEXT : WS_REASM_OP_BINARY;
+        fill_random(msg, len);
+
+        TEST_ASSERT_EQUAL_INT(1, feed_fragmented(op, msg, len, 4, RX_BUF));
+        TEST_ASSERT_EQUAL_INT(i + 1, g_msg_count);
+        TEST_ASSERT_EQUAL_UINT8(op, g_msg_op[i % MAX_RECEIVED]);
+        TEST_ASSERT_EQUAL_INT(len, g_msg_len[i % MAX_RECEIVED]);
+        TEST_ASSERT_EQUAL_MEMORY(msg, g_msg_data[i % MAX_RECEIVED], len);
+    }
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(2000, st.messages);
+    TEST_ASSERT_TRUE(st.fragmented > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, st.protocol_errors);
+    TEST_ASSERT_EQUAL_UINT32(0, st.no_slot);
+}
+
+void test_oversize_is_dropped_and_next_message_ok(void) {
+    static uint8_t msg[SLOT_SIZE + 100];
+    ws_reasm_stats_t st;
+
+    g_seed = 7;
+    fill_random(msg, sizeof(msg));
+    TEST_ASSERT_EQUAL_INT(-1, feed_fragmented(WS_REASM_OP_TEXT, msg, sizeof(msg), 3, RX_BUF));
+    TEST_ASSERT_EQUAL_INT(0, g_msg_count);
+
+    TEST_ASSERT_EQUAL_INT(1, feed_fragmented(WS_REASM_OP_TEXT, msg, 100, 3, 16));
+    TEST_ASSERT_EQUAL_MEMORY(msg, g_msg_data[0], 100);
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.oversize);
+}
+
+void test_pool_exhaustion_drops_until_release(void) {
+    const uint8_t text[] = "{}";
+    ws_reasm_stats_t st;
+
+    g_hold = true;
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text, 2, 2, 0));
+    }
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text, 2, 2, 0));
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.no_slot);
+
+    /* Receiver hands one back (e.g. from another task) */
+    ws_reasm_release(&g_r, g_held[0]);
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text, 2, 2, 0));
+    TEST_ASSERT_EQUAL_INT(SLOT_COUNT + 1, g_msg_count);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Protocol Errors                                              */
+/* ------------------------------------------------------------------ */
+
+void test_continuation_without_start_is_rejected(void) {
+    const uint8_t text[] = "abc";
+    ws_reasm_stats_t st;
+
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_feed(&g_r, WS_REASM_OP_CONT, true, text, 3, 3, 0));
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text, 3, 3, 0));
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.protocol_errors);
+    TEST_ASSERT_EQUAL_INT(1, g_msg_count);
+}
+
+void test_unfinished_message_is_replaced(void) {
+    const uint8_t text[] = "abcdef";
+    ws_reasm_stats_t st;
+
+    /* First frame without fin, then a new message instead of CONT */
+    TEST_ASSERT_EQUAL_INT(0, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, false, text, 3, 3, 0));
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text + 3, 3, 3, 0));
+    TEST_ASSERT_EQUAL_STRING("def", (const char *)g_msg_data[0]);
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.protocol_errors);
+
+    /* The abandoned message's slot was returned */
+    for (int i = 0; i < SLOT_COUNT * 2; i++) {
+        TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_TEXT, true, text, 6, 6, 0));
+    }
+}
+
+void test_offset_gap_is_rejected(void) {
+    const uint8_t data[8] = {0};
+    ws_reasm_stats_t st;
+
+    TEST_ASSERT_EQUAL_INT(0, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, data, 4, 8, 0));
+    TEST_ASSERT_EQUAL_INT(-1, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, data, 2, 8, 6));
+    TEST_ASSERT_EQUAL_INT(0, g_msg_count);
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.protocol_errors);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Streamed Binary                                              */
+/* ------------------------------------------------------------------ */
+
+void test_streamed_binary_is_sample_aligned(void) {
+    static uint8_t msg[SLOT_SIZE * 3];
+    ws_reasm_stats_t st;
+
+    ws_reasm_set_stream_binary(&g_r, true);
+    g_seed = 0xb1a5;
+    for (int i = 0; i < 300; i++) {
+        /* Larger than a slot: streaming needs no buffer */
+        int len = 2 * rand_below(SLOT_SIZE * 3 / 2 + 1);
+        fill_random(msg, len);
+        g_stream_len = 0;
+        g_stream_last = 0;
+
+        /* Odd chunk sizes split samples across events */
+        TEST_ASSERT_EQUAL_INT(1, feed_fragmented(WS_REASM_OP_BINARY, msg, len, 4, 997));
+        TEST_ASSERT_EQUAL_INT(len, g_stream_len);
+        TEST_ASSERT_EQUAL_MEMORY(msg, g_stream, len);
+        TEST_ASSERT_EQUAL_INT(1, g_stream_last);
+    }
+    TEST_ASSERT_EQUAL_INT(0, g_stream_odd_chunks);
+    TEST_ASSERT_EQUAL_INT(0, g_msg_count);
+
+    ws_reasm_get_stats(&g_r, &st);
+    TEST_ASSERT_EQUAL_UINT32(300, st.messages);
+    TEST_ASSERT_EQUAL_UINT32(0, st.oversize);
+}
+
+void test_streamed_odd_tail_does_not_shift_next_message(void) {
+    const uint8_t odd[5] = {1, 2, 3, 4, 5};
+    const uint8_t even[4] = {6, 7, 8, 9};
+
+    ws_reasm_set_stream_binary(&g_r, true);
+    TEST_ASSERT_EQUAL_INT(0, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, odd, 3, 5, 0));
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, odd + 3, 2, 5, 3));
+    TEST_ASSERT_EQUAL_INT(4, g_stream_len);    /* Trailing odd byte dropped */
+
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, even, 4, 4, 0));
+    TEST_ASSERT_EQUAL_INT(8, g_stream_len);
+    TEST_ASSERT_EQUAL_MEMORY(even, &g_stream[4], 4);
+    TEST_ASSERT_EQUAL_INT(0, g_stream_odd_chunks);
+}
+
+void test_text_is_buffered_while_binary_streams(void) {
+    const char *json = "{\"type\":\"tts_start\"}";
+    int len = (int)strlen(json);
+
+    ws_reasm_set_stream_binary(&g_r, true);
+    g_seed = 3;
+    TEST_ASSERT_EQUAL_INT(1, feed_fragmented(WS_REASM_OP_TEXT, (const uint8_t *)json, len, 3, 5));
+    TEST_ASSERT_EQUAL_STRING(json, (const char *)g_msg_data[0]);
+    TEST_ASSERT_EQUAL_INT(0, g_stream_len);
+}
+
+void test_stream_tag_strips_header_and_buffers_other_channels(void) {
+    static uint8_t audio[2 + 4000];
+    const uint8_t ctl[] = { 0x02, 0x00, 0x06, 0x00, 0x00 };
+
+    ws_reasm_set_stream_binary(&g_r, true);
+    ws_reasm_set_stream_tag(&g_r, 0x01, 2);
+    g_seed = 0x7a6;
+
+    /* Audio channel: streamed without its 2-byte header, still aligned */
+    audio[0] = 0x01;
+    audio[1] = 0x00;
+    fill_random(audio + 2, sizeof(audio) - 2);
+    TEST_ASSERT_EQUAL_INT(1, feed_fragmented(WS_REASM_OP_BINARY, audio, sizeof(audio), 3, 333));
+    TEST_ASSERT_EQUAL_INT(sizeof(audio) - 2, g_stream_len);
+    TEST_ASSERT_EQUAL_MEMORY(audio + 2, g_stream, sizeof(audio) - 2);
+    TEST_ASSERT_EQUAL_INT(0, g_stream_odd_chunks);
+
+    /* Any other first byte: buffered whole, header included */
+    TEST_ASSERT_EQUAL_INT(1, feed_fragmented(WS_REASM_OP_BINARY, ctl, sizeof(ctl), 2, 2));
+    TEST_ASSERT_EQUAL_INT(1, g_msg_count);
+    TEST_ASSERT_EQUAL_INT(sizeof(ctl), g_msg_len[0]);
+    TEST_ASSERT_EQUAL_MEMORY(ctl, g_msg_data[0], sizeof(ctl));
+    TEST_ASSERT_EQUAL_INT(sizeof(audio) - 2, g_stream_len);
+
+    /* Untagged again: everything streams as-is */
+    ws_reasm_set_stream_tag(&g_r, -1, 0);
+    g_stream_len = 0;
+    TEST_ASSERT_EQUAL_INT(1, ws_reasm_feed(&g_r, WS_REASM_OP_BINARY, true, ctl, 4, 4, 0));
+    TEST_ASSERT_EQUAL_INT(4, g_stream_len);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_invalid_args);
+
+    /* Buffered messages */
+    RUN_TEST(test_single_event_text_is_nul_terminated);
+    RUN_TEST(test_randomized_fragmentation_round_trips);
+    RUN_TEST(test_oversize_is_dropped_and_next_message_ok);
+    RUN_TEST(test_pool_exhaustion_drops_until_release);
+
+    /* Protocol errors */
+    RUN_TEST(test_continuation_without_start_is_rejected);
+    RUN_TEST(test_unfinished_message_is_replaced);
+    RUN_TEST(test_offset_gap_is_rejected);
+
+    /* Streamed binary */
+    RUN_TEST(test_streamed_binary_is_sample_aligned);
+    RUN_TEST(test_streamed_odd_tail_does_not_shift_next_message);
+    RUN_TEST(test_text_is_buffered_while_binary_streams);
+    RUN_TEST(test_stream_tag_strips_header_and_buffers_other_channels);
+
+    return UNITY_END();
+}
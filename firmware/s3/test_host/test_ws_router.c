@@ -1,5 +1,7 @@
 #include "unity.h"
 #include "ws_router.h"
+#include "ws_json.h"
+#include <stdio.h>
 #include <string.h>
 
 /* ------------------------------------------------------------------ */
@@ -15,6 +17,8 @@ static bool asr_result_called = false;
 static bool bot_reply_called = false;
 static bool tts_end_called = false;
 static bool error_called = false;
+static bool hello_called = false;
+static bool pong_called = false;
 
 static ws_servo_cmd_t last_servo;
 static ws_display_cmd_t last_display;
@@ -23,6 +27,8 @@ static ws_capture_cmd_t last_capture;
 static ws_asr_result_cmd_t last_asr_result;
 static ws_bot_reply_cmd_t last_bot_reply;
 static ws_error_cmd_t last_error;
+static ws_hello_cmd_t last_hello;
+static ws_pong_cmd_t last_pong;
 
 void mock_servo_handler(const ws_servo_cmd_t *cmd) {
     servo_called = true;
@@ -67,6 +73,16 @@ void mock_error_handler(const ws_error_cmd_t *cmd) {
     last_error = *cmd;
 }
 
+void mock_hello_handler(const ws_hello_cmd_t *cmd) {
+    hello_called = true;
+    last_hello = *cmd;
+}
+
+void mock_pong_handler(const ws_pong_cmd_t *cmd) {
+    pong_called = true;
+    last_pong = *cmd;
+}
+
 void reset_mocks(void) {
     servo_called = false;
     display_called = false;
@@ -77,6 +93,8 @@ void reset_mocks(void) {
     bot_reply_called = false;
     tts_end_called = false;
     error_called = false;
+    hello_called = false;
+    pong_called = false;
     memset(&last_servo, 0, sizeof(last_servo));
     memset(&last_display, 0, sizeof(last_display));
     memset(&last_status, 0, sizeof(last_status));
@@ -84,6 +102,8 @@ void reset_mocks(void) {
     memset(&last_asr_result, 0, sizeof(last_asr_result));
     memset(&last_bot_reply, 0, sizeof(last_bot_reply));
     memset(&last_error, 0, sizeof(last_error));
+    memset(&last_hello, 0, sizeof(last_hello));
+    memset(&last_pong, 0, sizeof(last_pong));
 }
 
 /* ------------------------------------------------------------------ */
@@ -103,6 +123,8 @@ void setUp(void) {
         .on_bot_reply  = mock_bot_reply_handler,
         .on_tts_end    = mock_tts_end_handler,
         .on_error      = mock_error_handler,
+        .on_hello      = mock_hello_handler,
+        .on_pong       = mock_pong_handler,
     };
     ws_router_init(&router);
 }
@@ -115,14 +137,15 @@ void tearDown(void) {
 /* ------------------------------------------------------------------ */
 
 void test_route_servo_message_v2(void) {
-    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"x\":90,\"y\":45}}";
+    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"y\",\"angle\":45,\"time\":500}}";
 
     ws_msg_type_t type = ws_route_message(json);
 
     TEST_ASSERT_EQUAL(WS_MSG_SERVO, type);
     TEST_ASSERT_TRUE(servo_called);
-    TEST_ASSERT_EQUAL_INT(90, last_servo.x);
-    TEST_ASSERT_EQUAL_INT(45, last_servo.y);
+    TEST_ASSERT_EQUAL_STRING("y", last_servo.id);
+    TEST_ASSERT_EQUAL_INT(45, last_servo.angle);
+    TEST_ASSERT_EQUAL_INT(500, last_servo.time_ms);
 }
 
 void test_route_display_message_v2(void) {
@@ -219,6 +242,27 @@ void test_route_reboot_message_v2(void) {
     TEST_ASSERT_TRUE(reboot_called);
 }
 
+void test_route_hello_message(void) {
+    const char *json = "{\"type\":\"hello\",\"code\":0,\"data\":{\"tts\":\"opus\",\"tts_rate\":24000}}";
+
+    ws_msg_type_t type = ws_route_message(json);
+
+    TEST_ASSERT_EQUAL(WS_MSG_HELLO, type);
+    TEST_ASSERT_TRUE(hello_called);
+    TEST_ASSERT_EQUAL_STRING("opus", last_hello.tts_codec);
+    TEST_ASSERT_EQUAL_INT(24000, last_hello.tts_rate);
+}
+
+void test_route_pong_message(void) {
+    const char *json = "{\"type\":\"pong\",\"code\":0,\"data\":{\"seq\":12,\"t\":123456}}";
+
+    ws_msg_type_t type = ws_route_message(json);
+
+    TEST_ASSERT_EQUAL(WS_MSG_PONG, type);
+    TEST_ASSERT_TRUE(pong_called);
+    TEST_ASSERT_EQUAL_UINT32(12, last_pong.seq);
+}
+
 void test_route_unknown_type(void) {
     const char *json = "{\"type\":\"unknown\",\"code\":0,\"data\":null}";
 
@@ -244,6 +288,32 @@ void test_route_missing_type(void) {
     TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, type);
 }
 
+void test_route_beyond_token_budget(void) {
+    char json[512];
+    int n = snprintf(json, sizeof(json),
+                     "{\"type\":\"display\",\"data\":{\"text\":\"Big\",\"emoji\":\"happy\","
+                     "\"size\":24,\"extra\":[");
+    for (int i = 0; i < WS_JSON_MAX_TOKENS; i++) {
+        n += snprintf(json + n, sizeof(json) - n, i ? ",%d" : "%d", i % 10);
+    }
+    snprintf(json + n, sizeof(json) - n, "]}}");
+
+    /* Valid, just more tokens than the in-place tokenizer holds */
+    ws_msg_type_t type = ws_route_message(json);
+
+    TEST_ASSERT_EQUAL(WS_MSG_DISPLAY, type);
+    TEST_ASSERT_TRUE(display_called);
+    TEST_ASSERT_EQUAL_STRING("Big", last_display.text);
+    TEST_ASSERT_EQUAL_STRING("happy", last_display.emoji);
+    TEST_ASSERT_EQUAL_INT(24, last_display.size);
+
+    /* Still invalid when the tail is broken */
+    display_called = false;
+    json[strlen(json) - 1] = ',';
+    TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, ws_route_message(json));
+    TEST_ASSERT_FALSE(display_called);
+}
+
 void test_route_null_input(void) {
     ws_msg_type_t type = ws_route_message(NULL);
 
@@ -255,29 +325,30 @@ void test_route_null_input(void) {
 /* ------------------------------------------------------------------ */
 
 void test_parse_servo_valid_v2(void) {
-    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"x\":0,\"y\":180}}";
+    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"x\",\"angle\":180,\"time\":200}}";
     ws_servo_cmd_t cmd;
 
     int ret = ws_parse_servo(json, &cmd);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
-    TEST_ASSERT_EQUAL_INT(0, cmd.x);
-    TEST_ASSERT_EQUAL_INT(180, cmd.y);
+    TEST_ASSERT_EQUAL_STRING("x", cmd.id);
+    TEST_ASSERT_EQUAL_INT(180, cmd.angle);
+    TEST_ASSERT_EQUAL_INT(200, cmd.time_ms);
 }
 
 void test_parse_servo_center_v2(void) {
-    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"x\":90,\"y\":90}}";
+    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"x\"}}";
     ws_servo_cmd_t cmd;
 
     int ret = ws_parse_servo(json, &cmd);
 
     TEST_ASSERT_EQUAL_INT(0, ret);
-    TEST_ASSERT_EQUAL_INT(90, cmd.x);
-    TEST_ASSERT_EQUAL_INT(90, cmd.y);
+    TEST_ASSERT_EQUAL_INT(90, cmd.angle);
+    TEST_ASSERT_EQUAL_INT(100, cmd.time_ms);
 }
 
 void test_parse_servo_null_output(void) {
-    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"x\":90,\"y\":90}}";
+    const char *json = "{\"type\":\"servo\",\"code\":0,\"data\":{\"id\":\"x\",\"angle\":90}}";
 
     int ret = ws_parse_servo(json, NULL);
 
@@ -327,6 +398,32 @@ void test_parse_error_valid(void) {
     TEST_ASSERT_EQUAL_STRING("Internal error", cmd.message);
 }
 
+/* ------------------------------------------------------------------ */
+/* Test: Hello Reply Parsing (codec negotiation)                      */
+/* ------------------------------------------------------------------ */
+
+void test_parse_hello_opus(void) {
+    const char *json = "{\"type\":\"hello\",\"code\":0,\"data\":{\"tts\":\"opus\",\"tts_rate\":16000}}";
+    ws_hello_cmd_t cmd;
+
+    int ret = ws_parse_hello(json, &cmd);
+
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_STRING("opus", cmd.tts_codec);
+    TEST_ASSERT_EQUAL_INT(16000, cmd.tts_rate);
+}
+
+void test_parse_hello_defaults_to_pcm(void) {
+    const char *json = "{\"type\":\"hello\",\"code\":0}";
+    ws_hello_cmd_t cmd;
+
+    int ret = ws_parse_hello(json, &cmd);
+
+    TEST_ASSERT_EQUAL_INT(0, ret);
+    TEST_ASSERT_EQUAL_STRING("pcm", cmd.tts_codec);
+    TEST_ASSERT_EQUAL_INT(24000, cmd.tts_rate);
+}
+
 /* ------------------------------------------------------------------ */
 /* Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -345,9 +442,12 @@ int main(void) {
     RUN_TEST(test_route_error_message);
     RUN_TEST(test_route_capture_message_v2);
     RUN_TEST(test_route_reboot_message_v2);
+    RUN_TEST(test_route_hello_message);
+    RUN_TEST(test_route_pong_message);
     RUN_TEST(test_route_unknown_type);
     RUN_TEST(test_route_invalid_json);
     RUN_TEST(test_route_missing_type);
+    RUN_TEST(test_route_beyond_token_budget);
     RUN_TEST(test_route_null_input);
 
     /* Servo parsing (v2.0) */
@@ -364,5 +464,9 @@ int main(void) {
     /* Error parsing */
     RUN_TEST(test_parse_error_valid);
 
+    /* Hello parsing */
+    RUN_TEST(test_parse_hello_opus);
+    RUN_TEST(test_parse_hello_defaults_to_pcm);
+
     return UNITY_END();
 }
@@ -0,0 +1,247 @@
+#include "unity.h"
+#include "ws_sendq.h"
+#include <string.h>
+
+#define OP_TEXT     0x1
+#define OP_BINARY   0x2
+#define HDR         12                  /* Per-entry header bytes */
+
+static const int g_budget[WS_SENDQ_CLASSES] = { 256, 1024, 128 };
+static uint8_t g_storage[256 + 1024 + 128];
+static ws_sendq_t g_q;
+static uint8_t g_out[2048];
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL_INT(0, ws_sendq_init(&g_q, g_storage, g_budget));
+}
+
+void tearDown(void) {
+}
+
+/* Frame whose first byte identifies it */
+static int push_id(ws_sendq_class_t cls, uint8_t id, int len, uint8_t flags, uint32_t now) {
+    uint8_t buf[1024];
+    memset(buf, id, len);
+    return ws_sendq_push(&g_q, cls, cls == WS_SENDQ_AUDIO ? OP_BINARY : OP_TEXT, flags, buf, len, now);
+}
+
+static int pop_id(void) {
+    uint8_t op;
+    int len = ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, NULL, 0);
+    return len > 0 ? g_out[0] : -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Configuration                                                */
+/* ------------------------------------------------------------------ */
+
+void test_init_invalid_args(void) {
+    const int tiny[WS_SENDQ_CLASSES] = { 256, 4, 128 };
+
+    TEST_ASSERT_EQUAL_INT(-1, ws_sendq_init(NULL, g_storage, g_budget));
+    TEST_ASSERT_EQUAL_INT(-1, ws_sendq_init(&g_q, NULL, g_budget));
+    TEST_ASSERT_EQUAL_INT(-1, ws_sendq_init(&g_q, g_storage, tiny));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(g_storage), ws_sendq_storage_size(g_budget));
+}
+
+void test_pop_empty(void) {
+    uint8_t op;
+    TEST_ASSERT_EQUAL_INT(-1, ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, ws_sendq_count(&g_q));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Priority                                                     */
+/* ------------------------------------------------------------------ */
+
+void test_control_before_audio_before_telemetry(void) {
+    push_id(WS_SENDQ_TELEMETRY, 't', 10, 0, 0);
+    push_id(WS_SENDQ_AUDIO, 'a', 100, 0, 0);
+    push_id(WS_SENDQ_AUDIO, 'b', 100, 0, 0);
+    push_id(WS_SENDQ_CONTROL, 'c', 10, 0, 0);
+
+    TEST_ASSERT_EQUAL_INT('c', pop_id());
+    TEST_ASSERT_EQUAL_INT('a', pop_id());
+    TEST_ASSERT_EQUAL_INT('b', pop_id());
+    TEST_ASSERT_EQUAL_INT('t', pop_id());
+    TEST_ASSERT_EQUAL_INT(-1, pop_id());
+}
+
+void test_pop_returns_op_class_and_payload(void) {
+    const char *over = "over";
+    uint8_t op;
+    ws_sendq_class_t cls;
+
+    TEST_ASSERT_EQUAL_INT(0, ws_sendq_push(&g_q, WS_SENDQ_AUDIO, OP_TEXT, WS_SENDQ_PINNED,
+                                           (const uint8_t *)over, 4, 0));
+    TEST_ASSERT_EQUAL_INT(4, ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, &cls, 0));
+    TEST_ASSERT_EQUAL_UINT8(OP_TEXT, op);
+    TEST_ASSERT_EQUAL_INT(WS_SENDQ_AUDIO, cls);
+    TEST_ASSERT_EQUAL_MEMORY(over, g_out, 4);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Budget and Drop Policy                                       */
+/* ------------------------------------------------------------------ */
+
+void test_audio_drops_oldest_when_full(void) {
+    ws_sendq_class_stats_t st;
+
+    /* 1024 / (200 + 12) = 4 entries fit */
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_INT(0, push_id(WS_SENDQ_AUDIO, (uint8_t)i, 200, 0, 0));
+    }
+
+    TEST_ASSERT_EQUAL_INT(2, pop_id());
+    TEST_ASSERT_EQUAL_INT(3, pop_id());
+
+    ws_sendq_get_stats(&g_q, WS_SENDQ_AUDIO, &st);
+    TEST_ASSERT_EQUAL_UINT32(6, st.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, st.evicted);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dropped);
+    TEST_ASSERT_EQUAL_INT(2 * (200 + HDR), st.depth_bytes);
+    TEST_ASSERT_EQUAL_INT(4 * (200 + HDR), st.high_water_bytes);
+}
+
+void test_control_is_rejected_not_evicted(void) {
+    ws_sendq_class_stats_t st;
+
+    TEST_ASSERT_EQUAL_INT(0, push_id(WS_SENDQ_CONTROL, 1, 100, 0, 0));
+    TEST_ASSERT_EQUAL_INT(0, push_id(WS_SENDQ_CONTROL, 2, 100, 0, 0));
+    TEST_ASSERT_EQUAL_INT(-1, push_id(WS_SENDQ_CONTROL, 3, 100, 0, 0));
+
+    TEST_ASSERT_EQUAL_INT(1, pop_id());
+    TEST_ASSERT_EQUAL_INT(2, pop_id());
+
+    ws_sendq_get_stats(&g_q, WS_SENDQ_CONTROL, &st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, st.evicted);
+}
+
+void test_pinned_marker_is_never_evicted(void) {
+    TEST_ASSERT_EQUAL_INT(0, push_id(WS_SENDQ_AUDIO, 'o', 4, WS_SENDQ_PINNED, 0));
+    for (int i = 0; i < 10; i++) {
+        push_id(WS_SENDQ_AUDIO, (uint8_t)i, 200, 0, 0);
+    }
+
+    /* The marker stays at the head; newer audio behind it was trimmed */
+    TEST_ASSERT_EQUAL_INT('o', pop_id());
+    TEST_ASSERT_EQUAL_INT(0, pop_id());
+}
+
+void test_oversize_entry_is_rejected(void) {
+    TEST_ASSERT_EQUAL_INT(-1, push_id(WS_SENDQ_TELEMETRY, 1, 128, 0, 0));
+    TEST_ASSERT_EQUAL_INT(0, push_id(WS_SENDQ_TELEMETRY, 1, 128 - HDR, 0, 0));
+}
+
+void test_entry_larger_than_pop_buffer_is_dropped(void) {
+    uint8_t op;
+    uint8_t small[16];
+
+    push_id(WS_SENDQ_AUDIO, 'x', 100, 0, 0);
+    push_id(WS_SENDQ_AUDIO, 'y', 8, 0, 0);
+    TEST_ASSERT_EQUAL_INT(8, ws_sendq_pop(&g_q, small, sizeof(small), &op, NULL, 0));
+    TEST_ASSERT_EQUAL_UINT8('y', small[0]);
+}
+
+void test_clear_counts_drops(void) {
+    ws_sendq_class_stats_t st;
+
+    push_id(WS_SENDQ_AUDIO, 1, 50, 0, 0);
+    push_id(WS_SENDQ_AUDIO, 2, 50, 0, 0);
+    push_id(WS_SENDQ_CONTROL, 3, 50, 0, 0);
+    ws_sendq_clear(&g_q);
+
+    TEST_ASSERT_EQUAL_INT(0, ws_sendq_count(&g_q));
+    TEST_ASSERT_EQUAL_INT(-1, pop_id());
+    ws_sendq_get_stats(&g_q, WS_SENDQ_AUDIO, &st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.dropped);
+    TEST_ASSERT_EQUAL_INT(0, st.depth_bytes);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Latency and Wrap-around                                      */
+/* ------------------------------------------------------------------ */
+
+void test_latency_is_measured_per_class(void) {
+    uint8_t op;
+    ws_sendq_class_stats_t st;
+
+    push_id(WS_SENDQ_AUDIO, 1, 10, 0, 1000);
+    push_id(WS_SENDQ_AUDIO, 2, 10, 0, 1010);
+    ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, NULL, 1040);   /* 40 ms */
+    ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, NULL, 1030);   /* 20 ms */
+
+    ws_sendq_get_stats(&g_q, WS_SENDQ_AUDIO, &st);
+    TEST_ASSERT_EQUAL_UINT32(2, st.sent);
+    TEST_ASSERT_EQUAL_UINT32(40, st.latency_max_ms);
+    TEST_ASSERT_EQUAL_UINT32(30, st.latency_avg_ms);
+
+    ws_sendq_get_stats(&g_q, WS_SENDQ_CONTROL, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.sent);
+}
+
+void test_wraparound_preserves_payloads(void) {
+    uint8_t buf[300];
+    uint8_t op;
+    uint32_t seed = 1;
+    int next_push = 0;
+    int next_pop = 0;
+
+    /* Odd sizes so entries straddle the ring end; never overfill */
+    for (int round = 0; round < 500; round++) {
+        int len = 1 + (int)((seed = seed * 1103515245u + 12345u) >> 16) % 150;
+        for (int i = 0; i < len; i++) buf[i] = (uint8_t)(next_push + i);
+        buf[0] = (uint8_t)next_push;
+        TEST_ASSERT_EQUAL_INT(0, ws_sendq_push(&g_q, WS_SENDQ_AUDIO, OP_BINARY, 0, buf, len, 0));
+        next_push++;
+
+        if (ws_sendq_count(&g_q) >= 3) {
+            int n = ws_sendq_pop(&g_q, g_out, sizeof(g_out), &op, NULL, 0);
+            TEST_ASSERT_TRUE(n > 0);
+            TEST_ASSERT_EQUAL_UINT8((uint8_t)next_pop, g_out[0]);
+            for (int i = 1; i < n; i++) {
+                TEST_ASSERT_EQUAL_UINT8((uint8_t)(next_pop + i), g_out[i]);
+            }
+            next_pop++;
+        }
+    }
+
+    ws_sendq_class_stats_t st;
+    ws_sendq_get_stats(&g_q, WS_SENDQ_AUDIO, &st);
+    TEST_ASSERT_EQUAL_UINT32(0, st.dropped);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Configuration */
+    RUN_TEST(test_init_invalid_args);
+    RUN_TEST(test_pop_empty);
+
+    /* Priority */
+    RUN_TEST(test_control_before_audio_before_telemetry);
+    RUN_TEST(test_pop_returns_op_class_and_payload);
+
+    /* Budget and drop policy */
+    RUN_TEST(test_audio_drops_oldest_when_full);
+    RUN_TEST(test_control_is_rejected_not_evicted);
+    RUN_TEST(test_pinned_marker_is_never_evicted);
+    RUN_TEST(test_oversize_entry_is_rejected);
+    RUN_TEST(test_entry_larger_than_pop_buffer_is_dropped);
+    RUN_TEST(test_clear_counts_drops);
+
+    /* Latency and wrap-around */
+    RUN_TEST(test_latency_is_measured_per_class);
+    RUN_TEST(test_wraparound_preserves_payloads);
+
+    return UNITY_END();
+}
@@ -0,0 +1,267 @@
+#include "unity.h"
+#include "ws_tlv.h"
+#include "ws_router.h"
+#include <string.h>
+
+static uint8_t g_buf[512];
+static ws_tlv_writer_t g_w;
+
+/* What the router delivered */
+static int g_servo_count;
+static ws_servo_cmd_t g_servo[2];
+static ws_display_cmd_t g_display;
+static ws_status_cmd_t g_status;
+static ws_error_cmd_t g_error;
+static ws_pong_cmd_t g_pong;
+static bool g_tts_end;
+
+static void on_servo(const ws_servo_cmd_t *cmd) {
+    if (g_servo_count < 2) g_servo[g_servo_count] = *cmd;
+    g_servo_count++;
+}
+static void on_display(const ws_display_cmd_t *cmd) { g_display = *cmd; }
+static void on_status(const ws_status_cmd_t *cmd) { g_status = *cmd; }
+static void on_error(const ws_error_cmd_t *cmd) { g_error = *cmd; }
+static void on_pong(const ws_pong_cmd_t *cmd) { g_pong = *cmd; }
+static void on_tts_end(void) { g_tts_end = true; }
+
+/* ------------------------------------------------------------------ */
+/* Setup / Teardown                                                   */
+/* ------------------------------------------------------------------ */
+
+void setUp(void) {
+    ws_router_t router = {
+        .on_servo   = on_servo,
+        .on_display = on_display,
+        .on_status  = on_status,
+        .on_error   = on_error,
+        .on_pong    = on_pong,
+        .on_tts_end = on_tts_end,
+    };
+    ws_router_init(&router);
+    ws_tlv_writer_init(&g_w, g_buf, sizeof(g_buf));
+
+    g_servo_count = 0;
+    memset(g_servo, 0, sizeof(g_servo));
+    memset(&g_display, 0, sizeof(g_display));
+    memset(&g_status, 0, sizeof(g_status));
+    memset(&g_error, 0, sizeof(g_error));
+    memset(&g_pong, 0, sizeof(g_pong));
+    g_tts_end = false;
+}
+
+void tearDown(void) {
+}
+
+static void put_servo(const char *id, int angle, int time_ms) {
+    ws_tlv_msg_begin(&g_w, WS_TLV_SERVO);
+    ws_tlv_put_str(&g_w, WS_TLV_F_ID, id);
+    ws_tlv_put_int(&g_w, WS_TLV_F_ANGLE, angle);
+    ws_tlv_put_int(&g_w, WS_TLV_F_TIME, time_ms);
+    ws_tlv_msg_end(&g_w);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Encoding                                                     */
+/* ------------------------------------------------------------------ */
+
+void test_servo_wire_format(void) {
+    const uint8_t expect[] = {
+        WS_TLV_CH_CONTROL, 0x00,
+        WS_TLV_SERVO, 10, 0,
+        WS_TLV_F_ID, 1, 'x',
+        WS_TLV_F_ANGLE, 1, 90,
+        WS_TLV_F_TIME, 2, 0xF4, 0x01,           /* 500 */
+    };
+
+    put_servo("x", 90, 500);
+    TEST_ASSERT_EQUAL_INT(sizeof(expect), ws_tlv_writer_finish(&g_w));
+    TEST_ASSERT_EQUAL_MEMORY(expect, g_buf, sizeof(expect));
+}
+
+void test_int_widths_round_trip(void) {
+    const int32_t values[] = { 0, -1, 127, -128, 128, 32767, -32768, 40000, -2000000000 };
+    const int n = (int)(sizeof(values) / sizeof(values[0]));
+    ws_tlv_reader_t r, body;
+    ws_tlv_field_t f;
+    uint8_t type;
+
+    ws_tlv_msg_begin(&g_w, 0x7F);
+    for (int i = 0; i < n; i++) {
+        ws_tlv_put_int(&g_w, (uint8_t)i, values[i]);
+    }
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL_INT(0, ws_tlv_reader_init(&r, g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_INT(1, ws_tlv_next_msg(&r, &type, &body));
+    TEST_ASSERT_EQUAL_UINT8(0x7F, type);
+    for (int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_INT(1, ws_tlv_next_field(&body, &f));
+        TEST_ASSERT_EQUAL_INT32(values[i], ws_tlv_field_int(&f, 0));
+    }
+    TEST_ASSERT_EQUAL_INT(0, ws_tlv_next_field(&body, &f));
+    TEST_ASSERT_EQUAL_INT(0, ws_tlv_next_msg(&r, &type, &body));
+}
+
+void test_writer_overflow(void) {
+    uint8_t small[8];
+
+    ws_tlv_writer_init(&g_w, small, sizeof(small));
+    put_servo("x", 90, 500);
+    TEST_ASSERT_EQUAL_INT(-1, ws_tlv_writer_finish(&g_w));
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Routing                                                      */
+/* ------------------------------------------------------------------ */
+
+void test_route_batched_servo(void) {
+    put_servo("x", 45, 200);
+    put_servo("y", 135, 300);
+
+    TEST_ASSERT_EQUAL(WS_MSG_SERVO, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_INT(2, g_servo_count);
+    TEST_ASSERT_EQUAL_STRING("x", g_servo[0].id);
+    TEST_ASSERT_EQUAL_INT(45, g_servo[0].angle);
+    TEST_ASSERT_EQUAL_INT(200, g_servo[0].time_ms);
+    TEST_ASSERT_EQUAL_STRING("y", g_servo[1].id);
+    TEST_ASSERT_EQUAL_INT(135, g_servo[1].angle);
+}
+
+void test_route_servo_defaults_match_json(void) {
+    ws_tlv_msg_begin(&g_w, WS_TLV_SERVO);
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL(WS_MSG_SERVO, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL(WS_MSG_SERVO, ws_route_message("{\"type\":\"servo\",\"data\":{}}"));
+    TEST_ASSERT_EQUAL_INT(2, g_servo_count);
+    TEST_ASSERT_EQUAL_STRING("", g_servo[0].id);
+    TEST_ASSERT_EQUAL_STRING(g_servo[1].id, g_servo[0].id);
+    TEST_ASSERT_EQUAL_INT(90, g_servo[0].angle);
+    TEST_ASSERT_EQUAL_INT(g_servo[1].angle, g_servo[0].angle);
+    TEST_ASSERT_EQUAL_INT(100, g_servo[0].time_ms);
+    TEST_ASSERT_EQUAL_INT(g_servo[1].time_ms, g_servo[0].time_ms);
+}
+
+void test_route_display_and_status(void) {
+    ws_tlv_msg_begin(&g_w, WS_TLV_DISPLAY);
+    ws_tlv_put_str(&g_w, WS_TLV_F_TEXT, "Hello");
+    ws_tlv_put_str(&g_w, WS_TLV_F_EMOJI, "happy");
+    ws_tlv_put_int(&g_w, WS_TLV_F_SIZE, 24);
+    ws_tlv_msg_end(&g_w);
+    ws_tlv_msg_begin(&g_w, WS_TLV_STATUS);
+    ws_tlv_put_str(&g_w, WS_TLV_F_TEXT, "[thinking]");
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL(WS_MSG_STATUS, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_STRING("Hello", g_display.text);
+    TEST_ASSERT_EQUAL_STRING("happy", g_display.emoji);
+    TEST_ASSERT_EQUAL_INT(24, g_display.size);
+    TEST_ASSERT_EQUAL_STRING("[thinking]", g_status.data);
+}
+
+void test_route_error_tts_end_and_pong(void) {
+    ws_tlv_msg_begin(&g_w, WS_TLV_ERROR);
+    ws_tlv_put_int(&g_w, WS_TLV_F_CODE, 3);
+    ws_tlv_put_str(&g_w, WS_TLV_F_TEXT, "ASR failed");
+    ws_tlv_msg_end(&g_w);
+    ws_tlv_msg_begin(&g_w, WS_TLV_TTS_END);
+    ws_tlv_msg_end(&g_w);
+    ws_tlv_msg_begin(&g_w, WS_TLV_PONG);
+    ws_tlv_put_int(&g_w, WS_TLV_F_TEXT, 70000);
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL(WS_MSG_PONG, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_INT(3, g_error.code);
+    TEST_ASSERT_EQUAL_STRING("ASR failed", g_error.message);
+    TEST_ASSERT_TRUE(g_tts_end);
+    TEST_ASSERT_EQUAL_UINT32(70000, g_pong.seq);
+}
+
+void test_long_string_is_truncated(void) {
+    char text[300];
+    memset(text, 'a', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    ws_tlv_msg_begin(&g_w, WS_TLV_DISPLAY);
+    ws_tlv_put_str(&g_w, WS_TLV_F_TEXT, text);      /* 255 on the wire */
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL(WS_MSG_DISPLAY, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_INT(WS_DISPLAY_TEXT_MAX - 1, (int)strlen(g_display.text));
+}
+
+void test_unknown_type_and_tag_are_skipped(void) {
+    ws_tlv_msg_begin(&g_w, 0x70);
+    ws_tlv_put_str(&g_w, 1, "future");
+    ws_tlv_msg_end(&g_w);
+    ws_tlv_msg_begin(&g_w, WS_TLV_SERVO);
+    ws_tlv_put_int(&g_w, 0x40, 1234);
+    ws_tlv_put_int(&g_w, WS_TLV_F_ANGLE, 10);
+    ws_tlv_msg_end(&g_w);
+
+    TEST_ASSERT_EQUAL(WS_MSG_SERVO, ws_route_binary(g_buf, ws_tlv_writer_finish(&g_w)));
+    TEST_ASSERT_EQUAL_INT(1, g_servo_count);
+    TEST_ASSERT_EQUAL_INT(10, g_servo[0].angle);
+}
+
+void test_malformed_frames_are_rejected(void) {
+    put_servo("x", 45, 200);
+    int len = ws_tlv_writer_finish(&g_w);
+
+    /* Truncated anywhere inside the message */
+    for (int cut = WS_TLV_HDR_LEN + 1; cut < len; cut++) {
+        TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, ws_route_binary(g_buf, cut));
+    }
+    TEST_ASSERT_EQUAL_INT(0, g_servo_count);
+
+    /* Field length past the end of its message */
+    g_buf[WS_TLV_HDR_LEN + 3 + 1] = 200;
+    TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, ws_route_binary(g_buf, len));
+
+    /* Audio channel or empty input is not a control frame */
+    g_buf[0] = WS_TLV_CH_AUDIO;
+    TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, ws_route_binary(g_buf, len));
+    TEST_ASSERT_EQUAL(WS_MSG_UNKNOWN, ws_route_binary(NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, g_servo_count);
+}
+
+/* ------------------------------------------------------------------ */
+/* Test: Hello Negotiation                                            */
+/* ------------------------------------------------------------------ */
+
+void test_hello_ctl_defaults_to_json(void) {
+    ws_hello_cmd_t cmd;
+
+    TEST_ASSERT_EQUAL_INT(0, ws_parse_hello("{\"type\":\"hello\",\"data\":{\"tts\":\"pcm\"}}", &cmd));
+    TEST_ASSERT_EQUAL_STRING("json", cmd.ctl);
+    TEST_ASSERT_EQUAL_INT(0, ws_parse_hello("{\"type\":\"hello\",\"data\":{\"ctl\":\"tlv\"}}", &cmd));
+    TEST_ASSERT_EQUAL_STRING("tlv", cmd.ctl);
+}
+
+/* ------------------------------------------------------------------ */
+/* Main                                                               */
+/* ------------------------------------------------------------------ */
+
+int main(void) {
+    UNITY_BEGIN();
+
+    /* Encoding */
+    RUN_TEST(test_servo_wire_format);
+    RUN_TEST(test_int_widths_round_trip);
+    RUN_TEST(test_writer_overflow);
+
+    /* Routing */
+    RUN_TEST(test_route_batched_servo);
+    RUN_TEST(test_route_servo_defaults_match_json);
+    RUN_TEST(test_route_display_and_status);
+    RUN_TEST(test_route_error_tts_end_and_pong);
+    RUN_TEST(test_long_string_is_truncated);
+    RUN_TEST(test_unknown_type_and_tag_are_skipped);
+    RUN_TEST(test_malformed_frames_are_rejected);
+
+    /* Hello negotiation */
+    RUN_TEST(test_hello_ctl_defaults_to_json);
+
+    return UNITY_END();
+}
@@ -460,6 +460,10 @@ class WebSocketThread(QThread):
 
                     self.audio_player.frame_buffer.clear()
 
+            elif msg_type == 'ping':
+                # Keepalive: echo seq/timestamp so the device can time the round trip
+                await websocket.send(json.dumps({"type": "pong", "code": 0, "data": data.get('data')}))
+
             else:
                 # Other message types
                 self.message_received.emit(client_id, json.dumps(data, indent=2)[:500])